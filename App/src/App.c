@@ -13,7 +13,7 @@ typedef struct AppData {
     AudioSource TestSource;
 	
 	MaterialLayout TestLayout;
-	Buffer* TriangleVertexBuffer;
+	BufferHandle TriangleVertexBuffer;
 } AppData;
 
 static AppData app;
@@ -38,7 +38,7 @@ b8 GameInit(Game* game)
 	}
 
 	app.TriangleVertexBuffer = RendererFrontendBufferCreate(sizeof(Vertices), BUFFER_USAGE_VERTEX);
-	if (!app.TriangleVertexBuffer) {
+	if (app.TriangleVertexBuffer == BUFFER_HANDLE_INVALID) {
 		ELSA_ERROR("Failed to create triangle vertex buffer!");
 		return false;
 	}
@@ -11,8 +11,10 @@ b8 CreateGame(Game* out_game, int argc, char** argv)
     out_game->AppConfig.Height = 720;
 #ifdef ELSA_PLATFORM_WINDOWS
 	out_game->AppConfig.Name = "Elsa Engine | <WIN32> | <VK> | <XAUDIO2>";
-#elif ELSA_PLATFORM_MACOS
+#elif defined(ELSA_PLATFORM_MACOS)
 	out_game->AppConfig.Name = "Elsa Engine | <COCOA> | <MTL> | <AVFOUNDATION>";
+#elif defined(ELSA_PLATFORM_LINUX)
+	out_game->AppConfig.Name = "Elsa Engine | <LINUX> | <HEADLESS> | <NULL>";
 #endif
     out_game->Init = GameInit;
     out_game->Free = GameFree;
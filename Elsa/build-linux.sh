@@ -0,0 +1,14 @@
+set echo on
+
+mkdir -p ../bin
+
+cFilenames=$(find . -type f \( -name "*.c" -o -name "*.cpp" \))
+
+Assembly="Elsa"
+CompilerFlags="-g -shared -fdeclspec -fPIC -Wno-missing-braces"
+IncludeFlags="-Isrc -IVendor"
+LinkerFlags="-lvulkan -lshaderc_shared -lstdc++ -lpthread -lm"
+Defines="-D_DEBUG -DELSA_EXPORT"
+
+echo "Building $Assembly..."
+clang $cFilenames $CompilerFlags -o ../bin/lib$Assembly.so $Defines $IncludeFlags $LinkerFlags
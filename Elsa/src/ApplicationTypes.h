@@ -24,6 +24,13 @@ typedef struct Game {
         i32 Height;
         /** @brief The title position of the window. */
         const char* Name;
+        /** @brief The path of a file the log is also written to. Optional. */
+        const char* LogFile;
+        /**
+         * @brief Whether to run without a window, with a renderer that draws nothing. Also enabled by
+         * setting the ELSA_HEADLESS environment variable, and always on Linux.
+         */
+        b8 Headless;
     } AppConfig;
 
     /** @brief Called once at the beginning of the application. */
@@ -56,6 +63,8 @@ typedef struct ApplicationState {
 
     /** @brief Whether or not the application is running. */
     b8 Running;
+    /** @brief Whether or not the application runs without a window. */
+    b8 Headless;
 } ApplicationState;
 
 #endif
\ No newline at end of file
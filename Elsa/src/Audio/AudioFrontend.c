@@ -1,3 +1,5 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_AUDIO
+
 #include "AudioFrontend.h"
 
 #include <Audio/Backend/AudioBackend.h>
@@ -22,6 +24,11 @@ b8 AudioFrontendInit()
 		ELSA_ERROR("AudioBackendCreate <AUDIO_BACKEND_API_AVFOUNDATION> failed. Shutting down...");
 		return false;
 	}
+#else
+	if (!AudioBackendCreate(AUDIO_BACKEND_API_NULL, &Frontend.Backend)) {
+		ELSA_ERROR("AudioBackendCreate <AUDIO_BACKEND_API_NULL> failed. Shutting down...");
+		return false;
+	}
 #endif
 	
 	if (!Frontend.Backend.Init(&Frontend.Backend))
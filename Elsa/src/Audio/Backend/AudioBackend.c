@@ -4,6 +4,7 @@
 
 #include "XAudio2/XAudio2Backend.h"
 #include "AVFoundation/AVFoundationBackend.h"
+#include "Null/NullBackend.h"
 
 // NOTE(milo): build dr_wav
 #define DR_WAV_IMPLEMENTATION
@@ -35,6 +36,13 @@ b8 AudioBackendCreate(AudioBackendAPI api, AudioBackend* out_audio_backend)
 		return false;
 #endif
 	}
+	if (api == AUDIO_BACKEND_API_NULL) {
+		out_audio_backend->API = AUDIO_BACKEND_API_NULL;
+        out_audio_backend->Init = NullBackendInit;
+        out_audio_backend->Shutdown = NullBackendShutdown;
+		out_audio_backend->Update = NullBackendUpdate;
+		return true;
+	}
 	
 	return false;
 }
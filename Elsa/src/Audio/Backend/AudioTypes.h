@@ -15,7 +15,9 @@ typedef enum AudioBackendAPI {
 	/** @brief (SUPPORTED: WIN32) The XAudio2 backend */
 	AUDIO_BACKEND_API_XAUDIO2,
 	/** @brief (SUPPORTED: MACOS) The AVFoundation backend */
-	AUDIO_BACKEND_API_AVFOUNDATION
+	AUDIO_BACKEND_API_AVFOUNDATION,
+	/** @brief (SUPPORTED: ALL) The null backend, which plays nothing */
+	AUDIO_BACKEND_API_NULL
 } AudioBackendAPI;
 
 /**
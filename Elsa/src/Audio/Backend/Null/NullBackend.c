@@ -0,0 +1,99 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_AUDIO
+
+#include "NullBackend.h"
+
+#include <Audio/AudioSource.h>
+#include <Core/Logger.h>
+
+#include <dr_wav/dr_wav.h>
+
+b8 NullBackendInit(AudioBackend* backend)
+{
+	backend->Details.SampleRate = 44100;
+	backend->Details.ChannelCount = 2;
+	
+	ELSA_INFO("Null audio backend initialized, no sound will be played.");
+	return true;
+}
+
+void NullBackendShutdown(AudioBackend* backend)
+{
+	
+}
+
+void NullBackendUpdate(AudioBackend* backend)
+{
+	
+}
+
+// The other backends implement audio sources themselves.
+#if !defined(ELSA_PLATFORM_WINDOWS) && !defined(ELSA_PLATFORM_MACOS)
+
+b8 AudioSourceCreate(AudioSource* out_source)
+{
+	out_source->Looping = false;
+	out_source->Volume = 1.0f;
+	out_source->Pitch = 1.0f;
+	out_source->BackendData = 0;
+	return true;
+}
+
+void AudioSourceDestroy(AudioSource* source)
+{
+	
+}
+
+b8 AudioSourceLoad(const char* path, AudioSource* source)
+{
+	// Still open the file, so that headless runs catch missing or broken assets.
+	drwav wave;
+	if (!drwav_init_file(&wave, path, NULL)) {
+		ELSA_ERROR("Failed to load .wav file from path %s", path);
+		return false;
+	}
+	drwav_uninit(&wave);
+	
+	return true;
+}
+
+b8 AudioSourcePlay(AudioSource* source)
+{
+	return true;
+}
+
+void AudioSourceStop(AudioSource* source)
+{
+	
+}
+
+void AudioSourceSetVolume(f32 volume, AudioSource* source)
+{
+	source->Volume = volume;
+}
+
+void AudioSourceSetPitch(f32 pitch, AudioSource* source)
+{
+	source->Pitch = pitch;
+}
+
+void AudioSourceSetLowPassFilter(f32 frequency, f32 one_over_q, AudioSource* source)
+{
+	
+}
+
+void AudioSourceSetHighPassFilter(f32 frequency, f32 one_over_q, AudioSource* source)
+{
+	
+}
+
+void AudioSourceSetBandFilter(f32 frequency, f32 one_over_q, AudioSource* source)
+{
+	
+}
+
+void AudioSourceSetNotchFilter(f32 frequency, f32 one_over_q, AudioSource* source)
+{
+	
+}
+
+#endif
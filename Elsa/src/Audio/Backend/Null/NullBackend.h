@@ -0,0 +1,19 @@
+/**
+ * @file NullBackend.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains the null audio backend, which plays nothing. It is
+ * used on platforms without an audio backend, such as headless Linux instances.
+ * @version 1.0
+ * @date 2022-07-30
+ */
+#ifndef ELSA_NULL_BACKEND_H
+#define ELSA_NULL_BACKEND_H
+
+#include <Defines.h>
+#include <Audio/Backend/AudioTypes.h>
+
+b8 NullBackendInit(AudioBackend* backend);
+void NullBackendShutdown(AudioBackend* backend);
+void NullBackendUpdate(AudioBackend* backend);
+
+#endif
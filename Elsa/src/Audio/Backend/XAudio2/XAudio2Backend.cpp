@@ -1,8 +1,11 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_AUDIO
+
 extern "C" {
 #include "XAudio2Backend.h"
 #include <Audio/AudioSource.h>
 #include <Core/Logger.h>
 #include <Core/MemTracker.h>
+#include <Core/MemoryPool.h>
 }
 
 #if defined(ELSA_PLATFORM_WINDOWS)
@@ -36,6 +39,8 @@ typedef struct XAudio2State {
 	
 	u32 SampleRate;
 	u32 ChannelCount;
+	
+	MemoryPool SourcePool;
 } XAudio2State;
 
 typedef struct XAudio2Source {
@@ -119,6 +124,11 @@ b8 XAudio2BackendInit(AudioBackend* backend)
 		return false;
 	}
 	
+	if (!MemoryPool_Create(XAudio2Source, MEMORY_POOL_DEFAULT_CHUNK_SLOTS, false, MEMORY_TAG_AUDIO, &state.SourcePool)) {
+		ELSA_ERROR("Failed to create the XAudio2 source pool.");
+		return false;
+	}
+	
 	// Launch message
 	ELSA_INFO("<XAudio2BackendInit> Using audio device with sample rate of %d and channel count of %d", details.InputSampleRate, details.InputChannels);
 	
@@ -127,6 +137,7 @@ b8 XAudio2BackendInit(AudioBackend* backend)
 
 void XAudio2BackendShutdown(AudioBackend* backend)
 {
+	MemoryPoolDestroy(&state.SourcePool);
 	state.MasterVoice->DestroyVoice();
 	state.Device->StopEngine();
 	state.Device->Release();
@@ -145,8 +156,10 @@ b8 AudioSourceCreate(AudioSource* out_source)
 	out_source->Looping = false;
 	out_source->Volume = 1.0f;
 	
-	out_source->BackendData = MemoryTrackerAlloc(sizeof(XAudio2Source), MEMORY_TAG_AUDIO);
+	out_source->BackendData = MemoryPool_Alloc(&state.SourcePool, XAudio2Source);
 	XAudio2Source* source = (XAudio2Source*)out_source->BackendData;
+	if (!source)
+		return false;
 	
 	// Wave format
 	WAVEFORMATEX wave_format = {};
@@ -176,7 +189,7 @@ void AudioSourceDestroy(AudioSource* source)
 	if (backend->SourceVoice)
 		backend->SourceVoice->DestroyVoice();
 	
-	MemoryTrackerFree(source->BackendData, sizeof(XAudio2Source), MEMORY_TAG_AUDIO);
+	MemoryPoolFree(&state.SourcePool, source->BackendData);
 }
 
 b8 AudioSourceLoad(const char* path, AudioSource* source)
@@ -0,0 +1,261 @@
+#include "Bitset.h"
+
+#include <Core/Logger.h>
+#include <Core/MemTracker.h>
+#include <Platform/Platform.h>
+
+#if defined(ELSA_BITSET_USE_AVX2)
+#include <immintrin.h>
+#elif defined(ELSA_BITSET_USE_SSE2)
+#include <emmintrin.h>
+#endif
+
+typedef enum BitsetOperation {
+    BITSET_OPERATION_AND,
+    BITSET_OPERATION_OR,
+    BITSET_OPERATION_AND_NOT
+} BitsetOperation;
+
+u64* BitsetCreate(u64 bit_count)
+{
+    u64 size = BITSET_WORDS(bit_count) * sizeof(u64);
+    u64* words = MemoryTrackerAlloc(size, MEMORY_TAG_ENGINE_GENERAL);
+    if (words)
+        PlatformZeroMemory(words, size);
+    return words;
+}
+
+void BitsetDestroy(u64* words, u64 bit_count)
+{
+    if (words)
+        MemoryTrackerFree(words, BITSET_WORDS(bit_count) * sizeof(u64), MEMORY_TAG_ENGINE_GENERAL);
+}
+
+u64 BitsetCount(const u64* words, u64 word_count)
+{
+    u64 count = 0;
+    for (u64 i = 0; i < word_count; i++)
+        count += __builtin_popcountll(words[i]);
+    return count;
+}
+
+// Scans for the first word at or after start that differs from skip_value.
+u64 BitsetSkipWords(const u64* words, u64 word_count, u64 start, u64 skip_value)
+{
+    u64 i = start;
+#if defined(ELSA_BITSET_USE_AVX2)
+    __m256i skip = _mm256_set1_epi64x((i64)skip_value);
+    for (; i + 4 <= word_count; i += 4) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(words + i));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi64(block, skip)) != -1)
+            break;
+    }
+#elif defined(ELSA_BITSET_USE_SSE2)
+    __m128i skip = _mm_set1_epi64x((i64)skip_value);
+    for (; i + 2 <= word_count; i += 2) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(words + i));
+        // SSE2 has no 64-bit compare, but both halves of a word matching is the same thing.
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(block, skip)) != 0xFFFF)
+            break;
+    }
+#endif
+    while (i < word_count && words[i] == skip_value)
+        i++;
+    return i;
+}
+
+b8 BitsetFindNextSet(const u64* words, u64 word_count, u64 start, u64* out_index)
+{
+    u64 word_index = start / BITSET_WORD_BITS;
+    if (word_index >= word_count)
+        return false;
+
+    // Mask off the bits before start in the first word.
+    u64 word = words[word_index] & (~0ull << (start % BITSET_WORD_BITS));
+    if (!word) {
+        word_index = BitsetSkipWords(words, word_count, word_index + 1, 0);
+        if (word_index >= word_count)
+            return false;
+        word = words[word_index];
+    }
+
+    *out_index = word_index * BITSET_WORD_BITS + __builtin_ctzll(word);
+    return true;
+}
+
+b8 BitsetFindNextClear(const u64* words, u64 word_count, u64 start, u64* out_index)
+{
+    u64 word_index = start / BITSET_WORD_BITS;
+    if (word_index >= word_count)
+        return false;
+
+    u64 word = ~words[word_index] & (~0ull << (start % BITSET_WORD_BITS));
+    if (!word) {
+        word_index = BitsetSkipWords(words, word_count, word_index + 1, ~0ull);
+        if (word_index >= word_count)
+            return false;
+        word = ~words[word_index];
+    }
+
+    *out_index = word_index * BITSET_WORD_BITS + __builtin_ctzll(word);
+    return true;
+}
+
+void BitsetCombine(u64* out, const u64* a, const u64* b, u64 word_count, BitsetOperation operation)
+{
+    u64 i = 0;
+#if defined(ELSA_BITSET_USE_AVX2)
+    for (; i + 4 <= word_count; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+        __m256i result;
+        switch (operation) {
+            case BITSET_OPERATION_AND: result = _mm256_and_si256(x, y); break;
+            case BITSET_OPERATION_OR: result = _mm256_or_si256(x, y); break;
+            default: result = _mm256_andnot_si256(y, x); break;
+        }
+        _mm256_storeu_si256((__m256i*)(out + i), result);
+    }
+#elif defined(ELSA_BITSET_USE_SSE2)
+    for (; i + 2 <= word_count; i += 2) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(b + i));
+        __m128i result;
+        switch (operation) {
+            case BITSET_OPERATION_AND: result = _mm_and_si128(x, y); break;
+            case BITSET_OPERATION_OR: result = _mm_or_si128(x, y); break;
+            default: result = _mm_andnot_si128(y, x); break;
+        }
+        _mm_storeu_si128((__m128i*)(out + i), result);
+    }
+#endif
+    for (; i < word_count; i++) {
+        switch (operation) {
+            case BITSET_OPERATION_AND: out[i] = a[i] & b[i]; break;
+            case BITSET_OPERATION_OR: out[i] = a[i] | b[i]; break;
+            default: out[i] = a[i] & ~b[i]; break;
+        }
+    }
+}
+
+void BitsetAnd(u64* out, const u64* a, const u64* b, u64 word_count)
+{
+    BitsetCombine(out, a, b, word_count, BITSET_OPERATION_AND);
+}
+
+void BitsetOr(u64* out, const u64* a, const u64* b, u64 word_count)
+{
+    BitsetCombine(out, a, b, word_count, BITSET_OPERATION_OR);
+}
+
+void BitsetAndNot(u64* out, const u64* a, const u64* b, u64 word_count)
+{
+    BitsetCombine(out, a, b, word_count, BITSET_OPERATION_AND_NOT);
+}
+
+// Sets the first bit_count bits of a level and clears the rest of its last word.
+void HierarchicalBitmapFillLevel(u64* words, u64 word_count, u64 bit_count)
+{
+    PlatformSetMemory(words, 0xFF, word_count * sizeof(u64));
+    if (bit_count % BITSET_WORD_BITS)
+        words[word_count - 1] = (1ull << (bit_count % BITSET_WORD_BITS)) - 1;
+}
+
+b8 HierarchicalBitmapCreate(u64 bit_count, b8 initial_value, HierarchicalBitmap* out_bitmap)
+{
+    if (!out_bitmap || bit_count == 0) {
+        ELSA_ERROR("HierarchicalBitmapCreate - bit_count must be nonzero, and out_bitmap is required.");
+        return false;
+    }
+
+    PlatformZeroMemory(out_bitmap, sizeof(HierarchicalBitmap));
+    out_bitmap->BitCount = bit_count;
+
+    // Add summary levels until one word covers everything.
+    u64 total_words = 0;
+    u64 level_bits = bit_count;
+    for (;;) {
+        if (out_bitmap->LevelCount == HIERARCHICAL_BITMAP_MAX_LEVELS) {
+            ELSA_ERROR("HierarchicalBitmapCreate - %llu bits is too many!", bit_count);
+            return false;
+        }
+        u64 word_count = BITSET_WORDS(level_bits);
+        out_bitmap->WordCounts[out_bitmap->LevelCount++] = word_count;
+        total_words += word_count;
+        if (word_count == 1)
+            break;
+        level_bits = word_count;
+    }
+
+    u64* memory = MemoryTrackerAlloc(total_words * sizeof(u64), MEMORY_TAG_ENGINE_GENERAL);
+    if (!memory) {
+        ELSA_ERROR("HierarchicalBitmapCreate - Failed to allocate %llu bits!", bit_count);
+        return false;
+    }
+    PlatformZeroMemory(memory, total_words * sizeof(u64));
+
+    level_bits = bit_count;
+    for (u32 level = 0; level < out_bitmap->LevelCount; level++) {
+        out_bitmap->Levels[level] = memory;
+        if (initial_value)
+            HierarchicalBitmapFillLevel(memory, out_bitmap->WordCounts[level], level_bits);
+        level_bits = out_bitmap->WordCounts[level];
+        memory += out_bitmap->WordCounts[level];
+    }
+    return true;
+}
+
+void HierarchicalBitmapDestroy(HierarchicalBitmap* bitmap)
+{
+    if (bitmap && bitmap->Levels[0]) {
+        u64 total_words = 0;
+        for (u32 level = 0; level < bitmap->LevelCount; level++)
+            total_words += bitmap->WordCounts[level];
+        MemoryTrackerFree(bitmap->Levels[0], total_words * sizeof(u64), MEMORY_TAG_ENGINE_GENERAL);
+        PlatformZeroMemory(bitmap, sizeof(HierarchicalBitmap));
+    }
+}
+
+void HierarchicalBitmapSet(HierarchicalBitmap* bitmap, u64 index)
+{
+    for (u32 level = 0; level < bitmap->LevelCount; level++) {
+        u64* word = &bitmap->Levels[level][index / BITSET_WORD_BITS];
+        b8 was_empty = *word == 0;
+        *word |= 1ull << (index % BITSET_WORD_BITS);
+        // The summary bit above is already set unless this word was empty.
+        if (!was_empty)
+            return;
+        index /= BITSET_WORD_BITS;
+    }
+}
+
+void HierarchicalBitmapClear(HierarchicalBitmap* bitmap, u64 index)
+{
+    for (u32 level = 0; level < bitmap->LevelCount; level++) {
+        u64* word = &bitmap->Levels[level][index / BITSET_WORD_BITS];
+        *word &= ~(1ull << (index % BITSET_WORD_BITS));
+        // The summary bit above stays set while the word has any bit left.
+        if (*word)
+            return;
+        index /= BITSET_WORD_BITS;
+    }
+}
+
+b8 HierarchicalBitmapTest(HierarchicalBitmap* bitmap, u64 index)
+{
+    return BitsetTest(bitmap->Levels[0], index);
+}
+
+b8 HierarchicalBitmapFindFirstSet(HierarchicalBitmap* bitmap, u64* out_index)
+{
+    u64 index = 0;
+    for (i32 level = (i32)bitmap->LevelCount - 1; level >= 0; level--) {
+        u64 word = bitmap->Levels[level][index];
+        if (!word)
+            return false;
+        index = index * BITSET_WORD_BITS + __builtin_ctzll(word);
+    }
+
+    *out_index = index;
+    return true;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file Bitset.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains packed bitsets, and a hierarchical bitmap that finds
+ * a set bit in a constant number of steps.
+ * @version 1.0
+ * @date 2022-07-24
+ */
+#ifndef ELSA_BITSET_H
+#define ELSA_BITSET_H
+
+#include <Defines.h>
+
+#if defined(__AVX2__)
+#define ELSA_BITSET_USE_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ELSA_BITSET_USE_SSE2 1
+#endif
+
+/** @brief The number of bits in a bitset word. */
+#define BITSET_WORD_BITS 64
+
+/**
+ * @brief The number of words needed to hold the given number of bits.
+ * A bitset is an array of this many u64s, which can live anywhere, including inside other structures.
+ * @param bit_count The number of bits.
+ */
+#define BITSET_WORDS(bit_count) (((bit_count) + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS)
+
+/** @brief The maximum number of levels of a hierarchical bitmap, enough for 2^36 bits. */
+#define HIERARCHICAL_BITMAP_MAX_LEVELS 6
+
+/**
+ * @brief Returns the value of a bit.
+ * @param words The bitset.
+ * @param index The index of the bit.
+ * @returns True if the bit is set; otherwise false.
+ */
+ELSA_INLINE b8 BitsetTest(const u64* words, u64 index)
+{
+    return (words[index / BITSET_WORD_BITS] >> (index % BITSET_WORD_BITS)) & 1;
+}
+
+/**
+ * @brief Sets a bit.
+ * @param words The bitset.
+ * @param index The index of the bit.
+ */
+ELSA_INLINE void BitsetSet(u64* words, u64 index)
+{
+    words[index / BITSET_WORD_BITS] |= 1ull << (index % BITSET_WORD_BITS);
+}
+
+/**
+ * @brief Clears a bit.
+ * @param words The bitset.
+ * @param index The index of the bit.
+ */
+ELSA_INLINE void BitsetClear(u64* words, u64 index)
+{
+    words[index / BITSET_WORD_BITS] &= ~(1ull << (index % BITSET_WORD_BITS));
+}
+
+/**
+ * @brief Sets or clears a bit.
+ * @param words The bitset.
+ * @param index The index of the bit.
+ * @param value The new value of the bit.
+ */
+ELSA_INLINE void BitsetAssign(u64* words, u64 index, b8 value)
+{
+    u64 mask = 1ull << (index % BITSET_WORD_BITS);
+    u64* word = &words[index / BITSET_WORD_BITS];
+    *word = (*word & ~mask) | ((u64)-(i64)(value != 0) & mask);
+}
+
+/**
+ * @brief Allocates a bitset with every bit cleared.
+ * @param bit_count The number of bits.
+ * @returns The bitset, or 0 on failure.
+ */
+ELSA_API u64* BitsetCreate(u64 bit_count);
+
+/**
+ * @brief Frees a bitset allocated with BitsetCreate.
+ * @param words The bitset.
+ * @param bit_count The number of bits it was created with.
+ */
+ELSA_API void BitsetDestroy(u64* words, u64 bit_count);
+
+/**
+ * @brief Counts the set bits of a bitset.
+ * @param words The bitset.
+ * @param word_count The number of words of the bitset.
+ * @returns The number of set bits.
+ */
+ELSA_API u64 BitsetCount(const u64* words, u64 word_count);
+
+/**
+ * @brief Finds the lowest set bit at or after start.
+ * @param words The bitset.
+ * @param word_count The number of words of the bitset.
+ * @param start The index to start searching from.
+ * @param out_index A pointer to hold the index of the bit.
+ * @returns True if a set bit was found; otherwise false.
+ */
+ELSA_API b8 BitsetFindNextSet(const u64* words, u64 word_count, u64 start, u64* out_index);
+
+/**
+ * @brief Finds the lowest clear bit at or after start. Bits past the end of the
+ * last word count as clear, so check the index against the size of the bitset.
+ * @param words The bitset.
+ * @param word_count The number of words of the bitset.
+ * @param start The index to start searching from.
+ * @param out_index A pointer to hold the index of the bit.
+ * @returns True if a clear bit was found; otherwise false.
+ */
+ELSA_API b8 BitsetFindNextClear(const u64* words, u64 word_count, u64 start, u64* out_index);
+
+/**
+ * @brief Computes out = a & b, word by word. The outputs may alias the inputs.
+ * @param out The bitset to write to.
+ * @param a The first bitset.
+ * @param b The second bitset.
+ * @param word_count The number of words of each bitset.
+ */
+ELSA_API void BitsetAnd(u64* out, const u64* a, const u64* b, u64 word_count);
+
+/**
+ * @brief Computes out = a | b, word by word. The outputs may alias the inputs.
+ * @see BitsetAnd
+ */
+ELSA_API void BitsetOr(u64* out, const u64* a, const u64* b, u64 word_count);
+
+/**
+ * @brief Computes out = a & ~b, word by word. The outputs may alias the inputs.
+ * @see BitsetAnd
+ */
+ELSA_API void BitsetAndNot(u64* out, const u64* a, const u64* b, u64 word_count);
+
+/**
+ * @brief Represents a bitset with a 64-ary tree of summary levels on top. Every
+ * bit of a summary level is set if the word below it has any bit set, so the
+ * lowest set bit is found with one word per level, regardless of size. Members
+ * of this structure should not be modified outside the functions associated with it.
+ *
+ * To track free slots, set the bits of free slots, and clear them as slots are used.
+ */
+typedef struct HierarchicalBitmap {
+    /** @brief The number of bits. */
+    u64 BitCount;
+    /** @brief The number of levels, including the leaves. The last level is a single word. */
+    u32 LevelCount;
+    /** @brief The number of words of each level. */
+    u64 WordCounts[HIERARCHICAL_BITMAP_MAX_LEVELS];
+    /** @brief The words of each level. Level 0 holds the bits themselves. */
+    u64* Levels[HIERARCHICAL_BITMAP_MAX_LEVELS];
+} HierarchicalBitmap;
+
+/**
+ * @brief Creates a hierarchical bitmap and stores it in out_bitmap.
+ * @param bit_count The number of bits.
+ * @param initial_value The value every bit starts with.
+ * @param out_bitmap A pointer to a bitmap in which to hold relevant data.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 HierarchicalBitmapCreate(u64 bit_count, b8 initial_value, HierarchicalBitmap* out_bitmap);
+
+/**
+ * @brief Destroys a hierarchical bitmap, releasing its memory.
+ * @param bitmap A pointer to the bitmap.
+ */
+ELSA_API void HierarchicalBitmapDestroy(HierarchicalBitmap* bitmap);
+
+/**
+ * @brief Sets a bit of the bitmap.
+ * @param bitmap A pointer to the bitmap.
+ * @param index The index of the bit.
+ */
+ELSA_API void HierarchicalBitmapSet(HierarchicalBitmap* bitmap, u64 index);
+
+/**
+ * @brief Clears a bit of the bitmap.
+ * @param bitmap A pointer to the bitmap.
+ * @param index The index of the bit.
+ */
+ELSA_API void HierarchicalBitmapClear(HierarchicalBitmap* bitmap, u64 index);
+
+/**
+ * @brief Returns the value of a bit of the bitmap.
+ * @param bitmap A pointer to the bitmap.
+ * @param index The index of the bit.
+ * @returns True if the bit is set; otherwise false.
+ */
+ELSA_API b8 HierarchicalBitmapTest(HierarchicalBitmap* bitmap, u64 index);
+
+/**
+ * @brief Finds the lowest set bit of the bitmap, reading one word per level.
+ * @param bitmap A pointer to the bitmap.
+ * @param out_index A pointer to hold the index of the bit.
+ * @returns True if a set bit was found; false if every bit is clear.
+ */
+ELSA_API b8 HierarchicalBitmapFindFirstSet(HierarchicalBitmap* bitmap, u64* out_index);
+
+#endif
@@ -16,11 +16,49 @@ void* _Darray_Create(u64 length, u64 stride)
     return (void*)(new_array + DARRAY_FIELD_LENGTH);
 }
 
+u64 StableDarrayPageAlign(u64 size)
+{
+    u64 page_size = PlatformGetPageSize();
+    return (size + page_size - 1) & ~(page_size - 1);
+}
+
+void* _Darray_CreateStable(u64 max_capacity, u64 stride)
+{
+    u64 header_size = DARRAY_FIELD_LENGTH * sizeof(u64);
+    u64 reserved_size = StableDarrayPageAlign(header_size + max_capacity * stride);
+    u64* new_array = PlatformReserveMemory(reserved_size);
+    if (!new_array) {
+        ELSA_ERROR("Failed to reserve %llu bytes for a stable darray!", reserved_size);
+        return 0;
+    }
+	
+    // Start with as few pages as will hold one element, committed pages are already zeroed.
+    u64 committed_size = StableDarrayPageAlign(header_size + stride);
+    if (!PlatformCommitMemory(new_array, committed_size)) {
+        ELSA_ERROR("Failed to commit memory for a stable darray!");
+        PlatformReleaseMemory(new_array, reserved_size);
+        return 0;
+    }
+	
+    new_array[DARRAY_CAPACITY] = (committed_size - header_size) / stride;
+    new_array[DARRAY_LENGTH] = 0;
+    new_array[DARRAY_STRIDE] = stride;
+    new_array[DARRAY_FLAGS] = DARRAY_FLAG_STABLE;
+    new_array[DARRAY_MAX_CAPACITY] = (reserved_size - header_size) / stride;
+    return (void*)(new_array + DARRAY_FIELD_LENGTH);
+}
+
 void _Darray_Destroy(void* array)
 {
     u64* header = (u64*)array - DARRAY_FIELD_LENGTH;
 	u64 header_size = DARRAY_FIELD_LENGTH * sizeof(u64);
-    u64 array_size = Darray_Length(array) * Darray_Stride(array);
+	if (header[DARRAY_FLAGS] & DARRAY_FLAG_STABLE) {
+		u64 reserved_size = StableDarrayPageAlign(header_size + header[DARRAY_MAX_CAPACITY] * header[DARRAY_STRIDE]);
+		PlatformReleaseMemory(header, reserved_size);
+		return;
+	}
+	
+    u64 array_size = Darray_Capacity(array) * Darray_Stride(array);
     MemoryTrackerFree(header, header_size + array_size, MEMORY_TAG_DARRAY);
 }
 
@@ -36,11 +74,51 @@ void _Darray_Field_Set(void* array, u64 field, u64 value)
     header[field] = value;
 }
 
-void* _Darray_Resize(void* array)
+void* StableDarrayGrow(void* array, u64 new_capacity)
+{
+    u64* header = (u64*)array - DARRAY_FIELD_LENGTH;
+    u64 header_size = DARRAY_FIELD_LENGTH * sizeof(u64);
+    u64 stride = header[DARRAY_STRIDE];
+    u64 capacity = header[DARRAY_CAPACITY];
+    u64 max_capacity = header[DARRAY_MAX_CAPACITY];
+    if (new_capacity > max_capacity)
+        new_capacity = max_capacity;
+    if (new_capacity <= capacity)
+        return array;
+	
+    u64 committed_size = StableDarrayPageAlign(header_size + capacity * stride);
+    u64 new_committed_size = StableDarrayPageAlign(header_size + new_capacity * stride);
+    if (new_committed_size > committed_size &&
+        !PlatformCommitMemory((u8*)header + committed_size, new_committed_size - committed_size)) {
+        ELSA_ERROR("Failed to commit memory for a stable darray!");
+        return array;
+    }
+	
+    header[DARRAY_CAPACITY] = (new_committed_size - header_size) / stride;
+    if (header[DARRAY_CAPACITY] > max_capacity)
+        header[DARRAY_CAPACITY] = max_capacity;
+    return array;
+}
+
+// Grows the array so that it holds at least min_capacity elements, following the growth policy.
+void* DarrayGrow(void* array, u64 min_capacity)
 {
+    u64 capacity = Darray_Capacity(array);
+    if (min_capacity <= capacity)
+        return array;
+	
+    u64 new_capacity = capacity * DARRAY_RESIZE_FACTOR;
+    if (new_capacity < DARRAY_MIN_GROW_CAPACITY)
+        new_capacity = DARRAY_MIN_GROW_CAPACITY;
+    if (new_capacity < min_capacity)
+        new_capacity = min_capacity;
+	
+    if (_Darray_Field_Get(array, DARRAY_FLAGS) & DARRAY_FLAG_STABLE)
+        return StableDarrayGrow(array, new_capacity);
+	
     u64 length = Darray_Length(array);
     u64 stride = Darray_Stride(array);
-    void* temp = _Darray_Create((DARRAY_RESIZE_FACTOR * Darray_Capacity(array)), stride);
+    void* temp = _Darray_Create(new_capacity, stride);
     PlatformCopyMemory(temp, array, length * stride);
 	
     _Darray_Field_Set(temp, DARRAY_LENGTH, length);
@@ -48,18 +126,83 @@ void* _Darray_Resize(void* array)
     return temp;
 }
 
+void* _Darray_Resize(void* array)
+{
+    return DarrayGrow(array, Darray_Capacity(array) + 1);
+}
+
+void* _Darray_Reserve_Capacity(void* array, u64 capacity)
+{
+    array = DarrayGrow(array, capacity);
+    if (Darray_Capacity(array) < capacity)
+        ELSA_ERROR("Darray can't grow to a capacity of %llu! Capacity: %llu", capacity, Darray_Capacity(array));
+    return array;
+}
+
+void* _Darray_Set_Length(void* array, u64 length)
+{
+    u64 old_length = Darray_Length(array);
+    u64 stride = Darray_Stride(array);
+    if (length > old_length) {
+        array = DarrayGrow(array, length);
+        if (length > Darray_Capacity(array)) {
+            ELSA_ERROR("Darray can't grow to a length of %llu! Capacity: %llu", length, Darray_Capacity(array));
+            return array;
+        }
+        PlatformZeroMemory((u8*)array + (old_length * stride), (length - old_length) * stride);
+    }
+	
+    _Darray_Field_Set(array, DARRAY_LENGTH, length);
+    return array;
+}
+
+void* _Darray_Shrink_To_Fit(void* array)
+{
+    u64 length = Darray_Length(array);
+    u64 stride = Darray_Stride(array);
+    u64 new_capacity = length ? length : DARRAY_DEFAULT_CAPACITY;
+    if (new_capacity >= Darray_Capacity(array))
+        return array;
+	
+    if (_Darray_Field_Get(array, DARRAY_FLAGS) & DARRAY_FLAG_STABLE) {
+        // Stable arrays can't move, so give the pages past the last element back instead.
+        u64* header = (u64*)array - DARRAY_FIELD_LENGTH;
+        u64 header_size = DARRAY_FIELD_LENGTH * sizeof(u64);
+        u64 committed_size = StableDarrayPageAlign(header_size + header[DARRAY_CAPACITY] * stride);
+        u64 needed_size = StableDarrayPageAlign(header_size + new_capacity * stride);
+        if (needed_size < committed_size) {
+            PlatformDecommitMemory((u8*)header + needed_size, committed_size - needed_size);
+            header[DARRAY_CAPACITY] = (needed_size - header_size) / stride;
+        }
+        return array;
+    }
+	
+    void* temp = _Darray_Create(new_capacity, stride);
+    PlatformCopyMemory(temp, array, length * stride);
+    _Darray_Field_Set(temp, DARRAY_LENGTH, length);
+    _Darray_Destroy(array);
+    return temp;
+}
+
 void* _Darray_Push(void* array, const void* value_ptr)
+{
+    return _Darray_Push_Many(array, value_ptr, 1);
+}
+
+void* _Darray_Push_Many(void* array, const void* values, u64 count)
 {
     u64 length = Darray_Length(array);
     u64 stride = Darray_Stride(array);
-    if (length >= Darray_Capacity(array)) {
-        array = _Darray_Resize(array);
+    if (length + count > Darray_Capacity(array)) {
+        array = DarrayGrow(array, length + count);
+        if (length + count > Darray_Capacity(array)) {
+            ELSA_ERROR("Darray is full and can't be resized! Capacity: %llu", Darray_Capacity(array));
+            return array;
+        }
     }
 	
-    u64 addr = (u64)array;
-    addr += (length * stride);
-    PlatformCopyMemory((void*)addr, value_ptr, stride);
-    _Darray_Field_Set(array, DARRAY_LENGTH, length + 1);
+    PlatformCopyMemory((u8*)array + (length * stride), values, count * stride);
+    _Darray_Field_Set(array, DARRAY_LENGTH, length + count);
     return array;
 }
 
@@ -78,49 +221,68 @@ void* _Darray_Pop_At(void* array, u64 index, void* value_ptr)
     u64 length = Darray_Length(array);
     u64 stride = Darray_Stride(array);
     if (index >= length) {
-        ELSA_ERROR("Index outside the bounds of this array! Length: %i, index: %index", length, index);
+        ELSA_ERROR("Index outside the bounds of this array! Length: %llu, index: %llu", length, index);
         return array;
     }
 	
-    u64 addr = (u64)array;
-    PlatformCopyMemory(value_ptr, (void*)(addr + (index * stride)), stride);
-	
-    if (index != length - 1) {
-        PlatformCopyMemory(
-						   (void*)(addr + (index * stride)),
-						   (void*)(addr + ((index + 1) * stride)),
-						   stride * (length - index)
-						   );
-    }
+    u8* element = (u8*)array + (index * stride);
+    if (value_ptr)
+        PlatformCopyMemory(value_ptr, element, stride);
+	
+    // Shift everything after the popped element down in a single move.
+    if (index != length - 1)
+        PlatformMoveMemory(element, element + stride, stride * (length - index - 1));
 	
     _Darray_Field_Set(array, DARRAY_LENGTH, length - 1);
     return array;
 }
 
-void* _Darray_Insert_At(void* array, u64 index, void* value_ptr)
+void* _Darray_Pop_Swap(void* array, u64 index, void* value_ptr)
 {
     u64 length = Darray_Length(array);
     u64 stride = Darray_Stride(array);
     if (index >= length) {
-        ELSA_ERROR("Index outside the bounds of this array! Length: %i, index: %index", length, index);
+        ELSA_ERROR("Index outside the bounds of this array! Length: %llu, index: %llu", length, index);
         return array;
     }
-    if (length >= Darray_Capacity(array)) {
-        array = _Darray_Resize(array);
-    }
 	
-    u64 addr = (u64)array;
+    u8* element = (u8*)array + (index * stride);
+    if (value_ptr)
+        PlatformCopyMemory(value_ptr, element, stride);
+    if (index != length - 1)
+        PlatformCopyMemory(element, (u8*)array + ((length - 1) * stride), stride);
 	
-    if (index != length - 1) {
-        PlatformCopyMemory(
-						   (void*)(addr + ((index + 1) * stride)),
-						   (void*)(addr + (index * stride)),
-						   stride * (length - index)
-						   );
+    _Darray_Field_Set(array, DARRAY_LENGTH, length - 1);
+    return array;
+}
+
+void* _Darray_Insert_At(void* array, u64 index, void* value_ptr)
+{
+    return _Darray_Insert_Many(array, index, value_ptr, 1);
+}
+
+void* _Darray_Insert_Many(void* array, u64 index, const void* values, u64 count)
+{
+    u64 length = Darray_Length(array);
+    u64 stride = Darray_Stride(array);
+    if (index > length) {
+        ELSA_ERROR("Index outside the bounds of this array! Length: %llu, index: %llu", length, index);
+        return array;
+    }
+    if (length + count > Darray_Capacity(array)) {
+        array = DarrayGrow(array, length + count);
+        if (length + count > Darray_Capacity(array)) {
+            ELSA_ERROR("Darray is full and can't be resized! Capacity: %llu", Darray_Capacity(array));
+            return array;
+        }
     }
 	
-    PlatformCopyMemory((void*)(addr + (index * stride)), value_ptr, stride);
+    // Open a gap for all of the new elements in a single move.
+    u8* element = (u8*)array + (index * stride);
+    if (index != length)
+        PlatformMoveMemory(element + (count * stride), element, stride * (length - index));
 	
-    _Darray_Field_Set(array, DARRAY_LENGTH, length + 1);
+    PlatformCopyMemory(element, values, count * stride);
+    _Darray_Field_Set(array, DARRAY_LENGTH, length + count);
     return array;
-}
\ No newline at end of file
+}
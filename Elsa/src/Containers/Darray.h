@@ -14,9 +14,17 @@ enum {
     DARRAY_CAPACITY,
     DARRAY_LENGTH,
     DARRAY_STRIDE,
+    DARRAY_FLAGS,
+    DARRAY_MAX_CAPACITY,
     DARRAY_FIELD_LENGTH
 };
 
+/** @brief Flags stored in the DARRAY_FLAGS field of a darray. */
+typedef enum DarrayFlags {
+    /** @brief The array lives in a reserved range of address space and never moves. */
+    DARRAY_FLAG_STABLE = 0x1
+} DarrayFlags;
+
 /**
  * @brief Creates a new darray of the given length and stride.
  * Note that this performs a dynamic memory allocation. 
@@ -27,6 +35,17 @@ enum {
  */
 ELSA_API void* _Darray_Create(u64 length, u64 stride);
 
+/**
+ * @brief Creates a new stable darray. The address space for max_capacity elements
+ * is reserved up front, and pages are committed as the array grows, so growing never
+ * copies and pointers to elements stay valid for the lifetime of the array.
+ * @note Avoid using this directly; use the Darray_CreateStable macro instead.
+ * @param max_capacity The maximum number of elements the array can ever hold.
+ * @param stride The size of each array element.
+ * @returns A pointer representing the block of memory containing the array, or 0 on failure.
+ */
+ELSA_API void* _Darray_CreateStable(u64 max_capacity, u64 stride);
+
 /**
  * @brief destroys the given array, freeing resources. Frees associated memory.
  * @note Avoid using this function directly. Use the darray_destroy macro instead.
@@ -54,13 +73,42 @@ ELSA_API void _Darray_Field_Set(void* array, u64 field, u64 value);
 
 /**
  * @brief Resizes the given array using internal resizing amounts.
- * Causes a new allocation.
+ * Causes a new allocation, unless the array is stable, in which case more pages
+ * are committed in place. A stable array that is already at its maximum capacity
+ * is returned unchanged.
  * @note This is an internal implementation detail and should not be called directly.
  * @param array The array to be resized.
  * @returns A pointer to the resized array block.
  */
 ELSA_API void* _Darray_Resize(void* array);
 
+/**
+ * @brief Grows the given array so that it can hold at least capacity elements.
+ * @note Avoid using this directly; call the Darray_EnsureCapacity macro instead.
+ * @param array The array to grow.
+ * @param capacity The number of elements the array must be able to hold.
+ * @returns A pointer to the array block.
+ */
+ELSA_API void* _Darray_Reserve_Capacity(void* array, u64 capacity);
+
+/**
+ * @brief Sets the length of the given array, growing it if required. New elements are zeroed.
+ * @note Avoid using this directly; call the Darray_Resize macro instead.
+ * @param array The array to resize.
+ * @param length The new length of the array.
+ * @returns A pointer to the array block.
+ */
+ELSA_API void* _Darray_Set_Length(void* array, u64 length);
+
+/**
+ * @brief Releases the capacity of the given array that isn't used by its elements.
+ * Stable arrays give the unused pages back instead of moving.
+ * @note Avoid using this directly; call the Darray_ShrinkToFit macro instead.
+ * @param array The array to shrink.
+ * @returns A pointer to the array block.
+ */
+ELSA_API void* _Darray_Shrink_To_Fit(void* array);
+
 /**
  * @brief Pushes a new entry to the given array. Resizes if necessary.
  * @note Avoid using this directly; call the darray_push macro instead.
@@ -70,6 +118,16 @@ ELSA_API void* _Darray_Resize(void* array);
  */
 ELSA_API void* _Darray_Push(void* array, const void* value_ptr);
 
+/**
+ * @brief Pushes count entries to the end of the given array, growing it at most once.
+ * @note Avoid using this directly; call the Darray_PushMany macro instead.
+ * @param array The array to be pushed to.
+ * @param values A pointer to the values to be pushed. Copies of the values are taken.
+ * @param count The number of values to push.
+ * @returns A pointer to the array block.
+ */
+ELSA_API void* _Darray_Push_Many(void* array, const void* values, u64 count);
+
 /**
  * @brief Pops an entry out of the array and places it into dest.
  * @note Avoid using this directly; call the darray_pop macro instead.
@@ -89,6 +147,17 @@ ELSA_API void _Darray_Pop(void* array, void* dest);
  */
 ELSA_API void* _Darray_Pop_At(void* array, u64 index, void* value_ptr);
 
+/**
+ * @brief Removes the entry at the given index by moving the last entry into its place.
+ * O(1), but doesn't preserve the order of the array.
+ * @note Avoid using this directly; call the Darray_PopSwap macro instead.
+ * @param array The array to pop from.
+ * @param index The index to pop from.
+ * @param value_ptr A pointer to hold the popped value. Optional.
+ * @returns The array block.
+ */
+ELSA_API void* _Darray_Pop_Swap(void* array, u64 index, void* value_ptr);
+
 /**
  * @brief Inserts a copy of the given value into the supplied array at the given index.
  * Triggers an array resize if required.
@@ -100,12 +169,35 @@ ELSA_API void* _Darray_Pop_At(void* array, u64 index, void* value_ptr);
  */
 ELSA_API void* _Darray_Insert_At(void* array, u64 index, void* value_ptr);
 
+/**
+ * @brief Inserts copies of count values into the supplied array at the given index,
+ * shifting the following entries once. Triggers an array resize if required.
+ * @note Avoid using this directly; call the Darray_InsertMany macro instead.
+ * @param array The array to insert into.
+ * @param index The index to insert at. May be equal to the length of the array.
+ * @param values A pointer to the values to be inserted.
+ * @param count The number of values to insert.
+ * @returns The array block.
+ */
+ELSA_API void* _Darray_Insert_Many(void* array, u64 index, const void* values, u64 count);
+
 /** @brief The default darray capacity. */
 #define DARRAY_DEFAULT_CAPACITY 1
 
 /** @brief The default resize factor (doubles on resize) */
 #define DARRAY_RESIZE_FACTOR 2
 
+/** @brief The smallest capacity a darray grows to, so that tiny arrays don't reallocate on every push. */
+#define DARRAY_MIN_GROW_CAPACITY 4
+
+/**
+ * @brief Fails to compile if pointer doesn't point to elements of the same size as array.
+ * @param array The darray.
+ * @param pointer The pointer to check.
+ */
+#define DARRAY_CHECK_TYPE(array, pointer) \
+_Static_assert(sizeof(*(pointer)) == sizeof(*(array)), "Darray element type mismatch")
+
 /**
  * @brief Creates a new darray of the given type with the default capacity. 
  * Performs a dynamic memory allocation.
@@ -125,6 +217,16 @@ _Darray_Create(DARRAY_DEFAULT_CAPACITY, sizeof(type))
 #define Darray_Reserve(type, capacity) \
 _Darray_Create(capacity, sizeof(type))
 
+/**
+ * @brief Creates a new stable darray of the given type. Growing the array never moves
+ * it, so pointers to its elements stay valid. Pushing past max_capacity fails.
+ * @param type The type to be used to create the darray.
+ * @param max_capacity The maximum number of elements the darray can ever hold.
+ * @returns A pointer to the array's memory block, or 0 on failure.
+ */
+#define Darray_CreateStable(type, max_capacity) \
+_Darray_CreateStable(max_capacity, sizeof(type))
+
 /**
  * @brief Destroys the provided array, freeing any memory allocated by it.
  * @param array The array to be destroyed.
@@ -143,6 +245,18 @@ typeof(value) temp = value;         \
 array = _Darray_Push(array, &temp); \
 }
 
+/**
+ * @brief Pushes count entries to the end of the given array, growing it at most once.
+ * @param array The array to be pushed to.
+ * @param values A pointer to the values to be pushed. Must point to the element type of the array.
+ * @param count The number of values to push.
+ */
+#define Darray_PushMany(array, values, count)      \
+{                                           \
+DARRAY_CHECK_TYPE(array, values);           \
+array = _Darray_Push_Many(array, values, count); \
+}
+
 /**
  * @brief Pops an entry out of the array and places it into dest.
  * @param array The array to pop from.
@@ -165,17 +279,66 @@ typeof(value) temp = value;                     \
 array = _Darray_Insert_At(array, index, &temp); \
 }
 
+/**
+ * @brief Inserts copies of count values into the supplied array at the given index.
+ * Triggers an array resize if required.
+ * @param array The array to insert into.
+ * @param index The index to insert at. May be equal to the length of the array.
+ * @param values A pointer to the values to be inserted. Must point to the element type of the array.
+ * @param count The number of values to insert.
+ */
+#define Darray_InsertMany(array, index, values, count)      \
+{                                                    \
+DARRAY_CHECK_TYPE(array, values);                    \
+array = _Darray_Insert_Many(array, index, values, count); \
+}
+
 /**
  * @brief Pops an entry out of the array at the given index and places it into dest.
  * Brings in all entries after the popped index in by one.
  * @param array The array to pop from.
  * @param index The index to pop from.
- * @param value_ptr A pointer to hold the popped value.
+ * @param value_ptr A pointer to hold the popped value. Optional.
  * @returns The array block.
  */
 #define Darray_PopAt(array, index, value_ptr) \
 _Darray_Pop_At(array, index, value_ptr)
 
+/**
+ * @brief Removes the entry at the given index by moving the last entry into its place.
+ * O(1), but doesn't preserve the order of the array.
+ * @param array The array to pop from.
+ * @param index The index to pop from.
+ * @param value_ptr A pointer to hold the popped value. Optional.
+ * @returns The array block.
+ */
+#define Darray_PopSwap(array, index, value_ptr) \
+_Darray_Pop_Swap(array, index, value_ptr)
+
+/**
+ * @brief Grows the given array so that it can hold at least capacity elements
+ * without reallocating.
+ * @param array The array to grow.
+ * @param capacity The number of elements the array must be able to hold.
+ */
+#define Darray_EnsureCapacity(array, capacity) \
+array = _Darray_Reserve_Capacity(array, capacity)
+
+/**
+ * @brief Sets the length of the given array, growing it if required. New elements are zeroed.
+ * @param array The array to resize.
+ * @param length The new length of the array.
+ */
+#define Darray_Resize(array, length) \
+array = _Darray_Set_Length(array, length)
+
+/**
+ * @brief Releases the capacity of the given array that isn't used by its elements.
+ * @param array The array to shrink.
+ */
+#define Darray_ShrinkToFit(array) \
+array = _Darray_Shrink_To_Fit(array)
+
 /**
  * @brief Clears all entries from the array. Does not release any internally-allocated memory.
  * @param array The array to be cleared.
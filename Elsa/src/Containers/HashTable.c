@@ -1,53 +1,255 @@
 #include "HashTable.h"
 
 #include <Core/Logger.h>
+#include <Core/MemTracker.h>
 #include <Platform/Platform.h>
 
-u64 HashName(const char* name, u32 element_count) {
-    // A multipler to use when generating a hash. Prime to hopefully avoid collisions.
-    static const u64 multiplier = 97;
+#include <string.h>
 
-    unsigned const char* us;
-    u64 hash = 0;
+#ifdef ELSA_HASHTABLE_USE_SSE2
+#include <emmintrin.h>
+#endif
 
-    for (us = (unsigned const char*)name; *us; us++) {
-        hash = hash * multiplier + *us;
+u8 HashTableControlFromHash(u64 hash)
+{
+    return (u8)(hash >> 57);
+}
+
+u64 HashTableAllocationSize(u64 element_size, u32 capacity)
+{
+    return capacity * (sizeof(u8) + sizeof(u64) + sizeof(char*) + element_size) + (HASHTABLE_GROUP_WIDTH - 1);
+}
+
+void HashTableSetControl(HashTable* table, u64 index, u8 control)
+{
+    table->Control[index] = control;
+    if (index < HASHTABLE_GROUP_WIDTH - 1)
+        table->Control[table->Capacity + index] = control;
+}
+
+#ifdef ELSA_HASHTABLE_USE_SSE2
+// Returns a mask with a bit set for each of the HASHTABLE_GROUP_WIDTH control bytes equal to value.
+u32 HashTableMatchGroup(__m128i group, u8 value)
+{
+    return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)value)));
+}
+#endif
+
+// Carves every per-slot array out of a single allocation.
+b8 HashTableAllocate(HashTable* table, u32 capacity)
+{
+    u8* block = MemoryTrackerAlloc(HashTableAllocationSize(table->ElementSize, capacity), MEMORY_TAG_HASHTABLE);
+    if (!block)
+        return false;
+
+    table->Capacity = capacity;
+    table->Hashes = (u64*)block;
+    table->Keys = (char**)(table->Hashes + capacity);
+    table->Memory = (void*)(table->Keys + capacity);
+    table->Control = (u8*)table->Memory + (table->ElementSize * capacity);
+    PlatformSetMemory(table->Control, HASHTABLE_CONTROL_EMPTY, capacity + (HASHTABLE_GROUP_WIDTH - 1));
+    return true;
+}
+
+void HashTableRelease(HashTable* table)
+{
+    if (table->Hashes)
+        MemoryTrackerFree(table->Hashes, HashTableAllocationSize(table->ElementSize, table->Capacity), MEMORY_TAG_HASHTABLE);
+}
+
+void* HashTableValueAt(HashTable* table, u64 index)
+{
+    return (u8*)table->Memory + (table->ElementSize * index);
+}
+
+// Returns the slot holding name, or -1 if it isn't in the table.
+i64 HashTableFind(HashTable* table, const char* name, u64 hash)
+{
+    u64 mask = table->Capacity - 1;
+    u64 index = hash & mask;
+    u8 control = HashTableControlFromHash(hash);
+
+    // The load factor guarantees an empty slot, which ends every probe sequence.
+#ifdef ELSA_HASHTABLE_USE_SSE2
+    for (;;) {
+        __m128i group = _mm_loadu_si128((const __m128i*)(table->Control + index));
+        u32 matches = HashTableMatchGroup(group, control);
+        u32 empties = HashTableMatchGroup(group, HASHTABLE_CONTROL_EMPTY);
+
+        // Only slots before the first empty one belong to the probe sequence.
+        if (empties)
+            matches &= (empties & (0 - empties)) - 1;
+
+        while (matches) {
+            u64 slot = (index + __builtin_ctz(matches)) & mask;
+            if (table->Hashes[slot] == hash && strcmp(table->Keys[slot], name) == 0)
+                return (i64)slot;
+            matches &= matches - 1;
+        }
+
+        if (empties)
+            return -1;
+        index = (index + HASHTABLE_GROUP_WIDTH) & mask;
+    }
+#else
+    for (;;) {
+        u8 slot_control = table->Control[index];
+        if (slot_control == HASHTABLE_CONTROL_EMPTY)
+            return -1;
+        if (slot_control == control && table->Hashes[index] == hash && strcmp(table->Keys[index], name) == 0)
+            return (i64)index;
+
+        index = (index + 1) & mask;
     }
+#endif
+}
 
-    // Mod it against the size of the table.
-    hash %= element_count;
+// Places an entry in the first free slot of its probe sequence. The entry must not be in the table yet.
+u64 HashTableInsertNew(HashTable* table, u64 hash, char* key)
+{
+    u64 mask = table->Capacity - 1;
+    u64 index = hash & mask;
+#ifdef ELSA_HASHTABLE_USE_SSE2
+    for (;;) {
+        __m128i group = _mm_loadu_si128((const __m128i*)(table->Control + index));
+        u32 empties = HashTableMatchGroup(group, HASHTABLE_CONTROL_EMPTY);
+        if (empties) {
+            index = (index + __builtin_ctz(empties)) & mask;
+            break;
+        }
+        index = (index + HASHTABLE_GROUP_WIDTH) & mask;
+    }
+#else
+    while (table->Control[index] != HASHTABLE_CONTROL_EMPTY)
+        index = (index + 1) & mask;
+#endif
 
-    return hash;
+    HashTableSetControl(table, index, HashTableControlFromHash(hash));
+    table->Hashes[index] = hash;
+    table->Keys[index] = key;
+    table->Count++;
+    return index;
 }
 
-void HashTableCreate(u64 element_size, u32 element_count, b8 is_pointer_type, void* memory, HashTable* out_hashtable)
+b8 HashTableGrow(HashTable* table)
 {
-    if (!memory || !out_hashtable) {
-        ELSA_ERROR("HashTableCreate failed! Pointer to memory and out_hashtable are required.");
-        return;
+    HashTable old = *table;
+    if (!HashTableAllocate(table, old.Capacity * 2)) {
+        ELSA_ERROR("HashTable failed to grow to %u slots!", old.Capacity * 2);
+        *table = old;
+        return false;
     }
-    if (!element_count || !element_size) {
-        ELSA_ERROR("element_size and element_count must be a positive non-zero value.");
-        return;
+
+    table->Count = 0;
+    for (u64 i = 0; i < old.Capacity; i++) {
+        if (old.Control[i] == HASHTABLE_CONTROL_EMPTY)
+            continue;
+
+        u64 index = HashTableInsertNew(table, old.Hashes[i], old.Keys[i]);
+        PlatformCopyMemory(HashTableValueAt(table, index), HashTableValueAt(&old, i), table->ElementSize);
     }
 
-    out_hashtable->Memory = memory;
-    out_hashtable->ElementCount = element_count;
-    out_hashtable->ElementSize = element_size;
+    HashTableRelease(&old);
+    return true;
+}
+
+// Returns the slot holding name, adding the entry if required, or -1 on failure.
+i64 HashTableFindOrInsert(HashTable* table, const char* name, u64 hash)
+{
+    i64 index = HashTableFind(table, name, hash);
+    if (index >= 0)
+        return index;
+
+    if ((u64)(table->Count + 1) * 100 > (u64)table->Capacity * HASHTABLE_MAX_LOAD_PERCENT && !HashTableGrow(table))
+        return -1;
+
+    u64 key_size = strlen(name) + 1;
+    char* key = MemoryTrackerAlloc(key_size, MEMORY_TAG_HASHTABLE);
+    PlatformCopyMemory(key, name, key_size);
+    return (i64)HashTableInsertNew(table, hash, key);
+}
+
+void HashTableRemoveAt(HashTable* table, u64 index)
+{
+    char* key = table->Keys[index];
+    MemoryTrackerFree(key, strlen(key) + 1, MEMORY_TAG_HASHTABLE);
+    table->Count--;
+
+    // Shift the following entries of the probe sequence back into the hole when
+    // that doesn't move them before their home slot, instead of leaving a tombstone.
+    u64 mask = table->Capacity - 1;
+    u64 hole = index;
+    u64 next = (index + 1) & mask;
+    while (table->Control[next] != HASHTABLE_CONTROL_EMPTY) {
+        u64 home = table->Hashes[next] & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            HashTableSetControl(table, hole, table->Control[next]);
+            table->Hashes[hole] = table->Hashes[next];
+            table->Keys[hole] = table->Keys[next];
+            PlatformCopyMemory(HashTableValueAt(table, hole), HashTableValueAt(table, next), table->ElementSize);
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+
+    HashTableSetControl(table, hole, HASHTABLE_CONTROL_EMPTY);
+}
+
+b8 HashTableCreate(u64 element_size, u32 element_count, b8 is_pointer_type, HashTable* out_hashtable)
+{
+    if (!out_hashtable) {
+        ELSA_ERROR("HashTableCreate failed! Pointer to out_hashtable is required.");
+        return false;
+    }
+    if (!element_size && !is_pointer_type) {
+        ELSA_ERROR("element_size must be a positive non-zero value.");
+        return false;
+    }
+
+    // Size the table so that element_count entries fit under the maximum load factor.
+    u64 required = ((u64)element_count * 100) / HASHTABLE_MAX_LOAD_PERCENT + 1;
+    u32 capacity = HASHTABLE_MIN_CAPACITY;
+    while (capacity < required)
+        capacity *= 2;
+
+    PlatformZeroMemory(out_hashtable, sizeof(HashTable));
+    out_hashtable->ElementSize = is_pointer_type ? sizeof(void*) : element_size;
     out_hashtable->IsPointerType = is_pointer_type;
-    PlatformZeroMemory(out_hashtable->Memory, element_size * element_count);
+    if (!HashTableAllocate(out_hashtable, capacity)) {
+        ELSA_ERROR("HashTableCreate failed to allocate %u slots!", capacity);
+        return false;
+    }
+
+    return true;
 }
 
 void HashTableDestroy(HashTable* table)
 {
     if (table) {
+        for (u64 i = 0; i < table->Capacity; i++) {
+            if (table->Control[i] != HASHTABLE_CONTROL_EMPTY)
+                MemoryTrackerFree(table->Keys[i], strlen(table->Keys[i]) + 1, MEMORY_TAG_HASHTABLE);
+        }
+        HashTableRelease(table);
+        if (table->FillValue)
+            MemoryTrackerFree(table->FillValue, table->ElementSize, MEMORY_TAG_HASHTABLE);
         PlatformZeroMemory(table, sizeof(HashTable));
     }
 }
 
 b8 HashTableSet(HashTable* table, const char* name, void** value)
 {
-    if (!table || !name || !value) {
+    if (!name) {
+        ELSA_ERROR("HashTableSet requires table, name and value to exist.");
+        return false;
+    }
+
+    return HashTableSetHashed(table, HashedStringCreate(name), value);
+}
+
+b8 HashTableSetHashed(HashTable* table, HashedString name, void** value)
+{
+    if (!table || !name.String || !value) {
         ELSA_ERROR("HashTableSet requires table, name and value to exist.");
         return false;
     }
@@ -56,15 +258,28 @@ b8 HashTableSet(HashTable* table, const char* name, void** value)
         return false;
     }
 
-    u64 hash = HashName(name, table->ElementCount);
-    PlatformCopyMemory(table->Memory + (table->ElementSize * hash), value, table->ElementSize);
+    i64 index = HashTableFindOrInsert(table, name.String, name.Hash);
+    if (index < 0)
+        return false;
+
+    PlatformCopyMemory(HashTableValueAt(table, index), value, table->ElementSize);
     return true;
 }
 
 b8 HashTableSetPointer(HashTable* table, const char* name, void** value)
 {
-    if (!table || !name || !value) {
-        ELSA_ERROR("HashTableSetPointer requires table, name and value to exist.");
+    if (!name) {
+        ELSA_ERROR("HashTableSetPointer requires table and name to exist.");
+        return false;
+    }
+
+    return HashTableSetPointerHashed(table, HashedStringCreate(name), value);
+}
+
+b8 HashTableSetPointerHashed(HashTable* table, HashedString name, void** value)
+{
+    if (!table || !name.String) {
+        ELSA_ERROR("HashTableSetPointer requires table and name to exist.");
         return false;
     }
     if (!table->IsPointerType) {
@@ -72,14 +287,32 @@ b8 HashTableSetPointer(HashTable* table, const char* name, void** value)
         return false;
     }
 
-    u64 hash = HashName(name, table->ElementCount);
-    ((void**)table->Memory)[hash] = value ? *value : 0;
+    if (!value || !*value) {
+        HashTableRemoveHashed(table, name);
+        return true;
+    }
+
+    i64 index = HashTableFindOrInsert(table, name.String, name.Hash);
+    if (index < 0)
+        return false;
+
+    ((void**)table->Memory)[index] = *value;
     return true;
 }
 
 b8 HashTableGet(HashTable* table, const char* name, void* out_value)
 {
-    if (!table || !name || !out_value) {
+    if (!name) {
+        ELSA_ERROR("HashTableGet requires table, name and out_value to exist.");
+        return false;
+    }
+
+    return HashTableGetHashed(table, HashedStringCreate(name), out_value);
+}
+
+b8 HashTableGetHashed(HashTable* table, HashedString name, void* out_value)
+{
+    if (!table || !name.String || !out_value) {
         ELSA_ERROR("HashTableGet requires table, name and out_value to exist.");
         return false;
     }
@@ -88,14 +321,30 @@ b8 HashTableGet(HashTable* table, const char* name, void* out_value)
         return false;
     }
 
-    u64 hash = HashName(name, table->ElementCount);
-    PlatformCopyMemory(out_value, table->Memory + (table->ElementSize * hash), table->ElementSize);
+    i64 index = HashTableFind(table, name.String, name.Hash);
+    if (index < 0) {
+        if (table->FillValue)
+            PlatformCopyMemory(out_value, table->FillValue, table->ElementSize);
+        return false;
+    }
+
+    PlatformCopyMemory(out_value, HashTableValueAt(table, index), table->ElementSize);
     return true;
 }
 
 b8 HashTableGetPointer(HashTable* table, const char* name, void** out_value)
 {
-    if (!table || !name || !out_value) {
+    if (!name) {
+        ELSA_ERROR("HashTableGetPointer requires table, name and out_value to exist.");
+        return false;
+    }
+
+    return HashTableGetPointerHashed(table, HashedStringCreate(name), out_value);
+}
+
+b8 HashTableGetPointerHashed(HashTable* table, HashedString name, void** out_value)
+{
+    if (!table || !name.String || !out_value) {
         ELSA_ERROR("HashTableGetPointer requires table, name and out_value to exist.");
         return false;
     }
@@ -104,9 +353,34 @@ b8 HashTableGetPointer(HashTable* table, const char* name, void** out_value)
         return false;
     }
 
-    u64 hash = HashName(name, table->ElementCount);
-    *out_value = ((void**)table->Memory)[hash];
-    return out_value != 0;
+    i64 index = HashTableFind(table, name.String, name.Hash);
+    *out_value = index >= 0 ? ((void**)table->Memory)[index] : 0;
+    return *out_value != 0;
+}
+
+b8 HashTableRemove(HashTable* table, const char* name)
+{
+    if (!name) {
+        ELSA_ERROR("HashTableRemove requires table and name to exist.");
+        return false;
+    }
+
+    return HashTableRemoveHashed(table, HashedStringCreate(name));
+}
+
+b8 HashTableRemoveHashed(HashTable* table, HashedString name)
+{
+    if (!table || !name.String) {
+        ELSA_ERROR("HashTableRemove requires table and name to exist.");
+        return false;
+    }
+
+    i64 index = HashTableFind(table, name.String, name.Hash);
+    if (index < 0)
+        return false;
+
+    HashTableRemoveAt(table, (u64)index);
+    return true;
 }
 
 b8 HashTableFill(HashTable* table, void* value)
@@ -120,9 +394,36 @@ b8 HashTableFill(HashTable* table, void* value)
         return false;
     }
 
-    for (u32 i = 0; i < table->ElementCount; ++i) {
-        PlatformCopyMemory(table->Memory + (table->ElementSize * i), value, table->ElementSize);
+    if (!table->FillValue)
+        table->FillValue = MemoryTrackerAlloc(table->ElementSize, MEMORY_TAG_HASHTABLE);
+    PlatformCopyMemory(table->FillValue, value, table->ElementSize);
+
+    for (u32 i = 0; i < table->Capacity; ++i) {
+        if (table->Control[i] != HASHTABLE_CONTROL_EMPTY)
+            PlatformCopyMemory(HashTableValueAt(table, i), value, table->ElementSize);
     }
 
     return true;
-}
\ No newline at end of file
+}
+
+b8 HashTableIterate(HashTable* table, u32* iterator, const char** out_name, void** out_value)
+{
+    if (!table || !iterator) {
+        ELSA_ERROR("HashTableIterate requires table and iterator to exist.");
+        return false;
+    }
+
+    while (*iterator < table->Capacity) {
+        u32 index = (*iterator)++;
+        if (table->Control[index] == HASHTABLE_CONTROL_EMPTY)
+            continue;
+
+        if (out_name)
+            *out_name = table->Keys[index];
+        if (out_value)
+            *out_value = table->IsPointerType ? ((void**)table->Memory)[index] : HashTableValueAt(table, index);
+        return true;
+    }
+
+    return false;
+}
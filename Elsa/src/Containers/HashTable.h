@@ -9,94 +9,195 @@
 #define ELSA_HASHTABLE_H
 
 #include <Defines.h>
+#include <Core/Hash.h>
+
+/** @brief The smallest number of slots a hashtable is created with. */
+#define HASHTABLE_MIN_CAPACITY 16
+
+/** @brief The hashtable grows once more than this percentage of its slots are used. */
+#define HASHTABLE_MAX_LOAD_PERCENT 75
+
+/** @brief The control byte of a slot that holds no entry. */
+#define HASHTABLE_CONTROL_EMPTY 0x80
+
+/** @brief The number of control bytes compared at once when probing. */
+#define HASHTABLE_GROUP_WIDTH 16
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ELSA_HASHTABLE_USE_SSE2 1
+#endif
 
 /**
- * @brief Represents a simple hashtable. Members of this structure
+ * @brief Represents an open-addressing hashtable. Members of this structure
  * should not be modified outside the functions associated with it.
- * 
- * For non-pointer types, table retains a copy of the value.For 
+ *
+ * Names are hashed with HashString. Callers that look up the same name
+ * repeatedly can hash it once with HashedStringCreate or HASHED_STRING, and use the
+ * *Hashed variants of the functions below.
+ *
+ * Every slot has a control byte, which is either HASHTABLE_CONTROL_EMPTY or the
+ * top 7 bits of the hash of the entry in that slot, so that most mismatching slots
+ * are skipped without touching their keys. When SSE2 is available, lookups compare
+ * HASHTABLE_GROUP_WIDTH control bytes at once. Collisions are resolved with linear
+ * probing, and removing an entry shifts the rest of its probe sequence back, so
+ * the table never accumulates tombstones. The table grows automatically once it
+ * is more than HASHTABLE_MAX_LOAD_PERCENT full.
+ *
+ * For non-pointer types, table retains a copy of the value.For
  * pointer types, make sure to use the _ptr setter and getter. Table
  * does not take ownership of pointers or associated memory allocations,
- * and should be managed externally.
+ * and should be managed externally. Keys are always copied.
  */
 typedef struct HashTable {
+    /** @brief The size in bytes of a value. */
     u64 ElementSize;
-    u32 ElementCount;
+    /** @brief The number of slots, always a power of two. */
+    u32 Capacity;
+    /** @brief The number of entries currently stored. */
+    u32 Count;
+    /** @brief Whether or not the table holds pointers. */
     b8 IsPointerType;
+    /** @brief One control byte per slot, followed by a copy of the first HASHTABLE_GROUP_WIDTH - 1
+     * bytes, so that a group can be loaded from any slot without wrapping. */
+    u8* Control;
+    /** @brief The full hash of the key in each slot. */
+    u64* Hashes;
+    /** @brief A copy of the key in each slot. */
+    char** Keys;
+    /** @brief The value in each slot. */
     void* Memory;
+    /** @brief The value copied out by HashTableGet for missing entries, set by HashTableFill. */
+    void* FillValue;
 } HashTable;
 
 /**
  * @brief Creates a hashtable and stores it in out_hashtable.
- * 
- * @param element_size The size of each element in bytes.
- * @param element_count The maximum number of elements. Cannot be resized.
- * @param memory A pointer to hold a block of memory to be used. Internally allocated. Will be equal in size to element_size * element_count.
+ *
+ * @param element_size The size of each element in bytes. Ignored for pointer types.
+ * @param element_count The number of elements to make room for up front. The table grows as required.
  * @param is_pointer_type Indicates if this hashtable will hold pointer types.
  * @param out_hashtable A pointer to a hashtable in which to hold relevant data.
+ * @returns True on success; otherwise false.
  */
-ELSA_API void HashTableCreate(u64 element_size, u32 element_count, b8 is_pointer_type, void* memory, HashTable* out_hashtable);
+ELSA_API b8 HashTableCreate(u64 element_size, u32 element_count, b8 is_pointer_type, HashTable* out_hashtable);
 
 /**
- * @brief Destroys the provided hashtable. Does not release memory for pointer types.
- * 
+ * @brief Destroys the provided hashtable, releasing its memory and keys.
+ * Does not release memory for pointer types.
+ *
  * @param table A pointer to the table to be destroyed.
  */
 ELSA_API void HashTableDestroy(HashTable* table);
 
 /**
- * @brief Stores a copy of the data in value in the provided hashtable. 
+ * @brief Stores a copy of the data in value in the provided hashtable, adding
+ * the entry if it doesn't exist yet.
  * Only use for tables which were *NOT* created with is_pointer_type = true.
- * 
+ *
  * @param table A pointer to the table to get from. Required.
  * @param name The name of the entry to set. Required.
  * @param value The value to be set. Required.
- * @returns True, or false if a null pointer is passed.
+ * @returns True, or false if a null pointer is passed or the table failed to grow.
  */
 ELSA_API b8 HashTableSet(HashTable* table, const char* name, void** value);
 
+/**
+ * @brief Same as HashTableSet, but takes a name whose hash was computed up front.
+ * @see HashTableSet
+ */
+ELSA_API b8 HashTableSetHashed(HashTable* table, HashedString name, void** value);
+
 /**
  * @brief Stores a pointer as provided in value in the hashtable.
  * Only use for tables which were created with is_pointer_type = true.
- * 
+ *
  * @param table A pointer to the table to get from. Required.
  * @param name The name of the entry to set. Required.
- * @param value A pointer value to be set. Can pass 0 to 'unset' an entry.
- * @returns True; or false if a null pointer is passed or if the entry is 0.
+ * @param value A pointer value to be set. Can pass 0 to remove an entry.
+ * @returns True; or false if a null pointer is passed or the table failed to grow.
  */
 ELSA_API b8 HashTableSetPointer(HashTable* table, const char* name, void** value);
 
 /**
- * @brief Obtains a copy of data present in the hashtable.
+ * @brief Same as HashTableSetPointer, but takes a name whose hash was computed up front.
+ * @see HashTableSetPointer
+ */
+ELSA_API b8 HashTableSetPointerHashed(HashTable* table, HashedString name, void** value);
+
+/**
+ * @brief Obtains a copy of data present in the hashtable. If the entry doesn't
+ * exist and the table was filled with HashTableFill, the fill value is copied instead.
  * Only use for tables which were *NOT* created with is_pointer_type = true.
- * 
+ *
  * @param table A pointer to the table to retrieved from. Required.
  * @param name The name of the entry to retrieved. Required.
  * @param value A pointer to store the retrieved value. Required.
- * @returns True; or false if a null pointer is passed.
+ * @returns True if the entry exists; false if it doesn't or a null pointer is passed.
  */
 ELSA_API b8 HashTableGet(HashTable* table, const char* name, void* out_value);
 
+/**
+ * @brief Same as HashTableGet, but takes a name whose hash was computed up front.
+ * @see HashTableGet
+ */
+ELSA_API b8 HashTableGetHashed(HashTable* table, HashedString name, void* out_value);
+
 /**
  * @brief Obtains a pointer to data present in the hashtable.
  * Only use for tables which were created with is_pointer_type = true.
- * 
+ *
  * @param table A pointer to the table to retrieved from. Required.
  * @param name The name of the entry to retrieved. Required.
- * @param value A pointer to store the retrieved value. Required.
+ * @param value A pointer to store the retrieved value. Set to 0 if the entry doesn't exist.
  * @return True if retrieved successfully; false if a null pointer is passed or is the retrieved value is 0.
  */
 ELSA_API b8 HashTableGetPointer(HashTable* table, const char* name, void** out_value);
 
+/**
+ * @brief Same as HashTableGetPointer, but takes a name whose hash was computed up front.
+ * @see HashTableGetPointer
+ */
+ELSA_API b8 HashTableGetPointerHashed(HashTable* table, HashedString name, void** out_value);
+
+/**
+ * @brief Removes an entry from the hashtable.
+ *
+ * @param table A pointer to the table to remove from. Required.
+ * @param name The name of the entry to remove. Required.
+ * @return True if the entry existed; otherwise false.
+ */
+ELSA_API b8 HashTableRemove(HashTable* table, const char* name);
+
+/**
+ * @brief Same as HashTableRemove, but takes a name whose hash was computed up front.
+ * @see HashTableRemove
+ */
+ELSA_API b8 HashTableRemoveHashed(HashTable* table, HashedString name);
+
 /**
  * @brief Fills all entries in the hashtable with the given value.
- * Useful when non-existent names should return some default value.
+ * The value is also returned by HashTableGet for names that don't exist, which
+ * is useful when non-existent names should return some default value.
  * Should not be used with pointer table types.
- * 
+ *
  * @param table A pointer to the table filled. Required.
  * @param value The value to be filled with. Required.
  * @return True if successful; otherwise false.
  */
 ELSA_API b8 HashTableFill(HashTable* table, void* value);
 
-#endif
\ No newline at end of file
+/**
+ * @brief Steps through the entries of the hashtable, in no particular order.
+ * Start with *iterator set to 0, and call until it returns false. Adding or
+ * removing entries invalidates the iteration.
+ *
+ * @param table A pointer to the table to iterate. Required.
+ * @param iterator A pointer to the position of the iteration. Required.
+ * @param out_name A pointer to hold the name of the entry. Optional.
+ * @param out_value A pointer to hold the address of the value of the entry, or the
+ * stored pointer itself for pointer types. Optional.
+ * @return True if an entry was returned; false once every entry has been visited.
+ */
+ELSA_API b8 HashTableIterate(HashTable* table, u32* iterator, const char** out_name, void** out_value);
+
+#endif
@@ -0,0 +1,172 @@
+#include "MpmcQueue.h"
+
+#include <Core/Atomic.h>
+#include <Core/Logger.h>
+#include <Core/MemTracker.h>
+#include <Platform/Platform.h>
+
+u64* MpmcQueueSequence(MpmcQueue* queue, u64 position)
+{
+    return (u64*)(queue->Cells + (position & (queue->Capacity - 1)) * queue->CellSize);
+}
+
+void* MpmcQueueElement(MpmcQueue* queue, u64 position)
+{
+    return queue->Cells + (position & (queue->Capacity - 1)) * queue->CellSize + sizeof(u64);
+}
+
+b8 MpmcQueueCreate(u64 element_size, u64 capacity, MpmcQueue* out_queue)
+{
+    if (!out_queue || element_size == 0 || capacity == 0) {
+        ELSA_ERROR("MpmcQueueCreate - element_size and capacity must be nonzero, and out_queue is required.");
+        return false;
+    }
+
+    // A single cell can't tell a full queue from an empty one.
+    u64 rounded_capacity = 2;
+    while (rounded_capacity < capacity)
+        rounded_capacity <<= 1;
+
+    PlatformZeroMemory(out_queue, sizeof(MpmcQueue));
+    out_queue->ElementSize = element_size;
+    out_queue->CellSize = (sizeof(u64) + element_size + 7) & ~7ull;
+    out_queue->Capacity = rounded_capacity;
+    out_queue->Cells = MemoryTrackerAlloc(out_queue->CellSize * rounded_capacity, MEMORY_TAG_QUEUE);
+    if (!out_queue->Cells) {
+        ELSA_ERROR("MpmcQueueCreate - Failed to allocate %llu elements!", rounded_capacity);
+        PlatformZeroMemory(out_queue, sizeof(MpmcQueue));
+        return false;
+    }
+
+    for (u64 i = 0; i < rounded_capacity; i++)
+        *MpmcQueueSequence(out_queue, i) = i;
+    return true;
+}
+
+void MpmcQueueDestroy(MpmcQueue* queue)
+{
+    if (queue && queue->Cells) {
+        MemoryTrackerFree(queue->Cells, queue->CellSize * queue->Capacity, MEMORY_TAG_QUEUE);
+        PlatformZeroMemory(queue, sizeof(MpmcQueue));
+    }
+}
+
+b8 MpmcQueuePush(MpmcQueue* queue, const void* value)
+{
+    u64 position = AtomicLoad(&queue->EnqueuePos, ATOMIC_RELAXED);
+    for (;;) {
+        u64 sequence = AtomicLoad(MpmcQueueSequence(queue, position), ATOMIC_ACQUIRE);
+        i64 difference = (i64)(sequence - position);
+        if (difference == 0) {
+            if (AtomicCompareExchangeWeak(&queue->EnqueuePos, &position, position + 1, ATOMIC_RELAXED, ATOMIC_RELAXED))
+                break;
+        } else if (difference < 0) {
+            // The cell still holds an element from the previous lap.
+            return false;
+        } else {
+            position = AtomicLoad(&queue->EnqueuePos, ATOMIC_RELAXED);
+        }
+    }
+
+    PlatformCopyMemory(MpmcQueueElement(queue, position), value, queue->ElementSize);
+    AtomicStore(MpmcQueueSequence(queue, position), position + 1, ATOMIC_RELEASE);
+    return true;
+}
+
+u64 MpmcQueuePushMany(MpmcQueue* queue, const void* values, u64 count)
+{
+    if (count == 0)
+        return 0;
+
+    u64 position = AtomicLoad(&queue->EnqueuePos, ATOMIC_RELAXED);
+    u64 claimed;
+    for (;;) {
+        // Count the free cells from position on. A free cell stays free until someone
+        // claims its position, which can only happen after EnqueuePos moves past it.
+        claimed = 0;
+        while (claimed < count &&
+               AtomicLoad(MpmcQueueSequence(queue, position + claimed), ATOMIC_ACQUIRE) == position + claimed)
+            claimed++;
+
+        if (claimed == 0) {
+            u64 sequence = AtomicLoad(MpmcQueueSequence(queue, position), ATOMIC_ACQUIRE);
+            if ((i64)(sequence - position) < 0)
+                return 0;
+            position = AtomicLoad(&queue->EnqueuePos, ATOMIC_RELAXED);
+            continue;
+        }
+
+        if (AtomicCompareExchangeWeak(&queue->EnqueuePos, &position, position + claimed, ATOMIC_RELAXED, ATOMIC_RELAXED))
+            break;
+    }
+
+    const u8* source = values;
+    for (u64 i = 0; i < claimed; i++) {
+        PlatformCopyMemory(MpmcQueueElement(queue, position + i), source + i * queue->ElementSize, queue->ElementSize);
+        AtomicStore(MpmcQueueSequence(queue, position + i), position + i + 1, ATOMIC_RELEASE);
+    }
+    return claimed;
+}
+
+b8 MpmcQueuePop(MpmcQueue* queue, void* out_value)
+{
+    u64 position = AtomicLoad(&queue->DequeuePos, ATOMIC_RELAXED);
+    for (;;) {
+        u64 sequence = AtomicLoad(MpmcQueueSequence(queue, position), ATOMIC_ACQUIRE);
+        i64 difference = (i64)(sequence - (position + 1));
+        if (difference == 0) {
+            if (AtomicCompareExchangeWeak(&queue->DequeuePos, &position, position + 1, ATOMIC_RELAXED, ATOMIC_RELAXED))
+                break;
+        } else if (difference < 0) {
+            // The cell hasn't been written for this lap yet.
+            return false;
+        } else {
+            position = AtomicLoad(&queue->DequeuePos, ATOMIC_RELAXED);
+        }
+    }
+
+    PlatformCopyMemory(out_value, MpmcQueueElement(queue, position), queue->ElementSize);
+    AtomicStore(MpmcQueueSequence(queue, position), position + queue->Capacity, ATOMIC_RELEASE);
+    return true;
+}
+
+u64 MpmcQueuePopMany(MpmcQueue* queue, void* out_values, u64 max_count)
+{
+    if (max_count == 0)
+        return 0;
+
+    u64 position = AtomicLoad(&queue->DequeuePos, ATOMIC_RELAXED);
+    u64 claimed;
+    for (;;) {
+        // A published cell stays published until someone claims its position.
+        claimed = 0;
+        while (claimed < max_count &&
+               AtomicLoad(MpmcQueueSequence(queue, position + claimed), ATOMIC_ACQUIRE) == position + claimed + 1)
+            claimed++;
+
+        if (claimed == 0) {
+            u64 sequence = AtomicLoad(MpmcQueueSequence(queue, position), ATOMIC_ACQUIRE);
+            if ((i64)(sequence - (position + 1)) < 0)
+                return 0;
+            position = AtomicLoad(&queue->DequeuePos, ATOMIC_RELAXED);
+            continue;
+        }
+
+        if (AtomicCompareExchangeWeak(&queue->DequeuePos, &position, position + claimed, ATOMIC_RELAXED, ATOMIC_RELAXED))
+            break;
+    }
+
+    u8* destination = out_values;
+    for (u64 i = 0; i < claimed; i++) {
+        PlatformCopyMemory(destination + i * queue->ElementSize, MpmcQueueElement(queue, position + i), queue->ElementSize);
+        AtomicStore(MpmcQueueSequence(queue, position + i), position + i + queue->Capacity, ATOMIC_RELEASE);
+    }
+    return claimed;
+}
+
+u64 MpmcQueueCount(MpmcQueue* queue)
+{
+    u64 dequeue_position = AtomicLoad(&queue->DequeuePos, ATOMIC_RELAXED);
+    u64 enqueue_position = AtomicLoad(&queue->EnqueuePos, ATOMIC_RELAXED);
+    return enqueue_position > dequeue_position ? enqueue_position - dequeue_position : 0;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file MpmcQueue.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains a bounded lock-free queue that any number of
+ * threads can push to and pop from concurrently.
+ * @version 1.0
+ * @date 2022-07-23
+ */
+#ifndef ELSA_MPMC_QUEUE_H
+#define ELSA_MPMC_QUEUE_H
+
+#include <Defines.h>
+
+/**
+ * @brief Represents a bounded multi-producer/multi-consumer ring buffer, following
+ * Dmitry Vyukov's design. Members of this structure should not be modified outside
+ * the functions associated with it.
+ *
+ * Every cell holds a sequence number in front of its element. A producer claims
+ * position pos by moving EnqueuePos forward once the sequence of its cell equals pos,
+ * writes the element, then publishes it by setting the sequence to pos + 1.
+ * A consumer claims the same position once the sequence is pos + 1, and frees the
+ * cell for the next lap by setting it to pos + Capacity. Threads only contend on
+ * EnqueuePos or DequeuePos, which are padded onto separate cache lines.
+ */
+typedef struct MpmcQueue {
+    u8 Padding0[ELSA_CACHE_LINE_SIZE];
+    /** @brief The next position to push to. */
+    u64 EnqueuePos;
+    u8 Padding1[ELSA_CACHE_LINE_SIZE - sizeof(u64)];
+    /** @brief The next position to pop from. */
+    u64 DequeuePos;
+    u8 Padding2[ELSA_CACHE_LINE_SIZE - sizeof(u64)];
+    /** @brief The size in bytes of an element. */
+    u64 ElementSize;
+    /** @brief The size in bytes of a cell: its sequence number and element, rounded up to 8 bytes. */
+    u64 CellSize;
+    /** @brief The number of elements the queue holds, always a power of two. */
+    u64 Capacity;
+    /** @brief The cell buffer. */
+    u8* Cells;
+    u8 Padding3[ELSA_CACHE_LINE_SIZE - 3 * sizeof(u64) - sizeof(u8*)];
+} MpmcQueue;
+
+/**
+ * @brief Creates a queue and stores it in out_queue.
+ *
+ * @param element_size The size of each element in bytes.
+ * @param capacity The number of elements the queue can hold. Rounded up to a power of two, at least 2.
+ * @param out_queue A pointer to a queue in which to hold relevant data.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 MpmcQueueCreate(u64 element_size, u64 capacity, MpmcQueue* out_queue);
+
+/**
+ * @brief Destroys the provided queue, releasing its memory. No thread may be using it.
+ *
+ * @param queue A pointer to the queue to be destroyed.
+ */
+ELSA_API void MpmcQueueDestroy(MpmcQueue* queue);
+
+/**
+ * @brief Pushes a copy of value to the queue. Safe to call from any thread.
+ *
+ * @param queue A pointer to the queue. Required.
+ * @param value A pointer to the value to push. Required.
+ * @returns True if the value was pushed; false if the queue is full.
+ */
+ELSA_API b8 MpmcQueuePush(MpmcQueue* queue, const void* value);
+
+/**
+ * @brief Pushes copies of as many of the given values as there are consecutive free
+ * cells for, claiming them all with a single atomic operation. Safe to call from any thread.
+ *
+ * @param queue A pointer to the queue. Required.
+ * @param values A pointer to the values to push. Required.
+ * @param count The number of values to push.
+ * @returns The number of values pushed, from the start of values.
+ */
+ELSA_API u64 MpmcQueuePushMany(MpmcQueue* queue, const void* values, u64 count);
+
+/**
+ * @brief Pops the oldest element of the queue. Safe to call from any thread.
+ *
+ * @param queue A pointer to the queue. Required.
+ * @param out_value A pointer to hold the popped value. Required.
+ * @returns True if a value was popped; false if the queue is empty.
+ */
+ELSA_API b8 MpmcQueuePop(MpmcQueue* queue, void* out_value);
+
+/**
+ * @brief Pops up to max_count consecutive elements that are ready, claiming them
+ * all with a single atomic operation. Safe to call from any thread.
+ *
+ * @param queue A pointer to the queue. Required.
+ * @param out_values A pointer to hold the popped values. Required.
+ * @param max_count The maximum number of values to pop.
+ * @returns The number of values popped.
+ */
+ELSA_API u64 MpmcQueuePopMany(MpmcQueue* queue, void* out_values, u64 max_count);
+
+/**
+ * @brief Returns an estimate of the number of elements in the queue, which may be
+ * stale by the time it returns when other threads are pushing or popping.
+ *
+ * @param queue A pointer to the queue. Required.
+ * @returns The approximate number of elements in the queue.
+ */
+ELSA_API u64 MpmcQueueCount(MpmcQueue* queue);
+
+#endif
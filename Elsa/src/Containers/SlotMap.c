@@ -0,0 +1,118 @@
+#include "SlotMap.h"
+
+#include <Containers/Darray.h>
+#include <Core/Logger.h>
+#include <Platform/Platform.h>
+
+SlotHandle SlotMapMakeHandle(u32 index, u32 generation)
+{
+    return ((u64)generation << 32) | index;
+}
+
+// Returns the slot the handle refers to, or 0 if the handle is invalid or stale.
+SlotMapSlot* SlotMapResolve(SlotMap* map, SlotHandle handle)
+{
+    u32 index = (u32)handle;
+    u32 generation = (u32)(handle >> 32);
+    if (!(generation & 1) || index >= Darray_Length(map->Slots))
+        return 0;
+
+    SlotMapSlot* slot = &map->Slots[index];
+    return slot->Generation == generation ? slot : 0;
+}
+
+b8 SlotMapCreate(u64 element_size, u32 capacity, SlotMap* out_map)
+{
+    if (!out_map || element_size == 0) {
+        ELSA_ERROR("SlotMapCreate - element_size must be nonzero, and out_map is required.");
+        return false;
+    }
+    if (capacity == 0)
+        capacity = SLOT_MAP_DEFAULT_CAPACITY;
+
+    out_map->ElementSize = element_size;
+    out_map->Data = _Darray_Create(capacity, element_size);
+    out_map->DenseSlots = Darray_Reserve(u32, capacity);
+    out_map->Slots = Darray_Reserve(SlotMapSlot, capacity);
+    out_map->FreeSlot = SLOT_MAP_NO_FREE_SLOT;
+    return true;
+}
+
+void SlotMapDestroy(SlotMap* map)
+{
+    if (map && map->Data) {
+        Darray_Destroy(map->Data);
+        Darray_Destroy(map->DenseSlots);
+        Darray_Destroy(map->Slots);
+        PlatformZeroMemory(map, sizeof(SlotMap));
+    }
+}
+
+SlotHandle SlotMapInsert(SlotMap* map, const void* value)
+{
+    u32 index = map->FreeSlot;
+    if (index != SLOT_MAP_NO_FREE_SLOT) {
+        map->FreeSlot = map->Slots[index].DenseIndex;
+    } else {
+        u64 slot_count = Darray_Length(map->Slots);
+        if (slot_count >= SLOT_MAP_NO_FREE_SLOT) {
+            ELSA_ERROR("SlotMapInsert - The slot map is full!");
+            return SLOT_HANDLE_INVALID;
+        }
+        index = (u32)slot_count;
+        SlotMapSlot slot = { 0, 0 };
+        Darray_Push(map->Slots, slot);
+    }
+
+    u32 dense_index = (u32)Darray_Length(map->Data);
+    if (value)
+        map->Data = _Darray_Push(map->Data, value);
+    else
+        map->Data = _Darray_Set_Length(map->Data, dense_index + 1);
+    Darray_Push(map->DenseSlots, index);
+
+    SlotMapSlot* slot = &map->Slots[index];
+    slot->DenseIndex = dense_index;
+    slot->Generation++;
+    return SlotMapMakeHandle(index, slot->Generation);
+}
+
+b8 SlotMapRemove(SlotMap* map, SlotHandle handle)
+{
+    SlotMapSlot* slot = SlotMapResolve(map, handle);
+    if (!slot)
+        return false;
+
+    // Move the last element into the hole, and point its slot at the new position.
+    u32 dense_index = slot->DenseIndex;
+    u32 last_index = (u32)Darray_Length(map->Data) - 1;
+    map->Data = _Darray_Pop_Swap(map->Data, dense_index, 0);
+    map->DenseSlots = _Darray_Pop_Swap(map->DenseSlots, dense_index, 0);
+    if (dense_index != last_index)
+        map->Slots[map->DenseSlots[dense_index]].DenseIndex = dense_index;
+
+    slot->Generation++;
+    slot->DenseIndex = map->FreeSlot;
+    map->FreeSlot = (u32)handle;
+    return true;
+}
+
+void* SlotMapGet(SlotMap* map, SlotHandle handle)
+{
+    SlotMapSlot* slot = SlotMapResolve(map, handle);
+    if (!slot)
+        return 0;
+
+    return (u8*)map->Data + (u64)slot->DenseIndex * map->ElementSize;
+}
+
+u32 SlotMapCount(SlotMap* map)
+{
+    return (u32)Darray_Length(map->Data);
+}
+
+SlotHandle SlotMapHandleAt(SlotMap* map, u32 dense_index)
+{
+    u32 index = map->DenseSlots[dense_index];
+    return SlotMapMakeHandle(index, map->Slots[index].Generation);
+}
@@ -0,0 +1,142 @@
+/**
+ * @file SlotMap.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains a slot map: a container that hands out generational
+ * handles to its elements while keeping them packed for iteration.
+ * @version 1.0
+ * @date 2022-07-23
+ */
+#ifndef ELSA_SLOT_MAP_H
+#define ELSA_SLOT_MAP_H
+
+#include <Defines.h>
+
+/**
+ * @brief Refers to an element of a slot map. The low 32 bits are the slot index,
+ * the high 32 bits the generation of the slot when the element was inserted.
+ */
+typedef u64 SlotHandle;
+
+/** @brief The handle that never refers to an element. */
+#define SLOT_HANDLE_INVALID 0
+
+/** @brief The number of elements a slot map makes room for when created with a capacity of 0. */
+#define SLOT_MAP_DEFAULT_CAPACITY 16
+
+/** @brief Marks the end of the free slot list. */
+#define SLOT_MAP_NO_FREE_SLOT 0xFFFFFFFF
+
+/** @brief An entry of the sparse slot array. */
+typedef struct SlotMapSlot {
+    /** @brief The index of the element in the dense array, or the next free slot if the slot is free. */
+    u32 DenseIndex;
+    /** @brief Incremented on every insert and remove, so it is odd while the slot is in use. */
+    u32 Generation;
+} SlotMapSlot;
+
+/**
+ * @brief Represents a slot map. Members of this structure should not be modified
+ * outside the functions associated with it.
+ *
+ * Elements are stored contiguously in Data, so iterating over them touches no
+ * holes. Handles go through the sparse Slots array, whose generation counter
+ * turns any handle to a removed element into a detectable miss instead of a
+ * use-after-free. Removing an element moves the last one into its place, so
+ * insert, remove and lookup are all O(1), but element addresses and order are
+ * only stable until the next insert or remove.
+ */
+typedef struct SlotMap {
+    /** @brief The size in bytes of an element. */
+    u64 ElementSize;
+    /** @brief The darray of elements, packed. */
+    void* Data;
+    /** @brief The darray holding the slot index of each element in Data. */
+    u32* DenseSlots;
+    /** @brief The darray of slots that handles refer to. */
+    SlotMapSlot* Slots;
+    /** @brief The first free slot, or SLOT_MAP_NO_FREE_SLOT. */
+    u32 FreeSlot;
+} SlotMap;
+
+/**
+ * @brief Creates a slot map and stores it in out_map.
+ *
+ * @param element_size The size of each element in bytes.
+ * @param capacity The number of elements to make room for up front. The map grows as required.
+ * @param out_map A pointer to a slot map in which to hold relevant data.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 SlotMapCreate(u64 element_size, u32 capacity, SlotMap* out_map);
+
+/**
+ * @brief Destroys the provided slot map, releasing its memory. Every handle becomes invalid.
+ *
+ * @param map A pointer to the slot map to be destroyed.
+ */
+ELSA_API void SlotMapDestroy(SlotMap* map);
+
+/**
+ * @brief Inserts a copy of value into the slot map.
+ *
+ * @param map A pointer to the slot map. Required.
+ * @param value A pointer to the value to insert. Optional; the element is zeroed if 0.
+ * @returns The handle of the new element, or SLOT_HANDLE_INVALID if the map is full.
+ */
+ELSA_API SlotHandle SlotMapInsert(SlotMap* map, const void* value);
+
+/**
+ * @brief Removes the element referred to by handle.
+ *
+ * @param map A pointer to the slot map. Required.
+ * @param handle The handle of the element to remove.
+ * @returns True if the element existed; false if the handle is invalid or stale.
+ */
+ELSA_API b8 SlotMapRemove(SlotMap* map, SlotHandle handle);
+
+/**
+ * @brief Looks up the element referred to by handle. The pointer is only valid
+ * until the next insert or remove.
+ *
+ * @param map A pointer to the slot map. Required.
+ * @param handle The handle of the element.
+ * @returns A pointer to the element, or 0 if the handle is invalid or stale.
+ */
+ELSA_API void* SlotMapGet(SlotMap* map, SlotHandle handle);
+
+/**
+ * @brief Returns the number of elements in the slot map. Elements 0 to count - 1
+ * of map->Data are the live elements.
+ *
+ * @param map A pointer to the slot map. Required.
+ * @returns The number of elements.
+ */
+ELSA_API u32 SlotMapCount(SlotMap* map);
+
+/**
+ * @brief Returns the handle of the element at the given position of map->Data.
+ *
+ * @param map A pointer to the slot map. Required.
+ * @param dense_index The position of the element, less than SlotMapCount.
+ * @returns The handle of the element.
+ */
+ELSA_API SlotHandle SlotMapHandleAt(SlotMap* map, u32 dense_index);
+
+/**
+ * @brief Creates a slot map for the given type.
+ * @param type The type of the elements.
+ * @param capacity The number of elements to make room for up front.
+ * @param out_map A pointer to a slot map in which to hold relevant data.
+ */
+#define SlotMap_Create(type, capacity, out_map) \
+SlotMapCreate(sizeof(type), capacity, out_map)
+
+/**
+ * @brief Looks up the element referred to by handle as the given type.
+ * @param map A pointer to the slot map.
+ * @param type The type of the elements.
+ * @param handle The handle of the element.
+ */
+#define SlotMap_Get(map, type, handle) \
+((type*)SlotMapGet(map, handle))
+
+#endif
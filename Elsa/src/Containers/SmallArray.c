@@ -0,0 +1,33 @@
+#include "SmallArray.h"
+
+#include <Containers/Darray.h>
+#include <Platform/Platform.h>
+#include <Core/Logger.h>
+#include <Core/MemTracker.h>
+
+b8 _SmallArray_Grow(void** data, const void* inline_data, u64* capacity, u64 length, u64 stride)
+{
+    u64 new_capacity = *capacity * DARRAY_RESIZE_FACTOR;
+    if (new_capacity < DARRAY_MIN_GROW_CAPACITY)
+        new_capacity = DARRAY_MIN_GROW_CAPACITY;
+	
+    void* new_data = MemoryTrackerAlloc(new_capacity * stride, MEMORY_TAG_DARRAY);
+    if (!new_data) {
+        ELSA_ERROR("_SmallArray_Grow - Failed to allocate %llu elements!", new_capacity);
+        return false;
+    }
+    PlatformCopyMemory(new_data, *data, length * stride);
+	
+    if (*data != inline_data)
+        MemoryTrackerFree(*data, *capacity * stride, MEMORY_TAG_DARRAY);
+	
+    *data = new_data;
+    *capacity = new_capacity;
+    return true;
+}
+
+void _SmallArray_Destroy(void* data, const void* inline_data, u64 capacity, u64 stride)
+{
+    if (data && data != inline_data)
+        MemoryTrackerFree(data, capacity * stride, MEMORY_TAG_DARRAY);
+}
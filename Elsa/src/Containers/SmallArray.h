@@ -0,0 +1,96 @@
+/**
+ * @file SmallArray.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains a dynamic array that keeps its first few elements
+ * inline, and only allocates once it outgrows them.
+ * @version 1.0
+ * @date 2022-07-22
+ */
+#ifndef ELSA_SMALL_ARRAY_H
+#define ELSA_SMALL_ARRAY_H
+
+#include <Defines.h>
+
+/**
+ * @brief Declares a small array of type holding up to inline_capacity elements
+ * without allocating. Once full, the elements spill into tracked heap memory.
+ *
+ * Data points either at Inline or at the spilled memory, so a small array must
+ * not be copied or moved after SmallArray_Init, and must be passed by pointer.
+ * @param type The type of the elements.
+ * @param inline_capacity The number of elements stored inline.
+ */
+#define SmallArray(type, inline_capacity) \
+struct {                                  \
+u64 Length;                               \
+u64 Capacity;                             \
+type* Data;                               \
+type Inline[inline_capacity];             \
+}
+
+/**
+ * @brief Grows the storage of a small array, moving it off the inline buffer if required.
+ * @note Avoid using this directly; call the SmallArray_Push macro instead.
+ * @param data A pointer to the data pointer of the array.
+ * @param inline_data A pointer to the inline buffer of the array.
+ * @param capacity A pointer to the capacity of the array.
+ * @param length The number of elements in the array.
+ * @param stride The size of each element in bytes.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 _SmallArray_Grow(void** data, const void* inline_data, u64* capacity, u64 length, u64 stride);
+
+/**
+ * @brief Frees the spilled storage of a small array, if any.
+ * @note Avoid using this directly; call the SmallArray_Destroy macro instead.
+ * @param data The data pointer of the array.
+ * @param inline_data A pointer to the inline buffer of the array.
+ * @param capacity The capacity of the array.
+ * @param stride The size of each element in bytes.
+ */
+ELSA_API void _SmallArray_Destroy(void* data, const void* inline_data, u64 capacity, u64 stride);
+
+/**
+ * @brief Initializes an empty small array using its inline buffer.
+ * @param array The small array.
+ */
+#define SmallArray_Init(array)                                             \
+{                                                                          \
+(array).Length = 0;                                                        \
+(array).Capacity = sizeof((array).Inline) / sizeof((array).Inline[0]);     \
+(array).Data = (array).Inline;                                             \
+}
+
+/**
+ * @brief Pushes a copy of value to the end of the small array, spilling to the heap if required.
+ * @param array The small array.
+ * @param value The value to push.
+ */
+#define SmallArray_Push(array, value)                                                        \
+{                                                                                            \
+typeof((array).Inline[0]) temp = value;                                                      \
+if ((array).Length < (array).Capacity ||                                                     \
+    _SmallArray_Grow((void**)&(array).Data, (array).Inline, &(array).Capacity, (array).Length, sizeof(temp))) \
+(array).Data[(array).Length++] = temp;                                                       \
+}
+
+/**
+ * @brief Removes every element from the small array, keeping its storage.
+ * @param array The small array.
+ */
+#define SmallArray_Clear(array) \
+(array).Length = 0
+
+/**
+ * @brief Frees the spilled storage of the small array. The array must be initialized again before reuse.
+ * @param array The small array.
+ */
+#define SmallArray_Destroy(array)                                                            \
+{                                                                                            \
+_SmallArray_Destroy((array).Data, (array).Inline, (array).Capacity, sizeof((array).Inline[0])); \
+(array).Data = (array).Inline;                                                               \
+(array).Length = 0;                                                                          \
+(array).Capacity = sizeof((array).Inline) / sizeof((array).Inline[0]);                       \
+}
+
+#endif
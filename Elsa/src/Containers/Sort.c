@@ -0,0 +1,201 @@
+#include "Sort.h"
+
+#include <Platform/Platform.h>
+
+typedef struct RadixSortJob {
+    const void* Source;
+    void* Destination;
+    u32 Count;
+    u32 WorkerCount;
+    u32 Shift;
+    b8 Wide;
+    // Bucket counts of each worker's range, turned into scatter offsets in place.
+    u32 Histograms[SORT_MAX_WORKERS][SORT_RADIX_BUCKETS];
+} RadixSortJob;
+
+u64 RadixSortKey(const void* entries, u32 index, b8 wide)
+{
+    return wide ? ((const SortEntry64*)entries)[index].Key : ((const SortEntry32*)entries)[index].Key;
+}
+
+void RadixSortScatter(const void* source, void* destination, u32 begin, u32 end, u32 shift, b8 wide, u32* offsets)
+{
+    if (wide) {
+        const SortEntry64* from = source;
+        SortEntry64* to = destination;
+        for (u32 i = begin; i < end; i++)
+            to[offsets[(from[i].Key >> shift) & (SORT_RADIX_BUCKETS - 1)]++] = from[i];
+    } else {
+        const SortEntry32* from = source;
+        SortEntry32* to = destination;
+        for (u32 i = begin; i < end; i++)
+            to[offsets[(from[i].Key >> shift) & (SORT_RADIX_BUCKETS - 1)]++] = from[i];
+    }
+}
+
+// Turns bucket counts into the offset each bucket starts at.
+void RadixSortPrefixSum(u32* histogram)
+{
+    u32 sum = 0;
+    for (u32 i = 0; i < SORT_RADIX_BUCKETS; i++) {
+        u32 bucket_count = histogram[i];
+        histogram[i] = sum;
+        sum += bucket_count;
+    }
+}
+
+void RadixSort(void* entries, void* scratch, u32 count, b8 wide)
+{
+    if (count < 2)
+        return;
+
+    u32 key_bytes = wide ? sizeof(u64) : sizeof(u32);
+    u64 entry_size = wide ? sizeof(SortEntry64) : sizeof(SortEntry32);
+
+    // The histogram of every byte only depends on the keys, not their order,
+    // so they can all be built up front in a single read of the entries.
+    u32 histograms[sizeof(u64)][SORT_RADIX_BUCKETS];
+    PlatformZeroMemory(histograms, sizeof(histograms));
+    if (wide) {
+        const SortEntry64* keys = entries;
+        for (u32 i = 0; i < count; i++) {
+            u64 key = keys[i].Key;
+            for (u32 byte = 0; byte < sizeof(u64); byte++)
+                histograms[byte][(key >> (byte * SORT_RADIX_BITS)) & (SORT_RADIX_BUCKETS - 1)]++;
+        }
+    } else {
+        const SortEntry32* keys = entries;
+        for (u32 i = 0; i < count; i++) {
+            u32 key = keys[i].Key;
+            for (u32 byte = 0; byte < sizeof(u32); byte++)
+                histograms[byte][(key >> (byte * SORT_RADIX_BITS)) & (SORT_RADIX_BUCKETS - 1)]++;
+        }
+    }
+
+    void* source = entries;
+    void* destination = scratch;
+    for (u32 byte = 0; byte < key_bytes; byte++) {
+        u32 shift = byte * SORT_RADIX_BITS;
+        // Every key has the same value in this byte, so the pass wouldn't move anything.
+        if (histograms[byte][(RadixSortKey(source, 0, wide) >> shift) & (SORT_RADIX_BUCKETS - 1)] == count)
+            continue;
+
+        RadixSortPrefixSum(histograms[byte]);
+        RadixSortScatter(source, destination, 0, count, shift, wide, histograms[byte]);
+
+        void* swap = source;
+        source = destination;
+        destination = swap;
+    }
+
+    if (source != entries)
+        PlatformCopyMemory(entries, source, count * entry_size);
+}
+
+void RadixSortWorkerRange(RadixSortJob* job, u32 worker_index, u32* out_begin, u32* out_end)
+{
+    *out_begin = (u32)(((u64)job->Count * worker_index) / job->WorkerCount);
+    *out_end = (u32)(((u64)job->Count * (worker_index + 1)) / job->WorkerCount);
+}
+
+void RadixSortHistogramTask(void* data, u32 worker_index)
+{
+    RadixSortJob* job = data;
+    u32 begin, end;
+    RadixSortWorkerRange(job, worker_index, &begin, &end);
+
+    u32* histogram = job->Histograms[worker_index];
+    PlatformZeroMemory(histogram, sizeof(job->Histograms[0]));
+    for (u32 i = begin; i < end; i++)
+        histogram[(RadixSortKey(job->Source, i, job->Wide) >> job->Shift) & (SORT_RADIX_BUCKETS - 1)]++;
+}
+
+void RadixSortScatterTask(void* data, u32 worker_index)
+{
+    RadixSortJob* job = data;
+    u32 begin, end;
+    RadixSortWorkerRange(job, worker_index, &begin, &end);
+    RadixSortScatter(job->Source, job->Destination, begin, end, job->Shift, job->Wide, job->Histograms[worker_index]);
+}
+
+void RadixSortDispatchSerial(SortTask task, void* task_data, u32 worker_count, void* user_data)
+{
+    for (u32 i = 0; i < worker_count; i++)
+        task(task_data, i);
+}
+
+void RadixSortParallel(void* entries, void* scratch, u32 count, b8 wide, u32 worker_count, SortDispatch dispatch, void* user_data)
+{
+    if (count < 2)
+        return;
+
+    if (!dispatch)
+        dispatch = RadixSortDispatchSerial;
+    if (worker_count > SORT_MAX_WORKERS)
+        worker_count = SORT_MAX_WORKERS;
+    if (worker_count > count)
+        worker_count = count;
+    if (worker_count == 0)
+        worker_count = 1;
+
+    u32 key_bytes = wide ? sizeof(u64) : sizeof(u32);
+    u64 entry_size = wide ? sizeof(SortEntry64) : sizeof(SortEntry32);
+
+    RadixSortJob job;
+    job.Count = count;
+    job.WorkerCount = worker_count;
+    job.Wide = wide;
+    job.Source = entries;
+    job.Destination = scratch;
+
+    for (u32 byte = 0; byte < key_bytes; byte++) {
+        job.Shift = byte * SORT_RADIX_BITS;
+        dispatch(RadixSortHistogramTask, &job, worker_count, user_data);
+
+        // Lay the buckets out in order, and within every bucket give each worker the
+        // range after the previous worker's, which keeps the sort stable.
+        u32 sum = 0;
+        b8 trivial = false;
+        for (u32 bucket = 0; bucket < SORT_RADIX_BUCKETS; bucket++) {
+            u32 bucket_start = sum;
+            for (u32 worker = 0; worker < worker_count; worker++) {
+                u32 worker_count_in_bucket = job.Histograms[worker][bucket];
+                job.Histograms[worker][bucket] = sum;
+                sum += worker_count_in_bucket;
+            }
+            if (sum - bucket_start == count)
+                trivial = true;
+        }
+        if (trivial)
+            continue;
+
+        dispatch(RadixSortScatterTask, &job, worker_count, user_data);
+
+        const void* swap = job.Source;
+        job.Source = job.Destination;
+        job.Destination = (void*)swap;
+    }
+
+    if (job.Source != entries)
+        PlatformCopyMemory(entries, job.Source, count * entry_size);
+}
+
+void RadixSort32(SortEntry32* entries, SortEntry32* scratch, u32 count)
+{
+    RadixSort(entries, scratch, count, false);
+}
+
+void RadixSort64(SortEntry64* entries, SortEntry64* scratch, u32 count)
+{
+    RadixSort(entries, scratch, count, true);
+}
+
+void RadixSort32Parallel(SortEntry32* entries, SortEntry32* scratch, u32 count, u32 worker_count, SortDispatch dispatch, void* user_data)
+{
+    RadixSortParallel(entries, scratch, count, false, worker_count, dispatch, user_data);
+}
+
+void RadixSort64Parallel(SortEntry64* entries, SortEntry64* scratch, u32 count, u32 worker_count, SortDispatch dispatch, void* user_data)
+{
+    RadixSortParallel(entries, scratch, count, true, worker_count, dispatch, user_data);
+}
@@ -0,0 +1,151 @@
+/**
+ * @file Sort.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains radix sorts on integer keys carrying an index payload,
+ * and helpers to build sort keys for draw ordering.
+ * @version 1.0
+ * @date 2022-07-24
+ */
+#ifndef ELSA_SORT_H
+#define ELSA_SORT_H
+
+#include <Defines.h>
+
+/** @brief The number of bits sorted per pass. */
+#define SORT_RADIX_BITS 8
+
+/** @brief The number of buckets of a pass. */
+#define SORT_RADIX_BUCKETS (1 << SORT_RADIX_BITS)
+
+/** @brief The maximum number of workers a parallel sort is split across. */
+#define SORT_MAX_WORKERS 32
+
+/** @brief The number of bits of a sort key holding the pipeline. */
+#define SORT_KEY_PIPELINE_BITS 16
+/** @brief The number of bits of a sort key holding the material. */
+#define SORT_KEY_MATERIAL_BITS 24
+/** @brief The number of bits of a sort key holding the depth. */
+#define SORT_KEY_DEPTH_BITS 24
+
+/** @brief A 32-bit key, along with the index of the element it was made for. */
+typedef struct SortEntry32 {
+    u32 Key;
+    u32 Index;
+} SortEntry32;
+
+/** @brief A 64-bit key, along with the index of the element it was made for. */
+typedef struct SortEntry64 {
+    u64 Key;
+    u32 Index;
+    u32 Padding;
+} SortEntry64;
+
+/**
+ * @brief A piece of work run by a parallel sort once per worker.
+ * @param data The data of the sort.
+ * @param worker_index The index of the worker, from 0 to the worker count - 1.
+ */
+typedef void (*SortTask)(void* data, u32 worker_index);
+
+/**
+ * @brief Runs task once for every worker index, possibly on different threads,
+ * and returns once every call has finished. JobSystemSortDispatch runs them as jobs.
+ * @param task The task to run.
+ * @param task_data The data to pass to the task.
+ * @param worker_count The number of times to run the task.
+ * @param user_data The user data passed to the sort.
+ */
+typedef void (*SortDispatch)(SortTask task, void* task_data, u32 worker_count, void* user_data);
+
+/**
+ * @brief Sorts entries by key in ascending order. The sort is stable, so entries
+ * with equal keys keep their order. Passes over bytes that are equal in every key are skipped.
+ *
+ * @param entries The entries to sort. Required.
+ * @param scratch A buffer of at least count entries the sort can use. Required.
+ * @param count The number of entries.
+ */
+ELSA_API void RadixSort32(SortEntry32* entries, SortEntry32* scratch, u32 count);
+
+/**
+ * @brief Sorts entries by key in ascending order. The sort is stable, so entries
+ * with equal keys keep their order. Passes over bytes that are equal in every key are skipped.
+ *
+ * @param entries The entries to sort. Required.
+ * @param scratch A buffer of at least count entries the sort can use. Required.
+ * @param count The number of entries.
+ */
+ELSA_API void RadixSort64(SortEntry64* entries, SortEntry64* scratch, u32 count);
+
+/**
+ * @brief Same as RadixSort32, but splits every pass across worker_count workers.
+ * Each worker builds the histogram of its own range of the entries, then scatters
+ * that range to the offsets the histograms add up to.
+ *
+ * @param entries The entries to sort. Required.
+ * @param scratch A buffer of at least count entries the sort can use. Required.
+ * @param count The number of entries.
+ * @param worker_count The number of workers, clamped to SORT_MAX_WORKERS.
+ * @param dispatch The function used to run the workers. Optional; the workers run one after the other if 0.
+ * @param user_data Passed through to dispatch.
+ */
+ELSA_API void RadixSort32Parallel(SortEntry32* entries, SortEntry32* scratch, u32 count, u32 worker_count, SortDispatch dispatch, void* user_data);
+
+/**
+ * @brief Same as RadixSort64, but splits every pass across worker_count workers.
+ * @see RadixSort32Parallel
+ */
+ELSA_API void RadixSort64Parallel(SortEntry64* entries, SortEntry64* scratch, u32 count, u32 worker_count, SortDispatch dispatch, void* user_data);
+
+/**
+ * @brief Maps a float to an integer with the same ordering, negative values included.
+ * @param value The value to map.
+ * @returns The integer, which compares as value does.
+ */
+ELSA_INLINE u32 SortKeyFromFloat(f32 value)
+{
+    u32 bits;
+    __builtin_memcpy(&bits, &value, sizeof(bits));
+    // Positive floats only need their sign flipped; negative ones need every bit flipped.
+    u32 mask = (u32)((i32)bits >> 31) | 0x80000000u;
+    return bits ^ mask;
+}
+
+/**
+ * @brief Packs a draw into a 64-bit key, so that sorting the keys groups draws by
+ * pipeline, then by material, then orders them front to back.
+ * For back to front ordering, such as for transparent draws, pass -depth.
+ * @param pipeline The index of the pipeline. Only the low SORT_KEY_PIPELINE_BITS bits are used.
+ * @param material The index of the material. Only the low SORT_KEY_MATERIAL_BITS bits are used.
+ * @param depth The depth of the draw. Quantized to SORT_KEY_DEPTH_BITS bits.
+ * @returns The sort key.
+ */
+ELSA_INLINE u64 SortKeyPack(u32 pipeline, u32 material, f32 depth)
+{
+    u64 key = (u64)(pipeline & ((1u << SORT_KEY_PIPELINE_BITS) - 1)) << (SORT_KEY_MATERIAL_BITS + SORT_KEY_DEPTH_BITS);
+    key |= (u64)(material & ((1u << SORT_KEY_MATERIAL_BITS) - 1)) << SORT_KEY_DEPTH_BITS;
+    key |= SortKeyFromFloat(depth) >> (32 - SORT_KEY_DEPTH_BITS);
+    return key;
+}
+
+/**
+ * @brief Extracts the pipeline index from a key built with SortKeyPack.
+ * @param key The sort key.
+ * @returns The pipeline index.
+ */
+ELSA_INLINE u32 SortKeyGetPipeline(u64 key)
+{
+    return (u32)(key >> (SORT_KEY_MATERIAL_BITS + SORT_KEY_DEPTH_BITS));
+}
+
+/**
+ * @brief Extracts the material index from a key built with SortKeyPack.
+ * @param key The sort key.
+ * @returns The material index.
+ */
+ELSA_INLINE u32 SortKeyGetMaterial(u64 key)
+{
+    return (u32)(key >> SORT_KEY_DEPTH_BITS) & ((1u << SORT_KEY_MATERIAL_BITS) - 1);
+}
+
+#endif
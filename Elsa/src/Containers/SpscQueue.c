@@ -0,0 +1,115 @@
+#include "SpscQueue.h"
+
+#include <Core/Atomic.h>
+#include <Core/Logger.h>
+#include <Core/MemTracker.h>
+#include <Platform/Platform.h>
+
+// Copies count elements into the ring starting at index, wrapping around the end of the buffer.
+void SpscQueueCopyIn(SpscQueue* queue, u64 index, const u8* values, u64 count)
+{
+    u64 offset = index & (queue->Capacity - 1);
+    u64 first = queue->Capacity - offset;
+    if (first > count)
+        first = count;
+
+    PlatformCopyMemory(queue->Memory + offset * queue->ElementSize, values, first * queue->ElementSize);
+    if (count > first)
+        PlatformCopyMemory(queue->Memory, values + first * queue->ElementSize, (count - first) * queue->ElementSize);
+}
+
+// Copies count elements out of the ring starting at index, wrapping around the end of the buffer.
+void SpscQueueCopyOut(SpscQueue* queue, u64 index, u8* values, u64 count)
+{
+    u64 offset = index & (queue->Capacity - 1);
+    u64 first = queue->Capacity - offset;
+    if (first > count)
+        first = count;
+
+    PlatformCopyMemory(values, queue->Memory + offset * queue->ElementSize, first * queue->ElementSize);
+    if (count > first)
+        PlatformCopyMemory(values + first * queue->ElementSize, queue->Memory, (count - first) * queue->ElementSize);
+}
+
+b8 SpscQueueCreate(u64 element_size, u64 capacity, SpscQueue* out_queue)
+{
+    if (!out_queue || element_size == 0 || capacity == 0) {
+        ELSA_ERROR("SpscQueueCreate - element_size and capacity must be nonzero, and out_queue is required.");
+        return false;
+    }
+
+    u64 rounded_capacity = 1;
+    while (rounded_capacity < capacity)
+        rounded_capacity <<= 1;
+
+    PlatformZeroMemory(out_queue, sizeof(SpscQueue));
+    out_queue->Memory = MemoryTrackerAlloc(element_size * rounded_capacity, MEMORY_TAG_QUEUE);
+    if (!out_queue->Memory) {
+        ELSA_ERROR("SpscQueueCreate - Failed to allocate %llu elements!", rounded_capacity);
+        return false;
+    }
+    out_queue->ElementSize = element_size;
+    out_queue->Capacity = rounded_capacity;
+    return true;
+}
+
+void SpscQueueDestroy(SpscQueue* queue)
+{
+    if (queue && queue->Memory) {
+        MemoryTrackerFree(queue->Memory, queue->ElementSize * queue->Capacity, MEMORY_TAG_QUEUE);
+        PlatformZeroMemory(queue, sizeof(SpscQueue));
+    }
+}
+
+b8 SpscQueuePush(SpscQueue* queue, const void* value)
+{
+    return SpscQueuePushMany(queue, value, 1) == 1;
+}
+
+u64 SpscQueuePushMany(SpscQueue* queue, const void* values, u64 count)
+{
+    u64 tail = queue->Tail;
+    u64 free = queue->Capacity - (tail - queue->CachedHead);
+    if (free < count) {
+        queue->CachedHead = AtomicLoad(&queue->Head, ATOMIC_ACQUIRE);
+        free = queue->Capacity - (tail - queue->CachedHead);
+    }
+    if (count > free)
+        count = free;
+    if (count == 0)
+        return 0;
+
+    SpscQueueCopyIn(queue, tail, values, count);
+    AtomicStore(&queue->Tail, tail + count, ATOMIC_RELEASE);
+    return count;
+}
+
+b8 SpscQueuePop(SpscQueue* queue, void* out_value)
+{
+    return SpscQueuePopMany(queue, out_value, 1) == 1;
+}
+
+u64 SpscQueuePopMany(SpscQueue* queue, void* out_values, u64 max_count)
+{
+    u64 head = queue->Head;
+    u64 available = queue->CachedTail - head;
+    if (available < max_count) {
+        queue->CachedTail = AtomicLoad(&queue->Tail, ATOMIC_ACQUIRE);
+        available = queue->CachedTail - head;
+    }
+    if (max_count > available)
+        max_count = available;
+    if (max_count == 0)
+        return 0;
+
+    SpscQueueCopyOut(queue, head, out_values, max_count);
+    AtomicStore(&queue->Head, head + max_count, ATOMIC_RELEASE);
+    return max_count;
+}
+
+u64 SpscQueueCount(SpscQueue* queue)
+{
+    u64 head = AtomicLoad(&queue->Head, ATOMIC_ACQUIRE);
+    u64 tail = AtomicLoad(&queue->Tail, ATOMIC_ACQUIRE);
+    return tail - head;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file SpscQueue.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains a bounded lock-free queue for exactly one producer
+ * thread and one consumer thread.
+ * @version 1.0
+ * @date 2022-07-23
+ */
+#ifndef ELSA_SPSC_QUEUE_H
+#define ELSA_SPSC_QUEUE_H
+
+#include <Defines.h>
+
+/**
+ * @brief Represents a bounded single-producer/single-consumer ring buffer. Members
+ * of this structure should not be modified outside the functions associated with it.
+ *
+ * Only one thread may push and only one thread may pop at any time, but the two
+ * may be different threads running concurrently. Head and Tail only ever
+ * increase, and are masked into the buffer. Each side keeps a cached copy of the
+ * other side's index and only reloads it when the queue looks full or empty, so
+ * that the two threads rarely touch each other's cache lines. The producer and
+ * consumer fields are padded onto separate cache lines.
+ */
+typedef struct SpscQueue {
+    u8 Padding0[ELSA_CACHE_LINE_SIZE];
+    /** @brief The index of the next element to pop. Written by the consumer. */
+    u64 Head;
+    /** @brief The consumer's last observed value of Tail. */
+    u64 CachedTail;
+    u8 Padding1[ELSA_CACHE_LINE_SIZE - 2 * sizeof(u64)];
+    /** @brief The index of the next element to push. Written by the producer. */
+    u64 Tail;
+    /** @brief The producer's last observed value of Head. */
+    u64 CachedHead;
+    u8 Padding2[ELSA_CACHE_LINE_SIZE - 2 * sizeof(u64)];
+    /** @brief The size in bytes of an element. */
+    u64 ElementSize;
+    /** @brief The number of elements the queue holds, always a power of two. */
+    u64 Capacity;
+    /** @brief The element buffer. */
+    u8* Memory;
+    u8 Padding3[ELSA_CACHE_LINE_SIZE - 2 * sizeof(u64) - sizeof(u8*)];
+} SpscQueue;
+
+/**
+ * @brief Creates a queue and stores it in out_queue.
+ *
+ * @param element_size The size of each element in bytes.
+ * @param capacity The number of elements the queue can hold. Rounded up to a power of two.
+ * @param out_queue A pointer to a queue in which to hold relevant data.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 SpscQueueCreate(u64 element_size, u64 capacity, SpscQueue* out_queue);
+
+/**
+ * @brief Destroys the provided queue, releasing its memory. No thread may be using it.
+ *
+ * @param queue A pointer to the queue to be destroyed.
+ */
+ELSA_API void SpscQueueDestroy(SpscQueue* queue);
+
+/**
+ * @brief Pushes a copy of value to the queue. Must only be called from the producer thread.
+ *
+ * @param queue A pointer to the queue. Required.
+ * @param value A pointer to the value to push. Required.
+ * @returns True if the value was pushed; false if the queue is full.
+ */
+ELSA_API b8 SpscQueuePush(SpscQueue* queue, const void* value);
+
+/**
+ * @brief Pushes copies of as many of the given values as fit, publishing them all at once.
+ * Must only be called from the producer thread.
+ *
+ * @param queue A pointer to the queue. Required.
+ * @param values A pointer to the values to push. Required.
+ * @param count The number of values to push.
+ * @returns The number of values pushed, from the start of values.
+ */
+ELSA_API u64 SpscQueuePushMany(SpscQueue* queue, const void* values, u64 count);
+
+/**
+ * @brief Pops the oldest element of the queue. Must only be called from the consumer thread.
+ *
+ * @param queue A pointer to the queue. Required.
+ * @param out_value A pointer to hold the popped value. Required.
+ * @returns True if a value was popped; false if the queue is empty.
+ */
+ELSA_API b8 SpscQueuePop(SpscQueue* queue, void* out_value);
+
+/**
+ * @brief Pops up to max_count of the oldest elements of the queue at once.
+ * Must only be called from the consumer thread.
+ *
+ * @param queue A pointer to the queue. Required.
+ * @param out_values A pointer to hold the popped values. Required.
+ * @param max_count The maximum number of values to pop.
+ * @returns The number of values popped.
+ */
+ELSA_API u64 SpscQueuePopMany(SpscQueue* queue, void* out_values, u64 max_count);
+
+/**
+ * @brief Returns the number of elements in the queue. Only exact when called
+ * from the producer or consumer thread while the other is idle.
+ *
+ * @param queue A pointer to the queue. Required.
+ * @returns The number of elements in the queue.
+ */
+ELSA_API u64 SpscQueueCount(SpscQueue* queue);
+
+#endif
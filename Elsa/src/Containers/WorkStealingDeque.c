@@ -0,0 +1,94 @@
+#include "WorkStealingDeque.h"
+
+#include <Core/Atomic.h>
+#include <Core/Logger.h>
+#include <Core/MemTracker.h>
+#include <Platform/Platform.h>
+
+b8 WorkStealingDequeCreate(u64 capacity, WorkStealingDeque* out_deque)
+{
+    if (!out_deque || capacity == 0) {
+        ELSA_ERROR("WorkStealingDequeCreate - capacity must be nonzero, and out_deque is required.");
+        return false;
+    }
+
+    u64 rounded_capacity = 1;
+    while (rounded_capacity < capacity)
+        rounded_capacity <<= 1;
+
+    PlatformZeroMemory(out_deque, sizeof(WorkStealingDeque));
+    out_deque->Elements = MemoryTrackerAlloc(sizeof(void*) * rounded_capacity, MEMORY_TAG_QUEUE);
+    if (!out_deque->Elements) {
+        ELSA_ERROR("WorkStealingDequeCreate - Failed to allocate %llu elements!", rounded_capacity);
+        return false;
+    }
+    out_deque->Capacity = (i64)rounded_capacity;
+    return true;
+}
+
+void WorkStealingDequeDestroy(WorkStealingDeque* deque)
+{
+    if (deque && deque->Elements) {
+        MemoryTrackerFree(deque->Elements, sizeof(void*) * deque->Capacity, MEMORY_TAG_QUEUE);
+        PlatformZeroMemory(deque, sizeof(WorkStealingDeque));
+    }
+}
+
+b8 WorkStealingDequePush(WorkStealingDeque* deque, void* element)
+{
+    i64 bottom = AtomicLoad(&deque->Bottom, ATOMIC_RELAXED);
+    i64 top = AtomicLoad(&deque->Top, ATOMIC_ACQUIRE);
+    if (bottom - top >= deque->Capacity)
+        return false;
+
+    AtomicStore(&deque->Elements[bottom & (deque->Capacity - 1)], element, ATOMIC_RELAXED);
+    // Publishes the element, and whatever it points to, to the thieves that read Bottom.
+    AtomicStore(&deque->Bottom, bottom + 1, ATOMIC_RELEASE);
+    return true;
+}
+
+b8 WorkStealingDequePop(WorkStealingDeque* deque, void** out_element)
+{
+    i64 bottom = AtomicLoad(&deque->Bottom, ATOMIC_RELAXED) - 1;
+    AtomicStore(&deque->Bottom, bottom, ATOMIC_RELAXED);
+    // Thieves must see the element reserved before the owner reads Top, or both could take it.
+    AtomicThreadFence(ATOMIC_SEQ_CST);
+    i64 top = AtomicLoad(&deque->Top, ATOMIC_RELAXED);
+
+    if (top > bottom) {
+        AtomicStore(&deque->Bottom, bottom + 1, ATOMIC_RELAXED);
+        return false;
+    }
+
+    *out_element = AtomicLoad(&deque->Elements[bottom & (deque->Capacity - 1)], ATOMIC_RELAXED);
+    if (top < bottom)
+        return true;
+
+    // The last element, race the thieves for it.
+    b8 won = AtomicCompareExchange(&deque->Top, &top, top + 1, ATOMIC_SEQ_CST, ATOMIC_RELAXED);
+    AtomicStore(&deque->Bottom, bottom + 1, ATOMIC_RELAXED);
+    return won;
+}
+
+b8 WorkStealingDequeSteal(WorkStealingDeque* deque, void** out_element)
+{
+    i64 top = AtomicLoad(&deque->Top, ATOMIC_ACQUIRE);
+    AtomicThreadFence(ATOMIC_SEQ_CST);
+    i64 bottom = AtomicLoad(&deque->Bottom, ATOMIC_ACQUIRE);
+    if (top >= bottom)
+        return false;
+
+    void* element = AtomicLoad(&deque->Elements[top & (deque->Capacity - 1)], ATOMIC_RELAXED);
+    if (!AtomicCompareExchange(&deque->Top, &top, top + 1, ATOMIC_SEQ_CST, ATOMIC_RELAXED))
+        return false;
+
+    *out_element = element;
+    return true;
+}
+
+u64 WorkStealingDequeCount(WorkStealingDeque* deque)
+{
+    i64 bottom = AtomicLoad(&deque->Bottom, ATOMIC_RELAXED);
+    i64 top = AtomicLoad(&deque->Top, ATOMIC_RELAXED);
+    return bottom > top ? (u64)(bottom - top) : 0;
+}
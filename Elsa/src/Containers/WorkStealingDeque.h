@@ -0,0 +1,90 @@
+/**
+ * @file WorkStealingDeque.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains a bounded lock-free deque of pointers, which one owner
+ * thread pushes to and pops from while any other thread can steal from it.
+ * @version 1.0
+ * @date 2022-07-31
+ */
+#ifndef ELSA_WORK_STEALING_DEQUE_H
+#define ELSA_WORK_STEALING_DEQUE_H
+
+#include <Defines.h>
+
+/**
+ * @brief Represents a bounded Chase-Lev work-stealing deque, with the memory orders of
+ * Lê et al., "Correct and Efficient Work-Stealing for Weak Memory Models". Members of
+ * this structure should not be modified outside the functions associated with it.
+ *
+ * The owner pushes and pops at Bottom, in LIFO order so that it keeps working on the
+ * data it just touched, and thieves take the oldest element at Top. The two ends only
+ * contend over the last element, which they race for with a compare-and-swap on Top.
+ * The buffer doesn't grow, so the owner has to handle a full deque.
+ */
+typedef struct WorkStealingDeque {
+    u8 Padding0[ELSA_CACHE_LINE_SIZE];
+    /** @brief The index of the oldest element. Moved forward by thieves, and by the owner taking the last element. */
+    i64 Top;
+    u8 Padding1[ELSA_CACHE_LINE_SIZE - sizeof(i64)];
+    /** @brief The index of the next element to push. Written by the owner. */
+    i64 Bottom;
+    u8 Padding2[ELSA_CACHE_LINE_SIZE - sizeof(i64)];
+    /** @brief The number of elements the deque holds, always a power of two. */
+    i64 Capacity;
+    /** @brief The element buffer. */
+    void** Elements;
+    u8 Padding3[ELSA_CACHE_LINE_SIZE - sizeof(i64) - sizeof(void**)];
+} WorkStealingDeque;
+
+/**
+ * @brief Creates a deque and stores it in out_deque.
+ *
+ * @param capacity The number of elements the deque can hold. Rounded up to a power of two.
+ * @param out_deque A pointer to a deque in which to hold relevant data.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 WorkStealingDequeCreate(u64 capacity, WorkStealingDeque* out_deque);
+
+/**
+ * @brief Destroys the provided deque, releasing its memory. No thread may be using it.
+ *
+ * @param deque A pointer to the deque to be destroyed.
+ */
+ELSA_API void WorkStealingDequeDestroy(WorkStealingDeque* deque);
+
+/**
+ * @brief Pushes an element to the bottom of the deque. Only the owner thread may call this.
+ *
+ * @param deque A pointer to the deque. Required.
+ * @param element The element to push.
+ * @returns True if the element was pushed; false if the deque is full.
+ */
+ELSA_API b8 WorkStealingDequePush(WorkStealingDeque* deque, void* element);
+
+/**
+ * @brief Pops the most recently pushed element. Only the owner thread may call this.
+ *
+ * @param deque A pointer to the deque. Required.
+ * @param out_element A pointer to hold the element. Required.
+ * @returns True if an element was popped; false if the deque is empty or a thief took the last element.
+ */
+ELSA_API b8 WorkStealingDequePop(WorkStealingDeque* deque, void** out_element);
+
+/**
+ * @brief Steals the oldest element of the deque. Safe to call from any thread.
+ *
+ * @param deque A pointer to the deque. Required.
+ * @param out_element A pointer to hold the element. Required.
+ * @returns True if an element was stolen; false if the deque is empty or another thread took the element first.
+ */
+ELSA_API b8 WorkStealingDequeSteal(WorkStealingDeque* deque, void** out_element);
+
+/**
+ * @brief Gets an estimate of the number of elements in the deque, which may be out of date by the time it returns.
+ *
+ * @param deque A pointer to the deque. Required.
+ * @returns The number of elements.
+ */
+ELSA_API u64 WorkStealingDequeCount(WorkStealingDeque* deque);
+
+#endif
@@ -1,12 +1,20 @@
 #include "Application.h"
 
 #include <Core/Event.h>
+#include <Core/FrameStats.h>
+#include <Core/JobSystem.h>
 #include <Core/Logger.h>
 #include <Core/MemTracker.h>
+#include <Core/Profiler.h>
+#include <Core/StringId.h>
+#include <Core/Trace.h>
 #include <Audio/AudioFrontend.h>
 #include <Platform/Platform.h>
 #include <Renderer/RendererFrontend.h>
 
+#include <stdlib.h>
+#include <string.h>
+
 static ApplicationState app_state;
 
 b8 ApplicationOnEvent(u16 code, void* sender, void* listener, Event event)
@@ -66,10 +74,45 @@ b8 ApplicationCreate(struct Game* game)
     app_state.Height = game->AppConfig.Height;
     app_state.Name = game->AppConfig.Name;
 	
+    const char* headless_env = getenv("ELSA_HEADLESS");
+    app_state.Headless = game->AppConfig.Headless || (headless_env && strcmp(headless_env, "0") != 0);
+#if defined(ELSA_PLATFORM_LINUX)
+    // There is no windowing on Linux yet, so it always runs headless.
+    app_state.Headless = true;
+#endif
+	
+    if (!LoggerInit(game->AppConfig.LogFile)) {
+        ELSA_FATAL("LoggerInit failed. Shutting down...");
+        return false;
+    }
 	if (!MemoryTrackerInit()) {
 		ELSA_FATAL("MemoryTrackerInit failed. Shutting down...");
 		return false;
 	}
+	if (!ProfilerInit()) {
+		ELSA_FATAL("ProfilerInit failed. Shutting down...");
+		return false;
+	}
+	if (!TraceInit()) {
+		ELSA_FATAL("TraceInit failed. Shutting down...");
+		return false;
+	}
+	if (!FrameStatsInit()) {
+		ELSA_FATAL("FrameStatsInit failed. Shutting down...");
+		return false;
+	}
+	if (!StringIdInit()) {
+		ELSA_FATAL("StringIdInit failed. Shutting down...");
+		return false;
+	}
+    if (!EventSystemInit()) {
+        ELSA_FATAL("EventSystemInit failed. Shutting down...");
+        return false;
+    }
+    if (!JobSystemInit(0)) {
+        ELSA_FATAL("JobSystemInit failed. Shutting down...");
+        return false;
+    }
     if (!PlatformInit(&app_state)) {
         ELSA_FATAL("PlatformInit failed. Shutting down...");
         return false;
@@ -78,7 +121,7 @@ b8 ApplicationCreate(struct Game* game)
         ELSA_FATAL("AudioFrontendInit failed. Shutting down...");
         return false;
     }
-    if (!RendererFrontendInit(app_state.Name)) {
+    if (!RendererFrontendInit(app_state.Name, app_state.Headless)) {
         ELSA_FATAL("RendererFrontendInit failed. Shutting down...");
         return false;
     }
@@ -101,32 +144,68 @@ b8 ApplicationRun()
     app_state.Running = true;
 	
     while (app_state.Running) {
-        if (!PlatformPumpMessages()) {
-            app_state.Running = false;
-        }
-		
-        PlatformUpdateGamepads();
-		AudioFrontendUpdate();
-		
-        if (!app_state.game->Update(app_state.game)) {
-            ELSA_ERROR("app_state.game->Update failed.");
-            return false;
-        }
+        f32 delta_time = (f32)FrameStatsBeginFrame();
 
-        if (!RendererFrontendBeginFrame(1.0f)) {
-            ELSA_ERROR("RendererFrontendBeginFrame failed.");
-            return false;
-        }
+        CODE_BLOCK("Frame")
+        {
+            MemoryTrackerFrameReset();
 
-        if (!app_state.game->Render(app_state.game)) {
-            ELSA_ERROR("app_state.game->Render failed.");
-            return false;
-        }
+            CODE_BLOCK("Pump messages")
+            {
+                if (!PlatformPumpMessages()) {
+                    app_state.Running = false;
+                }
+            }
+
+            CODE_BLOCK("Gamepads")
+            {
+                PlatformUpdateGamepads();
+            }
+
+            CODE_BLOCK("Event dispatch")
+            {
+                EventDispatchQueued();
+            }
+
+            CODE_BLOCK("Audio update")
+            {
+                AudioFrontendUpdate();
+            }
+
+            CODE_BLOCK("Game update")
+            {
+                if (!app_state.game->Update(app_state.game)) {
+                    ELSA_ERROR_LIMITED("app_state.game->Update failed.");
+                    return false;
+                }
+            }
+
+            CODE_BLOCK("Begin frame")
+            {
+                if (!RendererFrontendBeginFrame(delta_time)) {
+                    ELSA_ERROR_LIMITED("RendererFrontendBeginFrame failed.");
+                    return false;
+                }
+            }
+
+            CODE_BLOCK("Game render")
+            {
+                if (!app_state.game->Render(app_state.game)) {
+                    ELSA_ERROR_LIMITED("app_state.game->Render failed.");
+                    return false;
+                }
+            }
 
-        if (!RendererFrontendEndFrame(1.0f)) {
-            ELSA_ERROR("RendererFrontendEndFrame failed.");
-            return false;
+            CODE_BLOCK("End frame")
+            {
+                if (!RendererFrontendEndFrame(delta_time)) {
+                    ELSA_ERROR_LIMITED("RendererFrontendEndFrame failed.");
+                    return false;
+                }
+            }
         }
+        ProfilerEndFrame();
+        FrameStatsEndFrame();
     }
 	
     if (!app_state.game->Free(app_state.game))
@@ -142,7 +221,14 @@ b8 ApplicationRun()
     RendererFrontendShutdown();
     AudioFrontendShutdown();
     PlatformExit();
+    JobSystemShutdown();
+    EventSystemExit();
+	StringIdShutdown();
+	FrameStatsShutdown();
+	TraceShutdown();
+	ProfilerShutdown();
 	MemoryTrackerShutdown();
+    LoggerShutdown();
 	
     return true;
 }
\ No newline at end of file
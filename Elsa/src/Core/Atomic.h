@@ -0,0 +1,139 @@
+/**
+ * @file Atomic.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains atomic operations and a spin lock, used by the
+ * engine systems that are shared between threads.
+ * @version 1.0
+ * @date 2022-07-20
+ */
+#ifndef ELSA_ATOMIC_H
+#define ELSA_ATOMIC_H
+
+#include <Defines.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+/** @brief Hints to the processor that the current thread is spinning. */
+#define ELSA_CPU_PAUSE() _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+/** @brief Hints to the processor that the current thread is spinning. */
+#define ELSA_CPU_PAUSE() __asm__ __volatile__("yield")
+#else
+/** @brief Hints to the processor that the current thread is spinning. */
+#define ELSA_CPU_PAUSE()
+#endif
+
+/** @brief No ordering constraints, only atomicity. */
+#define ATOMIC_RELAXED __ATOMIC_RELAXED
+/** @brief No reads or writes after this load can be reordered before it. */
+#define ATOMIC_ACQUIRE __ATOMIC_ACQUIRE
+/** @brief No reads or writes before this store can be reordered after it. */
+#define ATOMIC_RELEASE __ATOMIC_RELEASE
+/** @brief Both acquire and release semantics, for read-modify-write operations. */
+#define ATOMIC_ACQ_REL __ATOMIC_ACQ_REL
+/** @brief Sequentially consistent ordering. */
+#define ATOMIC_SEQ_CST __ATOMIC_SEQ_CST
+
+/**
+ * @brief Atomically loads the value pointed to by ptr.
+ * @param ptr A pointer to the value to load.
+ * @param order The memory order of the operation.
+ * @returns The loaded value.
+ */
+#define AtomicLoad(ptr, order) __atomic_load_n(ptr, order)
+
+/**
+ * @brief Atomically stores a value to the location pointed to by ptr.
+ * @param ptr A pointer to the location to store to.
+ * @param value The value to store.
+ * @param order The memory order of the operation.
+ */
+#define AtomicStore(ptr, value, order) __atomic_store_n(ptr, value, order)
+
+/**
+ * @brief Atomically adds a value to the location pointed to by ptr.
+ * @param ptr A pointer to the value to add to.
+ * @param value The value to add.
+ * @param order The memory order of the operation.
+ * @returns The value before the addition.
+ */
+#define AtomicFetchAdd(ptr, value, order) __atomic_fetch_add(ptr, value, order)
+
+/**
+ * @brief Atomically subtracts a value from the location pointed to by ptr.
+ * @param ptr A pointer to the value to subtract from.
+ * @param value The value to subtract.
+ * @param order The memory order of the operation.
+ * @returns The value before the subtraction.
+ */
+#define AtomicFetchSub(ptr, value, order) __atomic_fetch_sub(ptr, value, order)
+
+/**
+ * @brief Atomically replaces the value pointed to by ptr.
+ * @param ptr A pointer to the value to replace.
+ * @param value The new value.
+ * @param order The memory order of the operation.
+ * @returns The previous value.
+ */
+#define AtomicExchange(ptr, value, order) __atomic_exchange_n(ptr, value, order)
+
+/**
+ * @brief Atomically replaces the value pointed to by ptr with desired if it is equal to
+ * the value pointed to by expected. On failure, expected receives the current value.
+ * @param ptr A pointer to the value to compare and replace.
+ * @param expected A pointer to the expected value.
+ * @param desired The value to store on success.
+ * @param success The memory order used on success.
+ * @param failure The memory order used on failure.
+ * @returns True if the value was replaced; otherwise false.
+ */
+#define AtomicCompareExchange(ptr, expected, desired, success, failure) \
+__atomic_compare_exchange_n(ptr, expected, desired, false, success, failure)
+
+/**
+ * @brief Same as AtomicCompareExchange, but may fail spuriously. Cheaper inside of loops.
+ * @param ptr A pointer to the value to compare and replace.
+ * @param expected A pointer to the expected value.
+ * @param desired The value to store on success.
+ * @param success The memory order used on success.
+ * @param failure The memory order used on failure.
+ * @returns True if the value was replaced; otherwise false.
+ */
+#define AtomicCompareExchangeWeak(ptr, expected, desired, success, failure) \
+__atomic_compare_exchange_n(ptr, expected, desired, true, success, failure)
+
+/**
+ * @brief Issues a memory fence.
+ * @param order The memory order of the fence.
+ */
+#define AtomicThreadFence(order) __atomic_thread_fence(order)
+
+/** @brief A lock that busy-waits. Only suitable for very short critical sections. */
+typedef struct SpinLock {
+	u32 Locked;
+} SpinLock;
+
+/**
+ * @brief Acquires a spin lock, spinning until it becomes available.
+ * @param lock The lock to acquire.
+ */
+ELSA_INLINE void SpinLockAcquire(SpinLock* lock)
+{
+	for (;;) {
+		if (!AtomicExchange(&lock->Locked, 1, ATOMIC_ACQUIRE))
+			return;
+		while (AtomicLoad(&lock->Locked, ATOMIC_RELAXED))
+			ELSA_CPU_PAUSE();
+	}
+}
+
+/**
+ * @brief Releases a spin lock.
+ * @param lock The lock to release.
+ */
+ELSA_INLINE void SpinLockRelease(SpinLock* lock)
+{
+	AtomicStore(&lock->Locked, 0, ATOMIC_RELEASE);
+}
+
+#endif
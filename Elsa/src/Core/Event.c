@@ -1,96 +1,443 @@
 #include "Event.h"
 
-#include <Containers/Darray.h>
+#include <Containers/MpmcQueue.h>
 #include <Platform/Platform.h>
+#include <Core/Atomic.h>
 #include <Core/Logger.h>
+#include <Core/MemTracker.h>
+#include <Core/Profiler.h>
+#include <Core/Trace.h>
 
 typedef struct RegisteredEvent {
     void* Listener;
     PFN_OnEvent Callback;
 } RegisteredEvent;
 
+// A code with listeners. The listeners of a code are a contiguous range of the registry's listeners.
 typedef struct EventCodeEntry {
-    RegisteredEvent* Events;
+    u16 Code;
+    b8 Used;
+    u16 FirstListener;
+    u16 ListenerCount;
 } EventCodeEntry;
 
-#define MAX_MESSAGE_CODES 16384
+// Every code and listener, in a single block: an open addressing table of Capacity
+// entries, followed by the listeners of all codes. A registry is never modified once
+// published: registration builds a modified copy instead, so that firing can read it
+// without a lock.
+typedef struct EventRegistry {
+    // Links the registries that were replaced, until they are freed.
+    struct EventRegistry* NextRetired;
+    u64 Size;
+    u32 Capacity;
+    u32 Shift;
+    u32 EntryCount;
+    u32 ListenerCount;
+    EventCodeEntry Entries[];
+} EventRegistry;
+
+typedef struct QueuedEvent {
+    u16 Code;
+    // The coalesced event this one stands for, whose data is read when it's dispatched.
+    u16 Coalesced;
+    void* Sender;
+    Event Data;
+} QueuedEvent;
+
+// The pending event of a coalesced code. Posts while it's pending replace its data
+// instead of taking another slot of the queue.
+typedef struct CoalescedEvent {
+    // Never changes once the code is published.
+    u16 Code;
+    u8 Mode;
+    SpinLock Lock;
+    b8 Pending;
+    void* Sender;
+    Event Data;
+} CoalescedEvent;
+
+#define EVENT_REGISTRY_MIN_CAPACITY 16
+#define EVENT_REGISTRY_MAX_LISTENERS 0xFFFF
+#define EVENT_REGISTRY_NO_REMOVAL 0xFFFFFFFF
+#define EVENT_MAX_COALESCED_CODES 16
+#define EVENT_NOT_COALESCED 0xFFFF
 
 typedef struct EventSystemState {
-    EventCodeEntry Registered[MAX_MESSAGE_CODES];
+    EventRegistry* Registry;
+
+    // Serializes registration. Firing never takes it.
+    SpinLock RegistrationLock;
+    // Replaced registries, freed once no fire can still be reading them.
+    EventRegistry* Retired;
+    // The number of fires in progress on the main thread.
+    u32 FireDepth;
+
+    // Events posted from any thread, drained by the main thread.
+    MpmcQueue Posted;
+    // The events of the dispatch in progress.
+    QueuedEvent* Batch;
+
+    // The codes that have had a coalescing mode, published by CoalescedCount. Only
+    // ever appended to, so that posting can look them up without a lock.
+    CoalescedEvent Coalesced[EVENT_MAX_COALESCED_CODES];
+    u32 CoalescedCount;
 } EventSystemState;
 
 static EventSystemState state;
 
-void EventSystemInit()
+RegisteredEvent* EventRegistryListeners(const EventRegistry* registry)
+{
+    return (RegisteredEvent*)(registry->Entries + registry->Capacity);
+}
+
+u32 EventRegistryHome(const EventRegistry* registry, u16 code)
+{
+    return ((u32)code * 0x9E3779B1u) >> registry->Shift;
+}
+
+// Returns the index of the entry for code, or of the empty entry where it would go.
+u32 EventRegistryProbe(const EventRegistry* registry, u16 code)
+{
+    u32 mask = registry->Capacity - 1;
+    u32 index = EventRegistryHome(registry, code);
+    while (registry->Entries[index].Used && registry->Entries[index].Code != code)
+        index = (index + 1) & mask;
+    return index;
+}
+
+const EventCodeEntry* EventRegistryFind(const EventRegistry* registry, u16 code)
+{
+    if (!registry)
+        return 0;
+
+    const EventCodeEntry* entry = &registry->Entries[EventRegistryProbe(registry, code)];
+    return entry->Used ? entry : 0;
+}
+
+void EventRegistryDestroy(EventRegistry* registry)
+{
+    MemoryTrackerFree(registry, registry->Size, MEMORY_TAG_ENGINE_GENERAL);
+}
+
+// Builds a copy of current with the entry of code changed: the listener at remove_index
+// removed, and added appended if given. Entries left without listeners are dropped.
+EventRegistry* EventRegistryRebuild(const EventRegistry* current, u16 code, u32 remove_index, const RegisteredEvent* added)
+{
+    const EventCodeEntry* old_entry = EventRegistryFind(current, code);
+    u32 old_count = old_entry ? old_entry->ListenerCount : 0;
+    u32 new_count = old_count - (remove_index != EVENT_REGISTRY_NO_REMOVAL) + (added != 0);
+    b8 keep = new_count != 0;
+
+    u32 entry_count = (current ? current->EntryCount : 0) - (old_entry != 0) + keep;
+    u32 listener_count = (current ? current->ListenerCount : 0) - old_count + new_count;
+    if (listener_count > EVENT_REGISTRY_MAX_LISTENERS) {
+        ELSA_ERROR("Too many event listeners are registered! (Code: %u)", code);
+        return 0;
+    }
+
+    // Keep the table at most half full, so that probes stay short.
+    u32 capacity = EVENT_REGISTRY_MIN_CAPACITY;
+    u32 shift = 32 - 4;
+    while (capacity < entry_count * 2) {
+        capacity *= 2;
+        shift--;
+    }
+
+    u64 size = sizeof(EventRegistry) + sizeof(EventCodeEntry) * capacity + sizeof(RegisteredEvent) * listener_count;
+    EventRegistry* registry = MemoryTrackerAlloc(size, MEMORY_TAG_ENGINE_GENERAL);
+    if (!registry) {
+        ELSA_ERROR("Failed to allocate the event registry!");
+        return 0;
+    }
+    PlatformZeroMemory(registry, sizeof(EventRegistry) + sizeof(EventCodeEntry) * capacity);
+    registry->Size = size;
+    registry->Capacity = capacity;
+    registry->Shift = shift;
+    registry->EntryCount = entry_count;
+    registry->ListenerCount = listener_count;
+
+    RegisteredEvent* listeners = EventRegistryListeners(registry);
+    u32 next_listener = 0;
+    if (current) {
+        const RegisteredEvent* current_listeners = EventRegistryListeners(current);
+        for (u32 i = 0; i < current->Capacity; i++) {
+            const EventCodeEntry* entry = &current->Entries[i];
+            if (!entry->Used || entry->Code == code)
+                continue;
+
+            EventCodeEntry* copy = &registry->Entries[EventRegistryProbe(registry, entry->Code)];
+            *copy = *entry;
+            copy->FirstListener = (u16)next_listener;
+            PlatformCopyMemory(listeners + next_listener, current_listeners + entry->FirstListener, sizeof(RegisteredEvent) * entry->ListenerCount);
+            next_listener += entry->ListenerCount;
+        }
+    }
+
+    if (keep) {
+        EventCodeEntry* entry = &registry->Entries[EventRegistryProbe(registry, code)];
+        entry->Code = code;
+        entry->Used = true;
+        entry->FirstListener = (u16)next_listener;
+        entry->ListenerCount = (u16)new_count;
+
+        const RegisteredEvent* old_listeners = old_entry ? EventRegistryListeners(current) + old_entry->FirstListener : 0;
+        for (u32 i = 0; i < old_count; i++) {
+            if (i != remove_index)
+                listeners[next_listener++] = old_listeners[i];
+        }
+        if (added)
+            listeners[next_listener++] = *added;
+    }
+
+    return registry;
+}
+
+// Swaps in the new registry, and retires the old one. Requires the registration lock.
+void EventRegistryPublish(EventRegistry* registry)
+{
+    EventRegistry* current = state.Registry;
+    AtomicStore(&state.Registry, registry, ATOMIC_RELEASE);
+    if (current) {
+        current->NextRetired = state.Retired;
+        state.Retired = current;
+    }
+}
+
+// Frees the retired registries. Only safe on the main thread, while nothing is being fired.
+void EventReclaimRetired()
+{
+    SpinLockAcquire(&state.RegistrationLock);
+    EventRegistry* retired = state.Retired;
+    state.Retired = 0;
+    SpinLockRelease(&state.RegistrationLock);
+
+    while (retired) {
+        EventRegistry* next = retired->NextRetired;
+        EventRegistryDestroy(retired);
+        retired = next;
+    }
+}
+
+b8 EventSystemInit()
 {
     PlatformZeroMemory(&state, sizeof(EventSystemState));
+
+    if (!MpmcQueueCreate(sizeof(QueuedEvent), EVENT_QUEUE_CAPACITY, &state.Posted)) {
+        ELSA_ERROR("Failed to create the event queue!");
+        return false;
+    }
+    state.Batch = MemoryTrackerAlloc(sizeof(QueuedEvent) * EVENT_QUEUE_CAPACITY, MEMORY_TAG_ENGINE_GENERAL);
+    if (!state.Batch) {
+        ELSA_ERROR("Failed to allocate the event dispatch batch!");
+        MpmcQueueDestroy(&state.Posted);
+        return false;
+    }
+
+    EventSetCoalesceMode(EVENT_CODE_RESIZED, EVENT_COALESCE_LAST);
+    EventSetCoalesceMode(EVENT_CODE_MOUSE_MOVED, EVENT_COALESCE_LAST);
+    return true;
 }
 
 void EventSystemExit()
 {
-    for (u16 i = 0; i < MAX_MESSAGE_CODES; i++) {
-        if (state.Registered[i].Events != 0) {
-            Darray_Destroy(state.Registered[i].Events);
-            state.Registered[i].Events = 0;
-        }
+    EventReclaimRetired();
+    if (state.Registry) {
+        EventRegistryDestroy(state.Registry);
+        state.Registry = 0;
     }
+
+    state.CoalescedCount = 0;
+    if (state.Batch) {
+        MemoryTrackerFree(state.Batch, sizeof(QueuedEvent) * EVENT_QUEUE_CAPACITY, MEMORY_TAG_ENGINE_GENERAL);
+        state.Batch = 0;
+    }
+    MpmcQueueDestroy(&state.Posted);
 }
 
 b8 EventRegister(u16 code, void* listener, PFN_OnEvent on_event)
 {
-    if (state.Registered[code].Events == 0) {
-        state.Registered[code].Events = Darray_Create(RegisteredEvent);
-    }
+    SpinLockAcquire(&state.RegistrationLock);
 
-    u64 registered_count = Darray_Length(state.Registered[code].Events);
-    for (u64 i = 0; i < registered_count; i++) {
-        if (state.Registered[code].Events[i].Listener == listener) {
-            ELSA_WARN("Trying to register an event listener that is already registered! (Code: %u)", code);
-            return false;
+    const EventRegistry* current = state.Registry;
+    const EventCodeEntry* entry = EventRegistryFind(current, code);
+    if (entry) {
+        const RegisteredEvent* listeners = EventRegistryListeners(current) + entry->FirstListener;
+        for (u32 i = 0; i < entry->ListenerCount; i++) {
+            if (listeners[i].Listener == listener) {
+                SpinLockRelease(&state.RegistrationLock);
+                ELSA_WARN("Trying to register an event listener that is already registered! (Code: %u)", code);
+                return false;
+            }
         }
     }
 
     RegisteredEvent event;
     event.Listener = listener;
     event.Callback = on_event;
-    Darray_Push(state.Registered[code].Events, event);
-    
-    return true;
+    EventRegistry* registry = EventRegistryRebuild(current, code, EVENT_REGISTRY_NO_REMOVAL, &event);
+    if (registry)
+        EventRegistryPublish(registry);
+
+    SpinLockRelease(&state.RegistrationLock);
+    return registry != 0;
 }
 
 b8 EventUnregister(u16 code, void* listener, PFN_OnEvent on_event)
 {
-    if (state.Registered[code].Events == 0) {
+    SpinLockAcquire(&state.RegistrationLock);
+
+    const EventRegistry* current = state.Registry;
+    const EventCodeEntry* entry = EventRegistryFind(current, code);
+    if (entry == 0 || entry->ListenerCount == 0) {
+        SpinLockRelease(&state.RegistrationLock);
         ELSA_WARN("Trying to unregister an event listener that isn't registered! (Code: %u)", code);
         return false;
     }
 
-    u64 registered_count = Darray_Length(state.Registered[code].Events);
-    for (u64 i = 0; i < registered_count; i++) {
-        RegisteredEvent e = state.Registered[code].Events[i];
+    const RegisteredEvent* listeners = EventRegistryListeners(current) + entry->FirstListener;
+    for (u32 i = 0; i < entry->ListenerCount; i++) {
+        RegisteredEvent e = listeners[i];
         if (e.Listener == listener && e.Callback == on_event) {
-            RegisteredEvent popped_event;
-            Darray_PopAt(state.Registered[code].Events, i, &popped_event);
-            return true;
+            EventRegistry* registry = EventRegistryRebuild(current, code, i, 0);
+            if (registry)
+                EventRegistryPublish(registry);
+
+            SpinLockRelease(&state.RegistrationLock);
+            return registry != 0;
         }
     }
 
+    SpinLockRelease(&state.RegistrationLock);
     return false;
 }
 
 b8 EventFire(u16 code, void* sender, Event data)
 {
-    if (state.Registered[code].Events == 0) {
+    b8 traced = TraceIsCapturing();
+    u64 start = traced ? ProfilerNow() : 0;
+
+    const EventRegistry* registry = AtomicLoad(&state.Registry, ATOMIC_ACQUIRE);
+    const EventCodeEntry* entry = EventRegistryFind(registry, code);
+    if (entry == 0) {
+        if (traced)
+            TraceEventFired(code, false, start, start);
         return false;
     }
 
-    u64 registered_count = Darray_Length(state.Registered[code].Events);
-    for (u64 i = 0; i < registered_count; i++) {
-        RegisteredEvent e = state.Registered[code].Events[i];
+    b8 handled = false;
+    const RegisteredEvent* listeners = EventRegistryListeners(registry) + entry->FirstListener;
+    state.FireDepth++;
+    for (u32 i = 0; i < entry->ListenerCount; i++) {
+        RegisteredEvent e = listeners[i];
         if (e.Callback(code, sender, e.Listener, data)) {
+            handled = true;
+            break;
+        }
+    }
+    state.FireDepth--;
+
+    if (traced)
+        TraceEventFired(code, handled, start, ProfilerNow());
+    return handled;
+}
+
+// Returns the coalesced event of code, or 0 if its posts aren't coalesced.
+CoalescedEvent* EventFindCoalesced(u16 code)
+{
+    u32 count = AtomicLoad(&state.CoalescedCount, ATOMIC_ACQUIRE);
+    for (u32 i = 0; i < count; i++) {
+        CoalescedEvent* coalesced = &state.Coalesced[i];
+        if (coalesced->Code == code)
+            return AtomicLoad(&coalesced->Mode, ATOMIC_RELAXED) == EVENT_COALESCE_LAST ? coalesced : 0;
+    }
+    return 0;
+}
+
+b8 EventPost(u16 code, void* sender, Event data)
+{
+    QueuedEvent queued;
+    queued.Code = code;
+    queued.Coalesced = EVENT_NOT_COALESCED;
+    queued.Sender = sender;
+    queued.Data = data;
+
+    CoalescedEvent* coalesced = EventFindCoalesced(code);
+    if (coalesced) {
+        SpinLockAcquire(&coalesced->Lock);
+        coalesced->Sender = sender;
+        coalesced->Data = data;
+        b8 pending = coalesced->Pending;
+        coalesced->Pending = true;
+        SpinLockRelease(&coalesced->Lock);
+
+        // Already queued, and dispatched with the data just written.
+        if (pending)
             return true;
+        queued.Coalesced = (u16)(coalesced - state.Coalesced);
+    }
+
+    if (!MpmcQueuePush(&state.Posted, &queued)) {
+        if (coalesced) {
+            SpinLockAcquire(&coalesced->Lock);
+            coalesced->Pending = false;
+            SpinLockRelease(&coalesced->Lock);
         }
+        ELSA_WARN_LIMITED("The event queue is full, dropping event %u.", code);
+        return false;
     }
+    return true;
+}
 
-    return false;
-}
\ No newline at end of file
+void EventDispatchQueued()
+{
+    // The batch is in use, and retired registries may still be read, until the outer dispatch returns.
+    if (state.FireDepth != 0)
+        return;
+
+    EventReclaimRetired();
+
+    // Events posted by the handlers below aren't in the batch, and wait for the next dispatch.
+    u32 count = (u32)MpmcQueuePopMany(&state.Posted, state.Batch, EVENT_QUEUE_CAPACITY);
+
+    for (u32 i = 0; i < count; i++) {
+        QueuedEvent* queued = &state.Batch[i];
+        if (queued->Coalesced != EVENT_NOT_COALESCED) {
+            // Takes the latest data, and lets the next post queue the code again.
+            CoalescedEvent* coalesced = &state.Coalesced[queued->Coalesced];
+            SpinLockAcquire(&coalesced->Lock);
+            queued->Sender = coalesced->Sender;
+            queued->Data = coalesced->Data;
+            coalesced->Pending = false;
+            SpinLockRelease(&coalesced->Lock);
+        }
+        EventFire(queued->Code, queued->Sender, queued->Data);
+    }
+}
+
+void EventSetCoalesceMode(u16 code, EventCoalesceMode mode)
+{
+    SpinLockAcquire(&state.RegistrationLock);
+
+    u32 count = state.CoalescedCount;
+    for (u32 i = 0; i < count; i++) {
+        if (state.Coalesced[i].Code == code) {
+            AtomicStore(&state.Coalesced[i].Mode, (u8)mode, ATOMIC_RELAXED);
+            SpinLockRelease(&state.RegistrationLock);
+            return;
+        }
+    }
+
+    if (mode != EVENT_COALESCE_NONE) {
+        if (count < EVENT_MAX_COALESCED_CODES) {
+            CoalescedEvent* coalesced = &state.Coalesced[count];
+            PlatformZeroMemory(coalesced, sizeof(CoalescedEvent));
+            coalesced->Code = code;
+            coalesced->Mode = (u8)mode;
+            AtomicStore(&state.CoalescedCount, count + 1, ATOMIC_RELEASE);
+        } else {
+            ELSA_ERROR("Only %d event codes can be coalesced! (Code: %u)", EVENT_MAX_COALESCED_CODES, code);
+        }
+    }
+
+    SpinLockRelease(&state.RegistrationLock);
+}
@@ -61,10 +61,26 @@ typedef struct Event {
  */
 typedef b8 (*PFN_OnEvent)(u16 code, void* sender, void* listener_inst, Event data);
 
+/** @brief The number of events that can be posted before they are dispatched. Must be a power of two. */
+#define EVENT_QUEUE_CAPACITY 4096
+
+/** @brief How repeated posts of an event code within a frame are handled. */
+typedef enum EventCoalesceMode {
+    /** @brief Every posted event is dispatched. */
+    EVENT_COALESCE_NONE = 0,
+    /**
+     * @brief Only the last event posted before a dispatch is delivered, at the position of the
+     * first one. Posts after the first replace its data, without taking another slot of the queue.
+     */
+    EVENT_COALESCE_LAST = 1
+} EventCoalesceMode;
+
 /**
- * @brief Initializes the event system.
+ * @brief Initializes the event system. EVENT_CODE_RESIZED and EVENT_CODE_MOUSE_MOVED
+ * start out coalesced with EVENT_COALESCE_LAST.
+ * @returns True on success; otherwise false.
  */
-ELSA_API void EventSystemInit();
+ELSA_API b8 EventSystemInit();
 
 /**
  * @brief Shuts the event system down.
@@ -77,6 +93,8 @@ ELSA_API void EventSystemExit();
  * @param code The event code to listen for.
  * @param listener A pointer to a listener instance. Can be 0/NULL.
  * @param on_event The callback function pointer to be invoked when the event code is fired.
+ * Safe to call from any thread. A listener registered while the code is being fired
+ * receives the event from the next fire on.
  * @returns True if the event is successfully registered; otherwise false.
  */
 ELSA_API b8 EventRegister(u16 code, void* listener, PFN_OnEvent on_event);
@@ -87,6 +105,7 @@ ELSA_API b8 EventRegister(u16 code, void* listener, PFN_OnEvent on_event);
  * @param code The event code to stop listening for.
  * @param listener A pointer to a listener instance. Can be 0/NULL.
  * @param on_event The callback function pointer to be unregistered.
+ * Safe to call from any thread. A fire already in progress may still call the listener.
  * @returns True if the event is successfully unregistered; otherwise false.
  */
 ELSA_API b8 EventUnregister(u16 code, void* listener, PFN_OnEvent on_event);
@@ -94,6 +113,7 @@ ELSA_API b8 EventUnregister(u16 code, void* listener, PFN_OnEvent on_event);
 /**
  * @brief Fires an event to listeners of the given code. If an event handler returns 
  * true, the event is considered handled and is not passed on to any more listeners.
+ * Only call this from the main thread; other threads should use EventPost.
  * @param code The event code to fire.
  * @param sender A pointer to the sender. Can be 0/NULL.
  * @param data The event data.
@@ -101,6 +121,32 @@ ELSA_API b8 EventUnregister(u16 code, void* listener, PFN_OnEvent on_event);
  */
 ELSA_API b8 EventFire(u16 code, void* sender, Event data);
 
+/**
+ * @brief Queues an event, to be fired by the next call to EventDispatchQueued instead of
+ * immediately. Events posted while the queue is dispatched are kept for the next dispatch.
+ * Safe to call from any thread, without taking a lock. Events posted by one thread are
+ * dispatched in the order that thread posted them.
+ * @param code The event code to post.
+ * @param sender A pointer to the sender. Can be 0/NULL. Must stay valid until the event is dispatched.
+ * @param data The event data.
+ * @returns True if the event was queued; false if the queue is full and the event was dropped.
+ */
+ELSA_API b8 EventPost(u16 code, void* sender, Event data);
+
+/**
+ * @brief Fires every queued event in the order they were posted. Called once per frame by the application, on the main thread.
+ * Does nothing when called from an event handler.
+ */
+ELSA_API void EventDispatchQueued();
+
+/**
+ * @brief Sets how repeated posts of an event code are handled. Safe to call from any thread.
+ * At most 16 codes can be given a coalescing mode.
+ * @param code The event code.
+ * @param mode The coalescing mode.
+ */
+ELSA_API void EventSetCoalesceMode(u16 code, EventCoalesceMode mode);
+
 typedef enum EventCode {
      /** @brief Shuts the application down on the next frame. */
     EVENT_CODE_APPLICATION_QUIT = 0x01,
@@ -0,0 +1,233 @@
+#include "FrameStats.h"
+
+#include <Containers/Darray.h>
+#include <Core/Logger.h>
+#include <Core/Profiler.h>
+#include <Platform/Platform.h>
+
+#include <string.h>
+
+typedef struct FrameStage {
+    const char* Name;
+    // Indexed like the frame times, 0 for the frames the stage didn't run in.
+    f32 Times[FRAME_STATS_WINDOW];
+    f64 Sum;
+} FrameStage;
+
+typedef struct FrameStatsState {
+    f64 FrameStart;
+    f64 DeltaTime;
+    u64 FrameCount;
+    u64 HitchCount;
+    f32 HitchThresholdMs;
+    f32 LogInterval;
+    f64 NextLog;
+    LogRateLimit HitchLimit;
+
+    // A ring of the frame times of the window, in milliseconds, and their histogram.
+    f32 Times[FRAME_STATS_WINDOW];
+    u32 NextSlot;
+    u32 SampleCount;
+    f64 Sum;
+    u16 Histogram[FRAME_STATS_BUCKET_COUNT];
+
+    FrameStage Stages[FRAME_STATS_MAX_STAGES];
+    u32 StageCount;
+} FrameStatsState;
+
+static FrameStatsState stats;
+
+b8 FrameStatsInit()
+{
+    PlatformZeroMemory(&stats, sizeof(stats));
+    stats.HitchThresholdMs = FRAME_STATS_DEFAULT_HITCH_MS;
+    stats.LogInterval = FRAME_STATS_DEFAULT_LOG_INTERVAL;
+    return true;
+}
+
+void FrameStatsShutdown()
+{
+    PlatformZeroMemory(&stats, sizeof(stats));
+}
+
+f64 FrameStatsBeginFrame()
+{
+    f64 now = PlatformGetAbsoluteTime();
+    stats.DeltaTime = stats.FrameStart != 0.0 ? now - stats.FrameStart : 0.0;
+    stats.FrameStart = now;
+    return stats.DeltaTime;
+}
+
+f64 FrameStatsGetDeltaTime()
+{
+    return stats.DeltaTime;
+}
+
+u32 FrameStatsBucket(f32 milliseconds)
+{
+    u32 bucket = (u32)(milliseconds / FRAME_STATS_BUCKET_MS);
+    return bucket < FRAME_STATS_BUCKET_COUNT ? bucket : FRAME_STATS_BUCKET_COUNT - 1;
+}
+
+u32 FrameStatsFindStage(const char* name)
+{
+    for (u32 i = 0; i < stats.StageCount; i++) {
+        // The same literal can have a different address in another translation unit.
+        if (stats.Stages[i].Name == name || strcmp(stats.Stages[i].Name, name) == 0)
+            return i;
+    }
+    if (stats.StageCount == FRAME_STATS_MAX_STAGES)
+        return FRAME_STATS_MAX_STAGES;
+
+    stats.Stages[stats.StageCount].Name = name;
+    return stats.StageCount++;
+}
+
+// Adds up the time of every stage of the main thread in the frame.
+void FrameStatsCollectStages(const ProfileFrame* frame, f32* out_stage_ms)
+{
+    const char* main_thread = ProfilerGetThreadName(ProfilerGetThreadIndex());
+    u32 node_count = (u32)Darray_Length(frame->Nodes);
+    for (u32 i = 0; i < node_count; i++) {
+        const ProfileNode* node = &frame->Nodes[i];
+        if (node->Depth != 2)
+            continue;
+        const ProfileNode* root = &frame->Nodes[frame->Nodes[node->Parent].Parent];
+        if (root->Name != main_thread)
+            continue;
+
+        u32 stage = FrameStatsFindStage(node->Name);
+        if (stage < FRAME_STATS_MAX_STAGES)
+            out_stage_ms[stage] += node->InclusiveNs / 1000000.0f;
+    }
+}
+
+void FrameStatsEndFrame()
+{
+    f64 now = PlatformGetAbsoluteTime();
+    f32 frame_ms = (f32)((now - stats.FrameStart) * 1000.0);
+    const ProfileFrame* frame = ProfilerGetLastFrame();
+
+    f32 stage_ms[FRAME_STATS_MAX_STAGES] = {0};
+    if (frame)
+        FrameStatsCollectStages(frame, stage_ms);
+
+    u32 slot = stats.NextSlot;
+    if (stats.SampleCount == FRAME_STATS_WINDOW) {
+        stats.Sum -= stats.Times[slot];
+        stats.Histogram[FrameStatsBucket(stats.Times[slot])]--;
+        for (u32 i = 0; i < stats.StageCount; i++)
+            stats.Stages[i].Sum -= stats.Stages[i].Times[slot];
+    } else {
+        stats.SampleCount++;
+    }
+
+    stats.Times[slot] = frame_ms;
+    stats.Sum += frame_ms;
+    stats.Histogram[FrameStatsBucket(frame_ms)]++;
+    for (u32 i = 0; i < stats.StageCount; i++) {
+        stats.Stages[i].Times[slot] = stage_ms[i];
+        stats.Stages[i].Sum += stage_ms[i];
+    }
+    stats.NextSlot = (slot + 1) % FRAME_STATS_WINDOW;
+
+    // The first frame pays for whatever is created lazily, so it isn't counted as a hitch.
+    if (stats.HitchThresholdMs > 0.0f && stats.FrameCount > 0 && frame_ms > stats.HitchThresholdMs) {
+        stats.HitchCount++;
+        u32 suppressed;
+        if (LogRateLimitCheck(&stats.HitchLimit, LOG_RATE_LIMIT_INTERVAL_MS, &suppressed)) {
+            ELSA_WARN("Hitch: frame %llu took %.2f ms, over the %.2f ms threshold.",
+                      frame ? frame->FrameIndex : stats.FrameCount, frame_ms, stats.HitchThresholdMs);
+            if (suppressed) {
+                ELSA_WARN("(%u hitches not shown)", suppressed);
+            }
+            if (frame)
+                ProfilerLogFrame(frame);
+        }
+    }
+    stats.FrameCount++;
+
+    if (stats.LogInterval > 0.0f && now >= stats.NextLog) {
+        if (stats.NextLog != 0.0)
+            FrameStatsLog();
+        stats.NextLog = now + stats.LogInterval;
+    }
+}
+
+// Gets the time under which a share of the frames of the window are, interpolating
+// within the bucket of the histogram it falls in.
+f32 FrameStatsPercentile(u32 permille, f32 max_ms)
+{
+    u32 rank = (stats.SampleCount * permille + 999) / 1000;
+    u32 seen = 0;
+    for (u32 i = 0; i < FRAME_STATS_BUCKET_COUNT - 1; i++) {
+        u32 count = stats.Histogram[i];
+        if (count && seen + count >= rank) {
+            f32 value = (f32)((i + (f32)(rank - seen) / count) * FRAME_STATS_BUCKET_MS);
+            return value < max_ms ? value : max_ms;
+        }
+        seen += count;
+    }
+    return max_ms;
+}
+
+void FrameStatsGet(FrameStats* out_stats)
+{
+    PlatformZeroMemory(out_stats, sizeof(FrameStats));
+    out_stats->FrameCount = stats.FrameCount;
+    out_stats->SampleCount = stats.SampleCount;
+    out_stats->HitchCount = stats.HitchCount;
+    if (stats.SampleCount == 0)
+        return;
+
+    u32 last = (stats.NextSlot + FRAME_STATS_WINDOW - 1) % FRAME_STATS_WINDOW;
+    out_stats->LastMs = stats.Times[last];
+    out_stats->AverageMs = (f32)(stats.Sum / stats.SampleCount);
+    for (u32 i = 0; i < stats.SampleCount; i++) {
+        if (stats.Times[i] > out_stats->MaxMs)
+            out_stats->MaxMs = stats.Times[i];
+    }
+    out_stats->P50Ms = FrameStatsPercentile(500, out_stats->MaxMs);
+    out_stats->P95Ms = FrameStatsPercentile(950, out_stats->MaxMs);
+    out_stats->P99Ms = FrameStatsPercentile(990, out_stats->MaxMs);
+
+    out_stats->StageCount = stats.StageCount;
+    for (u32 s = 0; s < stats.StageCount; s++) {
+        const FrameStage* stage = &stats.Stages[s];
+        FrameStageStats* out_stage = &out_stats->Stages[s];
+        out_stage->Name = stage->Name;
+        out_stage->LastMs = stage->Times[last];
+        out_stage->AverageMs = (f32)(stage->Sum / stats.SampleCount);
+        for (u32 i = 0; i < stats.SampleCount; i++) {
+            if (stage->Times[i] > out_stage->MaxMs)
+                out_stage->MaxMs = stage->Times[i];
+        }
+    }
+}
+
+void FrameStatsLog()
+{
+    FrameStats frame_stats;
+    FrameStatsGet(&frame_stats);
+    if (frame_stats.SampleCount == 0)
+        return;
+
+    ELSA_INFO("Frame time over the last %u frames: %.2f ms average (%.1f FPS), p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms, %llu hitches.",
+              frame_stats.SampleCount, frame_stats.AverageMs, frame_stats.AverageMs > 0.0f ? 1000.0f / frame_stats.AverageMs : 0.0f,
+              frame_stats.P50Ms, frame_stats.P95Ms, frame_stats.P99Ms, frame_stats.MaxMs, frame_stats.HitchCount);
+    for (u32 i = 0; i < frame_stats.StageCount; i++) {
+        ELSA_INFO("  %s: %.3f ms average, %.3f ms max", frame_stats.Stages[i].Name,
+                  frame_stats.Stages[i].AverageMs, frame_stats.Stages[i].MaxMs);
+    }
+}
+
+void FrameStatsSetHitchThreshold(f32 milliseconds)
+{
+    stats.HitchThresholdMs = milliseconds;
+}
+
+void FrameStatsSetLogInterval(f32 seconds)
+{
+    stats.LogInterval = seconds;
+    stats.NextLog = 0.0;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file FrameStats.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains the frame timing statistics. Frame times are measured with
+ * the monotonic platform clock and kept over a rolling window, along with the time of
+ * every stage of the frame taken from its profile. Frames slower than a threshold are
+ * reported as hitches along with their profile.
+ * @version 1.0
+ * @date 2022-07-29
+ */
+#ifndef ELSA_FRAME_STATS_H
+#define ELSA_FRAME_STATS_H
+
+#include <Defines.h>
+
+/** @brief The number of frames the statistics are computed over. */
+#define FRAME_STATS_WINDOW 1024
+
+/** @brief The maximum number of stages tracked. Stages beyond it are left out of the breakdown. */
+#define FRAME_STATS_MAX_STAGES 16
+
+/** @brief The width of a bucket of the frame time histogram, in milliseconds. */
+#define FRAME_STATS_BUCKET_MS 0.1
+
+/** @brief The number of buckets of the frame time histogram. Longer frames all land in the last one. */
+#define FRAME_STATS_BUCKET_COUNT 1000
+
+/** @brief The default duration above which a frame is a hitch, in milliseconds. */
+#define FRAME_STATS_DEFAULT_HITCH_MS 50.0f
+
+/** @brief The default number of seconds between two logs of the statistics. */
+#define FRAME_STATS_DEFAULT_LOG_INTERVAL 10.0f
+
+/** @brief The times of a stage of the frame over the window. */
+typedef struct FrameStageStats {
+    /** @brief The name of the scope of the stage. */
+    const char* Name;
+    /** @brief The time the stage took in the last frame, in milliseconds. */
+    f32 LastMs;
+    /** @brief The average time the stage took, in milliseconds. */
+    f32 AverageMs;
+    /** @brief The longest time the stage took, in milliseconds. */
+    f32 MaxMs;
+} FrameStageStats;
+
+/** @brief The frame time statistics over the window. */
+typedef struct FrameStats {
+    /** @brief The number of frames measured since the statistics were initialized. */
+    u64 FrameCount;
+    /** @brief The number of frames in the window. */
+    u32 SampleCount;
+    /** @brief The time the last frame took, in milliseconds. */
+    f32 LastMs;
+    /** @brief The average frame time, in milliseconds. */
+    f32 AverageMs;
+    /** @brief The median frame time, in milliseconds, to the precision of the histogram. */
+    f32 P50Ms;
+    /** @brief The 95th percentile of the frame time, in milliseconds, to the precision of the histogram. */
+    f32 P95Ms;
+    /** @brief The 99th percentile of the frame time, in milliseconds, to the precision of the histogram. */
+    f32 P99Ms;
+    /** @brief The longest frame time, in milliseconds. */
+    f32 MaxMs;
+    /** @brief The number of hitches since the statistics were initialized. */
+    u64 HitchCount;
+    /** @brief The number of stages in Stages. */
+    u32 StageCount;
+    /** @brief The stages of the frame, in the order they were first seen. */
+    FrameStageStats Stages[FRAME_STATS_MAX_STAGES];
+} FrameStats;
+
+/**
+ * @brief Initializes the frame statistics.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 FrameStatsInit();
+
+/** @brief Shuts the frame statistics down. */
+ELSA_API void FrameStatsShutdown();
+
+/**
+ * @brief Marks the beginning of a frame. Must be called from the main thread.
+ * @returns The number of seconds elapsed since the beginning of the last frame, or 0 for the first frame.
+ */
+ELSA_API f64 FrameStatsBeginFrame();
+
+/**
+ * @brief Marks the end of a frame, after ProfilerEndFrame. Records the time of the frame
+ * and of its stages, reports a hitch if the frame was too slow, and logs the statistics
+ * when the log interval has elapsed. Must be called from the main thread.
+ *
+ * The stages are the scopes directly inside the top-level scopes of the main thread,
+ * such as the stages of ApplicationRun inside its "Frame" scope.
+ */
+ELSA_API void FrameStatsEndFrame();
+
+/**
+ * @brief Gets the number of seconds elapsed between the beginnings of the last two frames.
+ * @returns The delta time in seconds.
+ */
+ELSA_API f64 FrameStatsGetDeltaTime();
+
+/**
+ * @brief Computes the statistics over the window.
+ * @param out_stats A pointer to hold the statistics.
+ */
+ELSA_API void FrameStatsGet(FrameStats* out_stats);
+
+/** @brief Logs the statistics over the window. */
+ELSA_API void FrameStatsLog();
+
+/**
+ * @brief Sets the duration above which a frame is a hitch.
+ * @param milliseconds The threshold in milliseconds, or 0 to stop detecting hitches.
+ */
+ELSA_API void FrameStatsSetHitchThreshold(f32 milliseconds);
+
+/**
+ * @brief Sets the time between two logs of the statistics.
+ * @param seconds The interval in seconds, or 0 to stop logging them periodically.
+ */
+ELSA_API void FrameStatsSetLogInterval(f32 seconds);
+
+#endif
@@ -0,0 +1,172 @@
+/**
+ * @file Hash.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains a fast 64-bit hash function for strings and
+ * arbitrary bytes, along with a string type carrying its precomputed hash.
+ * @version 1.0
+ * @date 2022-07-20
+ */
+#ifndef ELSA_HASH_H
+#define ELSA_HASH_H
+
+#include <Defines.h>
+
+// The hash follows the structure of wyhash: input is consumed 16 bytes per step
+// (48 bytes per step for long inputs), and every step folds two words together
+// with a full 64x64 -> 128 bit multiplication.
+#define HASH_SECRET_0 0xA0761D6478BD642Full
+#define HASH_SECRET_1 0xE7037ED1A0B428DBull
+#define HASH_SECRET_2 0x8EBC6AF09C88C6E3ull
+#define HASH_SECRET_3 0x589965CC75374CC3ull
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#pragma intrinsic(_umul128)
+#endif
+
+/**
+ * @brief Multiplies two 64-bit values and folds the 128-bit product back into 64 bits.
+ * @param a The first value.
+ * @param b The second value.
+ * @returns The low half of the product xored with the high half.
+ */
+ELSA_INLINE u64 HashMix(u64 a, u64 b)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	u64 high;
+	u64 low = _umul128(a, b, &high);
+	return low ^ high;
+#else
+	__uint128_t product = (__uint128_t)a * b;
+	return (u64)product ^ (u64)(product >> 64);
+#endif
+}
+
+/**
+ * @brief Reads an unaligned little-endian 64-bit value.
+ * @param bytes A pointer to the bytes to read.
+ * @returns The value read.
+ */
+ELSA_INLINE u64 HashRead64(const u8* bytes)
+{
+	u64 value;
+	__builtin_memcpy(&value, bytes, sizeof(value));
+	return value;
+}
+
+/**
+ * @brief Reads an unaligned little-endian 32-bit value.
+ * @param bytes A pointer to the bytes to read.
+ * @returns The value read, widened to 64 bits.
+ */
+ELSA_INLINE u64 HashRead32(const u8* bytes)
+{
+	u32 value;
+	__builtin_memcpy(&value, bytes, sizeof(value));
+	return value;
+}
+
+/**
+ * @brief Hashes a block of bytes. When called with constant input, such as a string
+ * literal, optimizing compilers fold the whole computation into a constant.
+ * @param data A pointer to the bytes to hash.
+ * @param length The number of bytes to hash.
+ * @param seed A seed to vary the hash with. Pass 0 for the default.
+ * @returns The 64-bit hash of the bytes.
+ */
+ELSA_INLINE u64 HashBytes(const void* data, u64 length, u64 seed)
+{
+	const u8* bytes = (const u8*)data;
+	seed ^= HashMix(seed ^ HASH_SECRET_0, HASH_SECRET_1);
+
+	u64 a = 0;
+	u64 b = 0;
+	if (length <= 16) {
+		if (length >= 4) {
+			u64 middle = (length >> 3) << 2;
+			a = (HashRead32(bytes) << 32) | HashRead32(bytes + middle);
+			b = (HashRead32(bytes + length - 4) << 32) | HashRead32(bytes + length - 4 - middle);
+		} else if (length > 0) {
+			a = ((u64)bytes[0] << 16) | ((u64)bytes[length >> 1] << 8) | bytes[length - 1];
+		}
+	} else {
+		u64 remaining = length;
+		if (remaining > 48) {
+			u64 seed1 = seed;
+			u64 seed2 = seed;
+			do {
+				seed = HashMix(HashRead64(bytes) ^ HASH_SECRET_1, HashRead64(bytes + 8) ^ seed);
+				seed1 = HashMix(HashRead64(bytes + 16) ^ HASH_SECRET_2, HashRead64(bytes + 24) ^ seed1);
+				seed2 = HashMix(HashRead64(bytes + 32) ^ HASH_SECRET_3, HashRead64(bytes + 40) ^ seed2);
+				bytes += 48;
+				remaining -= 48;
+			} while (remaining > 48);
+			seed ^= seed1 ^ seed2;
+		}
+
+		while (remaining > 16) {
+			seed = HashMix(HashRead64(bytes) ^ HASH_SECRET_1, HashRead64(bytes + 8) ^ seed);
+			bytes += 16;
+			remaining -= 16;
+		}
+
+		a = HashRead64(bytes + remaining - 16);
+		b = HashRead64(bytes + remaining - 8);
+	}
+
+	a ^= HASH_SECRET_1;
+	b ^= seed;
+#if defined(_MSC_VER) && !defined(__clang__)
+	u64 high;
+	a = _umul128(a, b, &high);
+	b = high;
+#else
+	__uint128_t product = (__uint128_t)a * b;
+	a = (u64)product;
+	b = (u64)(product >> 64);
+#endif
+	return HashMix(a ^ HASH_SECRET_0 ^ length, b ^ HASH_SECRET_1);
+}
+
+/**
+ * @brief Hashes a null-terminated string, excluding the terminator.
+ * @param string The string to hash.
+ * @returns The 64-bit hash of the string.
+ */
+ELSA_INLINE u64 HashString(const char* string)
+{
+	return HashBytes(string, __builtin_strlen(string), 0);
+}
+
+/**
+ * @brief A string paired with its hash, so that the hash is only computed once
+ * no matter how many lookups the string is used for.
+ */
+typedef struct HashedString {
+	/** @brief The string. Not owned. */
+	const char* String;
+	/** @brief The hash of the string, as returned by HashString. */
+	u64 Hash;
+} HashedString;
+
+/**
+ * @brief Creates a hashed string, hashing the string at runtime.
+ * @param string The string. Must outlive the hashed string.
+ * @returns The hashed string.
+ */
+ELSA_INLINE HashedString HashedStringCreate(const char* string)
+{
+	HashedString hashed = { string, HashString(string) };
+	return hashed;
+}
+
+/**
+ * @brief Creates a hashed string from a string literal. The length is known at compile
+ * time, so optimizing compilers evaluate the hash at compile time too.
+ * @param literal The string literal.
+ * @returns The hashed string.
+ */
+#define HASHED_STRING(literal) \
+((HashedString){ literal, HashBytes(literal, sizeof(literal) - 1, 0) })
+
+#endif
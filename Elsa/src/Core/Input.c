@@ -2,15 +2,17 @@
 
 #include <Platform/Platform.h>
 #include <Core/Event.h>
+#include <Containers/Bitset.h>
 
+// Key and button states are bitsets, so that saving them every frame is a couple of vector stores.
 typedef struct KeyboardState {
-    b8 Keys[256];
+    u64 Keys[BITSET_WORDS(256)];
 } KeyboardState;
 
 typedef struct MouseState {
     i16 X;
     i16 Y;
-    u8 Buttons[BUTTON_MAX_BUTTONS];
+    u64 Buttons[BITSET_WORDS(BUTTON_MAX_BUTTONS)];
 } MouseState;
 
 typedef struct ControllerState {
@@ -35,8 +37,8 @@ static InputState state;
 
 void InputUpdate()
 {
-    PlatformCopyMemory(&state.KeyboardPrevious, &state.KeyboardCurrent, sizeof(KeyboardState));
-    PlatformCopyMemory(&state.MousePrevious, &state.MouseCurrent, sizeof(MouseState));
+    state.KeyboardPrevious = state.KeyboardCurrent;
+    state.MousePrevious = state.MouseCurrent;
 
     for (i32 i = 0; i < 4; i++) {
         PlatformCopyMemory(&state.GamepadPrevious[i], &state.GamepadCurrent[i], sizeof(ControllerState));
@@ -45,23 +47,23 @@ void InputUpdate()
 
 void InputProcessKey(Keys key, b8 pressed)
 {
-    if (state.KeyboardCurrent.Keys[key] != pressed) {
-        state.KeyboardCurrent.Keys[key] = pressed;
+    if (BitsetTest(state.KeyboardCurrent.Keys, key) != pressed) {
+        BitsetAssign(state.KeyboardCurrent.Keys, key, pressed);
 
         Event event;
         event.data.u16[0] = key;
-        EventFire(pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, event);
+        EventPost(pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, event);
     }
 }
 
 void InputProcessButton(Buttons button, b8 pressed)
 {
-    if (state.MouseCurrent.Buttons[button] != pressed) {
-        state.MouseCurrent.Buttons[button] = pressed;
+    if (BitsetTest(state.MouseCurrent.Buttons, button) != pressed) {
+        BitsetAssign(state.MouseCurrent.Buttons, button, pressed);
 
         Event event;
         event.data.u16[0] = button;
-        EventFire(pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED, 0, event);
+        EventPost(pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED, 0, event);
     }
 }
 
@@ -75,7 +77,7 @@ void InputProcessMouseMove(i16 x, i16 y)
         Event event;
         event.data.u16[0] = x;
         event.data.u16[1] = y;
-        EventFire(EVENT_CODE_MOUSE_MOVED, 0, event);
+        EventPost(EVENT_CODE_MOUSE_MOVED, 0, event);
     }
 }
 
@@ -83,47 +85,47 @@ void InputProcessMouseWheel(i8 z_delta)
 {
     Event event;
     event.data.u8[0] = z_delta;
-    EventFire(EVENT_CODE_MOUSE_WHEEL, 0, event);
+    EventPost(EVENT_CODE_MOUSE_WHEEL, 0, event);
 }
 
 b8 InputIsKeyDown(Keys key)
 {
-    return state.KeyboardCurrent.Keys[key] == true;
+    return BitsetTest(state.KeyboardCurrent.Keys, key);
 }
 
 b8 InputIsKeyUp(Keys key)
 {
-    return state.KeyboardCurrent.Keys[key] == false;
+    return !BitsetTest(state.KeyboardCurrent.Keys, key);
 }
 
 b8 InputWasKeyDown(Keys key)
 {
-    return state.KeyboardPrevious.Keys[key] == true;
+    return BitsetTest(state.KeyboardPrevious.Keys, key);
 }
 
 b8 InputWasKeyUp(Keys key)
 {
-    return state.KeyboardPrevious.Keys[key] == false;
+    return !BitsetTest(state.KeyboardPrevious.Keys, key);
 }
 
 b8 InputIsButtonDown(Buttons button)
 {
-    return state.MouseCurrent.Buttons[button] == true;
+    return BitsetTest(state.MouseCurrent.Buttons, button);
 }
 
 b8 InputIsButtonUp(Buttons button)
 {
-    return state.MouseCurrent.Buttons[button] == false;
+    return !BitsetTest(state.MouseCurrent.Buttons, button);
 }
 
 b8 InputWasButtonDown(Buttons button)
 {
-    return state.MousePrevious.Buttons[button] == true;
+    return BitsetTest(state.MousePrevious.Buttons, button);
 }
 
 b8 InputWasButtonUp(Buttons button)
 {
-    return state.MousePrevious.Buttons[button] == false;
+    return !BitsetTest(state.MousePrevious.Buttons, button);
 }
 
 void InputGetMousePosition(i32* x, i32* y)
@@ -192,7 +194,7 @@ void InputProcessGamepadButton(i32 index, GamepadButtons button, b8 pressed)
 
     Event event;
     event.data.u16[0] = button;
-    EventFire(pressed ? EVENT_CODE_GAMEPAD_BUTTON_PRESSED : EVENT_CODE_GAMEPAD_BUTTON_RELEASED, 0, event);
+    EventPost(pressed ? EVENT_CODE_GAMEPAD_BUTTON_PRESSED : EVENT_CODE_GAMEPAD_BUTTON_RELEASED, 0, event);
 }
 
 void InputProcessGamepadBattery(i32 index, f32 value)
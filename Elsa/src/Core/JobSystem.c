@@ -0,0 +1,413 @@
+#include "JobSystem.h"
+
+#include <Containers/MpmcQueue.h>
+#include <Containers/WorkStealingDeque.h>
+#include <Core/Logger.h>
+#include <Core/MemTracker.h>
+#include <Core/Profiler.h>
+#include <Platform/Platform.h>
+
+#include <stdio.h>
+
+typedef struct JobWorker {
+    // The jobs pushed by the thread. Padded onto its own cache lines.
+    WorkStealingDeque Deque;
+    PlatformThread Thread;
+    u32 Index;
+    // The state of the xorshift picking the first thread to steal from.
+    u32 Random;
+} JobWorker;
+
+typedef struct JobSystemState {
+    u32 ThreadCount;
+    u32 Running;
+    // The number of threads asleep on WakeUp, or about to be.
+    u32 Sleeping;
+    PlatformSemaphore WakeUp;
+    // The jobs submitted by threads outside the pool.
+    MpmcQueue Injected;
+    JobWorker* Workers;
+} JobSystemState;
+
+static JobSystemState jobs;
+
+// The names of the worker threads in the profile, which must outlive the job system.
+static char job_thread_names[JOB_SYSTEM_MAX_THREADS][24];
+
+// The index of the calling thread in the pool plus one, 0 for threads outside of it.
+static ELSA_THREAD_LOCAL u32 job_thread_slot;
+
+b8 JobSystemIsRunning()
+{
+    return AtomicLoad(&jobs.Running, ATOMIC_ACQUIRE) != 0;
+}
+
+JobWorker* JobSystemGetWorker()
+{
+    return job_thread_slot ? &jobs.Workers[job_thread_slot - 1] : 0;
+}
+
+// Wakes up to count sleeping threads after jobs were pushed.
+void JobSystemWake(u32 count)
+{
+    // Pairs with the fence of JobSystemSleep: either the sleeper sees the jobs, or this sees the sleeper.
+    AtomicThreadFence(ATOMIC_SEQ_CST);
+    u32 sleeping = AtomicLoad(&jobs.Sleeping, ATOMIC_RELAXED);
+    if (sleeping)
+        PlatformSemaphoreSignal(&jobs.WakeUp, count < sleeping ? count : sleeping);
+}
+
+void JobExecute(Job* job);
+
+// Hands a job to the calling thread's deque, or to the injection queue for threads outside the pool.
+// Returns false if it ran the job instead, which it does when the job system isn't running.
+b8 JobSchedule(Job* job)
+{
+    if (JobSystemIsRunning()) {
+        JobWorker* worker = JobSystemGetWorker();
+        if (worker ? WorkStealingDequePush(&worker->Deque, job) : MpmcQueuePush(&jobs.Injected, &job))
+            return true;
+    }
+
+    JobExecute(job);
+    return false;
+}
+
+void JobScheduleList(Job* job)
+{
+    u32 scheduled = 0;
+    while (job) {
+        // The job may finish and be released as soon as it's scheduled.
+        Job* next = job->Next;
+        scheduled += JobSchedule(job);
+        job = next;
+    }
+    if (scheduled)
+        JobSystemWake(scheduled);
+}
+
+void JobCounterDecrement(JobCounter* counter)
+{
+    // Only the decrement to zero is made under the lock, so that waiters can tell when
+    // nothing touches the counter anymore by waiting for the lock to be released.
+    u32 value = AtomicLoad(&counter->Value, ATOMIC_RELAXED);
+    while (value > 1) {
+        if (AtomicCompareExchangeWeak(&counter->Value, &value, value - 1, ATOMIC_ACQ_REL, ATOMIC_RELAXED))
+            return;
+    }
+
+    Job* waiting = 0;
+    SpinLockAcquire(&counter->Lock);
+    if (AtomicFetchSub(&counter->Value, 1, ATOMIC_ACQ_REL) == 1) {
+        waiting = counter->Waiting;
+        counter->Waiting = 0;
+    }
+    SpinLockRelease(&counter->Lock);
+
+    if (waiting)
+        JobScheduleList(waiting);
+}
+
+void JobExecute(Job* job)
+{
+    JobCounter* signal = job->Signal;
+    job->Function(job->Data);
+    if (signal)
+        JobCounterDecrement(signal);
+}
+
+// Takes a job from the deque of the worker, the injection queue, or the deque of another thread.
+Job* JobFind(JobWorker* worker)
+{
+    Job* job;
+    if (worker && WorkStealingDequePop(&worker->Deque, (void**)&job))
+        return job;
+    if (MpmcQueuePop(&jobs.Injected, &job))
+        return job;
+
+    u32 count = jobs.ThreadCount;
+    u32 start = 0;
+    if (worker) {
+        worker->Random ^= worker->Random << 13;
+        worker->Random ^= worker->Random >> 17;
+        worker->Random ^= worker->Random << 5;
+        start = worker->Random % count;
+    }
+    for (u32 i = 0; i < count; i++) {
+        JobWorker* victim = &jobs.Workers[(start + i) % count];
+        if (victim != worker && WorkStealingDequeSteal(&victim->Deque, (void**)&job))
+            return job;
+    }
+    return 0;
+}
+
+void JobSystemSleep(JobWorker* worker)
+{
+    AtomicFetchAdd(&jobs.Sleeping, 1, ATOMIC_SEQ_CST);
+    AtomicThreadFence(ATOMIC_SEQ_CST);
+
+    // Jobs pushed before the thread counted itself as sleeping didn't wake anyone up.
+    Job* job = JobFind(worker);
+    if (job) {
+        AtomicFetchSub(&jobs.Sleeping, 1, ATOMIC_SEQ_CST);
+        JobExecute(job);
+        return;
+    }
+    if (JobSystemIsRunning())
+        PlatformSemaphoreWait(&jobs.WakeUp);
+    AtomicFetchSub(&jobs.Sleeping, 1, ATOMIC_SEQ_CST);
+}
+
+u32 JobWorkerMain(void* param)
+{
+    JobWorker* worker = (JobWorker*)param;
+    job_thread_slot = worker->Index + 1;
+    ProfilerSetThreadName(job_thread_names[worker->Index]);
+
+    u32 idle = 0;
+    while (JobSystemIsRunning()) {
+        Job* job = JobFind(worker);
+        if (job) {
+            JobExecute(job);
+            idle = 0;
+        } else if (++idle < JOB_SPIN_COUNT) {
+            ELSA_CPU_PAUSE();
+        } else {
+            JobSystemSleep(worker);
+            idle = 0;
+        }
+    }
+
+    MemoryTrackerFlushThreadCache();
+    return 0;
+}
+
+b8 JobSystemInit(u32 thread_count)
+{
+    if (thread_count == 0)
+        thread_count = PlatformGetProcessorCount();
+    if (thread_count > JOB_SYSTEM_MAX_THREADS)
+        thread_count = JOB_SYSTEM_MAX_THREADS;
+
+    PlatformZeroMemory(&jobs, sizeof(jobs));
+    jobs.Workers = MemoryTrackerAlloc(sizeof(JobWorker) * thread_count, MEMORY_TAG_ENGINE_GENERAL);
+    if (!jobs.Workers) {
+        ELSA_ERROR("JobSystemInit - Failed to allocate %u workers!", thread_count);
+        return false;
+    }
+    PlatformZeroMemory(jobs.Workers, sizeof(JobWorker) * thread_count);
+    jobs.ThreadCount = thread_count;
+
+    if (!PlatformSemaphoreCreate(0, &jobs.WakeUp) ||
+        !MpmcQueueCreate(sizeof(Job*), JOB_INJECT_CAPACITY, &jobs.Injected)) {
+        ELSA_ERROR("JobSystemInit - Failed to create the job queues.");
+        JobSystemShutdown();
+        return false;
+    }
+    for (u32 i = 0; i < thread_count; i++) {
+        JobWorker* worker = &jobs.Workers[i];
+        worker->Index = i;
+        worker->Random = 0x9E3779B9u * (i + 1);
+        if (!WorkStealingDequeCreate(JOB_DEQUE_CAPACITY, &worker->Deque)) {
+            ELSA_ERROR("JobSystemInit - Failed to create the job queues.");
+            JobSystemShutdown();
+            return false;
+        }
+        if (i)
+            snprintf(job_thread_names[i], sizeof(job_thread_names[i]), "Job worker %u", i);
+    }
+
+    // The calling thread is the first of the pool, and keeps running wherever the OS puts it.
+    job_thread_slot = 1;
+    AtomicStore(&jobs.Running, 1, ATOMIC_RELEASE);
+
+    u32 processor_count = PlatformGetProcessorCount();
+    u32 pinned = 0;
+    for (u32 i = 1; i < thread_count; i++) {
+        JobWorker* worker = &jobs.Workers[i];
+        if (!PlatformThreadCreate(JobWorkerMain, worker, &worker->Thread)) {
+            ELSA_ERROR("JobSystemInit - Failed to start worker thread %u.", i);
+            JobSystemShutdown();
+            return false;
+        }
+        if (thread_count <= processor_count)
+            pinned += PlatformThreadSetAffinity(&worker->Thread, i);
+    }
+
+    ELSA_INFO("Job system initialized with %u threads, %u workers pinned.", thread_count, pinned);
+    return true;
+}
+
+void JobSystemShutdown()
+{
+    AtomicStore(&jobs.Running, 0, ATOMIC_RELEASE);
+    if (jobs.Workers) {
+        if (jobs.WakeUp.Handle)
+            PlatformSemaphoreSignal(&jobs.WakeUp, jobs.ThreadCount);
+        for (u32 i = 1; i < jobs.ThreadCount; i++) {
+            if (jobs.Workers[i].Thread.Handle)
+                PlatformThreadJoin(&jobs.Workers[i].Thread);
+        }
+        for (u32 i = 0; i < jobs.ThreadCount; i++)
+            WorkStealingDequeDestroy(&jobs.Workers[i].Deque);
+        MemoryTrackerFree(jobs.Workers, sizeof(JobWorker) * jobs.ThreadCount, MEMORY_TAG_ENGINE_GENERAL);
+    }
+    MpmcQueueDestroy(&jobs.Injected);
+    PlatformSemaphoreDestroy(&jobs.WakeUp);
+
+    PlatformZeroMemory(&jobs, sizeof(jobs));
+    job_thread_slot = 0;
+}
+
+u32 JobSystemGetThreadCount()
+{
+    return jobs.ThreadCount ? jobs.ThreadCount : 1;
+}
+
+u32 JobSystemGetThreadIndex()
+{
+    return job_thread_slot ? job_thread_slot - 1 : JOB_THREAD_NONE;
+}
+
+void JobSystemRun(Job* jobs_to_run, u32 count, JobCounter* signal)
+{
+    JobSystemRunAfter(jobs_to_run, count, 0, signal);
+}
+
+void JobSystemRunAfter(Job* jobs_to_run, u32 count, JobCounter* dependency, JobCounter* signal)
+{
+    if (count == 0)
+        return;
+
+    if (signal)
+        AtomicFetchAdd(&signal->Value, count, ATOMIC_RELAXED);
+    for (u32 i = 0; i < count; i++) {
+        jobs_to_run[i].Signal = signal;
+        jobs_to_run[i].Next = i + 1 < count ? &jobs_to_run[i + 1] : 0;
+    }
+
+    if (dependency) {
+        SpinLockAcquire(&dependency->Lock);
+        if (AtomicLoad(&dependency->Value, ATOMIC_ACQUIRE) != 0) {
+            jobs_to_run[count - 1].Next = dependency->Waiting;
+            dependency->Waiting = jobs_to_run;
+            SpinLockRelease(&dependency->Lock);
+            return;
+        }
+        SpinLockRelease(&dependency->Lock);
+    }
+
+    JobScheduleList(jobs_to_run);
+}
+
+void JobSystemWait(JobCounter* counter)
+{
+    JobWorker* worker = JobSystemGetWorker();
+    u32 idle = 0;
+    while (AtomicLoad(&counter->Value, ATOMIC_ACQUIRE) != 0) {
+        Job* job = jobs.ThreadCount ? JobFind(worker) : 0;
+        if (job) {
+            JobExecute(job);
+            idle = 0;
+        } else if (++idle < JOB_SPIN_COUNT) {
+            ELSA_CPU_PAUSE();
+        } else {
+            // The jobs left are running on other threads.
+            PlatformSleep(0);
+        }
+    }
+    // The thread that brought the counter to zero may still be releasing its lock.
+    while (AtomicLoad(&counter->Lock.Locked, ATOMIC_ACQUIRE))
+        ELSA_CPU_PAUSE();
+}
+
+b8 JobCounterIsDone(JobCounter* counter)
+{
+    return AtomicLoad(&counter->Value, ATOMIC_ACQUIRE) == 0 && !AtomicLoad(&counter->Lock.Locked, ATOMIC_ACQUIRE);
+}
+
+typedef struct JobParallelForRange {
+    PFN_ParallelFor Function;
+    void* Data;
+    u32 Begin;
+    u32 End;
+} JobParallelForRange;
+
+void JobParallelForRun(void* data)
+{
+    JobParallelForRange* range = (JobParallelForRange*)data;
+    range->Function(range->Data, range->Begin, range->End);
+}
+
+void JobSystemParallelFor(u32 count, u32 grain, PFN_ParallelFor function, void* data)
+{
+    if (count == 0)
+        return;
+
+    u32 thread_count = JobSystemGetThreadCount();
+    if (grain == 0) {
+        grain = count / (thread_count * JOB_PARALLEL_FOR_JOBS_PER_THREAD);
+        if (grain == 0)
+            grain = 1;
+    }
+    u32 job_count = (count + grain - 1) / grain;
+    if (job_count > JOB_PARALLEL_FOR_MAX_JOBS) {
+        grain = (count + JOB_PARALLEL_FOR_MAX_JOBS - 1) / JOB_PARALLEL_FOR_MAX_JOBS;
+        job_count = (count + grain - 1) / grain;
+    }
+    if (job_count == 1 || thread_count == 1) {
+        function(data, 0, count);
+        return;
+    }
+
+    Job range_jobs[JOB_PARALLEL_FOR_MAX_JOBS];
+    JobParallelForRange ranges[JOB_PARALLEL_FOR_MAX_JOBS];
+    for (u32 i = 0; i < job_count; i++) {
+        ranges[i].Function = function;
+        ranges[i].Data = data;
+        ranges[i].Begin = i * grain;
+        ranges[i].End = i + 1 < job_count ? (i + 1) * grain : count;
+        range_jobs[i].Function = JobParallelForRun;
+        range_jobs[i].Data = &ranges[i];
+    }
+
+    JobCounter counter = {0};
+    JobSystemRun(range_jobs + 1, job_count - 1, &counter);
+    JobParallelForRun(&ranges[0]);
+    JobSystemWait(&counter);
+}
+
+typedef struct JobSortWorker {
+    SortTask Task;
+    void* TaskData;
+    u32 WorkerIndex;
+} JobSortWorker;
+
+void JobSortWorkerRun(void* data)
+{
+    JobSortWorker* worker = (JobSortWorker*)data;
+    worker->Task(worker->TaskData, worker->WorkerIndex);
+}
+
+void JobSystemSortDispatch(SortTask task, void* task_data, u32 worker_count, void* user_data)
+{
+    if (worker_count > SORT_MAX_WORKERS)
+        worker_count = SORT_MAX_WORKERS;
+    if (worker_count == 0)
+        return;
+
+    Job sort_jobs[SORT_MAX_WORKERS];
+    JobSortWorker workers[SORT_MAX_WORKERS];
+    for (u32 i = 0; i < worker_count; i++) {
+        workers[i].Task = task;
+        workers[i].TaskData = task_data;
+        workers[i].WorkerIndex = i;
+        sort_jobs[i].Function = JobSortWorkerRun;
+        sort_jobs[i].Data = &workers[i];
+    }
+
+    JobCounter counter = {0};
+    JobSystemRun(sort_jobs + 1, worker_count - 1, &counter);
+    JobSortWorkerRun(&workers[0]);
+    JobSystemWait(&counter);
+}
@@ -0,0 +1,163 @@
+/**
+ * @file JobSystem.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains the job system, which runs small functions on a fixed pool
+ * of worker threads. Every thread of the pool owns a work-stealing deque: jobs are pushed
+ * to the deque of the thread that runs them, and idle threads steal from the others.
+ * Jobs signal counters as they finish, which is how callers wait for them and how
+ * batches of jobs are made to depend on each other.
+ * @version 1.0
+ * @date 2022-07-31
+ */
+#ifndef ELSA_JOB_SYSTEM_H
+#define ELSA_JOB_SYSTEM_H
+
+#include <Defines.h>
+#include <Core/Atomic.h>
+#include <Containers/Sort.h>
+
+/** @brief The maximum number of threads in the pool, including the thread that initialized it. */
+#define JOB_SYSTEM_MAX_THREADS 64
+
+/** @brief The number of jobs the deque of a thread holds. Jobs pushed to a full deque run right away. */
+#define JOB_DEQUE_CAPACITY 4096
+
+/** @brief The number of jobs threads outside the pool can submit before the pool takes them. */
+#define JOB_INJECT_CAPACITY 1024
+
+/** @brief The number of times an idle thread looks for a job before going to sleep. */
+#define JOB_SPIN_COUNT 256
+
+/** @brief The maximum number of jobs a parallel for is split into. */
+#define JOB_PARALLEL_FOR_MAX_JOBS 256
+
+/** @brief The number of jobs per thread a parallel for is split into when no grain size is given. */
+#define JOB_PARALLEL_FOR_JOBS_PER_THREAD 4
+
+/** @brief The index of threads outside the pool. */
+#define JOB_THREAD_NONE 0xFFFFFFFF
+
+/**
+ * @brief The function of a job.
+ * @param data The data of the job.
+ */
+typedef void (*PFN_Job)(void* data);
+
+/**
+ * @brief The function of a parallel for, called with consecutive ranges of the indices.
+ * @param data The data passed to JobSystemParallelFor.
+ * @param begin The first index of the range.
+ * @param end The index past the last one of the range.
+ */
+typedef void (*PFN_ParallelFor)(void* data, u32 begin, u32 end);
+
+struct Job;
+
+/**
+ * @brief Counts the jobs of one or more batches that haven't finished. A zeroed counter is
+ * ready to use, and can be reused once it reaches zero. Members of this structure should
+ * not be modified outside the functions associated with it.
+ */
+typedef struct JobCounter {
+    /** @brief The number of jobs that haven't finished. */
+    u32 Value;
+    /** @brief Guards Waiting, and the decrement of Value to zero. */
+    SpinLock Lock;
+    /** @brief The jobs to run once Value reaches zero, linked through their Next member. */
+    struct Job* Waiting;
+} JobCounter;
+
+/**
+ * @brief Represents a job. Jobs are owned by the caller, and must stay valid until they
+ * have finished, which callers ensure by waiting on the counter the jobs signal.
+ */
+typedef struct Job {
+    /** @brief The function of the job. */
+    PFN_Job Function;
+    /** @brief The data passed to the function. */
+    void* Data;
+
+    /** @brief The counter decremented once the job has finished. Set by the job system. */
+    JobCounter* Signal;
+    /** @brief The next job waiting on the same counter. Set by the job system. */
+    struct Job* Next;
+} Job;
+
+/**
+ * @brief Initializes the job system, starting a worker thread for every thread of the pool
+ * but the calling one, which takes part in the pool whenever it waits on a counter. Worker
+ * threads are pinned to their own logical processor.
+ * @param thread_count The number of threads of the pool, including the calling thread, or 0 for one per logical processor.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 JobSystemInit(u32 thread_count);
+
+/**
+ * @brief Stops the worker threads and shuts the job system down. Jobs that haven't run
+ * by then are dropped, so every counter should be waited on first.
+ */
+ELSA_API void JobSystemShutdown();
+
+/**
+ * @brief Gets the number of threads of the pool, including the thread that initialized it.
+ * @returns The number of threads, or 1 if the job system isn't running.
+ */
+ELSA_API u32 JobSystemGetThreadCount();
+
+/**
+ * @brief Gets the index of the calling thread in the pool.
+ * @returns The index, from 0 for the thread that initialized the pool, or JOB_THREAD_NONE for threads outside of it.
+ */
+ELSA_API u32 JobSystemGetThreadIndex();
+
+/**
+ * @brief Runs a batch of jobs. Safe to call from any thread, including from a job.
+ * When the job system isn't running, the jobs run before this returns.
+ * @param jobs The jobs to run. Must stay valid until they have finished.
+ * @param count The number of jobs.
+ * @param signal The counter the jobs decrement as they finish. Optional.
+ */
+ELSA_API void JobSystemRun(Job* jobs, u32 count, JobCounter* signal);
+
+/**
+ * @brief Runs a batch of jobs once a counter reaches zero, without blocking the calling thread.
+ * Safe to call from any thread, including from a job.
+ * @param jobs The jobs to run. Must stay valid until they have finished.
+ * @param count The number of jobs.
+ * @param dependency The counter to wait for. Optional; the jobs are run right away if 0.
+ * @param signal The counter the jobs decrement as they finish. Optional.
+ */
+ELSA_API void JobSystemRunAfter(Job* jobs, u32 count, JobCounter* dependency, JobCounter* signal);
+
+/**
+ * @brief Waits for a counter to reach zero, running jobs in the meantime. Once this returns,
+ * the job system doesn't touch the counter anymore, so it can go out of scope.
+ * @param counter The counter to wait on.
+ */
+ELSA_API void JobSystemWait(JobCounter* counter);
+
+/**
+ * @brief Indicates if every job signaling a counter has finished.
+ * @param counter The counter to check.
+ * @returns True if the counter is zero; otherwise false.
+ */
+ELSA_API b8 JobCounterIsDone(JobCounter* counter);
+
+/**
+ * @brief Calls function over the indices from 0 to count, split into ranges run as jobs,
+ * and waits for all of them. The calling thread runs the first range itself.
+ * @param count The number of indices.
+ * @param grain The number of indices per job, or 0 to split them into JOB_PARALLEL_FOR_JOBS_PER_THREAD jobs
+ * per thread. Raised if needed to stay within JOB_PARALLEL_FOR_MAX_JOBS jobs.
+ * @param function The function to call with each range.
+ * @param data The data passed to function.
+ */
+ELSA_API void JobSystemParallelFor(u32 count, u32 grain, PFN_ParallelFor function, void* data);
+
+/**
+ * @brief A SortDispatch that runs the workers of a parallel sort as jobs, e.g.
+ * RadixSort32Parallel(entries, scratch, count, JobSystemGetThreadCount(), JobSystemSortDispatch, 0).
+ */
+ELSA_API void JobSystemSortDispatch(SortTask task, void* task_data, u32 worker_count, void* user_data);
+
+#endif
@@ -1,34 +1,847 @@
 #include "Logger.h"
 
+#include <Containers/Darray.h>
+#include <Core/Atomic.h>
+#include <Core/MemTracker.h>
+#include <Platform/FileSystem.h>
 #include <Platform/Platform.h>
 
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <string.h>
+
+// Records are fixed size slots of a ring, claimed by the logging threads and written
+// out in order by the writer thread. Lines that don't fit a slot are allocated instead.
+#define LOG_RECORD_SIZE 512
+#define LOG_RING_CAPACITY 2048
+#define LOG_WRITE_BATCH_SIZE 16384
+#define LOG_FLUSH_TIMEOUT_MS 200
+#define LOG_DIRECT_BUFFER_SIZE 32000
+#define LOG_LINE_SIZE 4096
+#define LOG_SITE_TABLE_SIZE 4096
+
+#define LOG_RECORD_TEXT_SIZE (LOG_RECORD_SIZE - sizeof(u64) - sizeof(char*) - sizeof(LogCallSite*) - sizeof(u32) - sizeof(u8))
+
+// A binary log file starts with this, followed by entries that each start with their LogFileEntry.
+#define LOG_FILE_MAGIC "ELSALOG1"
+#define LOG_FILE_MAGIC_LENGTH 8
+
+typedef enum LogFileEntry {
+    // The index of a call site, its level, argument types, and format string.
+    LOG_FILE_ENTRY_SITE = 1,
+    // The index of a call site, and the encoded arguments of a line logged there.
+    LOG_FILE_ENTRY_LINE = 2,
+    // A line that was formatted when it was logged.
+    LOG_FILE_ENTRY_TEXT = 3
+} LogFileEntry;
+
+typedef struct LogRecord {
+    // Equals the position of the slot while it is free, and the position + 1 once the record is published.
+    u64 Sequence;
+    // The line, when it didn't fit in Text.
+    char* LongText;
+    // The call site of a binary line, whose encoded arguments are in Text. 0 for text lines.
+    const LogCallSite* Site;
+    u32 Length;
+    u8 Level;
+    char Text[LOG_RECORD_TEXT_SIZE];
+} LogRecord;
+
+// An argument decoded from a binary line.
+typedef struct LogArgValue {
+    u8 Type;
+    union {
+        i64 Signed;
+        u64 Unsigned;
+        f64 Double;
+        const char* Text;
+    };
+} LogArgValue;
+
+typedef struct LoggerState {
+    ELSA_ALIGN(ELSA_CACHE_LINE_SIZE) u64 EnqueuePos;
+    // Everything before this position has been written to the sinks.
+    ELSA_ALIGN(ELSA_CACHE_LINE_SIZE) u64 WrittenPos;
+    ELSA_ALIGN(ELSA_CACHE_LINE_SIZE) u32 Running;
+
+    LogRecord* Records;
+    PlatformThread Writer;
+    FileHandle File;
+    // Set when the file gets binary entries rather than text.
+    b8 BinaryFile;
+
+    // The rest is only used by the writer thread.
+    // Consecutive lines of the same level, written out with a single call.
+    char Batch[LOG_WRITE_BATCH_SIZE];
+    u64 BatchLength;
+    LogLevel BatchLevel;
+    // Binary entries waiting to be written to the file.
+    u8 FileBatch[LOG_WRITE_BATCH_SIZE];
+    u64 FileBatchLength;
+    // The call sites already written to the binary file, and the index each was given.
+    const LogCallSite* Sites[LOG_SITE_TABLE_SIZE];
+    u32 SiteIndices[LOG_SITE_TABLE_SIZE];
+    u32 SiteCount;
+    char Line[LOG_LINE_SIZE];
+} LoggerState;
+
+static LoggerState state;
+
+// Every level of every channel starts out logged.
+u64 log_channel_mask = 0x3F3F3F3F3F3F3F3Full;
+
+static const char* level_strings[6] = {"[FATAL]: ", "[ERROR]: ", "[WARN]:  ", "[INFO]:  ", "[DEBUG]: ", "[TRACE]: "};
+
+#define LOG_LEVEL_STRING_LENGTH 9
+
+void LogWriteConsole(LogLevel level, const char* text)
+{
+    if (level < LOG_LEVEL_WARN)
+        PlatformConsoleWriteError(text, level);
+    else
+        PlatformConsoleWrite(text, level);
+}
+
+void LogWriteSinks(LogLevel level, const char* text, u64 length)
+{
+    LogWriteConsole(level, text);
+
+    if (state.File.IsValid && !state.BinaryFile) {
+        u64 written = 0;
+        FileSystemWrite(&state.File, length, text, &written);
+    }
+}
+
+u64 LogPutVarint(u8* out, u64 value)
+{
+    u64 length = 0;
+    while (value >= 0x80) {
+        out[length++] = (u8)value | 0x80;
+        value >>= 7;
+    }
+    out[length++] = (u8)value;
+    return length;
+}
+
+// Reads a varint at *offset, and moves the offset past it.
+u64 LogGetVarint(const u8* in, u64 length, u64* offset)
+{
+    u64 value = 0;
+    for (u32 shift = 0; *offset < length && shift < 64; shift += 7) {
+        u8 byte = in[(*offset)++];
+        value |= (u64)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            break;
+    }
+    return value;
+}
+
+// Maps signed values to unsigned ones so that small negative values stay short as varints.
+u64 LogZigzag(i64 value)
+{
+    return ((u64)value << 1) ^ (u64)(value >> 63);
+}
+
+// Copies the arguments of a binary line into out. Numbers take at most 10 bytes
+// each, and strings are cut short to fit in what's left, setting out_truncated.
+u64 LogEncodeArgs(const LogCallSite* site, va_list args, u8* out, u64 capacity, b8* out_truncated)
+{
+    *out_truncated = false;
+    u32 arg_count = 0;
+    while (arg_count < LOG_BINARY_MAX_ARGS && site->ArgTypes[arg_count] != LOG_ARG_END)
+        arg_count++;
+
+    u64 length = 0;
+    for (u32 i = 0; i < arg_count; i++) {
+        switch (site->ArgTypes[i]) {
+            case LOG_ARG_INT: length += LogPutVarint(out + length, LogZigzag(va_arg(args, int))); break;
+            case LOG_ARG_UINT: length += LogPutVarint(out + length, va_arg(args, unsigned int)); break;
+            case LOG_ARG_LONG: length += LogPutVarint(out + length, LogZigzag(va_arg(args, long))); break;
+            case LOG_ARG_ULONG: length += LogPutVarint(out + length, va_arg(args, unsigned long)); break;
+            case LOG_ARG_LLONG: length += LogPutVarint(out + length, LogZigzag(va_arg(args, long long))); break;
+            case LOG_ARG_ULLONG: length += LogPutVarint(out + length, va_arg(args, unsigned long long)); break;
+            case LOG_ARG_DOUBLE: {
+                f64 value = va_arg(args, double);
+                PlatformCopyMemory(out + length, &value, sizeof(value));
+                length += sizeof(value);
+            } break;
+            case LOG_ARG_POINTER: {
+                void* pointer = va_arg(args, void*);
+                u64 value = 0;
+                PlatformCopyMemory(&value, &pointer, sizeof(pointer));
+                length += LogPutVarint(out + length, value);
+            } break;
+            case LOG_ARG_STRING: {
+                const char* text = va_arg(args, const char*);
+                if (!text)
+                    text = "(null)";
+                // Strings are stored with their terminator, leaving room for the arguments after them.
+                u64 reserved = length + (arg_count - i - 1) * 10 + 1;
+                u64 text_length = strlen(text);
+                if (reserved + text_length > capacity) {
+                    text_length = capacity > reserved ? capacity - reserved : 0;
+                    *out_truncated = true;
+                }
+                PlatformCopyMemory(out + length, text, text_length);
+                length += text_length;
+                out[length++] = 0;
+            } break;
+        }
+    }
+    return length;
+}
+
+u32 LogDecodeArgs(const u8* arg_types, const u8* payload, u64 payload_length, LogArgValue* out_values)
+{
+    u64 offset = 0;
+    u32 count = 0;
+    for (; count < LOG_BINARY_MAX_ARGS && arg_types[count] != LOG_ARG_END && offset < payload_length; count++) {
+        LogArgValue* value = &out_values[count];
+        value->Type = arg_types[count];
+        switch (value->Type) {
+            case LOG_ARG_INT:
+            case LOG_ARG_LONG:
+            case LOG_ARG_LLONG: {
+                u64 zigzag = LogGetVarint(payload, payload_length, &offset);
+                value->Signed = (i64)(zigzag >> 1) ^ -(i64)(zigzag & 1);
+            } break;
+            case LOG_ARG_DOUBLE:
+                if (offset + sizeof(f64) > payload_length)
+                    return count;
+                PlatformCopyMemory(&value->Double, payload + offset, sizeof(f64));
+                offset += sizeof(f64);
+                break;
+            case LOG_ARG_STRING:
+                value->Text = (const char*)payload + offset;
+                while (offset < payload_length && payload[offset])
+                    offset++;
+                // A string cut off by the end of the payload isn't terminated, so drop it.
+                if (offset++ >= payload_length)
+                    return count;
+                break;
+            default:
+                value->Unsigned = LogGetVarint(payload, payload_length, &offset);
+                break;
+        }
+    }
+    return count;
+}
+
+i64 LogArgInteger(const LogArgValue* value)
+{
+    if (!value || value->Type == LOG_ARG_STRING)
+        return 0;
+    return value->Type == LOG_ARG_DOUBLE ? (i64)value->Double : value->Signed;
+}
+
+// Formats the arguments of a binary line with its format string. Every conversion is
+// formatted on its own, with the length modifier replaced to match the decoded value.
+u64 LogFormatArgs(const char* format, const u8* arg_types, const u8* payload, u64 payload_length, char* out, u64 capacity)
+{
+    LogArgValue values[LOG_BINARY_MAX_ARGS];
+    u32 count = LogDecodeArgs(arg_types, payload, payload_length, values);
+    u32 next = 0;
+
+    u64 length = 0;
+    const char* f = format;
+    while (*f && length + 1 < capacity) {
+        if (*f != '%') {
+            out[length++] = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            out[length++] = '%';
+            f += 2;
+            continue;
+        }
+
+        // Flags, then the width and the precision, either of which can be taken from an argument.
+        char spec[48];
+        u32 spec_length = 0;
+        spec[spec_length++] = *f++;
+        while (*f && strchr("-+ #0", *f) && spec_length < 8)
+            spec[spec_length++] = *f++;
+        for (u32 part = 0; part < 2; part++) {
+            if (part == 1) {
+                if (*f != '.')
+                    break;
+                spec[spec_length++] = *f++;
+            }
+            if (*f == '*') {
+                i64 star = LogArgInteger(next < count ? &values[next++] : 0);
+                spec_length += snprintf(spec + spec_length, 12, "%d", (i32)star);
+                f++;
+            } else {
+                while (*f >= '0' && *f <= '9' && spec_length < 32)
+                    spec[spec_length++] = *f++;
+            }
+        }
+        while (*f && strchr("hljztLq", *f))
+            f++;
+        char conversion = *f;
+        if (!conversion)
+            break;
+        f++;
+
+        const LogArgValue* value = next < count ? &values[next++] : 0;
+        u64 remaining = capacity - length;
+        i32 written = 0;
+        switch (conversion) {
+            case 'd':
+            case 'i':
+            case 'o':
+            case 'u':
+            case 'x':
+            case 'X':
+                spec[spec_length++] = 'l';
+                spec[spec_length++] = 'l';
+                spec[spec_length++] = conversion;
+                spec[spec_length] = 0;
+                written = snprintf(out + length, remaining, spec, (long long)LogArgInteger(value));
+                break;
+            case 'c':
+                spec[spec_length++] = conversion;
+                spec[spec_length] = 0;
+                written = snprintf(out + length, remaining, spec, (int)LogArgInteger(value));
+                break;
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                spec[spec_length++] = conversion;
+                spec[spec_length] = 0;
+                written = snprintf(out + length, remaining, spec, value && value->Type == LOG_ARG_DOUBLE ? value->Double : (f64)LogArgInteger(value));
+                break;
+            case 's':
+                spec[spec_length++] = conversion;
+                spec[spec_length] = 0;
+                written = snprintf(out + length, remaining, spec, value && value->Type == LOG_ARG_STRING ? value->Text : "(?)");
+                break;
+            case 'p':
+                spec[spec_length++] = conversion;
+                spec[spec_length] = 0;
+                written = snprintf(out + length, remaining, spec, (void*)(__SIZE_TYPE__)(value ? value->Unsigned : 0));
+                break;
+            default:
+                break;
+        }
+
+        if (written > 0)
+            length += (u64)written < remaining ? (u64)written : remaining - 1;
+    }
+
+    out[length] = 0;
+    return length;
+}
+
+// Formats a binary line the way LogOutput would have: level, message and newline.
+u64 LogFormatLine(LogLevel level, const char* format, const u8* arg_types, const u8* payload, u64 payload_length, char* out, u64 capacity)
+{
+    PlatformCopyMemory(out, level_strings[level], LOG_LEVEL_STRING_LENGTH);
+    u64 length = LOG_LEVEL_STRING_LENGTH + LogFormatArgs(format, arg_types, payload, payload_length, out + LOG_LEVEL_STRING_LENGTH, capacity - LOG_LEVEL_STRING_LENGTH - 1);
+    out[length++] = '\n';
+    out[length] = 0;
+    return length;
+}
+
+// Formats and writes a line on the calling thread, for when the writer thread isn't running.
+void LogWriteDirect(LogLevel level, const char* message, va_list args)
+{
+    char out_message[LOG_DIRECT_BUFFER_SIZE];
+    PlatformCopyMemory(out_message, level_strings[level], LOG_LEVEL_STRING_LENGTH);
+
+    i32 length = vsnprintf(out_message + LOG_LEVEL_STRING_LENGTH, sizeof(out_message) - LOG_LEVEL_STRING_LENGTH - 1, message, args);
+    u64 end = LOG_LEVEL_STRING_LENGTH + (length < 0 ? 0 : length);
+    if (end > sizeof(out_message) - 2)
+        end = sizeof(out_message) - 2;
+    out_message[end++] = '\n';
+    out_message[end] = 0;
+
+    LogWriteSinks(level, out_message, end);
+}
+
+// Formats a line into a record, allocating it instead if it's too long for the slot.
+void LogFormatRecord(LogRecord* record, LogLevel level, const char* message, va_list args)
+{
+    va_list args_copy;
+    va_copy(args_copy, args);
+
+    PlatformCopyMemory(record->Text, level_strings[level], LOG_LEVEL_STRING_LENGTH);
+    u64 capacity = LOG_RECORD_TEXT_SIZE - LOG_LEVEL_STRING_LENGTH;
+    i32 length = vsnprintf(record->Text + LOG_LEVEL_STRING_LENGTH, capacity, message, args);
+    if (length < 0)
+        length = 0;
+
+    record->Level = (u8)level;
+    record->LongText = 0;
+    record->Site = 0;
+    // Keep room for the newline, and the terminator the console functions need.
+    if ((u64)length + 2 <= capacity) {
+        record->Length = LOG_LEVEL_STRING_LENGTH + length + 1;
+        record->Text[record->Length - 1] = '\n';
+        record->Text[record->Length] = 0;
+    } else if ((record->LongText = PlatformAlloc(LOG_LEVEL_STRING_LENGTH + (u64)length + 2)) != 0) {
+        PlatformCopyMemory(record->LongText, level_strings[level], LOG_LEVEL_STRING_LENGTH);
+        vsnprintf(record->LongText + LOG_LEVEL_STRING_LENGTH, length + 1, message, args_copy);
+        record->Length = LOG_LEVEL_STRING_LENGTH + length + 1;
+        record->LongText[record->Length - 1] = '\n';
+        record->LongText[record->Length] = 0;
+    } else {
+        // Keep what fits, rather than lose the line.
+        record->Length = LOG_RECORD_TEXT_SIZE - 1;
+        record->Text[record->Length - 1] = '\n';
+        record->Text[record->Length] = 0;
+    }
+
+    va_end(args_copy);
+}
+
+// Claims the next slot of the ring. Publish it by storing position + 1 to its sequence.
+LogRecord* LogClaimRecord(u64* out_position)
+{
+    u64 position = AtomicLoad(&state.EnqueuePos, ATOMIC_RELAXED);
+    for (;;) {
+        LogRecord* record = &state.Records[position & (LOG_RING_CAPACITY - 1)];
+        u64 sequence = AtomicLoad(&record->Sequence, ATOMIC_ACQUIRE);
+        i64 difference = (i64)(sequence - position);
+        if (difference == 0) {
+            if (AtomicCompareExchangeWeak(&state.EnqueuePos, &position, position + 1, ATOMIC_RELAXED, ATOMIC_RELAXED)) {
+                *out_position = position;
+                return record;
+            }
+        } else if (difference < 0) {
+            // The ring is full, so wait for the writer to catch up rather than drop the line.
+            PlatformSleep(0);
+            position = AtomicLoad(&state.EnqueuePos, ATOMIC_RELAXED);
+        } else {
+            position = AtomicLoad(&state.EnqueuePos, ATOMIC_RELAXED);
+        }
+    }
+}
+
+void LogEnqueue(LogLevel level, const char* message, va_list args)
+{
+    u64 position;
+    LogRecord* record = LogClaimRecord(&position);
+    LogFormatRecord(record, level, message, args);
+    AtomicStore(&record->Sequence, position + 1, ATOMIC_RELEASE);
+}
+
+void LogFlushBatch()
+{
+    if (state.BatchLength) {
+        LogWriteSinks(state.BatchLevel, state.Batch, state.BatchLength);
+        state.BatchLength = 0;
+    }
+}
+
+// Adds a line to the batch, writing the batch out first if the level changes or it's full.
+void LogBatchLine(LogLevel level, const char* text, u64 length)
+{
+    if (state.BatchLength && (level != state.BatchLevel || state.BatchLength + length >= LOG_WRITE_BATCH_SIZE))
+        LogFlushBatch();
+
+    if (length >= LOG_WRITE_BATCH_SIZE) {
+        LogWriteSinks(level, text, length);
+        return;
+    }
+    PlatformCopyMemory(state.Batch + state.BatchLength, text, length);
+    state.BatchLength += length;
+    state.Batch[state.BatchLength] = 0;
+    state.BatchLevel = level;
+}
+
+void LogFlushFile()
+{
+    if (state.FileBatchLength) {
+        u64 written = 0;
+        FileSystemWrite(&state.File, state.FileBatchLength, state.FileBatch, &written);
+        state.FileBatchLength = 0;
+    }
+}
+
+void LogFileWrite(const void* data, u64 length)
+{
+    if (state.FileBatchLength + length > LOG_WRITE_BATCH_SIZE)
+        LogFlushFile();
+
+    if (length > LOG_WRITE_BATCH_SIZE) {
+        u64 written = 0;
+        FileSystemWrite(&state.File, length, data, &written);
+        return;
+    }
+    PlatformCopyMemory(state.FileBatch + state.FileBatchLength, data, length);
+    state.FileBatchLength += length;
+}
+
+void LogFileWriteText(LogLevel level, const char* text, u64 length)
+{
+    u8 header[12];
+    header[0] = LOG_FILE_ENTRY_TEXT;
+    header[1] = (u8)level;
+    u64 header_length = 2 + LogPutVarint(header + 2, length);
+    LogFileWrite(header, header_length);
+    LogFileWrite(text, length);
+}
+
+// Writes a binary line to the file, preceded by its call site the first time the site is seen.
+// The formatted text is written instead once the site table is full.
+void LogFileWriteLine(const LogCallSite* site, const u8* payload, u64 payload_length, const char* text, u64 text_length)
+{
+    u32 slot = (u32)((((u64)(__SIZE_TYPE__)site >> 3) * 0x9E3779B97F4A7C15ull) >> 52) & (LOG_SITE_TABLE_SIZE - 1);
+    while (state.Sites[slot] && state.Sites[slot] != site)
+        slot = (slot + 1) & (LOG_SITE_TABLE_SIZE - 1);
+
+    if (!state.Sites[slot]) {
+        // Keep the table at most half full, so that probes stay short.
+        if (state.SiteCount >= LOG_SITE_TABLE_SIZE / 2) {
+            LogFileWriteText(site->Level, text, text_length);
+            return;
+        }
+        state.Sites[slot] = site;
+        state.SiteIndices[slot] = state.SiteCount++;
+
+        u8 arg_count = 0;
+        while (arg_count < LOG_BINARY_MAX_ARGS && site->ArgTypes[arg_count] != LOG_ARG_END)
+            arg_count++;
+        u64 format_length = strlen(site->Format);
+
+        u8 header[32 + LOG_BINARY_MAX_ARGS];
+        u64 header_length = 0;
+        header[header_length++] = LOG_FILE_ENTRY_SITE;
+        header_length += LogPutVarint(header + header_length, state.SiteIndices[slot]);
+        header[header_length++] = site->Level;
+        header[header_length++] = arg_count;
+        PlatformCopyMemory(header + header_length, site->ArgTypes, arg_count);
+        header_length += arg_count;
+        header_length += LogPutVarint(header + header_length, format_length);
+        LogFileWrite(header, header_length);
+        LogFileWrite(site->Format, format_length);
+    }
+
+    u8 header[24];
+    u64 header_length = 0;
+    header[header_length++] = LOG_FILE_ENTRY_LINE;
+    header_length += LogPutVarint(header + header_length, state.SiteIndices[slot]);
+    header_length += LogPutVarint(header + header_length, payload_length);
+    LogFileWrite(header, header_length);
+    LogFileWrite(payload, payload_length);
+}
+
+void LogWriteRecord(LogRecord* record)
+{
+    if (record->Site) {
+        // Binary lines are only formatted here, for the console.
+        const LogCallSite* site = record->Site;
+        u64 length = LogFormatLine(site->Level, site->Format, site->ArgTypes, (const u8*)record->Text, record->Length, state.Line, sizeof(state.Line));
+        LogBatchLine(site->Level, state.Line, length);
+        if (state.BinaryFile)
+            LogFileWriteLine(site, (const u8*)record->Text, record->Length, state.Line, length);
+        return;
+    }
+
+    const char* text = record->LongText ? record->LongText : record->Text;
+    LogBatchLine(record->Level, text, record->Length);
+    if (state.BinaryFile)
+        LogFileWriteText(record->Level, text, record->Length);
+    if (record->LongText)
+        PlatformFree(record->LongText);
+}
+
+u32 LogWriterThread(void* param)
+{
+    u64 read_position = 0;
+    for (;;) {
+        u64 start_position = read_position;
+
+        for (;;) {
+            LogRecord* record = &state.Records[read_position & (LOG_RING_CAPACITY - 1)];
+            if (AtomicLoad(&record->Sequence, ATOMIC_ACQUIRE) != read_position + 1)
+                break;
+
+            LogWriteRecord(record);
+            AtomicStore(&record->Sequence, read_position + LOG_RING_CAPACITY, ATOMIC_RELEASE);
+            read_position++;
+        }
+
+        LogFlushBatch();
+        if (state.BinaryFile)
+            LogFlushFile();
+        AtomicStore(&state.WrittenPos, read_position, ATOMIC_RELEASE);
+
+        if (read_position == start_position) {
+            if (!AtomicLoad(&state.Running, ATOMIC_ACQUIRE) && read_position == AtomicLoad(&state.EnqueuePos, ATOMIC_ACQUIRE))
+                break;
+            PlatformSleep(1);
+        }
+    }
+
+    MemoryTrackerFlushThreadCache();
+    return 0;
+}
+
+b8 LoggerInit(const char* file_path)
+{
+    state.Records = PlatformAlloc(sizeof(LogRecord) * LOG_RING_CAPACITY);
+    if (!state.Records) {
+        ELSA_ERROR("Failed to allocate the log ring!");
+        return false;
+    }
+    for (u64 i = 0; i < LOG_RING_CAPACITY; i++)
+        state.Records[i].Sequence = i;
+    state.EnqueuePos = 0;
+    state.WrittenPos = 0;
+
+    if (file_path) {
+        if (FileSystemOpen(file_path, FILE_MODE_WRITE, LOG_BINARY_ENABLED, &state.File)) {
+            state.BinaryFile = LOG_BINARY_ENABLED;
+            if (state.BinaryFile) {
+                u64 written = 0;
+                FileSystemWrite(&state.File, LOG_FILE_MAGIC_LENGTH, LOG_FILE_MAGIC, &written);
+            }
+        } else {
+            ELSA_WARN("Failed to open the log file '%s', only logging to the console.", file_path);
+        }
+    }
+
+    AtomicStore(&state.Running, 1, ATOMIC_RELEASE);
+    if (!PlatformThreadCreate(LogWriterThread, 0, &state.Writer)) {
+        AtomicStore(&state.Running, 0, ATOMIC_RELEASE);
+        ELSA_ERROR("Failed to start the log writer thread!");
+        LoggerShutdown();
+        return false;
+    }
+    return true;
+}
+
+void LoggerShutdown()
+{
+    if (AtomicLoad(&state.Running, ATOMIC_ACQUIRE)) {
+        // The writer drains whatever is left before it exits.
+        AtomicStore(&state.Running, 0, ATOMIC_RELEASE);
+        PlatformThreadJoin(&state.Writer);
+    }
+
+    if (state.File.IsValid)
+        FileSystemClose(&state.File);
+    state.BinaryFile = false;
+    if (state.Records) {
+        PlatformFree(state.Records);
+        state.Records = 0;
+    }
+}
+
+void LoggerFlush()
+{
+    if (!AtomicLoad(&state.Running, ATOMIC_ACQUIRE))
+        return;
+
+    u64 target = AtomicLoad(&state.EnqueuePos, ATOMIC_ACQUIRE);
+    for (u32 waited = 0; waited < LOG_FLUSH_TIMEOUT_MS; waited++) {
+        if ((i64)(AtomicLoad(&state.WrittenPos, ATOMIC_ACQUIRE) - target) >= 0)
+            return;
+        PlatformSleep(1);
+    }
+}
+
+void LogSetChannelLevel(LogChannel channel, LogLevel level)
+{
+    u64 shift = channel * 8;
+    u64 levels = ((2ull << level) - 1) | (1ull << LOG_LEVEL_FATAL);
+    u64 mask = AtomicLoad(&log_channel_mask, ATOMIC_RELAXED);
+    while (!AtomicCompareExchangeWeak(&log_channel_mask, &mask, (mask & ~(0xFFull << shift)) | (levels << shift), ATOMIC_RELAXED, ATOMIC_RELAXED))
+        ;
+}
+
+b8 LogRateLimitCheck(LogRateLimit* limit, u32 interval_ms, u32* out_suppressed)
+{
+    u64 now = (u64)(PlatformGetAbsoluteTime() * 1000.0);
+    u64 next_time = AtomicLoad(&limit->NextTime, ATOMIC_RELAXED);
+    // Only the thread that moves the deadline gets to log, so racing threads can't both pass.
+    if (now < next_time || !AtomicCompareExchange(&limit->NextTime, &next_time, now + interval_ms, ATOMIC_RELAXED, ATOMIC_RELAXED)) {
+        AtomicFetchAdd(&limit->Suppressed, 1, ATOMIC_RELAXED);
+        return false;
+    }
+    *out_suppressed = AtomicExchange(&limit->Suppressed, 0, ATOMIC_RELAXED);
+    return true;
+}
 
 void LogOutput(LogLevel level, const char* message, ...)
 {
-    const char* level_strings[6] = {"[FATAL]: ", "[ERROR]: ", "[WARN]:  ", "[INFO]:  ", "[DEBUG]: ", "[TRACE]: "};
-    b8 is_error = level < LOG_LEVEL_WARN;
-	
-    char out_message[32000];
-    PlatformZeroMemory(out_message, sizeof(out_message));
-	
-    __builtin_va_list arg_ptr;
-    va_start(arg_ptr, message);
-    vsnprintf(out_message, 32000, message, arg_ptr);
-    va_end(arg_ptr);
-	
-    char out_message2[32000];
-    sprintf(out_message2, "%s%s\n", level_strings[level], out_message);
-	
-    if (!is_error)
-        PlatformConsoleWrite(out_message2, level);
+    va_list args;
+    va_start(args, message);
+    if (AtomicLoad(&state.Running, ATOMIC_ACQUIRE))
+        LogEnqueue(level, message, args);
     else
-        PlatformConsoleWriteError(out_message2, level);
+        LogWriteDirect(level, message, args);
+    va_end(args);
+
+    // Fatal lines, assertion failures included, come right before the application stops.
+    if (level == LOG_LEVEL_FATAL)
+        LoggerFlush();
+}
+
+void LogOutputBinary(const LogCallSite* site, ...)
+{
+    va_list args;
+    va_list args_copy;
+    va_start(args, site);
+    va_copy(args_copy, args);
+    b8 truncated;
+    if (AtomicLoad(&state.Running, ATOMIC_ACQUIRE)) {
+        u64 position;
+        LogRecord* record = LogClaimRecord(&position);
+        record->Site = site;
+        record->LongText = 0;
+        record->Level = site->Level;
+        record->Length = (u32)LogEncodeArgs(site, args, (u8*)record->Text, sizeof(record->Text), &truncated);
+        // Strings too long for the slot are rare, so format those lines as text instead of losing the end.
+        if (truncated)
+            LogFormatRecord(record, site->Level, site->Format, args_copy);
+        AtomicStore(&record->Sequence, position + 1, ATOMIC_RELEASE);
+    } else {
+        u8 payload[LOG_RECORD_TEXT_SIZE];
+        u64 payload_length = LogEncodeArgs(site, args, payload, sizeof(payload), &truncated);
+        if (truncated) {
+            LogWriteDirect(site->Level, site->Format, args_copy);
+        } else {
+            char line[LOG_LINE_SIZE];
+            u64 length = LogFormatLine(site->Level, site->Format, site->ArgTypes, payload, payload_length, line, sizeof(line));
+            LogWriteSinks(site->Level, line, length);
+        }
+    }
+    va_end(args_copy);
+    va_end(args);
+
+    if (site->Level == LOG_LEVEL_FATAL)
+        LoggerFlush();
+}
+
+typedef struct LogDecodedSite {
+    u8 Level;
+    u8 ArgTypes[LOG_BINARY_MAX_ARGS + 1];
+    char* Format;
+} LogDecodedSite;
+
+b8 LogDecodeFile(const char* path, const char* out_path)
+{
+    FileHandle file;
+    if (!FileSystemOpen(path, FILE_MODE_READ, true, &file)) {
+        ELSA_ERROR("LogDecodeFile - Failed to open '%s'.", path);
+        return false;
+    }
+    u64 size = 0;
+    FileSystemSize(&file, &size);
+    u8* data = PlatformAlloc(size + 1);
+    u64 read = 0;
+    b8 result = data && FileSystemRead(&file, size, data, &read) && read == size;
+    FileSystemClose(&file);
+    if (!result || size < LOG_FILE_MAGIC_LENGTH || memcmp(data, LOG_FILE_MAGIC, LOG_FILE_MAGIC_LENGTH) != 0) {
+        ELSA_ERROR("LogDecodeFile - '%s' is not a binary log file.", path);
+        if (data)
+            PlatformFree(data);
+        return false;
+    }
+
+    FileHandle out;
+    out.IsValid = false;
+    if (out_path && !FileSystemOpen(out_path, FILE_MODE_WRITE, false, &out)) {
+        ELSA_ERROR("LogDecodeFile - Failed to open '%s'.", out_path);
+        PlatformFree(data);
+        return false;
+    }
+
+    LogDecodedSite* sites = Darray_Create(LogDecodedSite);
+    char line[LOG_LINE_SIZE];
+    u64 offset = LOG_FILE_MAGIC_LENGTH;
+    while (offset < size) {
+        u8 entry = data[offset++];
+        LogLevel level;
+        u64 length;
+
+        if (entry == LOG_FILE_ENTRY_SITE) {
+            LogDecodedSite site;
+            PlatformZeroMemory(&site, sizeof(site));
+            u64 index = LogGetVarint(data, size, &offset);
+            if (index != Darray_Length(sites) || offset + 2 > size) {
+                result = false;
+                break;
+            }
+            site.Level = data[offset++];
+            u8 arg_count = data[offset++];
+            if (site.Level > LOG_LEVEL_TRACE || arg_count > LOG_BINARY_MAX_ARGS || offset + arg_count > size) {
+                result = false;
+                break;
+            }
+            PlatformCopyMemory(site.ArgTypes, data + offset, arg_count);
+            offset += arg_count;
+            u64 format_length = LogGetVarint(data, size, &offset);
+            if (offset + format_length > size) {
+                result = false;
+                break;
+            }
+            site.Format = PlatformAlloc(format_length + 1);
+            PlatformCopyMemory(site.Format, data + offset, format_length);
+            site.Format[format_length] = 0;
+            offset += format_length;
+            Darray_Push(sites, site);
+            continue;
+        } else if (entry == LOG_FILE_ENTRY_LINE) {
+            u64 index = LogGetVarint(data, size, &offset);
+            u64 payload_length = LogGetVarint(data, size, &offset);
+            if (index >= Darray_Length(sites) || offset + payload_length > size) {
+                result = false;
+                break;
+            }
+            LogDecodedSite* site = &sites[index];
+            level = site->Level;
+            length = LogFormatLine(level, site->Format, site->ArgTypes, data + offset, payload_length, line, sizeof(line));
+            offset += payload_length;
+        } else if (entry == LOG_FILE_ENTRY_TEXT && offset < size) {
+            level = data[offset++];
+            length = LogGetVarint(data, size, &offset);
+            if (level > LOG_LEVEL_TRACE || offset + length > size) {
+                result = false;
+                break;
+            }
+            u64 text_length = length;
+            // Text entries aren't terminated, and the console needs them to be.
+            if (length >= sizeof(line))
+                length = sizeof(line) - 1;
+            PlatformCopyMemory(line, data + offset, length);
+            line[length] = 0;
+            offset += text_length;
+        } else {
+            result = false;
+            break;
+        }
+
+        if (out.IsValid) {
+            u64 written = 0;
+            FileSystemWrite(&out, length, line, &written);
+        } else {
+            LogWriteConsole(level, line);
+        }
+    }
+
+    if (!result)
+        ELSA_ERROR("LogDecodeFile - '%s' is corrupted at byte %llu.", path, offset);
+
+    for (u64 i = 0; i < Darray_Length(sites); i++)
+        PlatformFree(sites[i].Format);
+    Darray_Destroy(sites);
+    if (out.IsValid)
+        FileSystemClose(&out);
+    PlatformFree(data);
+    return result;
 }
 
 void ReportAssertionFailure(const char* expression, const char* message, const char* file, i32 line)
 {
 	LogOutput(LOG_LEVEL_FATAL, "Assertion Failure: %s, message: '%s', in file: %s, line: %d\n", expression, message, file, line);
-}
\ No newline at end of file
+}
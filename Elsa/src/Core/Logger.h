@@ -10,20 +10,32 @@
 #define ELSA_LOGGER_H
 
 #include <Defines.h>
+#include <Core/Atomic.h>
 
+/**
+ * @brief The most verbose log level compiled in, as the number of a LogLevel. The logging
+ * macros of more verbose levels compile to nothing, so their arguments aren't evaluated.
+ * Fatal level logging is always compiled in.
+ * Defaults to trace, or info in release builds.
+ */
+#ifndef ELSA_LOG_LEVEL
+#if ELSA_RELEASE == 1
+    #define ELSA_LOG_LEVEL 3
+#else
+    #define ELSA_LOG_LEVEL 5
+#endif
+#endif
+
+/** @brief Indicates if error level logging is enabled. */
+#define LOG_ERROR_ENABLED (ELSA_LOG_LEVEL >= 1)
 /** @brief Indicates if warning level logging is enabled. */
-#define LOG_WARN_ENABLED 1
+#define LOG_WARN_ENABLED (ELSA_LOG_LEVEL >= 2)
 /** @brief Indicates if info level logging is enabled. */
-#define LOG_INFO_ENABLED 1
+#define LOG_INFO_ENABLED (ELSA_LOG_LEVEL >= 3)
 /** @brief Indicates if debug level logging is enabled. */
-#define LOG_DEBUG_ENABLED 1
+#define LOG_DEBUG_ENABLED (ELSA_LOG_LEVEL >= 4)
 /** @brief Indicates if trace level logging is enabled. */
-#define LOG_TRACE_ENABLED 1
-
-#if ELSA_RELEASE == 1
-    #define LOG_DEBUG_ENABLED 0
-    #define LOG_TRACE_ENABLED 0
-#endif
+#define LOG_TRACE_ENABLED (ELSA_LOG_LEVEL >= 5)
 
 /** @brief Represents levels of logging */
 typedef enum LogLevel {
@@ -41,21 +53,244 @@ typedef enum LogLevel {
     LOG_LEVEL_TRACE = 5
 } LogLevel;
 
+/** @brief Represents the subsystems log lines come from, each filtered separately at runtime. */
+typedef enum LogChannel {
+    /** @brief The core systems, and anything not in another channel. */
+    LOG_CHANNEL_CORE = 0,
+    /** @brief The platform layer and the file system. */
+    LOG_CHANNEL_PLATFORM = 1,
+    /** @brief The renderer frontend and backends. */
+    LOG_CHANNEL_RENDERER = 2,
+    /** @brief The audio frontend and backends. */
+    LOG_CHANNEL_AUDIO = 3,
+    /** @brief The shader compiler. */
+    LOG_CHANNEL_SHADER_COMPILER = 4,
+    /** @brief The number of channels. At most 8, as each takes a byte of the channel mask. */
+    LOG_CHANNEL_COUNT = 5
+} LogChannel;
+
 /**
- * @brief Outputs logging at the given level.
+ * @brief The channel the logging macros of a file log to. To move a file to another
+ * channel, define this before any include of the file, e.g. as LOG_CHANNEL_RENDERER.
+ */
+#ifndef ELSA_LOG_CHANNEL
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_CORE
+#endif
+
+/**
+ * @brief Has bit channel * 8 + level set for every level of every channel that is logged.
+ * Read by the logging macros before anything is formatted. Change it with LogSetChannelLevel.
+ */
+ELSA_API extern u64 log_channel_mask;
+
+/**
+ * @brief Checks if a level of a channel is logged, with a single load of the channel mask.
+ * @param channel The channel.
+ * @param level The log level.
+ * @returns True if lines of the level are logged on the channel; otherwise false.
+ */
+ELSA_INLINE b8 LogChannelEnabled(LogChannel channel, LogLevel level)
+{
+    return (AtomicLoad(&log_channel_mask, ATOMIC_RELAXED) >> (channel * 8 + level)) & 1;
+}
+
+/**
+ * @brief Sets the most verbose level logged on a channel. Fatal lines are always logged.
+ * Safe to call from any thread.
+ * @param channel The channel.
+ * @param level The most verbose level to log.
+ */
+ELSA_API void LogSetChannelLevel(LogChannel channel, LogLevel level);
+
+/** @brief The default interval of the rate limited logging macros, in milliseconds. */
+#define LOG_RATE_LIMIT_INTERVAL_MS 1000
+
+/** @brief Tracks when a rate limited call site last logged. Zero initialized. */
+typedef struct LogRateLimit {
+    /** @brief The time before which lines are suppressed, in milliseconds of PlatformGetAbsoluteTime. */
+    u64 NextTime;
+    /** @brief The number of lines suppressed since the last one logged. */
+    u32 Suppressed;
+} LogRateLimit;
+
+/**
+ * @brief Checks if a rate limited call site can log, allowing at most one line per interval.
+ * Safe to call from any thread.
+ * @param limit The state of the call site.
+ * @param interval_ms The interval in milliseconds.
+ * @param out_suppressed A pointer to hold the number of lines suppressed since the last one, when allowed.
+ * @returns True if the line should be logged; otherwise false.
+ */
+ELSA_API b8 LogRateLimitCheck(LogRateLimit* limit, u32 interval_ms, u32* out_suppressed);
+
+/**
+ * @brief Starts the log writer thread. Until this is called, and after LoggerShutdown,
+ * every line is formatted and written on the thread that logs it.
+ * @param file_path The path of a file the log is also written to. Optional. With ELSA_LOG_BINARY
+ * defined, the file holds binary lines, which LogDecodeFile or the LogDecoder tool turn back into text.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 LoggerInit(const char* file_path);
+
+/**
+ * @brief Writes out every line still queued, and stops the log writer thread.
+ * Other threads must have stopped logging by the time this is called.
+ */
+ELSA_API void LoggerShutdown();
+
+/**
+ * @brief Waits until every line logged before the call has been written out, or
+ * until a timeout of a few hundred milliseconds passes. Called by fatal level logging,
+ * and before the application exits after a failed run.
+ */
+ELSA_API void LoggerFlush();
+
+/**
+ * @brief Outputs logging at the given level. Safe to call from any thread. While the
+ * writer thread runs, the line is formatted into a ring buffer and written out by it.
  * @param level The log level to use.
  * @param message The message to be logged.
  * @param ... Any formatted data that should be included in the log entry.
  */
 ELSA_API void LogOutput(LogLevel level, const char* message, ...);
 
+/** @brief The maximum number of arguments of a line logged in binary mode. */
+#define LOG_BINARY_MAX_ARGS 12
+
+/** @brief The types a binary log argument is read back as. Smaller integers are promoted to int. */
+typedef enum LogArgType {
+    LOG_ARG_END = 0,
+    LOG_ARG_INT,
+    LOG_ARG_UINT,
+    LOG_ARG_LONG,
+    LOG_ARG_ULONG,
+    LOG_ARG_LLONG,
+    LOG_ARG_ULLONG,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_STRING,
+    LOG_ARG_POINTER
+} LogArgType;
+
+/**
+ * @brief Describes a line logged in binary mode. Every call site has one in static
+ * storage, so a logged line only needs a pointer to it, along with the raw arguments.
+ */
+typedef struct LogCallSite {
+    /** @brief The format string. Must be a string literal. */
+    const char* Format;
+    /** @brief The LogLevel of the line. */
+    u8 Level;
+    /** @brief The LogArgType of every argument, followed by LOG_ARG_END. */
+    u8 ArgTypes[LOG_BINARY_MAX_ARGS + 1];
+} LogCallSite;
+
+/**
+ * @brief Logs a line without formatting it. The arguments are copied as raw values,
+ * or as bytes for strings, and formatted later by the writer thread, or by LogDecodeFile
+ * when the log file is binary. Use it through the logging macros with ELSA_LOG_BINARY defined.
+ * @param site The call site of the line.
+ * @param ... The arguments of the line, matching site->ArgTypes.
+ */
+ELSA_API void LogOutputBinary(const LogCallSite* site, ...);
+
+/**
+ * @brief Decodes a log file written in binary mode into text.
+ * @param path The path of the binary log file.
+ * @param out_path The path of the text file to write. Optional; the text is written to the console if 0.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 LogDecodeFile(const char* path, const char* out_path);
+
+/** @brief Maps the type of an argument to its LogArgType, without evaluating it. */
+#define LOG_ARG_TYPE(x) _Generic((x),                                   \
+    _Bool: LOG_ARG_INT, char: LOG_ARG_INT, signed char: LOG_ARG_INT,    \
+    unsigned char: LOG_ARG_INT, short: LOG_ARG_INT,                     \
+    unsigned short: LOG_ARG_INT, int: LOG_ARG_INT,                      \
+    unsigned int: LOG_ARG_UINT, long: LOG_ARG_LONG,                     \
+    unsigned long: LOG_ARG_ULONG, long long: LOG_ARG_LLONG,             \
+    unsigned long long: LOG_ARG_ULLONG, float: LOG_ARG_DOUBLE,          \
+    double: LOG_ARG_DOUBLE, char*: LOG_ARG_STRING,                      \
+    const char*: LOG_ARG_STRING, default: LOG_ARG_POINTER)
+
+#define LOG_ARG_CONCAT_(a, b) a##b
+#define LOG_ARG_CONCAT(a, b) LOG_ARG_CONCAT_(a, b)
+#define LOG_ARG_COUNT_(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, count, ...) count
+#define LOG_ARG_COUNT(...) LOG_ARG_COUNT_(0, ##__VA_ARGS__, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+
+#define LOG_ARG_TYPES_0()
+#define LOG_ARG_TYPES_1(a) LOG_ARG_TYPE(a),
+#define LOG_ARG_TYPES_2(a, ...) LOG_ARG_TYPE(a), LOG_ARG_TYPES_1(__VA_ARGS__)
+#define LOG_ARG_TYPES_3(a, ...) LOG_ARG_TYPE(a), LOG_ARG_TYPES_2(__VA_ARGS__)
+#define LOG_ARG_TYPES_4(a, ...) LOG_ARG_TYPE(a), LOG_ARG_TYPES_3(__VA_ARGS__)
+#define LOG_ARG_TYPES_5(a, ...) LOG_ARG_TYPE(a), LOG_ARG_TYPES_4(__VA_ARGS__)
+#define LOG_ARG_TYPES_6(a, ...) LOG_ARG_TYPE(a), LOG_ARG_TYPES_5(__VA_ARGS__)
+#define LOG_ARG_TYPES_7(a, ...) LOG_ARG_TYPE(a), LOG_ARG_TYPES_6(__VA_ARGS__)
+#define LOG_ARG_TYPES_8(a, ...) LOG_ARG_TYPE(a), LOG_ARG_TYPES_7(__VA_ARGS__)
+#define LOG_ARG_TYPES_9(a, ...) LOG_ARG_TYPE(a), LOG_ARG_TYPES_8(__VA_ARGS__)
+#define LOG_ARG_TYPES_10(a, ...) LOG_ARG_TYPE(a), LOG_ARG_TYPES_9(__VA_ARGS__)
+#define LOG_ARG_TYPES_11(a, ...) LOG_ARG_TYPE(a), LOG_ARG_TYPES_10(__VA_ARGS__)
+#define LOG_ARG_TYPES_12(a, ...) LOG_ARG_TYPE(a), LOG_ARG_TYPES_11(__VA_ARGS__)
+
+/** @brief Expands to the LogArgType of every argument, each followed by a comma. */
+#define LOG_ARG_TYPES(...) LOG_ARG_CONCAT(LOG_ARG_TYPES_, LOG_ARG_COUNT(__VA_ARGS__))(__VA_ARGS__)
+
+/**
+ * @brief Logs a line in binary mode, through a call site in static storage.
+ * @param level The log level to use.
+ * @param message The format string. Must be a string literal.
+ * @param ... Up to LOG_BINARY_MAX_ARGS arguments.
+ */
+#define LOG_BINARY(level, message, ...)                                                                  \
+do {                                                                                                     \
+    static const LogCallSite elsa_log_site = { message, level, { LOG_ARG_TYPES(__VA_ARGS__) LOG_ARG_END } }; \
+    LogOutputBinary(&elsa_log_site, ##__VA_ARGS__);                                                       \
+} while (0)
+
+// C++ has no _Generic, so C++ files keep formatting on the calling thread.
+#if defined(ELSA_LOG_BINARY) && !defined(__cplusplus)
+/** @brief Indicates if the logging macros record binary lines, formatted later. */
+#define LOG_BINARY_ENABLED 1
+#define LOG_EMIT(level, message, ...) LOG_BINARY(level, message, ##__VA_ARGS__)
+#else
+/** @brief Indicates if the logging macros record binary lines, formatted later. */
+#define LOG_BINARY_ENABLED 0
+#define LOG_EMIT(level, message, ...) LogOutput(level, message, ##__VA_ARGS__)
+#endif
+
+/** @brief Logs a line if its level is enabled on the channel of the file. */
+#define LOG_CHANNEL_EMIT(level, message, ...)                       \
+do {                                                                \
+    if (LogChannelEnabled(ELSA_LOG_CHANNEL, level))                 \
+        LOG_EMIT(level, message, ##__VA_ARGS__);                    \
+} while (0)
+
+/**
+ * @brief Logs a line at most once per interval, for lines that could repeat every frame.
+ * The first line logged after some were suppressed is followed by their count.
+ * @param level The log level to use.
+ * @param interval_ms The interval in milliseconds.
+ * @param message The message to be logged.
+ * @param ... Any formatted data that should be included in the log entry.
+ */
+#define LOG_RATE_LIMITED(level, interval_ms, message, ...)                                          \
+do {                                                                                                \
+    static LogRateLimit elsa_log_limit;                                                             \
+    u32 elsa_log_suppressed;                                                                        \
+    if (LogChannelEnabled(ELSA_LOG_CHANNEL, level) && LogRateLimitCheck(&elsa_log_limit, interval_ms, &elsa_log_suppressed)) { \
+        LOG_EMIT(level, message, ##__VA_ARGS__);                                                    \
+        if (elsa_log_suppressed)                                                                    \
+            LOG_EMIT(level, "(%u similar lines suppressed)", elsa_log_suppressed);                  \
+    }                                                                                               \
+} while (0)
+
 /** 
  * @brief Logs a fatal-level message. Should be used to stop the application when hit.
  * @param message The message to be logged. Can be a format string for additional parameters.
  * @param ... Additional parameters to be logged.
  */
-#define ELSA_FATAL(message, ...) LogOutput(LOG_LEVEL_FATAL, message, ##__VA_ARGS__);
+#define ELSA_FATAL(message, ...) LOG_EMIT(LOG_LEVEL_FATAL, message, ##__VA_ARGS__);
 
+#if LOG_ERROR_ENABLED == 1
 #ifndef ELSA_ERROR
 /** 
  * @brief Logs an error-level message. Should be used to indicate critical runtime problems 
@@ -63,7 +298,28 @@ ELSA_API void LogOutput(LogLevel level, const char* message, ...);
  * @param message The message to be logged.
  * @param ... Any formatted data that should be included in the log entry.
  */
-#define ELSA_ERROR(message, ...) LogOutput(LOG_LEVEL_ERROR, message, ##__VA_ARGS__);
+#define ELSA_ERROR(message, ...) LOG_CHANNEL_EMIT(LOG_LEVEL_ERROR, message, ##__VA_ARGS__);
+#endif
+
+/**
+ * @brief Logs an error-level message at most once per LOG_RATE_LIMIT_INTERVAL_MS from the same line
+ * of code. Should be used for errors that can repeat every frame.
+ * @param message The message to be logged.
+ * @param ... Any formatted data that should be included in the log entry.
+ */
+#define ELSA_ERROR_LIMITED(message, ...) LOG_RATE_LIMITED(LOG_LEVEL_ERROR, LOG_RATE_LIMIT_INTERVAL_MS, message, ##__VA_ARGS__);
+#else
+#ifndef ELSA_ERROR
+/** 
+ * @brief Logs an error-level message. Should be used to indicate critical runtime problems 
+ * that cause the application to run improperly or not at all. Does nothing when LOG_ERROR_ENABLED != 1
+ * @param message The message to be logged.
+ * @param ... Any formatted data that should be included in the log entry.
+ */
+#define ELSA_ERROR(message, ...) ((void)0)
+#endif
+/** @brief Does nothing when LOG_ERROR_ENABLED != 1 */
+#define ELSA_ERROR_LIMITED(message, ...) ((void)0)
 #endif
 
 #if LOG_WARN_ENABLED == 1
@@ -73,7 +329,15 @@ ELSA_API void LogOutput(LogLevel level, const char* message, ...);
  * @param message The message to be logged.
  * @param ... Any formatted data that should be included in the log entry.
  */
-#define ELSA_WARN(message, ...) LogOutput(LOG_LEVEL_WARN, message, ##__VA_ARGS__);
+#define ELSA_WARN(message, ...) LOG_CHANNEL_EMIT(LOG_LEVEL_WARN, message, ##__VA_ARGS__);
+
+/**
+ * @brief Logs a warning-level message at most once per LOG_RATE_LIMIT_INTERVAL_MS from the same
+ * line of code. Should be used for warnings that can repeat every frame.
+ * @param message The message to be logged.
+ * @param ... Any formatted data that should be included in the log entry.
+ */
+#define ELSA_WARN_LIMITED(message, ...) LOG_RATE_LIMITED(LOG_LEVEL_WARN, LOG_RATE_LIMIT_INTERVAL_MS, message, ##__VA_ARGS__);
 #else
 /** 
  * @brief Logs a warning-level message. Should be used to indicate non-critial problems with 
@@ -81,7 +345,9 @@ ELSA_API void LogOutput(LogLevel level, const char* message, ...);
  * @param message The message to be logged.
  * @param ... Any formatted data that should be included in the log entry.
  */
-#define ELSA_WARN(message, ...)
+#define ELSA_WARN(message, ...) ((void)0)
+/** @brief Does nothing when LOG_WARN_ENABLED != 1 */
+#define ELSA_WARN_LIMITED(message, ...) ((void)0)
 #endif
 
 #if LOG_INFO_ENABLED == 1
@@ -90,7 +356,7 @@ ELSA_API void LogOutput(LogLevel level, const char* message, ...);
  * @param message The message to be logged.
  * @param ... Any formatted data that should be included in the log entry.
  */
-#define ELSA_INFO(message, ...) LogOutput(LOG_LEVEL_INFO, message, ##__VA_ARGS__);
+#define ELSA_INFO(message, ...) LOG_CHANNEL_EMIT(LOG_LEVEL_INFO, message, ##__VA_ARGS__);
 #else
 /** 
  * @brief Logs an info-level message. Should be used for non-erronuous informational purposes.
@@ -98,7 +364,7 @@ ELSA_API void LogOutput(LogLevel level, const char* message, ...);
  * @param message The message to be logged.
  * @param ... Any formatted data that should be included in the log entry.
  */
-#define ELSA_INFO(message, ...)
+#define ELSA_INFO(message, ...) ((void)0)
 #endif
 
 #if LOG_DEBUG_ENABLED == 1
@@ -107,7 +373,7 @@ ELSA_API void LogOutput(LogLevel level, const char* message, ...);
  * @param message The message to be logged.
  * @param ... Any formatted data that should be included in the log entry.
  */
-#define ELSA_DEBUG(message, ...) LogOutput(LOG_LEVEL_DEBUG, message, ##__VA_ARGS__);
+#define ELSA_DEBUG(message, ...) LOG_CHANNEL_EMIT(LOG_LEVEL_DEBUG, message, ##__VA_ARGS__);
 #else
 /** 
  * @brief Logs a debug-level message. Should be used for debugging purposes.
@@ -115,7 +381,7 @@ ELSA_API void LogOutput(LogLevel level, const char* message, ...);
  * @param message The message to be logged.
  * @param ... Any formatted data that should be included in the log entry.
  */
-#define ELSA_DEBUG(message, ...)
+#define ELSA_DEBUG(message, ...) ((void)0)
 #endif
 
 #if LOG_TRACE_ENABLED == 1
@@ -124,7 +390,7 @@ ELSA_API void LogOutput(LogLevel level, const char* message, ...);
  * @param message The message to be logged.
  * @param ... Any formatted data that should be included in the log entry.
  */
-#define ELSA_TRACE(message, ...) LogOutput(LOG_LEVEL_TRACE, message, ##__VA_ARGS__);
+#define ELSA_TRACE(message, ...) LOG_CHANNEL_EMIT(LOG_LEVEL_TRACE, message, ##__VA_ARGS__);
 #else
 /** 
  * @brief Logs a trace-level message. Should be used for verbose debugging purposes.
@@ -132,7 +398,7 @@ ELSA_API void LogOutput(LogLevel level, const char* message, ...);
  * @param message The message to be logged.
  * @param ... Any formatted data that should be included in the log entry.
  */
-#define ELSA_TRACE(message, ...)
+#define ELSA_TRACE(message, ...) ((void)0)
 #endif
 
 #endif
\ No newline at end of file
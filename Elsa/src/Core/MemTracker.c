@@ -1,59 +1,683 @@
 #include "MemTracker.h"
 
 #include <Platform/Platform.h>
+#include <Core/Logger.h>
+#include <Core/MemoryPool.h>
+#include <Core/Atomic.h>
 
-typedef struct TagTracker {
+// Each tag lives on its own cache line, so that threads allocating with different tags don't contend.
+typedef struct ELSA_ALIGN(ELSA_CACHE_LINE_SIZE) TagTracker {
 	u8 Tag;
 	u64 AllocationCount;
 	u64 UsedMemory;
+	u64 ArenaMemory;
+	u64 ArenaHighWaterMark;
 } TagTracker;
 
+// Small blocks are rounded up to a power of two size class, from 16 to 512 bytes.
+#define THREAD_CACHE_MIN_SHIFT 4
+#define THREAD_CACHE_MAX_SHIFT 9
+#define THREAD_CACHE_BIN_COUNT (THREAD_CACHE_MAX_SHIFT - THREAD_CACHE_MIN_SHIFT + 1)
+
+typedef struct ThreadCacheBin {
+	void* FreeList;
+	u32 Count;
+} ThreadCacheBin;
+
+typedef struct ThreadCache {
+	ThreadCacheBin Bins[THREAD_CACHE_BIN_COUNT];
+	// The allocation counter of the thread, claimed on its first allocation.
+	u64* AllocationCounter;
+} ThreadCache;
+
+// Threads past this count share one counter, which they update with atomic adds.
+#define ALLOCATION_COUNTER_CAPACITY 64
+
+// Only its own thread writes a counter, so threads never contend for the cache line.
+typedef struct ELSA_ALIGN(ELSA_CACHE_LINE_SIZE) AllocationCounter {
+	u64 Count;
+} AllocationCounter;
+
+#ifdef ELSA_MEMORY_TRACK_ALLOCATIONS
+#define TRACKING_SITE_CAPACITY 4096
+#define TRACKING_LIVE_INITIAL_CAPACITY 4096
+
+typedef struct AllocationSite {
+	const char* File;
+	u32 Line;
+	MemoryTag Tag;
+	u64 TotalCount;
+	u64 TotalBytes;
+	u64 LiveCount;
+	u64 LiveBytes;
+} AllocationSite;
+
+typedef struct LiveAllocation {
+	void* Block;
+	u64 Size;
+	u32 Site;
+} LiveAllocation;
+
+// Both tables use open addressing with linear probing. Their memory comes straight
+// from the platform layer, so that the tracking doesn't show up in its own report.
+typedef struct AllocationTracking {
+	SpinLock Lock;
+	AllocationSite Sites[TRACKING_SITE_CAPACITY + 1];
+	u32 SiteCount;
+	LiveAllocation* Live;
+	u64 LiveCapacity;
+	u64 LiveCount;
+} AllocationTracking;
+
+static AllocationTracking tracking;
+#endif
+
 typedef struct MemTrackerInternal {
 	TagTracker tags[MEMORY_TAG_MAX_TAGS];
+
+	AllocationCounter AllocationCounters[ALLOCATION_COUNTER_CAPACITY];
+	AllocationCounter SharedAllocationCounter;
+	u32 AllocationCounterCount;
+	// The total allocation count at the last MemoryTrackerFrameReset.
+	u64 FrameAllocationBase;
+
+	SpinLock PoolLock;
+
+	MemoryArena FrameArenas[2];
+	u32 FrameArenaIndex;
+
+	MemoryPool* Pools[MEMORY_TRACKER_MAX_POOLS];
+	u32 PoolCount;
 } MemTrackerInternal;
 
+static const char* tag_names[MEMORY_TAG_MAX_TAGS] = {
+	"UNKNOWN",
+	"DARRAY",
+	"RENDERER",
+	"HASHTABLE",
+	"APP",
+	"ENGINE_GENERAL",
+	"AUDIO",
+	"FRAME_ARENA",
+	"STRING_TABLE",
+	"QUEUE",
+	"PROFILER"
+};
+
 static MemTrackerInternal mem;
+static ELSA_THREAD_LOCAL ThreadCache thread_cache;
+
+void ArenaTrackGrow(MemoryTag tag, u64 size)
+{
+	u64 used = AtomicFetchAdd(&mem.tags[tag].ArenaMemory, size, ATOMIC_RELAXED) + size;
+	u64 high = AtomicLoad(&mem.tags[tag].ArenaHighWaterMark, ATOMIC_RELAXED);
+	while (used > high) {
+		if (AtomicCompareExchangeWeak(&mem.tags[tag].ArenaHighWaterMark, &high, used, ATOMIC_RELAXED, ATOMIC_RELAXED))
+			break;
+	}
+}
+
+void ArenaTrackShrink(MemoryTag tag, u64 size)
+{
+	AtomicFetchSub(&mem.tags[tag].ArenaMemory, size, ATOMIC_RELAXED);
+}
+
+// Returns the size class bin for the given size, or -1 if the size is too big to be cached.
+i32 ThreadCacheBinIndex(u64 size)
+{
+	if (size > (1ull << THREAD_CACHE_MAX_SHIFT))
+		return -1;
+
+	i32 bin = 0;
+	while ((1ull << (bin + THREAD_CACHE_MIN_SHIFT)) < size)
+		bin++;
+	return bin;
+}
+
+u64 ThreadCacheBinSize(i32 bin)
+{
+	return 1ull << (bin + THREAD_CACHE_MIN_SHIFT);
+}
+
+void ThreadCacheCountAllocation()
+{
+	u64* counter = thread_cache.AllocationCounter;
+	if (!counter) {
+		u32 index = AtomicFetchAdd(&mem.AllocationCounterCount, 1, ATOMIC_RELAXED);
+		counter = index < ALLOCATION_COUNTER_CAPACITY ? &mem.AllocationCounters[index].Count : &mem.SharedAllocationCounter.Count;
+		thread_cache.AllocationCounter = counter;
+	}
+
+	if (counter == &mem.SharedAllocationCounter.Count)
+		AtomicFetchAdd(counter, 1, ATOMIC_RELAXED);
+	else
+		AtomicStore(counter, AtomicLoad(counter, ATOMIC_RELAXED) + 1, ATOMIC_RELAXED);
+}
+
+u64 AllocationCountTotal()
+{
+	u32 count = AtomicLoad(&mem.AllocationCounterCount, ATOMIC_RELAXED);
+	if (count > ALLOCATION_COUNTER_CAPACITY)
+		count = ALLOCATION_COUNTER_CAPACITY;
+
+	u64 total = AtomicLoad(&mem.SharedAllocationCounter.Count, ATOMIC_RELAXED);
+	for (u32 i = 0; i < count; i++)
+		total += AtomicLoad(&mem.AllocationCounters[i].Count, ATOMIC_RELAXED);
+	return total;
+}
+
+#ifdef ELSA_MEMORY_TRACK_ALLOCATIONS
+u64 TrackingHashPointer(const void* pointer)
+{
+	return ((u64)pointer >> 4) * 0x9E3779B97F4A7C15ull;
+}
+
+u32 TrackingFindSite(const char* file, u32 line, MemoryTag tag)
+{
+	u64 hash = (TrackingHashPointer(file) ^ ((u64)line << 8) ^ tag) * 0x9E3779B97F4A7C15ull;
+	u32 index = (u32)(hash >> 32) & (TRACKING_SITE_CAPACITY - 1);
+
+	for (;;) {
+		AllocationSite* site = &tracking.Sites[index];
+		if (site->TotalCount == 0) {
+			// Keep one slot free, so that lookups always terminate. Sites that don't fit share the overflow slot.
+			if (tracking.SiteCount >= TRACKING_SITE_CAPACITY - 1)
+				return TRACKING_SITE_CAPACITY;
+
+			site->File = file;
+			site->Line = line;
+			site->Tag = tag;
+			tracking.SiteCount++;
+			return index;
+		}
+		if (site->File == file && site->Line == line && site->Tag == tag)
+			return index;
+
+		index = (index + 1) & (TRACKING_SITE_CAPACITY - 1);
+	}
+}
+
+const char* TrackingSiteFile(AllocationSite* site)
+{
+	if (site == &tracking.Sites[TRACKING_SITE_CAPACITY])
+		return "(site table full)";
+	return site->File ? site->File : "(unknown)";
+}
+
+void TrackingInsertLive(LiveAllocation allocation)
+{
+	u64 mask = tracking.LiveCapacity - 1;
+	u64 index = TrackingHashPointer(allocation.Block) & mask;
+	while (tracking.Live[index].Block)
+		index = (index + 1) & mask;
+
+	tracking.Live[index] = allocation;
+	tracking.LiveCount++;
+}
+
+b8 TrackingGrowLive()
+{
+	LiveAllocation* old_live = tracking.Live;
+	u64 old_capacity = tracking.LiveCapacity;
+
+	u64 new_capacity = old_capacity ? old_capacity * 2 : TRACKING_LIVE_INITIAL_CAPACITY;
+	LiveAllocation* new_live = PlatformAlloc(new_capacity * sizeof(LiveAllocation));
+	if (!new_live)
+		return false;
+	PlatformZeroMemory(new_live, new_capacity * sizeof(LiveAllocation));
+
+	tracking.Live = new_live;
+	tracking.LiveCapacity = new_capacity;
+	tracking.LiveCount = 0;
+	for (u64 i = 0; i < old_capacity; i++) {
+		if (old_live[i].Block)
+			TrackingInsertLive(old_live[i]);
+	}
+
+	if (old_live)
+		PlatformFree(old_live);
+	return true;
+}
+
+void TrackingRecordAlloc(void* block, u64 size, MemoryTag tag, const char* file, u32 line)
+{
+	SpinLockAcquire(&tracking.Lock);
+
+	u32 site_index = TrackingFindSite(file, line, tag);
+	AllocationSite* site = &tracking.Sites[site_index];
+	site->TotalCount++;
+	site->TotalBytes += size;
+	site->LiveCount++;
+	site->LiveBytes += size;
+
+	// Keep the load factor under one half.
+	if ((tracking.LiveCount + 1) * 2 > tracking.LiveCapacity && !TrackingGrowLive()) {
+		SpinLockRelease(&tracking.Lock);
+		return;
+	}
+
+	LiveAllocation allocation = { block, size, site_index };
+	TrackingInsertLive(allocation);
+
+	SpinLockRelease(&tracking.Lock);
+}
+
+// Returns false if the block was allocated with a different size than the one it's freed with.
+b8 TrackingRecordFree(void* block, u64 size)
+{
+	SpinLockAcquire(&tracking.Lock);
+	if (!tracking.LiveCount) {
+		SpinLockRelease(&tracking.Lock);
+		return true;
+	}
+
+	u64 mask = tracking.LiveCapacity - 1;
+	u64 index = TrackingHashPointer(block) & mask;
+	while (tracking.Live[index].Block && tracking.Live[index].Block != block)
+		index = (index + 1) & mask;
+
+	if (!tracking.Live[index].Block) {
+		SpinLockRelease(&tracking.Lock);
+		return true;
+	}
+
+	AllocationSite* site = &tracking.Sites[tracking.Live[index].Site];
+	u64 allocated_size = tracking.Live[index].Size;
+	site->LiveCount--;
+	site->LiveBytes -= tracking.Live[index].Size;
+	tracking.LiveCount--;
+
+	// Shift the following entries of the probe sequence back, instead of leaving a tombstone.
+	u64 hole = index;
+	u64 next = (index + 1) & mask;
+	while (tracking.Live[next].Block) {
+		u64 home = TrackingHashPointer(tracking.Live[next].Block) & mask;
+		if (((next - home) & mask) >= ((next - hole) & mask)) {
+			tracking.Live[hole] = tracking.Live[next];
+			hole = next;
+		}
+		next = (next + 1) & mask;
+	}
+	PlatformZeroMemory(&tracking.Live[hole], sizeof(LiveAllocation));
+
+	SpinLockRelease(&tracking.Lock);
+
+	if (allocated_size != size) {
+		ELSA_FATAL("MemoryTrackerFree: block allocated at %s:%u with %llu bytes was freed with %llu bytes.",
+				   site->File ? site->File : "<unknown>", site->Line, allocated_size, size);
+		return false;
+	}
+	return true;
+}
+
+void TrackingPrintTopSites(const char* title, b8 by_bytes)
+{
+	u32 top[MEMORY_TRACKER_REPORT_SITES];
+	u32 top_count = 0;
+
+	// Insertion sort into a short list, the site table is only walked once.
+	for (u32 i = 0; i <= TRACKING_SITE_CAPACITY; i++) {
+		AllocationSite* site = &tracking.Sites[i];
+		if (!site->TotalCount)
+			continue;
+
+		u64 value = by_bytes ? site->TotalBytes : site->TotalCount;
+		u32 position = top_count;
+		while (position > 0) {
+			AllocationSite* other = &tracking.Sites[top[position - 1]];
+			if ((by_bytes ? other->TotalBytes : other->TotalCount) >= value)
+				break;
+			position--;
+		}
+		if (position >= MEMORY_TRACKER_REPORT_SITES)
+			continue;
+
+		u32 last = top_count < MEMORY_TRACKER_REPORT_SITES ? top_count : MEMORY_TRACKER_REPORT_SITES - 1;
+		for (u32 j = last; j > position; j--)
+			top[j] = top[j - 1];
+		top[position] = i;
+		if (top_count < MEMORY_TRACKER_REPORT_SITES)
+			top_count++;
+	}
+
+	ELSA_INFO("%s", title);
+	for (u32 i = 0; i < top_count; i++) {
+		AllocationSite* site = &tracking.Sites[top[i]];
+		ELSA_INFO("    %8llu allocation(s), %12llu bytes  %s:%u (%s)",
+				  site->TotalCount, site->TotalBytes, TrackingSiteFile(site), site->Line, tag_names[site->Tag]);
+	}
+}
+
+void TrackingReportAndShutdown()
+{
+	SpinLockAcquire(&tracking.Lock);
+
+	TrackingPrintTopSites("Top allocation sites by count:", false);
+	TrackingPrintTopSites("Top allocation sites by bytes:", true);
+
+	if (tracking.LiveCount) {
+		ELSA_WARN("%llu allocation(s) leaked:", tracking.LiveCount);
+		for (u32 i = 0; i <= TRACKING_SITE_CAPACITY; i++) {
+			AllocationSite* site = &tracking.Sites[i];
+			if (site->LiveCount) {
+				ELSA_WARN("    %8llu allocation(s), %12llu bytes  %s:%u (%s)",
+						  site->LiveCount, site->LiveBytes, TrackingSiteFile(site), site->Line, tag_names[site->Tag]);
+			}
+		}
+	}
+
+	if (tracking.Live)
+		PlatformFree(tracking.Live);
+	tracking.Live = 0;
+	tracking.LiveCapacity = 0;
+	tracking.LiveCount = 0;
+	PlatformZeroMemory(tracking.Sites, sizeof(tracking.Sites));
+	tracking.SiteCount = 0;
+
+	SpinLockRelease(&tracking.Lock);
+}
+#endif
 
 b8 MemoryTrackerInit()
 {
 	for (i32 i = 0; i < MEMORY_TAG_MAX_TAGS; i++) {
 		PlatformZeroMemory(&mem.tags[i], sizeof(TagTracker));
-		
+
 		mem.tags[i].Tag = (MemoryTag)i;
 	}
-	
+
+	for (i32 i = 0; i < 2; i++) {
+		if (!MemoryArenaCreate(MEMORY_FRAME_ARENA_CAPACITY, MEMORY_TAG_FRAME_ARENA, &mem.FrameArenas[i])) {
+			ELSA_ERROR("Failed to create frame arena %d!", i);
+			return false;
+		}
+	}
+	mem.FrameArenaIndex = 0;
+
 	return true;
 }
 
 void MemoryTrackerShutdown()
 {
+	for (i32 i = 0; i < 2; i++) {
+		MemoryArenaDestroy(&mem.FrameArenas[i]);
+	}
+
+	MemoryTrackerFlushThreadCache();
+
+#ifdef ELSA_MEMORY_TRACK_ALLOCATIONS
+	TrackingReportAndShutdown();
+#else
+	for (i32 i = 0; i < MEMORY_TAG_MAX_TAGS; i++) {
+		u64 count = MemoryTrackerGetAllocationCount((MemoryTag)i);
+		if (count) {
+			ELSA_WARN("MemoryTracker: %llu allocation(s) (%llu bytes) tagged %s were never freed.",
+					  count, MemoryTrackerGetUsage((MemoryTag)i), tag_names[i]);
+		}
+	}
+#endif
+
 	for (i32 i = 0; i < MEMORY_TAG_MAX_TAGS; i++) {
 		PlatformZeroMemory(&mem.tags[i], sizeof(TagTracker));;
 	}
 }
 
-void* MemoryTrackerAlloc(u64 size, MemoryTag tag)
+// The platform doesn't zero what it allocates, but the tracker promises zeroed blocks.
+void* AllocZeroed(u64 size)
 {
-	mem.tags[tag].AllocationCount++;
-	mem.tags[tag].UsedMemory += size;
-	
-	return PlatformAlloc(size);
+	void* block = PlatformAlloc(size);
+	if (block)
+		PlatformZeroMemory(block, size);
+	return block;
+}
+
+void* AllocInternal(u64 size, MemoryTag tag)
+{
+	AtomicFetchAdd(&mem.tags[tag].AllocationCount, 1, ATOMIC_RELAXED);
+	ThreadCacheCountAllocation();
+	AtomicFetchAdd(&mem.tags[tag].UsedMemory, size, ATOMIC_RELAXED);
+
+	i32 bin = ThreadCacheBinIndex(size);
+	if (bin < 0)
+		return AllocZeroed(size);
+
+	ThreadCacheBin* cache_bin = &thread_cache.Bins[bin];
+	if (!cache_bin->FreeList)
+		return AllocZeroed(ThreadCacheBinSize(bin));
+
+	// Recycled blocks still hold the data of their last use.
+	void* block = cache_bin->FreeList;
+	cache_bin->FreeList = *(void**)block;
+	cache_bin->Count--;
+	PlatformZeroMemory(block, ThreadCacheBinSize(bin));
+	return block;
+}
+
+void* MemoryTrackerAllocAt(u64 size, MemoryTag tag, const char* file, u32 line)
+{
+	void* block = AllocInternal(size, tag);
+#ifdef ELSA_MEMORY_TRACK_ALLOCATIONS
+	if (block)
+		TrackingRecordAlloc(block, size, tag, file, line);
+#endif
+	return block;
+}
+
+// Parenthesized so that the definition isn't replaced by the tracking macro.
+void* (MemoryTrackerAlloc)(u64 size, MemoryTag tag)
+{
+	return MemoryTrackerAllocAt(size, tag, 0, 0);
 }
 
 void MemoryTrackerFree(void* block, u64 size, MemoryTag tag)
 {
-	mem.tags[tag].AllocationCount--;
-	mem.tags[tag].UsedMemory -= size;
+	// Nothing was allocated, so there's nothing to count or cache.
+	if (!block)
+		return;
 	
-	PlatformFree(block);
+	AtomicFetchSub(&mem.tags[tag].AllocationCount, 1, ATOMIC_RELAXED);
+	AtomicFetchSub(&mem.tags[tag].UsedMemory, size, ATOMIC_RELAXED);
+
+#ifdef ELSA_MEMORY_TRACK_ALLOCATIONS
+	// The bin is picked from the size, so a block freed with the wrong one can't be cached.
+	if (!TrackingRecordFree(block, size)) {
+		PlatformFree(block);
+		return;
+	}
+#endif
+
+	i32 bin = ThreadCacheBinIndex(size);
+	if (bin < 0 || thread_cache.Bins[bin].Count >= MEMORY_THREAD_CACHE_MAX_BLOCKS) {
+		PlatformFree(block);
+		return;
+	}
+
+	ThreadCacheBin* cache_bin = &thread_cache.Bins[bin];
+	*(void**)block = cache_bin->FreeList;
+	cache_bin->FreeList = block;
+	cache_bin->Count++;
+}
+
+void MemoryTrackerFlushThreadCache()
+{
+	for (i32 i = 0; i < THREAD_CACHE_BIN_COUNT; i++) {
+		ThreadCacheBin* cache_bin = &thread_cache.Bins[i];
+		while (cache_bin->FreeList) {
+			void* block = cache_bin->FreeList;
+			cache_bin->FreeList = *(void**)block;
+			PlatformFree(block);
+		}
+		cache_bin->Count = 0;
+	}
 }
 
 u64 MemoryTrackerGetAllocationCount(MemoryTag tag)
 {
-	return mem.tags[tag].AllocationCount;
+	return AtomicLoad(&mem.tags[tag].AllocationCount, ATOMIC_RELAXED);
 }
 
 u64 MemoryTrackerGetUsage(MemoryTag tag)
 {
-	return mem.tags[tag].UsedMemory;
-}
\ No newline at end of file
+	return AtomicLoad(&mem.tags[tag].UsedMemory, ATOMIC_RELAXED);
+}
+
+const char* MemoryTrackerGetTagName(MemoryTag tag)
+{
+	return tag_names[tag];
+}
+
+void MemoryTrackerRegisterPool(MemoryPool* pool)
+{
+	SpinLockAcquire(&mem.PoolLock);
+	if (mem.PoolCount >= MEMORY_TRACKER_MAX_POOLS) {
+		SpinLockRelease(&mem.PoolLock);
+		ELSA_WARN("MemoryTracker can only report on %d pools, '%s' will not be tracked.", MEMORY_TRACKER_MAX_POOLS, pool->Name);
+		return;
+	}
+
+	mem.Pools[mem.PoolCount++] = pool;
+	SpinLockRelease(&mem.PoolLock);
+}
+
+void MemoryTrackerUnregisterPool(MemoryPool* pool)
+{
+	SpinLockAcquire(&mem.PoolLock);
+	for (u32 i = 0; i < mem.PoolCount; i++) {
+		if (mem.Pools[i] == pool) {
+			mem.Pools[i] = mem.Pools[--mem.PoolCount];
+			break;
+		}
+	}
+	SpinLockRelease(&mem.PoolLock);
+}
+
+u32 MemoryTrackerGetPoolCount()
+{
+	return AtomicLoad(&mem.PoolCount, ATOMIC_RELAXED);
+}
+
+MemoryPool* MemoryTrackerGetPool(u32 index)
+{
+	return index < mem.PoolCount ? mem.Pools[index] : 0;
+}
+
+void MemoryTrackerPrintStatistics()
+{
+	ELSA_INFO("Memory usage per tag:");
+	for (i32 i = 0; i < MEMORY_TAG_MAX_TAGS; i++) {
+		ELSA_INFO("    %-16s %8llu allocation(s), %10llu bytes, arena high-water mark %10llu bytes",
+				  tag_names[i], MemoryTrackerGetAllocationCount((MemoryTag)i), MemoryTrackerGetUsage((MemoryTag)i), MemoryTrackerGetArenaHighWaterMark((MemoryTag)i));
+	}
+
+	ELSA_INFO("Memory pools:");
+	SpinLockAcquire(&mem.PoolLock);
+	for (u32 i = 0; i < mem.PoolCount; i++) {
+		MemoryPool* pool = mem.Pools[i];
+		// Only read by the line below, which info level stripping compiles out.
+		(void)pool;
+		ELSA_INFO("    %-24s %6llu live, %6llu peak, %4llu chunk(s) of %u x %llu bytes",
+				  pool->Name, pool->LiveCount, pool->PeakCount, pool->ChunkCount, pool->SlotsPerChunk, pool->SlotSize);
+	}
+	SpinLockRelease(&mem.PoolLock);
+}
+
+u64 MemoryTrackerGetArenaHighWaterMark(MemoryTag tag)
+{
+	return AtomicLoad(&mem.tags[tag].ArenaHighWaterMark, ATOMIC_RELAXED);
+}
+
+u64 MemoryTrackerGetFrameAllocationCount()
+{
+	return AllocationCountTotal() - mem.FrameAllocationBase;
+}
+
+void MemoryTrackerFrameReset()
+{
+	// The counters belong to their threads, so the count restarts from their current total instead.
+	mem.FrameAllocationBase = AllocationCountTotal();
+
+	mem.FrameArenaIndex = (mem.FrameArenaIndex + 1) % 2;
+	MemoryArenaReset(&mem.FrameArenas[mem.FrameArenaIndex]);
+}
+
+MemoryArena* MemoryTrackerGetFrameArena()
+{
+	return &mem.FrameArenas[mem.FrameArenaIndex];
+}
+
+b8 MemoryArenaCreate(u64 capacity, MemoryTag tag, MemoryArena* out_arena)
+{
+	if (!out_arena || !capacity) {
+		ELSA_ERROR("MemoryArenaCreate requires a non-zero capacity and out_arena to exist.");
+		return false;
+	}
+
+	out_arena->Memory = MemoryTrackerAlloc(capacity, tag);
+	if (!out_arena->Memory) {
+		ELSA_ERROR("Failed to allocate %llu bytes for memory arena!", capacity);
+		return false;
+	}
+
+	out_arena->Capacity = capacity;
+	out_arena->Offset = 0;
+	out_arena->HighWaterMark = 0;
+	out_arena->Tag = tag;
+	return true;
+}
+
+void MemoryArenaDestroy(MemoryArena* arena)
+{
+	if (arena && arena->Memory) {
+		ArenaTrackShrink(arena->Tag, arena->Offset);
+		MemoryTrackerFree(arena->Memory, arena->Capacity, arena->Tag);
+		PlatformZeroMemory(arena, sizeof(MemoryArena));
+	}
+}
+
+void* MemoryArenaPush(MemoryArena* arena, u64 size, u64 alignment)
+{
+	u64 base = (u64)arena->Memory;
+	u64 aligned = (base + arena->Offset + (alignment - 1)) & ~(alignment - 1);
+	u64 new_offset = (aligned - base) + size;
+
+	if (new_offset > arena->Capacity) {
+		ELSA_ERROR("MemoryArenaPush: arena out of memory! (Capacity: %llu, requested: %llu)", arena->Capacity, size);
+		return 0;
+	}
+
+	ArenaTrackGrow(arena->Tag, new_offset - arena->Offset);
+	arena->Offset = new_offset;
+	if (arena->Offset > arena->HighWaterMark)
+		arena->HighWaterMark = arena->Offset;
+
+	return (void*)aligned;
+}
+
+void* MemoryArenaPushZero(MemoryArena* arena, u64 size, u64 alignment)
+{
+	void* block = MemoryArenaPush(arena, size, alignment);
+	if (block)
+		PlatformZeroMemory(block, size);
+	return block;
+}
+
+u64 MemoryArenaGetMark(MemoryArena* arena)
+{
+	return arena->Offset;
+}
+
+void MemoryArenaRewind(MemoryArena* arena, u64 mark)
+{
+	if (mark > arena->Offset) {
+		ELSA_WARN("MemoryArenaRewind: mark is past the current arena offset, ignoring.");
+		return;
+	}
+
+	ArenaTrackShrink(arena->Tag, arena->Offset - mark);
+	arena->Offset = mark;
+}
+
+void MemoryArenaReset(MemoryArena* arena)
+{
+	MemoryArenaRewind(arena, 0);
+}
@@ -19,9 +19,48 @@ typedef enum MemoryTag {
 	MEMORY_TAG_APP = 4,
 	MEMORY_TAG_ENGINE_GENERAL = 5,
 	MEMORY_TAG_AUDIO = 6,
+	MEMORY_TAG_FRAME_ARENA = 7,
+	MEMORY_TAG_STRING_TABLE = 8,
+	MEMORY_TAG_QUEUE = 9,
+	MEMORY_TAG_PROFILER = 10,
 	MEMORY_TAG_MAX_TAGS
 } MemoryTag;
 
+struct MemoryPool;
+
+/** @brief The maximum number of memory pools the tracker can report on at once. */
+#define MEMORY_TRACKER_MAX_POOLS 32
+
+/** @brief The default capacity of each of the per-frame arenas. */
+#define MEMORY_FRAME_ARENA_CAPACITY (4 * 1024 * 1024)
+
+/** @brief The maximum number of freed blocks of each size class a thread keeps for reuse. */
+#define MEMORY_THREAD_CACHE_MAX_BLOCKS 64
+
+/** @brief The number of allocation sites listed in each section of the shutdown report. */
+#define MEMORY_TRACKER_REPORT_SITES 10
+
+/** @brief The default alignment used when pushing onto an arena. */
+#define MEMORY_ARENA_DEFAULT_ALIGNMENT 16
+
+/**
+ * @brief Represents a linear (bump) allocator. Allocations are made by moving 
+ * an offset forward through a single block of memory, and are released all at
+ * once by either rewinding to a previous mark or resetting the arena.
+ */
+typedef struct MemoryArena {
+	/** @brief The block of memory backing the arena. */
+	u8* Memory;
+	/** @brief The size in bytes of the backing block. */
+	u64 Capacity;
+	/** @brief The current offset of the arena, in bytes. */
+	u64 Offset;
+	/** @brief The highest offset the arena has reached since its creation. */
+	u64 HighWaterMark;
+	/** @brief The tag the backing block was allocated with. */
+	MemoryTag Tag;
+} MemoryArena;
+
 /** 
 * @brief Initializes the memory tracker system
 * @returns True on success; otherwise false.
@@ -32,7 +71,9 @@ ELSA_API b8 MemoryTrackerInit();
 ELSA_API void MemoryTrackerShutdown();
 
 /**
-* @brief Allocates a memory block from a certain tag.
+* @brief Allocates a zeroed memory block from a certain tag. Safe to call from any thread.
+* Blocks of 512 bytes or less are served from a per-thread cache of recently freed blocks
+* when possible.
 * 
 * @param size The size of the block to allocate.
 * @param tag The tag used for the allocation.
@@ -41,14 +82,42 @@ ELSA_API void MemoryTrackerShutdown();
 ELSA_API void* MemoryTrackerAlloc(u64 size, MemoryTag tag);
 
 /**
-* @brief Frees a memory block from a certain tag.
+* @brief Allocates a zeroed memory block from a certain tag, recording the call site.
+* When ELSA_MEMORY_TRACK_ALLOCATIONS is defined, MemoryTrackerAlloc expands to this
+* with the current file and line, and every live allocation is recorded so that the
+* busiest allocation sites and any leaks are reported on shutdown. Otherwise the call
+* site is ignored.
+*
+* @param size The size of the block to allocate.
+* @param tag The tag used for the allocation.
+* @param file The source file of the allocation. Must be a string literal.
+* @param line The source line of the allocation.
+* @returns A pointer to the allocated block.
+*/
+ELSA_API void* MemoryTrackerAllocAt(u64 size, MemoryTag tag, const char* file, u32 line);
+
+#ifdef ELSA_MEMORY_TRACK_ALLOCATIONS
+#define MemoryTrackerAlloc(size, tag) MemoryTrackerAllocAt(size, tag, __FILE__, __LINE__)
+#endif
+
+/**
+* @brief Frees a memory block from a certain tag. Safe to call from any thread, not only
+* the one that allocated the block. Small blocks are cached by the size they are freed with,
+* so it must be the exact size they were allocated with. When ELSA_MEMORY_TRACK_ALLOCATIONS
+* is defined, a mismatch is reported as fatal and the block isn't cached.
 *
 * @param block The block of memory to free.
-* @param size The size of the memory block to free.
+* @param size The size the block was allocated with.
 * @param tag The tag used for the allocation.
 */
 ELSA_API void MemoryTrackerFree(void* block, u64 size, MemoryTag tag);
 
+/**
+* @brief Releases every block held in the calling thread's small-object cache back to the
+* platform. Threads other than the main thread should call this before exiting.
+*/
+ELSA_API void MemoryTrackerFlushThreadCache();
+
 /**
 * @brief Returns the allocation count of the provided memory tag.
 *
@@ -65,4 +134,150 @@ ELSA_API u64 MemoryTrackerGetAllocationCount(MemoryTag tag);
 */
 ELSA_API u64 MemoryTrackerGetUsage(MemoryTag tag);
 
+/**
+* @brief Returns the name of the provided memory tag.
+*
+* @param tag The memory tag whose name to return.
+* @returns The name of the tag.
+*/
+ELSA_API const char* MemoryTrackerGetTagName(MemoryTag tag);
+
+/**
+* @brief Returns the highest amount of arena memory that was in use at once 
+* for the provided memory tag.
+*
+* @param tag The memory tag whose arena high-water mark to return.
+* @returns The arena high-water mark in bytes.
+*/
+ELSA_API u64 MemoryTrackerGetArenaHighWaterMark(MemoryTag tag);
+
+/**
+* @brief Registers a memory pool so that it shows up in the tracker's statistics.
+* Called by MemoryPoolCreate.
+*
+* @param pool The pool to register.
+*/
+ELSA_API void MemoryTrackerRegisterPool(struct MemoryPool* pool);
+
+/**
+* @brief Removes a memory pool from the tracker's statistics. Called by MemoryPoolDestroy.
+*
+* @param pool The pool to unregister.
+*/
+ELSA_API void MemoryTrackerUnregisterPool(struct MemoryPool* pool);
+
+/**
+* @brief Returns the number of memory pools currently registered.
+*
+* @returns The number of registered pools.
+*/
+ELSA_API u32 MemoryTrackerGetPoolCount();
+
+/**
+* @brief Returns a registered memory pool.
+*
+* @param index The index of the pool, less than MemoryTrackerGetPoolCount().
+* @returns A pointer to the pool.
+*/
+ELSA_API struct MemoryPool* MemoryTrackerGetPool(u32 index);
+
+/**
+* @brief Returns the number of allocations made since the last call to MemoryTrackerFrameReset.
+* Allocations of every thread are counted, each thread keeping its own count.
+* Arena pushes and pool allocations served from existing chunks are not counted.
+*
+* @returns The number of allocations made this frame.
+*/
+ELSA_API u64 MemoryTrackerGetFrameAllocationCount();
+
+/**
+* @brief Logs the usage of every memory tag and every registered pool.
+*/
+ELSA_API void MemoryTrackerPrintStatistics();
+
+/**
+* @brief Swaps the double-buffered frame arenas and resets the one that becomes current.
+* Allocations made on the previous frame's arena stay valid for one more frame.
+* Should be called once at the beginning of every frame.
+*/
+ELSA_API void MemoryTrackerFrameReset();
+
+/**
+* @brief Returns the frame arena of the current frame. Memory pushed onto it is
+* released automatically two frames later, and must never be freed manually.
+*
+* @returns A pointer to the current frame arena.
+*/
+ELSA_API MemoryArena* MemoryTrackerGetFrameArena();
+
+/**
+* @brief Creates a linear arena by allocating its backing block from the tracker.
+*
+* @param capacity The size in bytes of the arena.
+* @param tag The tag used for the backing allocation.
+* @param out_arena A pointer to hold the created arena.
+* @returns True on success; otherwise false.
+*/
+ELSA_API b8 MemoryArenaCreate(u64 capacity, MemoryTag tag, MemoryArena* out_arena);
+
+/**
+* @brief Destroys an arena, freeing its backing block.
+*
+* @param arena The arena to destroy.
+*/
+ELSA_API void MemoryArenaDestroy(MemoryArena* arena);
+
+/**
+* @brief Pushes an aligned block of memory onto the arena.
+*
+* @param arena The arena to push onto.
+* @param size The size in bytes of the block.
+* @param alignment The alignment of the block. Must be a power of two.
+* @returns A pointer to the block, or 0 if the arena is out of memory.
+*/
+ELSA_API void* MemoryArenaPush(MemoryArena* arena, u64 size, u64 alignment);
+
+/**
+* @brief Pushes a zeroed, aligned block of memory onto the arena.
+*
+* @param arena The arena to push onto.
+* @param size The size in bytes of the block.
+* @param alignment The alignment of the block. Must be a power of two.
+* @returns A pointer to the block, or 0 if the arena is out of memory.
+*/
+ELSA_API void* MemoryArenaPushZero(MemoryArena* arena, u64 size, u64 alignment);
+
+/**
+* @brief Returns the current position of the arena, to be rewound to later.
+*
+* @param arena The arena.
+* @returns The current mark of the arena.
+*/
+ELSA_API u64 MemoryArenaGetMark(MemoryArena* arena);
+
+/**
+* @brief Rewinds an arena to a mark, releasing everything pushed since.
+*
+* @param arena The arena to rewind.
+* @param mark A mark previously returned by MemoryArenaGetMark.
+*/
+ELSA_API void MemoryArenaRewind(MemoryArena* arena, u64 mark);
+
+/**
+* @brief Releases everything pushed onto the arena.
+*
+* @param arena The arena to reset.
+*/
+ELSA_API void MemoryArenaReset(MemoryArena* arena);
+
+/**
+ * @brief Pushes an array of the given type onto an arena, using the type's natural alignment.
+ * @param arena The arena to push onto.
+ * @param type The type of the array elements.
+ * @param count The number of elements.
+ * @returns A pointer to the array, or 0 if the arena is out of memory.
+ */
+#define MemoryArena_PushArray(arena, type, count) \
+(type*)MemoryArenaPush(arena, sizeof(type) * (count), _Alignof(type))
+
 #endif
@@ -0,0 +1,121 @@
+#include "MemoryPool.h"
+
+#include <Platform/Platform.h>
+#include <Core/Logger.h>
+
+#define MEMORY_POOL_CHUNK_HEADER_SIZE MEMORY_POOL_SLOT_ALIGNMENT
+#define MEMORY_POOL_GENERATION_HEADER_SIZE MEMORY_POOL_SLOT_ALIGNMENT
+
+u64 PoolSlotHeaderSize(MemoryPool* pool)
+{
+	return pool->UseGenerations ? MEMORY_POOL_GENERATION_HEADER_SIZE : 0;
+}
+
+b8 PoolGrow(MemoryPool* pool)
+{
+	u64 chunk_size = MEMORY_POOL_CHUNK_HEADER_SIZE + (pool->SlotSize * pool->SlotsPerChunk);
+	u8* chunk = MemoryTrackerAlloc(chunk_size, pool->Tag);
+	if (!chunk) {
+		ELSA_ERROR("MemoryPool '%s' failed to allocate a new chunk!", pool->Name);
+		return false;
+	}
+	PlatformZeroMemory(chunk, chunk_size);
+
+	*(void**)chunk = pool->Chunks;
+	pool->Chunks = chunk;
+	pool->ChunkCount++;
+
+	// Thread the new slots onto the free list back to front, so that allocations walk the chunk in order.
+	u64 header_size = PoolSlotHeaderSize(pool);
+	u8* slots = chunk + MEMORY_POOL_CHUNK_HEADER_SIZE;
+	for (u32 i = pool->SlotsPerChunk; i > 0; i--) {
+		void* element = slots + ((u64)(i - 1) * pool->SlotSize) + header_size;
+		*(void**)element = pool->FreeList;
+		pool->FreeList = element;
+	}
+
+	return true;
+}
+
+b8 MemoryPoolCreate(const char* name, u64 element_size, u32 slots_per_chunk, b8 use_generations, MemoryTag tag, MemoryPool* out_pool)
+{
+	if (!out_pool || !element_size || !slots_per_chunk) {
+		ELSA_ERROR("MemoryPoolCreate requires a non-zero element_size, slots_per_chunk and out_pool to exist.");
+		return false;
+	}
+
+	PlatformZeroMemory(out_pool, sizeof(MemoryPool));
+	out_pool->Name = name;
+	out_pool->ElementSize = element_size;
+	out_pool->SlotsPerChunk = slots_per_chunk;
+	out_pool->UseGenerations = use_generations;
+	out_pool->Tag = tag;
+
+	// A free slot stores the free list link in place of the element.
+	u64 payload_size = element_size < sizeof(void*) ? sizeof(void*) : element_size;
+	u64 slot_size = PoolSlotHeaderSize(out_pool) + payload_size;
+	out_pool->SlotSize = (slot_size + (MEMORY_POOL_SLOT_ALIGNMENT - 1)) & ~((u64)MEMORY_POOL_SLOT_ALIGNMENT - 1);
+
+	MemoryTrackerRegisterPool(out_pool);
+	return true;
+}
+
+void MemoryPoolDestroy(MemoryPool* pool)
+{
+	if (!pool)
+		return;
+
+	if (pool->LiveCount != 0) {
+		ELSA_WARN("MemoryPool '%s' destroyed with %llu element(s) still allocated.", pool->Name, pool->LiveCount);
+	}
+
+	u64 chunk_size = MEMORY_POOL_CHUNK_HEADER_SIZE + (pool->SlotSize * pool->SlotsPerChunk);
+	void* chunk = pool->Chunks;
+	while (chunk) {
+		void* next = *(void**)chunk;
+		MemoryTrackerFree(chunk, chunk_size, pool->Tag);
+		chunk = next;
+	}
+
+	MemoryTrackerUnregisterPool(pool);
+	PlatformZeroMemory(pool, sizeof(MemoryPool));
+}
+
+void* MemoryPoolAlloc(MemoryPool* pool)
+{
+	if (!pool->FreeList && !PoolGrow(pool))
+		return 0;
+
+	void* element = pool->FreeList;
+	pool->FreeList = *(void**)element;
+	PlatformZeroMemory(element, pool->ElementSize);
+
+	pool->LiveCount++;
+	if (pool->LiveCount > pool->PeakCount)
+		pool->PeakCount = pool->LiveCount;
+
+	return element;
+}
+
+void MemoryPoolFree(MemoryPool* pool, void* element)
+{
+	if (!element)
+		return;
+
+	if (pool->UseGenerations)
+		((u32*)((u8*)element - MEMORY_POOL_GENERATION_HEADER_SIZE))[0]++;
+
+	*(void**)element = pool->FreeList;
+	pool->FreeList = element;
+	pool->LiveCount--;
+}
+
+u32 MemoryPoolGetGeneration(MemoryPool* pool, void* element)
+{
+	if (!pool->UseGenerations) {
+		ELSA_WARN("MemoryPoolGetGeneration called on pool '%s', which has no generations.", pool->Name);
+		return 0;
+	}
+
+	return ((u32*)((u8*)element - MEMORY_POOL_GENERATION_HEADER_SIZE))[0];
+}
@@ -0,0 +1,120 @@
+/**
+ * @file MemoryPool.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains a fixed-size pool allocator, used for engine objects
+ * that are created and destroyed frequently.
+ * @version 1.0
+ * @date 2022-07-20
+ */
+#ifndef ELSA_MEMORY_POOL_H
+#define ELSA_MEMORY_POOL_H
+
+#include <Defines.h>
+#include <Core/MemTracker.h>
+
+/** @brief The alignment of every slot handed out by a pool. */
+#define MEMORY_POOL_SLOT_ALIGNMENT 16
+
+/** @brief The default number of slots allocated per chunk. */
+#define MEMORY_POOL_DEFAULT_CHUNK_SLOTS 64
+
+/**
+ * @brief Represents a pool of fixed-size slots. Slots are carved out of chunks
+ * allocated from the memory tracker, and freed slots are kept in an intrusive free
+ * list so that both allocating and freeing are O(1). Chunks are only released when
+ * the pool is destroyed.
+ *
+ * When generations are enabled, each slot carries a counter that is incremented
+ * every time it is freed, which lets owners detect stale references.
+ */
+typedef struct MemoryPool {
+	/** @brief The name of the pool, used for statistics. */
+	const char* Name;
+	/** @brief The size in bytes of an element. */
+	u64 ElementSize;
+	/** @brief The size in bytes of a slot, including its header. */
+	u64 SlotSize;
+	/** @brief The number of slots in each chunk. */
+	u32 SlotsPerChunk;
+	/** @brief Whether or not slots carry a generation counter. */
+	b8 UseGenerations;
+	/** @brief The tag used to allocate chunks. */
+	MemoryTag Tag;
+
+	/** @brief The first free slot, or 0 if every slot is in use. */
+	void* FreeList;
+	/** @brief The most recently allocated chunk. Chunks are linked through their first bytes. */
+	void* Chunks;
+
+	/** @brief The number of chunks allocated. */
+	u64 ChunkCount;
+	/** @brief The number of elements currently allocated. */
+	u64 LiveCount;
+	/** @brief The highest number of elements that were allocated at once. */
+	u64 PeakCount;
+} MemoryPool;
+
+/**
+ * @brief Creates a memory pool and registers it with the memory tracker.
+ * @param name The name of the pool, used for statistics. Must outlive the pool.
+ * @param element_size The size in bytes of each element.
+ * @param slots_per_chunk The number of slots allocated at a time when the pool runs out.
+ * @param use_generations Whether or not slots should carry a generation counter.
+ * @param tag The tag used to allocate chunks.
+ * @param out_pool A pointer to hold the created pool.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 MemoryPoolCreate(const char* name, u64 element_size, u32 slots_per_chunk, b8 use_generations, MemoryTag tag, MemoryPool* out_pool);
+
+/**
+ * @brief Destroys a memory pool, releasing every chunk. Any element still
+ * allocated becomes invalid.
+ * @param pool The pool to destroy.
+ */
+ELSA_API void MemoryPoolDestroy(MemoryPool* pool);
+
+/**
+ * @brief Allocates a zeroed element from the pool. Allocates a new chunk if required.
+ * @param pool The pool to allocate from.
+ * @returns A pointer to the element, or 0 on failure.
+ */
+ELSA_API void* MemoryPoolAlloc(MemoryPool* pool);
+
+/**
+ * @brief Returns an element to the pool.
+ * @param pool The pool the element was allocated from.
+ * @param element The element to free.
+ */
+ELSA_API void MemoryPoolFree(MemoryPool* pool, void* element);
+
+/**
+ * @brief Returns the current generation of the slot holding the given element.
+ * Only valid for pools created with generations enabled.
+ * @param pool The pool the element was allocated from.
+ * @param element The element.
+ * @returns The generation of the slot.
+ */
+ELSA_API u32 MemoryPoolGetGeneration(MemoryPool* pool, void* element);
+
+/**
+ * @brief Creates a memory pool for the given type, named after the type.
+ * @param type The type of the elements.
+ * @param slots_per_chunk The number of slots allocated at a time.
+ * @param use_generations Whether or not slots should carry a generation counter.
+ * @param tag The tag used to allocate chunks.
+ * @param out_pool A pointer to hold the created pool.
+ * @returns True on success; otherwise false.
+ */
+#define MemoryPool_Create(type, slots_per_chunk, use_generations, tag, out_pool) \
+MemoryPoolCreate(#type, sizeof(type), slots_per_chunk, use_generations, tag, out_pool)
+
+/**
+ * @brief Allocates a zeroed element of the given type from the pool.
+ * @param pool The pool to allocate from.
+ * @param type The type of the element.
+ * @returns A pointer to the element, or 0 on failure.
+ */
+#define MemoryPool_Alloc(pool, type) \
+((type*)MemoryPoolAlloc(pool))
+
+#endif
@@ -0,0 +1,365 @@
+#include "Profiler.h"
+
+#include <Containers/Darray.h>
+#include <Core/Atomic.h>
+#include <Core/Logger.h>
+#include <Core/MemTracker.h>
+#include <Core/Trace.h>
+#include <Platform/Platform.h>
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct ProfileEvent {
+    // The name of the scope for a begin event, 0 for an end event.
+    const char* Name;
+    u64 Time;
+} ProfileEvent;
+
+// A scope of a thread that has begun but not ended, as seen by the main thread.
+typedef struct ProfileOpenScope {
+    const char* Name;
+    u64 Start;
+    // The node of the scope in the frame with index NodeFrame.
+    u32 Node;
+    u64 NodeFrame;
+} ProfileOpenScope;
+
+typedef struct ProfileThread {
+    // Only written by the thread.
+    ELSA_ALIGN(ELSA_CACHE_LINE_SIZE) u64 WritePos;
+    // Only written by the main thread, once it has read the events before it.
+    ELSA_ALIGN(ELSA_CACHE_LINE_SIZE) u64 ReadPos;
+    ELSA_ALIGN(ELSA_CACHE_LINE_SIZE) u32 Dropped;
+    // The number of recorded scopes of the thread that haven't ended. Only used by the thread.
+    u32 Depth;
+    const char* Name;
+    char DefaultName[16];
+    u32 Index;
+
+    // The rest is only used by the main thread.
+    ProfileOpenScope Open[PROFILE_MAX_DEPTH];
+    u32 OpenCount;
+    u32 Root;
+    u64 RootFrame;
+
+    ProfileEvent Events[PROFILE_RING_CAPACITY];
+} ProfileThread;
+
+typedef struct ProfilerState {
+    u32 Running;
+    // Changes every time the profiler starts, which invalidates the thread pointers threads cached.
+    u32 Generation;
+
+    SpinLock ThreadLock;
+    ProfileThread* Threads[PROFILE_MAX_THREADS];
+    u32 ThreadCount;
+
+    // The frame being built, and the last one ended.
+    ProfileFrame Frames[2];
+    u32 CurrentFrame;
+    b8 HasLastFrame;
+} ProfilerState;
+
+static ProfilerState profiler;
+static ELSA_THREAD_LOCAL ProfileThread* profile_thread;
+static ELSA_THREAD_LOCAL u32 profile_thread_generation;
+static ELSA_THREAD_LOCAL const char* profile_thread_name;
+
+u64 ProfilerNow()
+{
+    return (u64)(PlatformGetAbsoluteTime() * 1000000000.0);
+}
+
+ProfileThread* ProfileRegisterThread(u32 generation)
+{
+    ProfileThread* thread = MemoryTrackerAlloc(sizeof(ProfileThread), MEMORY_TAG_PROFILER);
+    if (thread)
+        PlatformZeroMemory(thread, sizeof(ProfileThread));
+
+    SpinLockAcquire(&profiler.ThreadLock);
+    u32 index = profiler.ThreadCount;
+    if (thread && index < PROFILE_MAX_THREADS) {
+        thread->RootFrame = ~0ull;
+        thread->Index = index;
+        snprintf(thread->DefaultName, sizeof(thread->DefaultName), "Thread %u", index);
+        thread->Name = profile_thread_name ? profile_thread_name : thread->DefaultName;
+        profiler.Threads[index] = thread;
+        AtomicStore(&profiler.ThreadCount, index + 1, ATOMIC_RELEASE);
+    } else if (thread) {
+        MemoryTrackerFree(thread, sizeof(ProfileThread), MEMORY_TAG_PROFILER);
+        thread = 0;
+    }
+    SpinLockRelease(&profiler.ThreadLock);
+
+    // Threads that couldn't get a buffer don't try again until the profiler restarts.
+    profile_thread = thread;
+    profile_thread_generation = generation;
+    return thread;
+}
+
+ProfileThread* ProfileGetThread()
+{
+    u32 generation = AtomicLoad(&profiler.Generation, ATOMIC_RELAXED);
+    if (profile_thread_generation == generation)
+        return profile_thread;
+    if (!AtomicLoad(&profiler.Running, ATOMIC_ACQUIRE))
+        return 0;
+    return ProfileRegisterThread(generation);
+}
+
+ProfileScope ProfileScopeBegin(const char* name)
+{
+    ProfileScope scope = {false, false};
+    ProfileThread* thread = ProfileGetThread();
+    if (!thread)
+        return scope;
+
+    u64 write_position = thread->WritePos;
+    u64 read_position = AtomicLoad(&thread->ReadPos, ATOMIC_ACQUIRE);
+    // Keep room for the end of this scope, and of every scope still open, so that they all end.
+    if (thread->Depth >= PROFILE_MAX_DEPTH || write_position - read_position + thread->Depth + 2 > PROFILE_RING_CAPACITY) {
+        AtomicFetchAdd(&thread->Dropped, 1, ATOMIC_RELAXED);
+        return scope;
+    }
+
+    ProfileEvent* event = &thread->Events[write_position & (PROFILE_RING_CAPACITY - 1)];
+    event->Name = name;
+    event->Time = ProfilerNow();
+    AtomicStore(&thread->WritePos, write_position + 1, ATOMIC_RELEASE);
+    thread->Depth++;
+
+    scope.Recorded = true;
+    return scope;
+}
+
+void ProfileScopeEnd(ProfileScope* scope)
+{
+    if (!scope->Recorded)
+        return;
+
+    ProfileThread* thread = profile_thread;
+    u64 write_position = thread->WritePos;
+    ProfileEvent* event = &thread->Events[write_position & (PROFILE_RING_CAPACITY - 1)];
+    event->Name = 0;
+    event->Time = ProfilerNow();
+    AtomicStore(&thread->WritePos, write_position + 1, ATOMIC_RELEASE);
+    thread->Depth--;
+}
+
+void ProfilerSetThreadName(const char* name)
+{
+    profile_thread_name = name;
+    if (profile_thread && profile_thread_generation == AtomicLoad(&profiler.Generation, ATOMIC_RELAXED))
+        AtomicStore(&profile_thread->Name, name, ATOMIC_RELAXED);
+}
+
+u32 ProfilerGetThreadIndex()
+{
+    ProfileThread* thread = ProfileGetThread();
+    return thread ? thread->Index : PROFILE_NODE_NONE;
+}
+
+u32 ProfilerGetThreadCount()
+{
+    return AtomicLoad(&profiler.ThreadCount, ATOMIC_ACQUIRE);
+}
+
+const char* ProfilerGetThreadName(u32 index)
+{
+    if (index >= AtomicLoad(&profiler.ThreadCount, ATOMIC_ACQUIRE))
+        return 0;
+    return AtomicLoad(&profiler.Threads[index]->Name, ATOMIC_RELAXED);
+}
+
+u32 ProfileAddNode(ProfileFrame* frame, u32 parent, u32 last_child, const char* name)
+{
+    ProfileNode node;
+    PlatformZeroMemory(&node, sizeof(node));
+    node.Name = name;
+    node.Parent = parent;
+    node.FirstChild = PROFILE_NODE_NONE;
+    node.NextSibling = PROFILE_NODE_NONE;
+    node.Depth = parent == PROFILE_NODE_NONE ? 0 : frame->Nodes[parent].Depth + 1;
+
+    u32 index = (u32)Darray_Length(frame->Nodes);
+    Darray_Push(frame->Nodes, node);
+    if (last_child != PROFILE_NODE_NONE)
+        frame->Nodes[last_child].NextSibling = index;
+    else if (parent != PROFILE_NODE_NONE)
+        frame->Nodes[parent].FirstChild = index;
+    return index;
+}
+
+u32 ProfileFindOrAddChild(ProfileFrame* frame, u32 parent, const char* name)
+{
+    u32 last_child = PROFILE_NODE_NONE;
+    for (u32 child = frame->Nodes[parent].FirstChild; child != PROFILE_NODE_NONE; child = frame->Nodes[child].NextSibling) {
+        // The same literal can have a different address in another translation unit.
+        if (frame->Nodes[child].Name == name || strcmp(frame->Nodes[child].Name, name) == 0)
+            return child;
+        last_child = child;
+    }
+    return ProfileAddNode(frame, parent, last_child, name);
+}
+
+// Finds the node of an open scope in the frame being built, adding it and its parents as needed.
+u32 ProfileResolveNode(ProfileThread* thread, ProfileFrame* frame, u32 open_index)
+{
+    if (thread->RootFrame != frame->FrameIndex) {
+        thread->Root = ProfileAddNode(frame, PROFILE_NODE_NONE, PROFILE_NODE_NONE, AtomicLoad(&thread->Name, ATOMIC_RELAXED));
+        thread->RootFrame = frame->FrameIndex;
+    }
+
+    u32 parent = thread->Root;
+    for (u32 i = 0; i <= open_index; i++) {
+        ProfileOpenScope* open = &thread->Open[i];
+        if (open->NodeFrame != frame->FrameIndex) {
+            open->Node = ProfileFindOrAddChild(frame, parent, open->Name);
+            open->NodeFrame = frame->FrameIndex;
+        }
+        parent = open->Node;
+    }
+    return parent;
+}
+
+// Adds every scope that ended since the last frame to the call tree of the thread. Scopes
+// still open are kept for a later frame, which gets all of their time.
+void ProfileDrainThread(ProfileThread* thread, ProfileFrame* frame)
+{
+    b8 traced = TraceIsCapturing();
+    u64 read_position = thread->ReadPos;
+    u64 write_position = AtomicLoad(&thread->WritePos, ATOMIC_ACQUIRE);
+    for (; read_position != write_position; read_position++) {
+        ProfileEvent* event = &thread->Events[read_position & (PROFILE_RING_CAPACITY - 1)];
+        if (event->Name) {
+            ProfileOpenScope* open = &thread->Open[thread->OpenCount++];
+            open->Name = event->Name;
+            open->Start = event->Time;
+            open->NodeFrame = ~0ull;
+        } else if (thread->OpenCount) {
+            u32 node = ProfileResolveNode(thread, frame, thread->OpenCount - 1);
+            ProfileOpenScope* open = &thread->Open[--thread->OpenCount];
+            frame->Nodes[node].Calls++;
+            frame->Nodes[node].InclusiveNs += event->Time - open->Start;
+            if (traced)
+                TraceScope(thread->Index, open->Name, open->Start, event->Time);
+        }
+    }
+    AtomicStore(&thread->ReadPos, read_position, ATOMIC_RELEASE);
+
+    frame->DroppedScopes += AtomicExchange(&thread->Dropped, 0, ATOMIC_RELAXED);
+}
+
+void ProfileComputeExclusive(ProfileFrame* frame)
+{
+    u32 node_count = (u32)Darray_Length(frame->Nodes);
+    for (u32 i = 0; i < node_count; i++)
+        frame->Nodes[i].ExclusiveNs = frame->Nodes[i].InclusiveNs;
+
+    // Children always come after their parents, so the roots get their totals before
+    // anything reads them. Roots have no time of their own, only that of their children.
+    for (u32 i = 0; i < node_count; i++) {
+        ProfileNode* node = &frame->Nodes[i];
+        if (node->Parent == PROFILE_NODE_NONE)
+            continue;
+        ProfileNode* parent = &frame->Nodes[node->Parent];
+        if (parent->Parent == PROFILE_NODE_NONE)
+            parent->InclusiveNs += node->InclusiveNs;
+        else
+            // A child can outlast its parent when the parent began in an earlier frame.
+            parent->ExclusiveNs = parent->ExclusiveNs > node->InclusiveNs ? parent->ExclusiveNs - node->InclusiveNs : 0;
+    }
+}
+
+b8 ProfilerInit()
+{
+    for (u32 i = 0; i < 2; i++) {
+        PlatformZeroMemory(&profiler.Frames[i], sizeof(ProfileFrame));
+        profiler.Frames[i].Nodes = Darray_Create(ProfileNode);
+        if (!profiler.Frames[i].Nodes) {
+            ELSA_ERROR("Failed to allocate the profiler frames!");
+            ProfilerShutdown();
+            return false;
+        }
+    }
+    profiler.CurrentFrame = 0;
+    profiler.HasLastFrame = false;
+    profiler.ThreadCount = 0;
+    profiler.Frames[0].StartNs = ProfilerNow();
+
+    AtomicFetchAdd(&profiler.Generation, 1, ATOMIC_RELAXED);
+    AtomicStore(&profiler.Running, 1, ATOMIC_RELEASE);
+    ProfilerSetThreadName("Main");
+    return true;
+}
+
+void ProfilerShutdown()
+{
+    AtomicStore(&profiler.Running, 0, ATOMIC_RELEASE);
+    AtomicFetchAdd(&profiler.Generation, 1, ATOMIC_RELAXED);
+
+    for (u32 i = 0; i < profiler.ThreadCount; i++)
+        MemoryTrackerFree(profiler.Threads[i], sizeof(ProfileThread), MEMORY_TAG_PROFILER);
+    profiler.ThreadCount = 0;
+
+    for (u32 i = 0; i < 2; i++) {
+        if (profiler.Frames[i].Nodes)
+            Darray_Destroy(profiler.Frames[i].Nodes);
+        profiler.Frames[i].Nodes = 0;
+    }
+    profiler.HasLastFrame = false;
+}
+
+void ProfilerEndFrame()
+{
+    if (!AtomicLoad(&profiler.Running, ATOMIC_ACQUIRE))
+        return;
+
+    ProfileFrame* frame = &profiler.Frames[profiler.CurrentFrame];
+    frame->EndNs = ProfilerNow();
+    u32 thread_count = AtomicLoad(&profiler.ThreadCount, ATOMIC_ACQUIRE);
+    for (u32 i = 0; i < thread_count; i++)
+        ProfileDrainThread(profiler.Threads[i], frame);
+    ProfileComputeExclusive(frame);
+    TraceEndFrame(frame);
+
+    profiler.CurrentFrame ^= 1;
+    profiler.HasLastFrame = true;
+
+    ProfileFrame* next = &profiler.Frames[profiler.CurrentFrame];
+    Darray_Clear(next->Nodes);
+    next->FrameIndex = frame->FrameIndex + 1;
+    next->StartNs = frame->EndNs;
+    next->EndNs = 0;
+    next->DroppedScopes = 0;
+}
+
+const ProfileFrame* ProfilerGetLastFrame()
+{
+    return profiler.HasLastFrame ? &profiler.Frames[profiler.CurrentFrame ^ 1] : 0;
+}
+
+void ProfileLogNode(const ProfileFrame* frame, u32 index)
+{
+    const ProfileNode* node = &frame->Nodes[index];
+    if (node->Parent == PROFILE_NODE_NONE) {
+        ELSA_INFO("  %s: %.3f ms", node->Name, node->InclusiveNs / 1000000.0);
+    } else {
+        ELSA_INFO("  %*s%s: %.3f ms, %.3f ms exclusive, %u calls", (i32)node->Depth * 2, "", node->Name,
+                  node->InclusiveNs / 1000000.0, node->ExclusiveNs / 1000000.0, node->Calls);
+    }
+
+    for (u32 child = node->FirstChild; child != PROFILE_NODE_NONE; child = frame->Nodes[child].NextSibling)
+        ProfileLogNode(frame, child);
+}
+
+void ProfilerLogFrame(const ProfileFrame* frame)
+{
+    ELSA_INFO("Profile of frame %llu: %.3f ms, %u scopes dropped", frame->FrameIndex,
+              (frame->EndNs - frame->StartNs) / 1000000.0, frame->DroppedScopes);
+    for (u32 i = 0; i < Darray_Length(frame->Nodes); i++) {
+        if (frame->Nodes[i].Parent == PROFILE_NODE_NONE)
+            ProfileLogNode(frame, i);
+    }
+}
@@ -0,0 +1,185 @@
+/**
+ * @file Profiler.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains a hierarchical CPU profiler. Scopes record their begin
+ * and end times into a ring buffer of the thread they run on, and the main thread
+ * turns those into a call tree of every frame.
+ * @version 1.0
+ * @date 2022-07-27
+ */
+#ifndef ELSA_PROFILER_H
+#define ELSA_PROFILER_H
+
+#include <Defines.h>
+
+/**
+ * @brief Indicates if the profiler macros are compiled in. When 0, PROFILE_SCOPE and
+ * CODE_BLOCK compile to nothing. Defaults to 1, or 0 in release builds.
+ */
+#ifndef ELSA_PROFILE_ENABLED
+#if ELSA_RELEASE == 1
+    #define ELSA_PROFILE_ENABLED 0
+#else
+    #define ELSA_PROFILE_ENABLED 1
+#endif
+#endif
+
+/** @brief The maximum number of threads that can record scopes. */
+#define PROFILE_MAX_THREADS 64
+
+/** @brief The number of begin and end events the ring buffer of each thread holds. Must be a power of 2. */
+#define PROFILE_RING_CAPACITY 16384
+
+/** @brief The maximum nesting depth of the scopes of a thread. Deeper scopes aren't recorded. */
+#define PROFILE_MAX_DEPTH 64
+
+/** @brief The index used for a node that doesn't exist. */
+#define PROFILE_NODE_NONE 0xFFFFFFFF
+
+/** @brief Represents a scope being recorded. Only used through the profiler macros. */
+typedef struct ProfileScope {
+    /** @brief Indicates if the beginning of the scope was recorded, so that its end must be too. */
+    b8 Recorded;
+    /** @brief Used by CODE_BLOCK to run its block once. */
+    b8 Done;
+} ProfileScope;
+
+/**
+ * @brief Represents every call of a scope with the same parents in a frame. The root
+ * of every thread that recorded scopes is a node named after the thread.
+ */
+typedef struct ProfileNode {
+    /** @brief The name of the scope. */
+    const char* Name;
+    /** @brief The index of the parent node, or PROFILE_NODE_NONE for the root of a thread. */
+    u32 Parent;
+    /** @brief The index of the first child, or PROFILE_NODE_NONE. */
+    u32 FirstChild;
+    /** @brief The index of the next node with the same parent, or PROFILE_NODE_NONE. */
+    u32 NextSibling;
+    /** @brief The depth of the node, 0 for the root of a thread. */
+    u32 Depth;
+    /** @brief The number of times the scope ended during the frame. */
+    u32 Calls;
+    /** @brief The time spent in the scope, in nanoseconds. */
+    u64 InclusiveNs;
+    /** @brief The time spent in the scope outside its children, in nanoseconds. */
+    u64 ExclusiveNs;
+} ProfileNode;
+
+/** @brief Represents the call trees of every thread over a frame. */
+typedef struct ProfileFrame {
+    /** @brief The number of the frame, counting from 0. */
+    u64 FrameIndex;
+    /** @brief The time the frame started, in nanoseconds of ProfilerNow. */
+    u64 StartNs;
+    /** @brief The time the frame ended, in nanoseconds of ProfilerNow. */
+    u64 EndNs;
+    /** @brief The nodes of the frame, as a darray. Parents always come before their children. */
+    ProfileNode* Nodes;
+    /** @brief The number of scopes that weren't recorded because a ring buffer was full, or scopes were nested too deep. */
+    u32 DroppedScopes;
+} ProfileFrame;
+
+/**
+ * @brief Initializes the profiler. Scopes are only recorded between this and ProfilerShutdown.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 ProfilerInit();
+
+/**
+ * @brief Shuts the profiler down, freeing the buffers of every thread.
+ * Other threads must have stopped recording scopes by the time this is called.
+ */
+ELSA_API void ProfilerShutdown();
+
+/**
+ * @brief Gets the time of the clock scopes are recorded with.
+ * @returns The time in nanoseconds.
+ */
+ELSA_API u64 ProfilerNow();
+
+/**
+ * @brief Names the calling thread in the profile. Call it before the thread records any scope.
+ * @param name The name of the thread. Must outlive the profiler.
+ */
+ELSA_API void ProfilerSetThreadName(const char* name);
+
+/**
+ * @brief Gets the index of the calling thread in the profile, registering it if needed.
+ * @returns The index, or PROFILE_NODE_NONE if the profiler isn't running or has no room for the thread.
+ */
+ELSA_API u32 ProfilerGetThreadIndex();
+
+/**
+ * @brief Gets the number of threads registered in the profile.
+ * @returns The number of threads.
+ */
+ELSA_API u32 ProfilerGetThreadCount();
+
+/**
+ * @brief Gets the name of a thread registered in the profile.
+ * @param index The index of the thread.
+ * @returns The name of the thread, or 0 if there's no thread with that index.
+ */
+ELSA_API const char* ProfilerGetThreadName(u32 index);
+
+/**
+ * @brief Ends the current frame, turning the scopes every thread recorded since the last
+ * call into call trees. Must be called from the main thread, outside of any scope.
+ */
+ELSA_API void ProfilerEndFrame();
+
+/**
+ * @brief Gets the last frame ended by ProfilerEndFrame. Valid until the next call of it.
+ * @returns A pointer to the frame, or 0 if no frame has ended yet.
+ */
+ELSA_API const ProfileFrame* ProfilerGetLastFrame();
+
+/**
+ * @brief Logs the call trees of a frame, with the inclusive and exclusive time of every node.
+ * @param frame A pointer to the frame.
+ */
+ELSA_API void ProfilerLogFrame(const ProfileFrame* frame);
+
+/**
+ * @brief Records the beginning of a scope. Safe to call from any thread.
+ * @note Avoid using this directly; use the PROFILE_SCOPE or CODE_BLOCK macros instead.
+ * @param name The name of the scope. Must be a string literal, or outlive the profiler.
+ * @returns The scope, to pass to ProfileScopeEnd.
+ */
+ELSA_API ProfileScope ProfileScopeBegin(const char* name);
+
+/**
+ * @brief Records the end of a scope.
+ * @note Avoid using this directly; use the PROFILE_SCOPE or CODE_BLOCK macros instead.
+ * @param scope A pointer to the scope returned by ProfileScopeBegin.
+ */
+ELSA_API void ProfileScopeEnd(ProfileScope* scope);
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#if ELSA_PROFILE_ENABLED == 1
+/**
+ * @brief Profiles the rest of the enclosing block, however it is left.
+ * @param name The name of the scope. Must be a string literal.
+ */
+#define PROFILE_SCOPE(name) \
+    ProfileScope PROFILE_CONCAT(elsa_profile_scope_, __LINE__) __attribute__((cleanup(ProfileScopeEnd))) = ProfileScopeBegin(name)
+
+#undef CODE_BLOCK
+/**
+ * @brief Marks the block that follows, and profiles it, however it is left. A break
+ * or continue directly inside the block leaves the block rather than an enclosing loop.
+ * @param name The name of the block. Must be a string literal.
+ */
+#define CODE_BLOCK(name)                                                                            \
+    for (ProfileScope elsa_code_block __attribute__((cleanup(ProfileScopeEnd))) = ProfileScopeBegin(name); \
+         !elsa_code_block.Done; elsa_code_block.Done = true)
+#else
+/** @brief Does nothing when ELSA_PROFILE_ENABLED != 1 */
+#define PROFILE_SCOPE(name)
+#endif
+
+#endif
@@ -0,0 +1,233 @@
+#include "StringId.h"
+
+#include <Core/Atomic.h>
+#include <Core/Logger.h>
+#include <Core/MemTracker.h>
+#include <Containers/Darray.h>
+#include <Platform/Platform.h>
+
+#define STRING_ID_INDEX_INITIAL_CAPACITY 1024
+#define STRING_ID_NO_SLOT 0xFFFFFFFF
+
+typedef struct StringEntry {
+	const char* String;
+	u64 Hash;
+	u32 Length;
+} StringEntry;
+
+typedef struct StringIdInternal {
+	SpinLock Lock;
+	b8 Initialized;
+
+	// Stable, so that entries never move and can be read without the lock.
+	StringEntry* Entries;
+	u32 Count;
+
+	// Open-addressing index of entry ids, kept under half full.
+	u32* Index;
+	u32 IndexCapacity;
+
+	// Interned strings are bump allocated out of blocks that are only freed on shutdown.
+	MemoryArena* Blocks;
+} StringIdInternal;
+
+static StringIdInternal strings;
+
+b8 StringIdIndexAllocate(u32 capacity)
+{
+	u32* index = MemoryTrackerAlloc(sizeof(u32) * capacity, MEMORY_TAG_STRING_TABLE);
+	if (!index)
+		return false;
+	PlatformZeroMemory(index, sizeof(u32) * capacity);
+
+	u32* old_index = strings.Index;
+	u32 old_capacity = strings.IndexCapacity;
+	strings.Index = index;
+	strings.IndexCapacity = capacity;
+
+	for (u32 i = 0; i < old_capacity; i++) {
+		StringId id = old_index[i];
+		if (id == STRING_ID_INVALID)
+			continue;
+
+		u32 slot = (u32)strings.Entries[id - 1].Hash & (capacity - 1);
+		while (index[slot] != STRING_ID_INVALID)
+			slot = (slot + 1) & (capacity - 1);
+		index[slot] = id;
+	}
+
+	if (old_index)
+		MemoryTrackerFree(old_index, sizeof(u32) * old_capacity, MEMORY_TAG_STRING_TABLE);
+	return true;
+}
+
+// Returns the index slot holding the string, or the empty slot it should be inserted in,
+// or STRING_ID_NO_SLOT if the index is full without holding it.
+u32 StringIdFindSlot(const char* string, u32 length, u64 hash)
+{
+	u32 mask = strings.IndexCapacity - 1;
+	u32 slot = (u32)hash & mask;
+	for (u32 probe = 0; probe < strings.IndexCapacity; probe++) {
+		StringId id = strings.Index[slot];
+		if (id == STRING_ID_INVALID)
+			return slot;
+
+		StringEntry* entry = &strings.Entries[id - 1];
+		if (entry->Hash == hash && entry->Length == length && __builtin_memcmp(entry->String, string, length) == 0)
+			return slot;
+
+		slot = (slot + 1) & mask;
+	}
+	return STRING_ID_NO_SLOT;
+}
+
+char* StringIdStore(const char* string, u32 length)
+{
+	u64 size = (u64)length + 1;
+	u64 block_count = Darray_Length(strings.Blocks);
+	char* copy = 0;
+	if (block_count) {
+		MemoryArena* block = &strings.Blocks[block_count - 1];
+		if (block->Offset + size <= block->Capacity)
+			copy = MemoryArenaPush(block, size, 1);
+	}
+
+	if (!copy) {
+		MemoryArena block;
+		if (!MemoryArenaCreate(size > STRING_ID_BLOCK_SIZE ? size : STRING_ID_BLOCK_SIZE, MEMORY_TAG_STRING_TABLE, &block))
+			return 0;
+		copy = MemoryArenaPush(&block, size, 1);
+		Darray_Push(strings.Blocks, block);
+	}
+
+	PlatformCopyMemory(copy, string, length);
+	copy[length] = 0;
+	return copy;
+}
+
+b8 StringIdInit()
+{
+	PlatformZeroMemory(&strings, sizeof(StringIdInternal));
+
+	strings.Entries = Darray_CreateStable(StringEntry, STRING_ID_MAX_STRINGS);
+	if (!strings.Entries) {
+		ELSA_ERROR("Failed to reserve the string entry array!");
+		return false;
+	}
+	strings.Blocks = Darray_Create(MemoryArena);
+
+	if (!StringIdIndexAllocate(STRING_ID_INDEX_INITIAL_CAPACITY)) {
+		ELSA_ERROR("Failed to allocate the string index!");
+		return false;
+	}
+
+	strings.Initialized = true;
+	return true;
+}
+
+void StringIdShutdown()
+{
+	if (!strings.Initialized)
+		return;
+
+	for (u64 i = 0; i < Darray_Length(strings.Blocks); i++) {
+		MemoryArenaDestroy(&strings.Blocks[i]);
+	}
+	Darray_Destroy(strings.Blocks);
+	Darray_Destroy(strings.Entries);
+	MemoryTrackerFree(strings.Index, sizeof(u32) * strings.IndexCapacity, MEMORY_TAG_STRING_TABLE);
+
+	PlatformZeroMemory(&strings, sizeof(StringIdInternal));
+}
+
+StringId StringIdIntern(const char* string)
+{
+	if (!string)
+		return STRING_ID_INVALID;
+
+	return StringIdInternHashed(HashedStringCreate(string));
+}
+
+StringId StringIdInternHashed(HashedString string)
+{
+	if (!string.String)
+		return STRING_ID_INVALID;
+
+	u32 length = (u32)__builtin_strlen(string.String);
+
+	SpinLockAcquire(&strings.Lock);
+
+	u32 slot = StringIdFindSlot(string.String, length, string.Hash);
+	StringId id = slot != STRING_ID_NO_SLOT ? strings.Index[slot] : STRING_ID_INVALID;
+	if (id != STRING_ID_INVALID) {
+		SpinLockRelease(&strings.Lock);
+		return id;
+	}
+
+	if (strings.Count >= STRING_ID_MAX_STRINGS) {
+		SpinLockRelease(&strings.Lock);
+		ELSA_ERROR("StringIdIntern: the string table is full! (%d strings)", STRING_ID_MAX_STRINGS);
+		return STRING_ID_INVALID;
+	}
+
+	// Only reached once growing the index failed. The last empty slot is what ends every probe.
+	if (strings.Count + 1 >= strings.IndexCapacity) {
+		SpinLockRelease(&strings.Lock);
+		ELSA_ERROR("StringIdIntern: the string index is full and couldn't grow! (%u strings)", strings.IndexCapacity - 1);
+		return STRING_ID_INVALID;
+	}
+
+	StringEntry entry;
+	entry.String = StringIdStore(string.String, length);
+	entry.Hash = string.Hash;
+	entry.Length = length;
+	if (!entry.String) {
+		SpinLockRelease(&strings.Lock);
+		ELSA_ERROR("StringIdIntern: failed to store string '%s'!", string.String);
+		return STRING_ID_INVALID;
+	}
+	Darray_Push(strings.Entries, entry);
+
+	// Publish the entry before its id, for lock-free readers.
+	id = strings.Count + 1;
+	AtomicStore(&strings.Count, id, ATOMIC_RELEASE);
+	strings.Index[slot] = id;
+
+	if ((strings.Count * 2) > strings.IndexCapacity && !StringIdIndexAllocate(strings.IndexCapacity * 2))
+		ELSA_WARN_LIMITED("StringIdIntern: failed to grow the string index, lookups will slow down.");
+
+	SpinLockRelease(&strings.Lock);
+	return id;
+}
+
+StringId StringIdFind(const char* string)
+{
+	if (!string)
+		return STRING_ID_INVALID;
+
+	u64 hash = HashString(string);
+	u32 length = (u32)__builtin_strlen(string);
+
+	SpinLockAcquire(&strings.Lock);
+	u32 slot = StringIdFindSlot(string, length, hash);
+	StringId id = slot != STRING_ID_NO_SLOT ? strings.Index[slot] : STRING_ID_INVALID;
+	SpinLockRelease(&strings.Lock);
+
+	return id;
+}
+
+const char* StringIdGetString(StringId id)
+{
+	if (id == STRING_ID_INVALID || id > AtomicLoad(&strings.Count, ATOMIC_ACQUIRE))
+		return 0;
+
+	return strings.Entries[id - 1].String;
+}
+
+u32 StringIdGetLength(StringId id)
+{
+	if (id == STRING_ID_INVALID || id > AtomicLoad(&strings.Count, ATOMIC_ACQUIRE))
+		return 0;
+
+	return strings.Entries[id - 1].Length;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file StringId.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains the string interning system. Interned strings are
+ * stored once and referred to by a 32-bit id, so that comparing them is an
+ * integer compare.
+ * @version 1.0
+ * @date 2022-07-20
+ */
+#ifndef ELSA_STRING_ID_H
+#define ELSA_STRING_ID_H
+
+#include <Defines.h>
+#include <Core/Hash.h>
+
+/** @brief Identifies an interned string. Equal strings always have equal ids. */
+typedef u32 StringId;
+
+/** @brief The id that never refers to a string. */
+#define STRING_ID_INVALID 0
+
+/** @brief The maximum number of strings that can be interned. */
+#define STRING_ID_MAX_STRINGS (1024 * 1024)
+
+/** @brief The size of each block of memory the interned strings are stored in. */
+#define STRING_ID_BLOCK_SIZE (64 * 1024)
+
+/**
+ * @brief Initializes the string interning system.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 StringIdInit();
+
+/** @brief Shuts down the string interning system. Every id becomes invalid. */
+ELSA_API void StringIdShutdown();
+
+/**
+ * @brief Interns a string, copying it if it wasn't interned before. Safe to call from any thread.
+ * @param string The string to intern.
+ * @returns The id of the string, or STRING_ID_INVALID if string is 0 or the table is full.
+ */
+ELSA_API StringId StringIdIntern(const char* string);
+
+/**
+ * @brief Same as StringIdIntern, but takes a string whose hash was computed up front.
+ * @param string The string to intern.
+ * @returns The id of the string, or STRING_ID_INVALID if string is 0 or the table is full.
+ */
+ELSA_API StringId StringIdInternHashed(HashedString string);
+
+/**
+ * @brief Looks up the id of a string without interning it.
+ * @param string The string to look up.
+ * @returns The id of the string, or STRING_ID_INVALID if it was never interned.
+ */
+ELSA_API StringId StringIdFind(const char* string);
+
+/**
+ * @brief Returns the interned copy of a string. The pointer stays valid until shutdown.
+ * Safe to call from any thread, and never takes a lock.
+ * @param id The id of the string.
+ * @returns The null-terminated string, or 0 if the id is invalid.
+ */
+ELSA_API const char* StringIdGetString(StringId id);
+
+/**
+ * @brief Returns the length of an interned string.
+ * @param id The id of the string.
+ * @returns The length of the string in bytes, excluding the terminator.
+ */
+ELSA_API u32 StringIdGetLength(StringId id);
+
+#endif
@@ -0,0 +1,485 @@
+#include "Trace.h"
+
+#include <Containers/MpmcQueue.h>
+#include <Containers/SpscQueue.h>
+#include <Core/Atomic.h>
+#include <Core/Logger.h>
+#include <Core/MemTracker.h>
+#include <Core/Profiler.h>
+#include <Platform/FileSystem.h>
+#include <Platform/Platform.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// The size of the text the writer thread formats records into before writing it.
+#define TRACE_TEXT_CAPACITY (64 * 1024)
+// The most text a single record can take, names included.
+#define TRACE_RECORD_TEXT_MAX 2048
+// The most characters of a name that are written.
+#define TRACE_NAME_MAX 256
+
+// The tracks that don't belong to a profiled thread.
+#define TRACE_TID_FRAMES PROFILE_MAX_THREADS
+#define TRACE_TID_OTHER_THREADS (PROFILE_MAX_THREADS + 1)
+
+typedef enum TraceRecordKind {
+    TRACE_RECORD_THREAD_NAME,
+    TRACE_RECORD_SCOPE,
+    TRACE_RECORD_EVENT,
+    TRACE_RECORD_FRAME,
+    TRACE_RECORD_COUNTER
+} TraceRecordKind;
+
+// Records are formatted by the writer thread, so the main thread only copies them.
+// Every name must outlive the capture.
+typedef struct TraceRecord {
+    const char* Name;
+    u64 Start;
+    u64 End;
+    // The frame index of a frame, the value of a counter, or the code and handled flag of an event.
+    u64 Value;
+    u32 Thread;
+    u32 Kind;
+} TraceRecord;
+
+typedef struct TraceChunk {
+    u32 Count;
+    TraceRecord Records[TRACE_CHUNK_RECORDS];
+} TraceChunk;
+
+typedef struct TraceFiredEvent {
+    u64 Start;
+    u64 End;
+    u32 Thread;
+    u16 Code;
+    b8 Handled;
+} TraceFiredEvent;
+
+typedef struct TraceState {
+    b8 Initialized;
+    // Read by any thread that fires an event.
+    u32 Capturing;
+    MpmcQueue Fired;
+    u32 DroppedEvents;
+
+    // The capture, only used by the main thread.
+    u64 StartNs;
+    u32 FrameLimit;
+    u32 FrameCount;
+    u32 DroppedRecords;
+    b8 NamedThreads[PROFILE_MAX_THREADS];
+    TraceChunk* Current;
+
+    // Shared with the writer thread, which owns the chunks between Full and Free.
+    TraceChunk* Chunks;
+    SpscQueue Free;
+    SpscQueue Full;
+    u32 Stopping;
+    b8 WriterActive;
+    PlatformThread Writer;
+
+    // Only used by the writer thread while it runs.
+    FileHandle File;
+    char Text[TRACE_TEXT_CAPACITY];
+    u64 TextLength;
+    b8 WriteFailed;
+} TraceState;
+
+static TraceState trace;
+
+void TraceFlushText()
+{
+    if (trace.TextLength == 0)
+        return;
+
+    u64 written = 0;
+    if (!trace.WriteFailed && !FileSystemWrite(&trace.File, trace.TextLength, trace.Text, &written))
+        trace.WriteFailed = true;
+    trace.TextLength = 0;
+}
+
+void TraceAppend(const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    i32 length = vsnprintf(trace.Text + trace.TextLength, TRACE_TEXT_CAPACITY - trace.TextLength, format, args);
+    va_end(args);
+    if (length > 0)
+        trace.TextLength += (u64)length < TRACE_TEXT_CAPACITY - trace.TextLength ? (u64)length : TRACE_TEXT_CAPACITY - trace.TextLength - 1;
+}
+
+// Appends a name as a JSON string.
+void TraceAppendName(const char* name)
+{
+    static const char hex[] = "0123456789abcdef";
+    char* out = trace.Text + trace.TextLength;
+    *out++ = '"';
+    for (u32 i = 0; name && name[i] && i < TRACE_NAME_MAX; i++) {
+        u8 c = (u8)name[i];
+        if (c == '"' || c == '\\') {
+            *out++ = '\\';
+            *out++ = (char)c;
+        } else if (c < 0x20) {
+            *out++ = '\\';
+            *out++ = 'u';
+            *out++ = '0';
+            *out++ = '0';
+            *out++ = hex[c >> 4];
+            *out++ = hex[c & 0xF];
+        } else {
+            *out++ = (char)c;
+        }
+    }
+    *out++ = '"';
+    trace.TextLength = (u64)(out - trace.Text);
+}
+
+// Appends a time as microseconds since the capture started, the unit of the format.
+void TraceAppendTime(const char* key, u64 ns)
+{
+    TraceAppend(",\"%s\":%llu.%03llu", key, ns / 1000, ns % 1000);
+}
+
+void TraceWriteRecord(const TraceRecord* record)
+{
+    if (trace.TextLength + TRACE_RECORD_TEXT_MAX > TRACE_TEXT_CAPACITY)
+        TraceFlushText();
+
+    // Cut what happened before the capture started.
+    u64 begin = record->Start > trace.StartNs ? record->Start : trace.StartNs;
+    u64 start = begin - trace.StartNs;
+    u64 duration = record->End > begin ? record->End - begin : 0;
+    switch (record->Kind) {
+        case TRACE_RECORD_THREAD_NAME:
+            TraceAppend(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", record->Thread);
+            TraceAppendName(record->Name);
+            TraceAppend("}}");
+            break;
+        case TRACE_RECORD_SCOPE:
+            TraceAppend(",\n{\"name\":");
+            TraceAppendName(record->Name);
+            TraceAppend(",\"ph\":\"X\",\"pid\":1,\"tid\":%u", record->Thread);
+            TraceAppendTime("ts", start);
+            TraceAppendTime("dur", duration);
+            TraceAppend("}");
+            break;
+        case TRACE_RECORD_EVENT:
+            TraceAppend(",\n{\"name\":\"EventFire\",\"cat\":\"event\",\"ph\":\"X\",\"pid\":1,\"tid\":%u", record->Thread);
+            TraceAppendTime("ts", start);
+            TraceAppendTime("dur", duration);
+            TraceAppend(",\"args\":{\"code\":%llu,\"handled\":%s}}", record->Value & 0xFFFF, (record->Value >> 16) ? "true" : "false");
+            break;
+        case TRACE_RECORD_FRAME:
+            TraceAppend(",\n{\"name\":\"Frame %llu\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":%u", record->Value, TRACE_TID_FRAMES);
+            TraceAppendTime("ts", start);
+            TraceAppendTime("dur", duration);
+            TraceAppend("}");
+            break;
+        case TRACE_RECORD_COUNTER:
+            TraceAppend(",\n{\"name\":");
+            TraceAppendName(record->Name);
+            TraceAppend(",\"cat\":\"memory\",\"ph\":\"C\",\"pid\":1");
+            TraceAppendTime("ts", start);
+            TraceAppend(",\"args\":{\"bytes\":%llu}}", record->Value);
+            break;
+    }
+}
+
+u32 TraceWriterThread(void* param)
+{
+    TraceAppend("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    TraceAppend("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Elsa\"}}");
+    TraceAppend(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"Frames\"}}", TRACE_TID_FRAMES);
+    TraceAppend(",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"sort_index\":-1}}", TRACE_TID_FRAMES);
+    TraceAppend(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"Other threads\"}}", TRACE_TID_OTHER_THREADS);
+
+    for (;;) {
+        // Every chunk is pushed before the capture stops, so once it has, an empty queue means the end.
+        b8 stopping = AtomicLoad(&trace.Stopping, ATOMIC_ACQUIRE);
+        TraceChunk* chunk;
+        if (SpscQueuePop(&trace.Full, &chunk)) {
+            for (u32 i = 0; i < chunk->Count; i++)
+                TraceWriteRecord(&chunk->Records[i]);
+            SpscQueuePush(&trace.Free, &chunk);
+            continue;
+        }
+        if (stopping)
+            break;
+
+        TraceFlushText();
+        PlatformSleep(1);
+    }
+
+    TraceAppend("\n]}\n");
+    TraceFlushText();
+    FileSystemClose(&trace.File);
+    if (trace.WriteFailed) {
+        ELSA_ERROR("Failed to write the trace file!");
+    }
+
+    MemoryTrackerFlushThreadCache();
+    return 0;
+}
+
+// Waits for the writer thread of the last capture and frees what it used.
+void TraceJoinWriter()
+{
+    if (trace.WriterActive) {
+        PlatformThreadJoin(&trace.Writer);
+        trace.WriterActive = false;
+    }
+
+    SpscQueueDestroy(&trace.Free);
+    SpscQueueDestroy(&trace.Full);
+    if (trace.Chunks) {
+        MemoryTrackerFree(trace.Chunks, sizeof(TraceChunk) * TRACE_CHUNK_COUNT, MEMORY_TAG_PROFILER);
+        trace.Chunks = 0;
+    }
+}
+
+TraceRecord* TraceAddRecord(TraceRecordKind kind)
+{
+    if (!trace.Current || trace.Current->Count == TRACE_CHUNK_RECORDS) {
+        if (trace.Current)
+            SpscQueuePush(&trace.Full, &trace.Current);
+        // Rather than waiting on the writer, drop records until it hands a chunk back.
+        if (!SpscQueuePop(&trace.Free, &trace.Current)) {
+            trace.Current = 0;
+            trace.DroppedRecords++;
+            return 0;
+        }
+        trace.Current->Count = 0;
+    }
+
+    TraceRecord* record = &trace.Current->Records[trace.Current->Count++];
+    record->Kind = kind;
+    record->Name = 0;
+    record->Start = 0;
+    record->End = 0;
+    record->Value = 0;
+    record->Thread = 0;
+    return record;
+}
+
+// Hands the records so far to the writer thread.
+void TraceSubmitChunk()
+{
+    if (trace.Current && trace.Current->Count) {
+        SpscQueuePush(&trace.Full, &trace.Current);
+        trace.Current = 0;
+    }
+}
+
+// Names the track of a thread the first time the thread shows up in the capture.
+u32 TraceThreadTrack(u32 thread)
+{
+    if (thread >= PROFILE_MAX_THREADS)
+        return TRACE_TID_OTHER_THREADS;
+
+    if (!trace.NamedThreads[thread]) {
+        TraceRecord* record = TraceAddRecord(TRACE_RECORD_THREAD_NAME);
+        if (record) {
+            record->Name = ProfilerGetThreadName(thread);
+            record->Thread = thread;
+            trace.NamedThreads[thread] = true;
+        }
+    }
+    return thread;
+}
+
+b8 TraceInit()
+{
+    if (!MpmcQueueCreate(sizeof(TraceFiredEvent), TRACE_EVENT_CAPACITY, &trace.Fired)) {
+        ELSA_ERROR("Failed to create the trace event queue!");
+        return false;
+    }
+    trace.Initialized = true;
+
+    const char* path = getenv(TRACE_ENV_PATH);
+    if (path && path[0]) {
+        const char* frames = getenv(TRACE_ENV_FRAMES);
+        TraceStart(path, frames ? (u32)strtoul(frames, 0, 10) : 0);
+    }
+    return true;
+}
+
+void TraceShutdown()
+{
+    if (!trace.Initialized)
+        return;
+
+    TraceStop();
+    TraceJoinWriter();
+    MpmcQueueDestroy(&trace.Fired);
+    trace.Initialized = false;
+}
+
+b8 TraceStart(const char* path, u32 frame_count)
+{
+    if (!trace.Initialized) {
+        ELSA_ERROR("TraceStart called before TraceInit!");
+        return false;
+    }
+    if (TraceIsCapturing()) {
+        ELSA_WARN("A trace is already being captured, ignoring TraceStart.");
+        return false;
+    }
+    TraceJoinWriter();
+
+    if (!FileSystemOpen(path, FILE_MODE_WRITE, false, &trace.File)) {
+        ELSA_ERROR("Failed to open the trace file '%s'!", path);
+        return false;
+    }
+
+    trace.Chunks = MemoryTrackerAlloc(sizeof(TraceChunk) * TRACE_CHUNK_COUNT, MEMORY_TAG_PROFILER);
+    if (!trace.Chunks || !SpscQueueCreate(sizeof(TraceChunk*), TRACE_CHUNK_COUNT, &trace.Free) ||
+        !SpscQueueCreate(sizeof(TraceChunk*), TRACE_CHUNK_COUNT, &trace.Full)) {
+        ELSA_ERROR("Failed to allocate the trace buffers!");
+        FileSystemClose(&trace.File);
+        TraceJoinWriter();
+        return false;
+    }
+    for (u32 i = 1; i < TRACE_CHUNK_COUNT; i++) {
+        TraceChunk* chunk = &trace.Chunks[i];
+        SpscQueuePush(&trace.Free, &chunk);
+    }
+    trace.Current = &trace.Chunks[0];
+    trace.Current->Count = 0;
+
+    // Drop the events fired since the last capture stopped.
+    TraceFiredEvent stale;
+    while (MpmcQueuePop(&trace.Fired, &stale))
+        ;
+
+    trace.StartNs = ProfilerNow();
+    trace.FrameLimit = frame_count;
+    trace.FrameCount = 0;
+    trace.DroppedRecords = 0;
+    AtomicStore(&trace.DroppedEvents, 0, ATOMIC_RELAXED);
+    PlatformZeroMemory(trace.NamedThreads, sizeof(trace.NamedThreads));
+    trace.TextLength = 0;
+    trace.WriteFailed = false;
+    AtomicStore(&trace.Stopping, 0, ATOMIC_RELAXED);
+
+    if (!PlatformThreadCreate(TraceWriterThread, 0, &trace.Writer)) {
+        ELSA_ERROR("Failed to start the trace writer thread!");
+        trace.Current = 0;
+        FileSystemClose(&trace.File);
+        TraceJoinWriter();
+        return false;
+    }
+    trace.WriterActive = true;
+
+    AtomicStore(&trace.Capturing, 1, ATOMIC_RELEASE);
+    if (frame_count) {
+        ELSA_INFO("Capturing a trace of %u frames to '%s'.", frame_count, path);
+    } else {
+        ELSA_INFO("Capturing a trace to '%s'.", path);
+    }
+    return true;
+}
+
+// Moves the events fired since the last call into the records.
+void TraceFlushFiredEvents()
+{
+    TraceFiredEvent fired;
+    while (MpmcQueuePop(&trace.Fired, &fired)) {
+        if (fired.End < trace.StartNs)
+            continue;
+
+        u32 track = TraceThreadTrack(fired.Thread);
+        TraceRecord* record = TraceAddRecord(TRACE_RECORD_EVENT);
+        if (record) {
+            record->Start = fired.Start;
+            record->End = fired.End;
+            record->Value = fired.Code | ((u64)fired.Handled << 16);
+            record->Thread = track;
+        }
+    }
+}
+
+void TraceStop()
+{
+    if (!TraceIsCapturing())
+        return;
+
+    TraceFlushFiredEvents();
+    AtomicStore(&trace.Capturing, 0, ATOMIC_RELEASE);
+    TraceSubmitChunk();
+    AtomicStore(&trace.Stopping, 1, ATOMIC_RELEASE);
+
+    u32 dropped = trace.DroppedRecords + AtomicLoad(&trace.DroppedEvents, ATOMIC_RELAXED);
+    if (dropped) {
+        ELSA_WARN("The trace dropped %u records because the writer thread fell behind.", dropped);
+    }
+    ELSA_INFO("Trace capture stopped after %u frames.", trace.FrameCount);
+}
+
+b8 TraceIsCapturing()
+{
+    return AtomicLoad(&trace.Capturing, ATOMIC_RELAXED) != 0;
+}
+
+void TraceScope(u32 thread, const char* name, u64 start, u64 end)
+{
+    if (end < trace.StartNs)
+        return;
+
+    u32 track = TraceThreadTrack(thread);
+    TraceRecord* record = TraceAddRecord(TRACE_RECORD_SCOPE);
+    if (record) {
+        record->Name = name;
+        record->Start = start;
+        record->End = end;
+        record->Thread = track;
+    }
+}
+
+void TraceEventFired(u16 code, b8 handled, u64 start, u64 end)
+{
+    if (!TraceIsCapturing())
+        return;
+
+    TraceFiredEvent fired;
+    fired.Start = start;
+    fired.End = end;
+    fired.Thread = ProfilerGetThreadIndex();
+    fired.Code = code;
+    fired.Handled = handled;
+    if (!MpmcQueuePush(&trace.Fired, &fired))
+        AtomicFetchAdd(&trace.DroppedEvents, 1, ATOMIC_RELAXED);
+}
+
+void TraceEndFrame(const ProfileFrame* frame)
+{
+    if (!TraceIsCapturing())
+        return;
+
+    TraceFlushFiredEvents();
+
+    TraceRecord* record = TraceAddRecord(TRACE_RECORD_FRAME);
+    if (record) {
+        record->Start = frame->StartNs;
+        record->End = frame->EndNs;
+        record->Value = frame->FrameIndex;
+    }
+    for (u32 i = 0; i < MEMORY_TAG_MAX_TAGS; i++) {
+        record = TraceAddRecord(TRACE_RECORD_COUNTER);
+        if (record) {
+            record->Name = MemoryTrackerGetTagName((MemoryTag)i);
+            record->Start = frame->EndNs;
+            record->End = frame->EndNs;
+            record->Value = MemoryTrackerGetUsage((MemoryTag)i);
+        }
+    }
+
+    // Keep the writer streaming while it's idle, rather than waiting for the chunk to fill.
+    if (SpscQueueCount(&trace.Full) == 0)
+        TraceSubmitChunk();
+
+    trace.FrameCount++;
+    if (trace.FrameLimit && trace.FrameCount >= trace.FrameLimit)
+        TraceStop();
+}
@@ -0,0 +1,87 @@
+/**
+ * @file Trace.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains the trace capture, which writes the profiled scopes, frames,
+ * memory usage and fired events of a range of frames to a Chrome JSON trace. The file
+ * opens in chrome://tracing, Perfetto and other viewers that read that format.
+ * @version 1.0
+ * @date 2022-07-28
+ */
+#ifndef ELSA_TRACE_H
+#define ELSA_TRACE_H
+
+#include <Defines.h>
+
+struct ProfileFrame;
+
+/** @brief The environment variable that starts a capture to the path it holds when the trace system initializes. */
+#define TRACE_ENV_PATH "ELSA_TRACE"
+
+/** @brief The environment variable holding the number of frames the capture started by TRACE_ENV_PATH lasts. */
+#define TRACE_ENV_FRAMES "ELSA_TRACE_FRAMES"
+
+/** @brief The number of records a chunk handed to the writer thread holds. */
+#define TRACE_CHUNK_RECORDS 2048
+
+/** @brief The number of chunks a capture can fill before the writer thread catches up. */
+#define TRACE_CHUNK_COUNT 32
+
+/** @brief The number of EventFire calls that can be recorded between two frames. */
+#define TRACE_EVENT_CAPACITY 4096
+
+/**
+ * @brief Initializes the trace system, and starts a capture if the TRACE_ENV_PATH
+ * environment variable is set. Must be called after ProfilerInit.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 TraceInit();
+
+/** @brief Stops the capture in progress, waits for the file to be written, and shuts the trace system down. */
+ELSA_API void TraceShutdown();
+
+/**
+ * @brief Starts capturing a trace. Must be called from the main thread.
+ * @param path The path of the file to write the trace to.
+ * @param frame_count The number of frames to capture, or 0 to capture until TraceStop.
+ * @returns True if the capture started; otherwise false.
+ */
+ELSA_API b8 TraceStart(const char* path, u32 frame_count);
+
+/**
+ * @brief Stops the capture in progress. The writer thread finishes the file in the
+ * background. Must be called from the main thread.
+ */
+ELSA_API void TraceStop();
+
+/**
+ * @brief Indicates if a trace is being captured.
+ * @returns True if a trace is being captured; otherwise false.
+ */
+ELSA_API b8 TraceIsCapturing();
+
+/**
+ * @brief Records a scope that ended. Called by the profiler as it drains the scopes of a thread.
+ * @param thread The index of the thread in the profile.
+ * @param name The name of the scope.
+ * @param start The time the scope began, in nanoseconds of ProfilerNow.
+ * @param end The time the scope ended, in nanoseconds of ProfilerNow.
+ */
+ELSA_API void TraceScope(u32 thread, const char* name, u64 start, u64 end);
+
+/**
+ * @brief Records a call of EventFire. Safe to call from any thread.
+ * @param code The code of the event.
+ * @param handled Indicates if a listener handled the event.
+ * @param start The time EventFire was called, in nanoseconds of ProfilerNow.
+ * @param end The time EventFire returned, in nanoseconds of ProfilerNow.
+ */
+ELSA_API void TraceEventFired(u16 code, b8 handled, u64 start, u64 end);
+
+/**
+ * @brief Records the end of a frame along with the memory usage of every tag, and stops
+ * the capture once it has recorded the requested number of frames. Called by ProfilerEndFrame.
+ * @param frame A pointer to the frame that ended.
+ */
+ELSA_API void TraceEndFrame(const struct ProfileFrame* frame);
+
+#endif
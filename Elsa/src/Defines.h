@@ -10,7 +10,7 @@
 #ifndef ELSA_DEFINES_H
 #define ELSA_DEFINES_H
 
-/** @brief Just used to mark code blocks */
+/** @brief Just used to mark code blocks. Including Core/Profiler.h makes it profile them. */
 #define CODE_BLOCK(name)
 
 /** @brief Signed 8-bit numeric type */
@@ -113,6 +113,22 @@ typedef i8 b8;
 #define ELSA_NO_INLINE 
 #endif
 
+// Alignment and thread-local storage
+#if defined(_MSC_VER) && !defined(__clang__)
+/** @brief Aligns a variable or structure to the given number of bytes. */
+#define ELSA_ALIGN(bytes) __declspec(align(bytes))
+/** @brief Marks a variable as having one instance per thread. */
+#define ELSA_THREAD_LOCAL __declspec(thread)
+#else
+/** @brief Aligns a variable or structure to the given number of bytes. */
+#define ELSA_ALIGN(bytes) __attribute__((aligned(bytes)))
+/** @brief Marks a variable as having one instance per thread. */
+#define ELSA_THREAD_LOCAL __thread
+#endif
+
+/** @brief The size of a CPU cache line, used to pad data shared between threads. */
+#define ELSA_CACHE_LINE_SIZE 64
+
 /**
  * @brief Clamps value to a range of min and max (inclusive).
  * @param value The value to be clamped.
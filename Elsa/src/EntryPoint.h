@@ -20,7 +20,7 @@
 extern b8 CreateGame(Game* game, int argc, char** argv);
 
 int main(i32 argc, char** argv) {
-    Game game;
+    Game game = {0};
     if (!CreateGame(&game, argc, argv)) {
         ELSA_FATAL("Could not create game!");
         return -1;
@@ -38,6 +38,8 @@ int main(i32 argc, char** argv) {
 
     if (!ApplicationRun()) {
         ELSA_INFO("Application did not terminate correctly.");
+        // The run failed without shutting the logger down, so write out what's still queued.
+        LoggerFlush();
         return 2;
     }
 
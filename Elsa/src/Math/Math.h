@@ -1375,10 +1375,10 @@ ELSA_INLINE q4f Q4Mul(q4f left, q4f right) {
     SSEResultTwo = _mm_shuffle_ps(right.InternalElementsSSE, right.InternalElementsSSE, _MM_SHUFFLE(3, 2, 1, 0));
     result.InternalElementsSSE = _mm_add_ps(SSEResultThree, _mm_mul_ps(SSEResultTwo, SSEResultOne));
 #else
-	result.X = (left.x * right.w) + (left.y * right.z) - (left.z * right.y) + (left.w * right.x);
-    result.Y = (-left.x * right.z) + (left.y * right.w) + (left.z * right.x) + (left.w * right.y);
-    result.Z = (left.x * right.y) - (left.y * right.x) + (left.z * right.w) + (left.w * right.z);
-    result.W = (-left.x * right.x) - (left.y * right.y) - (left.z * right.z) + (left.w * right.w);
+	result.x = (left.x * right.w) + (left.y * right.z) - (left.z * right.y) + (left.w * right.x);
+    result.y = (-left.x * right.z) + (left.y * right.w) + (left.z * right.x) + (left.w * right.y);
+    result.z = (left.x * right.y) - (left.y * right.x) + (left.z * right.w) + (left.w * right.z);
+    result.w = (-left.x * right.x) - (left.y * right.y) - (left.z * right.z) + (left.w * right.w);
 #endif
 	return result;
 }
@@ -1,3 +1,5 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_PLATFORM
+
 #include "FileSystem.h"
 
 #include <Core/Logger.h>
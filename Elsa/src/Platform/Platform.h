@@ -20,6 +20,8 @@ struct VulkanContext;
 
 /**
  * @brief Performs startup routines within the platform layer. 
+ * Linux has no windowing, input or Vulkan surface yet, so it always runs headless,
+ * and SIGINT or SIGTERM ask it to quit.
  * 
  * @param application_state The application state.
  * @return True on success; otherwise false.
@@ -59,6 +61,49 @@ ELSA_API void* PlatformAlloc(u64 size);
  */
 ELSA_API void PlatformFree(void* block);
 
+/**
+ * @brief Returns the granularity of the virtual memory functions below.
+ * 
+ * @returns The size of a page of memory in bytes.
+ */
+ELSA_API u64 PlatformGetPageSize();
+
+/**
+ * @brief Reserves a range of address space without backing it with memory.
+ * The range can't be accessed until parts of it are committed.
+ * 
+ * @param size The size in bytes of the range to reserve. Rounded up to the page size.
+ * @returns If succesful, a pointer to the start of the range; otherwise 0.
+ */
+ELSA_API void* PlatformReserveMemory(u64 size);
+
+/**
+ * @brief Backs part of a reserved range with zeroed, readable and writable memory.
+ * 
+ * @param block A page aligned pointer inside of a reserved range.
+ * @param size The size in bytes to commit. Rounded up to the page size.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 PlatformCommitMemory(void* block, u64 size);
+
+/**
+ * @brief Returns the memory backing part of a reserved range to the system. The
+ * range stays reserved and can be committed again.
+ * 
+ * @param block A page aligned pointer inside of a reserved range.
+ * @param size The size in bytes to decommit. Rounded up to the page size.
+ */
+ELSA_API void PlatformDecommitMemory(void* block, u64 size);
+
+/**
+ * @brief Releases a range reserved with PlatformReserveMemory, along with any
+ * memory committed in it.
+ * 
+ * @param block The pointer returned by PlatformReserveMemory.
+ * @param size The size passed to PlatformReserveMemory.
+ */
+ELSA_API void PlatformReleaseMemory(void* block, u64 size);
+
 /**
  * @brief Zeroes out the provided memory block
  * 
@@ -112,6 +157,182 @@ ELSA_API void PlatformConsoleWrite(const char* message, u8 colour);
  */
 ELSA_API void PlatformConsoleWriteError(const char* message, u8 colour);
 
+/**
+ * @brief The entry point of a thread created with PlatformThreadCreate.
+ * @param param The parameter passed to PlatformThreadCreate.
+ * @returns The exit code of the thread.
+ */
+typedef u32 (*PFN_ThreadStart)(void* param);
+
+/** @brief Holds a handle to a thread. */
+typedef struct PlatformThread {
+    /** @brief Opaque handle to the internal thread handle. */
+    u64 Handle;
+} PlatformThread;
+
+/**
+ * @brief Starts a thread running the given function.
+ * 
+ * @param start The function the thread runs.
+ * @param param The parameter passed to start.
+ * @param out_thread A pointer to hold the handle of the thread.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 PlatformThreadCreate(PFN_ThreadStart start, void* param, PlatformThread* out_thread);
+
+/**
+ * @brief Waits for a thread to exit, and releases its handle.
+ * 
+ * @param thread A pointer to the handle of the thread.
+ */
+ELSA_API void PlatformThreadJoin(PlatformThread* thread);
+
+/**
+ * @brief Restricts a thread to run on a single logical processor. Only a hint on platforms
+ * without hard affinity, such as MacOS.
+ * 
+ * @param thread A pointer to the handle of the thread.
+ * @param processor The index of the logical processor, from 0 to PlatformGetProcessorCount() - 1.
+ * @returns True if the thread was pinned; otherwise false.
+ */
+ELSA_API b8 PlatformThreadSetAffinity(PlatformThread* thread, u32 processor);
+
+/**
+ * @brief Gets the number of logical processors available to the process.
+ * @returns The number of logical processors, at least 1.
+ */
+ELSA_API u32 PlatformGetProcessorCount();
+
+/** @brief Holds a handle to a mutex. Mutexes aren't recursive. */
+typedef struct PlatformMutex {
+    /** @brief Opaque handle to the internal mutex. */
+    u64 Handle;
+} PlatformMutex;
+
+/**
+ * @brief Creates a mutex.
+ * 
+ * @param out_mutex A pointer to hold the handle of the mutex.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 PlatformMutexCreate(PlatformMutex* out_mutex);
+
+/**
+ * @brief Destroys a mutex. It must not be locked.
+ * 
+ * @param mutex A pointer to the handle of the mutex.
+ */
+ELSA_API void PlatformMutexDestroy(PlatformMutex* mutex);
+
+/**
+ * @brief Locks a mutex, waiting for the thread holding it to unlock it.
+ * 
+ * @param mutex A pointer to the handle of the mutex.
+ */
+ELSA_API void PlatformMutexLock(PlatformMutex* mutex);
+
+/**
+ * @brief Unlocks a mutex held by the calling thread.
+ * 
+ * @param mutex A pointer to the handle of the mutex.
+ */
+ELSA_API void PlatformMutexUnlock(PlatformMutex* mutex);
+
+/** @brief Holds a handle to a counting semaphore. */
+typedef struct PlatformSemaphore {
+    /** @brief Opaque handle to the internal semaphore. */
+    u64 Handle;
+} PlatformSemaphore;
+
+/**
+ * @brief Creates a counting semaphore.
+ * 
+ * @param initial_count The initial count of the semaphore.
+ * @param out_semaphore A pointer to hold the handle of the semaphore.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 PlatformSemaphoreCreate(u32 initial_count, PlatformSemaphore* out_semaphore);
+
+/**
+ * @brief Destroys a semaphore. No thread may be waiting on it.
+ * 
+ * @param semaphore A pointer to the handle of the semaphore.
+ */
+ELSA_API void PlatformSemaphoreDestroy(PlatformSemaphore* semaphore);
+
+/**
+ * @brief Increments the count of a semaphore, waking up to count waiting threads.
+ * 
+ * @param semaphore A pointer to the handle of the semaphore.
+ * @param count The number to add to the count.
+ */
+ELSA_API void PlatformSemaphoreSignal(PlatformSemaphore* semaphore, u32 count);
+
+/**
+ * @brief Waits for the count of a semaphore to be above 0, then decrements it.
+ * 
+ * @param semaphore A pointer to the handle of the semaphore.
+ */
+ELSA_API void PlatformSemaphoreWait(PlatformSemaphore* semaphore);
+
+/** @brief Holds a handle to a condition variable. */
+typedef struct PlatformCondition {
+    /** @brief Opaque handle to the internal condition variable. */
+    u64 Handle;
+} PlatformCondition;
+
+/**
+ * @brief Creates a condition variable.
+ * 
+ * @param out_condition A pointer to hold the handle of the condition variable.
+ * @returns True on success; otherwise false.
+ */
+ELSA_API b8 PlatformConditionCreate(PlatformCondition* out_condition);
+
+/**
+ * @brief Destroys a condition variable. No thread may be waiting on it.
+ * 
+ * @param condition A pointer to the handle of the condition variable.
+ */
+ELSA_API void PlatformConditionDestroy(PlatformCondition* condition);
+
+/**
+ * @brief Unlocks a mutex and waits for the condition variable to be signaled, then locks
+ * the mutex again. May wake up spuriously, so the condition must be checked in a loop.
+ * 
+ * @param condition A pointer to the handle of the condition variable.
+ * @param mutex A pointer to the handle of a mutex held by the calling thread.
+ */
+ELSA_API void PlatformConditionWait(PlatformCondition* condition, PlatformMutex* mutex);
+
+/**
+ * @brief Wakes up one thread waiting on the condition variable.
+ * 
+ * @param condition A pointer to the handle of the condition variable.
+ */
+ELSA_API void PlatformConditionSignal(PlatformCondition* condition);
+
+/**
+ * @brief Wakes up every thread waiting on the condition variable.
+ * 
+ * @param condition A pointer to the handle of the condition variable.
+ */
+ELSA_API void PlatformConditionBroadcast(PlatformCondition* condition);
+
+/**
+ * @brief Suspends the calling thread. Passing 0 only gives up the rest of its time slice.
+ * 
+ * @param ms The number of milliseconds to sleep for.
+ */
+ELSA_API void PlatformSleep(u64 ms);
+
+/**
+ * @brief Gets the time of a monotonic clock, which only makes sense relative to another reading.
+ * Safe to call from any thread, and before PlatformInit.
+ * @returns The time in seconds.
+ */
+ELSA_API f64 PlatformGetAbsoluteTime();
+
 /**
  * @brief Gets an opaque pointer of the window view. HWND for Windows, CAMetalLayer* for MacOS.
  * @returns The pointer of the window view.
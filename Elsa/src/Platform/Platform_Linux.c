@@ -0,0 +1,442 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_PLATFORM
+
+// For pthread_setaffinity_np and the CPU_* macros.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "Platform.h"
+
+#include "Core/Logger.h"
+#include "Core/Event.h"
+#include "Containers/Darray.h"
+
+#if defined(ELSA_PLATFORM_LINUX)
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+typedef struct PlatformState {
+    ApplicationState* app_state;
+
+    struct sigaction PreviousInterrupt;
+    struct sigaction PreviousTerminate;
+    b8 QuitPosted;
+} PlatformState;
+
+static PlatformState platform_state;
+// Set from the signal handler, so it can't be part of the state.
+static volatile sig_atomic_t quit_requested;
+
+void PlatformOnQuitSignal(i32 signal)
+{
+    quit_requested = 1;
+}
+
+b8 PlatformInit(ApplicationState* application_state)
+{
+    platform_state.app_state = application_state;
+    platform_state.QuitPosted = false;
+    quit_requested = 0;
+
+    // Without a window to close, SIGINT and SIGTERM are how a headless instance is asked to quit.
+    struct sigaction action;
+    PlatformZeroMemory(&action, sizeof(action));
+    action.sa_handler = PlatformOnQuitSignal;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGINT, &action, &platform_state.PreviousInterrupt) != 0 ||
+        sigaction(SIGTERM, &action, &platform_state.PreviousTerminate) != 0) {
+        ELSA_FATAL("Failed to install the signal handlers!");
+        return false;
+    }
+
+    ELSA_INFO("<PlatformInit: LINUX> Platform initialised succesfully, running headless.");
+
+    return true;
+}
+
+void PlatformExit()
+{
+    sigaction(SIGINT, &platform_state.PreviousInterrupt, 0);
+    sigaction(SIGTERM, &platform_state.PreviousTerminate, 0);
+}
+
+void PlatformUpdateGamepads()
+{
+    // No gamepads without a window to take their input.
+}
+
+b8 PlatformPumpMessages()
+{
+    if (quit_requested && !platform_state.QuitPosted) {
+        Event data = {};
+        EventPost(EVENT_CODE_APPLICATION_QUIT, 0, data);
+        platform_state.QuitPosted = true;
+    }
+
+    return true;
+}
+
+void* PlatformAlloc(u64 size)
+{
+    return malloc(size);
+}
+
+void PlatformFree(void* block)
+{
+    free(block);
+}
+
+u64 PlatformGetPageSize()
+{
+    return (u64)sysconf(_SC_PAGESIZE);
+}
+
+void* PlatformReserveMemory(u64 size)
+{
+    void* block = mmap(0, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return block == MAP_FAILED ? 0 : block;
+}
+
+b8 PlatformCommitMemory(void* block, u64 size)
+{
+    return mprotect(block, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+void PlatformDecommitMemory(void* block, u64 size)
+{
+    // Drop the pages first, so that committing the range again hands out zeroed memory.
+    madvise(block, size, MADV_DONTNEED);
+    mprotect(block, size, PROT_NONE);
+}
+
+void PlatformReleaseMemory(void* block, u64 size)
+{
+    munmap(block, size);
+}
+
+void PlatformZeroMemory(void* block, u64 size)
+{
+    memset(block, 0, size);
+}
+
+void PlatformSetMemory(void* block, i32 value, u64 size)
+{
+    memset(block, value, size);
+}
+
+void PlatformCopyMemory(void* dest, const void* source, u64 size)
+{
+    memcpy(dest, source, size);
+}
+
+void PlatformMoveMemory(void* dest, const void* source, u64 size)
+{
+    memmove(dest, source, size);
+}
+
+// The colour codes are only written to terminals, not to logs redirected to files.
+void PlatformConsoleWriteStream(FILE* stream, b8 colour_output, const char* message, u8 colour)
+{
+    // FATAL,ERROR,WARN,INFO,DEBUG,TRACE
+    static const char* colour_strings[] = {"0;41", "1;31", "1;33", "1;32", "1;34", "1;30"};
+    if (colour_output)
+        fprintf(stream, "\033[%sm%s\033[0m", colour_strings[colour], message);
+    else
+        fputs(message, stream);
+    fflush(stream);
+}
+
+void PlatformConsoleWrite(const char* message, u8 colour)
+{
+    static i32 is_terminal = -1;
+    if (is_terminal < 0)
+        is_terminal = isatty(STDOUT_FILENO);
+    PlatformConsoleWriteStream(stdout, is_terminal, message, colour);
+}
+
+void PlatformConsoleWriteError(const char* message, u8 colour)
+{
+    static i32 is_terminal = -1;
+    if (is_terminal < 0)
+        is_terminal = isatty(STDERR_FILENO);
+    PlatformConsoleWriteStream(stderr, is_terminal, message, colour);
+}
+
+typedef struct PlatformThreadStart {
+    PFN_ThreadStart Start;
+    void* Param;
+} PlatformThreadStart;
+
+void* PlatformThreadEntry(void* param)
+{
+    PlatformThreadStart start = *(PlatformThreadStart*)param;
+    PlatformFree(param);
+    return (void*)(u64)start.Start(start.Param);
+}
+
+b8 PlatformThreadCreate(PFN_ThreadStart start, void* param, PlatformThread* out_thread)
+{
+    PlatformThreadStart* thread_start = PlatformAlloc(sizeof(PlatformThreadStart));
+    if (!thread_start)
+        return false;
+    thread_start->Start = start;
+    thread_start->Param = param;
+
+    pthread_t thread;
+    if (pthread_create(&thread, 0, PlatformThreadEntry, thread_start) != 0) {
+        PlatformFree(thread_start);
+        return false;
+    }
+    out_thread->Handle = (u64)thread;
+    return true;
+}
+
+void PlatformThreadJoin(PlatformThread* thread)
+{
+    pthread_join((pthread_t)thread->Handle, 0);
+    thread->Handle = 0;
+}
+
+b8 PlatformThreadSetAffinity(PlatformThread* thread, u32 processor)
+{
+    // Processors are numbered among the ones the process may run on, which aren't always the first ones.
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        return false;
+
+    u32 seen = 0;
+    for (u32 cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &allowed))
+            continue;
+        if (seen++ == processor) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            return pthread_setaffinity_np((pthread_t)thread->Handle, sizeof(set), &set) == 0;
+        }
+    }
+    return false;
+}
+
+u32 PlatformGetProcessorCount()
+{
+    // The affinity mask of the process accounts for taskset and container limits.
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        i32 count = CPU_COUNT(&set);
+        if (count > 0)
+            return (u32)count;
+    }
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (u32)count : 1;
+}
+
+b8 PlatformMutexCreate(PlatformMutex* out_mutex)
+{
+    pthread_mutex_t* mutex = PlatformAlloc(sizeof(pthread_mutex_t));
+    if (!mutex)
+        return false;
+    if (pthread_mutex_init(mutex, 0) != 0) {
+        PlatformFree(mutex);
+        return false;
+    }
+    out_mutex->Handle = (u64)mutex;
+    return true;
+}
+
+void PlatformMutexDestroy(PlatformMutex* mutex)
+{
+    if (!mutex->Handle)
+        return;
+    pthread_mutex_destroy((pthread_mutex_t*)mutex->Handle);
+    PlatformFree((void*)mutex->Handle);
+    mutex->Handle = 0;
+}
+
+void PlatformMutexLock(PlatformMutex* mutex)
+{
+    pthread_mutex_lock((pthread_mutex_t*)mutex->Handle);
+}
+
+void PlatformMutexUnlock(PlatformMutex* mutex)
+{
+    pthread_mutex_unlock((pthread_mutex_t*)mutex->Handle);
+}
+
+b8 PlatformSemaphoreCreate(u32 initial_count, PlatformSemaphore* out_semaphore)
+{
+    sem_t* semaphore = PlatformAlloc(sizeof(sem_t));
+    if (!semaphore)
+        return false;
+    if (sem_init(semaphore, 0, initial_count) != 0) {
+        PlatformFree(semaphore);
+        return false;
+    }
+    out_semaphore->Handle = (u64)semaphore;
+    return true;
+}
+
+void PlatformSemaphoreDestroy(PlatformSemaphore* semaphore)
+{
+    if (!semaphore->Handle)
+        return;
+    sem_destroy((sem_t*)semaphore->Handle);
+    PlatformFree((void*)semaphore->Handle);
+    semaphore->Handle = 0;
+}
+
+void PlatformSemaphoreSignal(PlatformSemaphore* semaphore, u32 count)
+{
+    for (u32 i = 0; i < count; i++)
+        sem_post((sem_t*)semaphore->Handle);
+}
+
+void PlatformSemaphoreWait(PlatformSemaphore* semaphore)
+{
+    // Signals interrupt the wait, e.g. the ones PlatformInit handles.
+    while (sem_wait((sem_t*)semaphore->Handle) != 0 && errno == EINTR) {}
+}
+
+b8 PlatformConditionCreate(PlatformCondition* out_condition)
+{
+    pthread_cond_t* condition = PlatformAlloc(sizeof(pthread_cond_t));
+    if (!condition)
+        return false;
+    if (pthread_cond_init(condition, 0) != 0) {
+        PlatformFree(condition);
+        return false;
+    }
+    out_condition->Handle = (u64)condition;
+    return true;
+}
+
+void PlatformConditionDestroy(PlatformCondition* condition)
+{
+    if (!condition->Handle)
+        return;
+    pthread_cond_destroy((pthread_cond_t*)condition->Handle);
+    PlatformFree((void*)condition->Handle);
+    condition->Handle = 0;
+}
+
+void PlatformConditionWait(PlatformCondition* condition, PlatformMutex* mutex)
+{
+    pthread_cond_wait((pthread_cond_t*)condition->Handle, (pthread_mutex_t*)mutex->Handle);
+}
+
+void PlatformConditionSignal(PlatformCondition* condition)
+{
+    pthread_cond_signal((pthread_cond_t*)condition->Handle);
+}
+
+void PlatformConditionBroadcast(PlatformCondition* condition)
+{
+    pthread_cond_broadcast((pthread_cond_t*)condition->Handle);
+}
+
+void PlatformSleep(u64 ms)
+{
+    if (ms == 0) {
+        sched_yield();
+        return;
+    }
+    struct timespec duration;
+    duration.tv_sec = ms / 1000;
+    duration.tv_nsec = (ms % 1000) * 1000000;
+    nanosleep(&duration, 0);
+}
+
+f64 PlatformGetAbsoluteTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (f64)now.tv_sec + (f64)now.tv_nsec * 0.000000001;
+}
+
+void* PlatformGetWindowView()
+{
+    return 0;
+}
+
+void PlatformGetRequiredExtensionNames(const char*** names_darray)
+{
+    // Headless, there's no surface to need an extension for.
+}
+
+void PlatformGetDirectoryFiles(const char* directory, char*** files_darray)
+{
+    // Callers pass a Win32 style pattern, "directory/*", only the directory is needed.
+    char path[PLATFORM_MAX_PATH];
+    snprintf(path, sizeof(path), "%s", directory);
+    u64 length = strlen(path);
+    if (length && path[length - 1] == '*')
+        path[--length] = 0;
+    if (length > 1 && path[length - 1] == '/')
+        path[--length] = 0;
+
+    DIR* dir = opendir(length ? path : ".");
+    if (!dir) {
+        ELSA_ERROR("Failed to open the directory '%s'!", path);
+        return;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != 0) {
+        b8 is_file = entry->d_type == DT_REG;
+        if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK) {
+            // Not every file system fills d_type in, and links are followed like FindNextFile does.
+            char entry_path[PLATFORM_MAX_PATH * 2];
+            snprintf(entry_path, sizeof(entry_path), "%s/%s", path, entry->d_name);
+            struct stat info;
+            is_file = stat(entry_path, &info) == 0 && S_ISREG(info.st_mode);
+        }
+        if (!is_file)
+            continue;
+
+        char* file = PlatformAlloc(sizeof(char) * PLATFORM_MAX_PATH);
+        PlatformZeroMemory(file, sizeof(char) * PLATFORM_MAX_PATH);
+        snprintf(file, PLATFORM_MAX_PATH, "%s", entry->d_name);
+        Darray_Push(*files_darray, file);
+    }
+    closedir(dir);
+}
+
+b8 PlatformDirectoryExists(const char* directory)
+{
+    struct stat info;
+    return stat(directory, &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+void PlatformCreateFile(const char* path)
+{
+    i32 fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd >= 0)
+        close(fd);
+}
+
+void PlatformCreateDirectory(const char* path)
+{
+    if (mkdir(path, 0755) != 0 && errno != EEXIST)
+        ELSA_ERROR("Failed to create the directory '%s': %s", path, strerror(errno));
+}
+
+b8 PlatformCreateVulkanSurface(struct VulkanContext* context)
+{
+    ELSA_FATAL("Vulkan surfaces aren't supported on Linux yet, run headless instead.");
+    return false;
+}
+
+#endif
@@ -1,3 +1,5 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_PLATFORM
+
 #include "Platform.h"
 
 #if defined(ELSA_PLATFORM_MACOS)
@@ -6,7 +8,15 @@
 #include <Core/Event.h>
 #include <Core/Input.h>
 
+#include <dispatch/dispatch.h>
+#include <mach/mach.h>
+#include <mach/thread_policy.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 #include <Foundation/Foundation.h>
 #include <Cocoa/Cocoa.h>
@@ -66,7 +76,7 @@ u16 TranslatePlayerIndex(GCControllerPlayerIndex index);
     platform_state.QuitFlagged = true;
 	
     Event event = {};
-    EventFire(EVENT_CODE_APPLICATION_QUIT, 0, event);
+    EventPost(EVENT_CODE_APPLICATION_QUIT, 0, event);
 	
     return YES;
 }
@@ -77,14 +87,14 @@ u16 TranslatePlayerIndex(GCControllerPlayerIndex index);
     const NSRect framebufferRect = [platform_state.View convertRectToBacking:contentRect];
     event.data.u16[0] = (u16)framebufferRect.size.width;
     event.data.u16[1] = (u16)framebufferRect.size.height;
-    EventFire(EVENT_CODE_RESIZED, 0, event);
+    EventPost(EVENT_CODE_RESIZED, 0, event);
 }
 
 - (void)windowDidMiniaturize:(NSNotification*)notification {
     Event event;
     event.data.u16[0] = 0;
     event.data.u16[1] = 0;
-    EventFire(EVENT_CODE_RESIZED, 0, event);
+    EventPost(EVENT_CODE_RESIZED, 0, event);
 	
     [platform_state.Window miniaturize:nil];
 }
@@ -95,7 +105,7 @@ u16 TranslatePlayerIndex(GCControllerPlayerIndex index);
     const NSRect framebufferRect = [platform_state.View convertRectToBacking:contentRect];
     event.data.u16[0] = (u16)framebufferRect.size.width;
     event.data.u16[1] = (u16)framebufferRect.size.height;
-    EventFire(EVENT_CODE_RESIZED, 0, event);
+    EventPost(EVENT_CODE_RESIZED, 0, event);
 	
     [platform_state.Window deminiaturize:nil];
 }
@@ -182,7 +192,7 @@ typedef struct GamepadHandle {
 	
     Event event;
     event.data.u16[0] = playerIndex;
-    EventFire(EVENT_CODE_GAMEPAD_CONNECTED, 0, event);
+    EventPost(EVENT_CODE_GAMEPAD_CONNECTED, 0, event);
 }
 
 - (void)controllerWasDisconnected:(NSNotification*)notification {
@@ -194,7 +204,7 @@ typedef struct GamepadHandle {
 	
     Event event;
     event.data.u16[0] = playerIndex;
-    EventFire(EVENT_CODE_GAMEPAD_DISCONNECTED, 0, event);
+    EventPost(EVENT_CODE_GAMEPAD_DISCONNECTED, 0, event);
 }
 
 - (BOOL)canBecomeKeyView {
@@ -475,6 +485,33 @@ void PlatformFree(void* block)
     free(block);
 }
 
+u64 PlatformGetPageSize()
+{
+    return (u64)sysconf(_SC_PAGESIZE);
+}
+
+void* PlatformReserveMemory(u64 size)
+{
+    void* block = mmap(0, size, PROT_NONE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    return block == MAP_FAILED ? 0 : block;
+}
+
+b8 PlatformCommitMemory(void* block, u64 size)
+{
+    return mprotect(block, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+void PlatformDecommitMemory(void* block, u64 size)
+{
+    // Mapping fresh pages over the range drops the old ones and leaves it reserved.
+    mmap(block, size, PROT_NONE, MAP_FIXED | MAP_PRIVATE | MAP_ANON, -1, 0);
+}
+
+void PlatformReleaseMemory(void* block, u64 size)
+{
+    munmap(block, size);
+}
+
 void PlatformZeroMemory(void* block, u64 size)
 {
 	memset(block, 0, size);
@@ -507,6 +544,169 @@ void PlatformConsoleWriteError(const char* message, u8 colour)
     printf("\033[%sm%s\033[0m", colour_strings[colour], message);
 }
 
+typedef struct PlatformThreadStart {
+    PFN_ThreadStart Start;
+    void* Param;
+} PlatformThreadStart;
+
+void* PlatformThreadEntry(void* param)
+{
+    PlatformThreadStart start = *(PlatformThreadStart*)param;
+    PlatformFree(param);
+    return (void*)(u64)start.Start(start.Param);
+}
+
+b8 PlatformThreadCreate(PFN_ThreadStart start, void* param, PlatformThread* out_thread)
+{
+    PlatformThreadStart* thread_start = PlatformAlloc(sizeof(PlatformThreadStart));
+    if (!thread_start)
+        return false;
+    thread_start->Start = start;
+    thread_start->Param = param;
+
+    pthread_t thread;
+    if (pthread_create(&thread, 0, PlatformThreadEntry, thread_start) != 0) {
+        PlatformFree(thread_start);
+        return false;
+    }
+    out_thread->Handle = (u64)thread;
+    return true;
+}
+
+void PlatformThreadJoin(PlatformThread* thread)
+{
+    pthread_join((pthread_t)thread->Handle, 0);
+    thread->Handle = 0;
+}
+
+b8 PlatformThreadSetAffinity(PlatformThread* thread, u32 processor)
+{
+    // MacOS has no hard affinity, threads with the same tag are only kept on the same L2 when possible.
+    thread_affinity_policy_data_t policy = { (integer_t)processor + 1 };
+    mach_port_t mach_thread = pthread_mach_thread_np((pthread_t)thread->Handle);
+    return thread_policy_set(mach_thread, THREAD_AFFINITY_POLICY, (thread_policy_t)&policy, THREAD_AFFINITY_POLICY_COUNT) == KERN_SUCCESS;
+}
+
+u32 PlatformGetProcessorCount()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (u32)count : 1;
+}
+
+b8 PlatformMutexCreate(PlatformMutex* out_mutex)
+{
+    pthread_mutex_t* mutex = PlatformAlloc(sizeof(pthread_mutex_t));
+    if (!mutex)
+        return false;
+    if (pthread_mutex_init(mutex, 0) != 0) {
+        PlatformFree(mutex);
+        return false;
+    }
+    out_mutex->Handle = (u64)mutex;
+    return true;
+}
+
+void PlatformMutexDestroy(PlatformMutex* mutex)
+{
+    if (!mutex->Handle)
+        return;
+    pthread_mutex_destroy((pthread_mutex_t*)mutex->Handle);
+    PlatformFree((void*)mutex->Handle);
+    mutex->Handle = 0;
+}
+
+void PlatformMutexLock(PlatformMutex* mutex)
+{
+    pthread_mutex_lock((pthread_mutex_t*)mutex->Handle);
+}
+
+void PlatformMutexUnlock(PlatformMutex* mutex)
+{
+    pthread_mutex_unlock((pthread_mutex_t*)mutex->Handle);
+}
+
+b8 PlatformSemaphoreCreate(u32 initial_count, PlatformSemaphore* out_semaphore)
+{
+    // Unnamed POSIX semaphores aren't implemented on MacOS.
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create((long)initial_count);
+    if (!semaphore)
+        return false;
+    out_semaphore->Handle = (u64)semaphore;
+    return true;
+}
+
+void PlatformSemaphoreDestroy(PlatformSemaphore* semaphore)
+{
+    if (!semaphore->Handle)
+        return;
+    dispatch_release((dispatch_semaphore_t)semaphore->Handle);
+    semaphore->Handle = 0;
+}
+
+void PlatformSemaphoreSignal(PlatformSemaphore* semaphore, u32 count)
+{
+    for (u32 i = 0; i < count; i++)
+        dispatch_semaphore_signal((dispatch_semaphore_t)semaphore->Handle);
+}
+
+void PlatformSemaphoreWait(PlatformSemaphore* semaphore)
+{
+    dispatch_semaphore_wait((dispatch_semaphore_t)semaphore->Handle, DISPATCH_TIME_FOREVER);
+}
+
+b8 PlatformConditionCreate(PlatformCondition* out_condition)
+{
+    pthread_cond_t* condition = PlatformAlloc(sizeof(pthread_cond_t));
+    if (!condition)
+        return false;
+    if (pthread_cond_init(condition, 0) != 0) {
+        PlatformFree(condition);
+        return false;
+    }
+    out_condition->Handle = (u64)condition;
+    return true;
+}
+
+void PlatformConditionDestroy(PlatformCondition* condition)
+{
+    if (!condition->Handle)
+        return;
+    pthread_cond_destroy((pthread_cond_t*)condition->Handle);
+    PlatformFree((void*)condition->Handle);
+    condition->Handle = 0;
+}
+
+void PlatformConditionWait(PlatformCondition* condition, PlatformMutex* mutex)
+{
+    pthread_cond_wait((pthread_cond_t*)condition->Handle, (pthread_mutex_t*)mutex->Handle);
+}
+
+void PlatformConditionSignal(PlatformCondition* condition)
+{
+    pthread_cond_signal((pthread_cond_t*)condition->Handle);
+}
+
+void PlatformConditionBroadcast(PlatformCondition* condition)
+{
+    pthread_cond_broadcast((pthread_cond_t*)condition->Handle);
+}
+
+void PlatformSleep(u64 ms)
+{
+    if (ms == 0) {
+        sched_yield();
+        return;
+    }
+    usleep(ms * 1000);
+}
+
+f64 PlatformGetAbsoluteTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (f64)now.tv_sec + (f64)now.tv_nsec * 0.000000001;
+}
+
 Keys TranslateKeycode(u32 ns_keycode) { 
     switch (ns_keycode) {
         case 0x1D:
@@ -1,3 +1,5 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_PLATFORM
+
 #include "Platform.h"
 
 #include "Core/Logger.h"
@@ -19,11 +21,6 @@
 #include <Renderer/Vulkan/VulkanTypes.h>
 
 /*
-TODO(milo): Threading system, need to implement threads, mutex and locks for both Windows
-and MacOS. Windows will use the Win32 API, and MacOS will use the pthread library.
-At least pthread is available on linux, so that it will facilitate the porting
-of the engine to linux once I have a machine that runs it.
-
 TODO(milo): Add a dynamic library wrapper for .dylib, .dll and .so
 */
 
@@ -107,6 +104,12 @@ b8 PlatformInit(ApplicationState* application_state)
         return false;
     }
 	
+	// A headless application has no window, its messages are still pumped for the thread
+	if (application_state->Headless) {
+		ELSA_INFO("<PlatformInit: WIN32> Platform initialised succesfully without a window (headless).");
+		return true;
+	}
+	
 	// Initialise the window
     HICON icon = LoadIcon(platform_state.hInstance, IDI_APPLICATION);
     
@@ -206,9 +209,9 @@ void PlatformUpdateGamepads()
             Event event;
             event.data.u16[0] = i;
             if (connected)
-                EventFire(EVENT_CODE_GAMEPAD_CONNECTED, 0, event);
+                EventPost(EVENT_CODE_GAMEPAD_CONNECTED, 0, event);
             else
-                EventFire(EVENT_CODE_GAMEPAD_DISCONNECTED, 0, event);
+                EventPost(EVENT_CODE_GAMEPAD_DISCONNECTED, 0, event);
         }
 		
         platform_state.Pads[i].Connected = connected;
@@ -318,6 +321,37 @@ void PlatformFree(void* block)
     VirtualFree(block, 0, MEM_RELEASE);
 }
 
+u64 PlatformGetPageSize()
+{
+    static u64 page_size = 0;
+    if (!page_size) {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        page_size = info.dwPageSize;
+    }
+    return page_size;
+}
+
+void* PlatformReserveMemory(u64 size)
+{
+    return VirtualAlloc(0, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+b8 PlatformCommitMemory(void* block, u64 size)
+{
+    return VirtualAlloc(block, size, MEM_COMMIT, PAGE_READWRITE) != 0;
+}
+
+void PlatformDecommitMemory(void* block, u64 size)
+{
+    VirtualFree(block, size, MEM_DECOMMIT);
+}
+
+void PlatformReleaseMemory(void* block, u64 size)
+{
+    VirtualFree(block, 0, MEM_RELEASE);
+}
+
 void PlatformZeroMemory(void* block, u64 size)
 {
     ZeroMemory(block, size);
@@ -362,6 +396,151 @@ void PlatformConsoleWriteError(const char* message, u8 colour)
     WriteConsoleA(GetStdHandle(STD_ERROR_HANDLE), message, (DWORD)length, number_written, 0);
 }
 
+typedef struct PlatformThreadStart {
+    PFN_ThreadStart Start;
+    void* Param;
+} PlatformThreadStart;
+
+DWORD WINAPI PlatformThreadEntry(LPVOID param)
+{
+    PlatformThreadStart start = *(PlatformThreadStart*)param;
+    PlatformFree(param);
+    return start.Start(start.Param);
+}
+
+b8 PlatformThreadCreate(PFN_ThreadStart start, void* param, PlatformThread* out_thread)
+{
+    PlatformThreadStart* thread_start = PlatformAlloc(sizeof(PlatformThreadStart));
+    if (!thread_start)
+        return false;
+    thread_start->Start = start;
+    thread_start->Param = param;
+
+    HANDLE thread = CreateThread(0, 0, PlatformThreadEntry, thread_start, 0, 0);
+    if (!thread) {
+        PlatformFree(thread_start);
+        return false;
+    }
+    out_thread->Handle = (u64)thread;
+    return true;
+}
+
+void PlatformThreadJoin(PlatformThread* thread)
+{
+    WaitForSingleObject((HANDLE)thread->Handle, INFINITE);
+    CloseHandle((HANDLE)thread->Handle);
+    thread->Handle = 0;
+}
+
+b8 PlatformThreadSetAffinity(PlatformThread* thread, u32 processor)
+{
+    if (processor >= sizeof(DWORD_PTR) * 8)
+        return false;
+    return SetThreadAffinityMask((HANDLE)thread->Handle, (DWORD_PTR)1 << processor) != 0;
+}
+
+u32 PlatformGetProcessorCount()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (u32)info.dwNumberOfProcessors : 1;
+}
+
+// SRW locks and condition variables are a single pointer initialized to 0, so they're kept in the handle itself.
+b8 PlatformMutexCreate(PlatformMutex* out_mutex)
+{
+    InitializeSRWLock((SRWLOCK*)&out_mutex->Handle);
+    return true;
+}
+
+void PlatformMutexDestroy(PlatformMutex* mutex)
+{
+    mutex->Handle = 0;
+}
+
+void PlatformMutexLock(PlatformMutex* mutex)
+{
+    AcquireSRWLockExclusive((SRWLOCK*)&mutex->Handle);
+}
+
+void PlatformMutexUnlock(PlatformMutex* mutex)
+{
+    ReleaseSRWLockExclusive((SRWLOCK*)&mutex->Handle);
+}
+
+b8 PlatformSemaphoreCreate(u32 initial_count, PlatformSemaphore* out_semaphore)
+{
+    HANDLE semaphore = CreateSemaphoreA(0, (LONG)initial_count, MAXLONG, 0);
+    if (!semaphore)
+        return false;
+    out_semaphore->Handle = (u64)semaphore;
+    return true;
+}
+
+void PlatformSemaphoreDestroy(PlatformSemaphore* semaphore)
+{
+    if (!semaphore->Handle)
+        return;
+    CloseHandle((HANDLE)semaphore->Handle);
+    semaphore->Handle = 0;
+}
+
+void PlatformSemaphoreSignal(PlatformSemaphore* semaphore, u32 count)
+{
+    if (count)
+        ReleaseSemaphore((HANDLE)semaphore->Handle, (LONG)count, 0);
+}
+
+void PlatformSemaphoreWait(PlatformSemaphore* semaphore)
+{
+    WaitForSingleObject((HANDLE)semaphore->Handle, INFINITE);
+}
+
+b8 PlatformConditionCreate(PlatformCondition* out_condition)
+{
+    InitializeConditionVariable((CONDITION_VARIABLE*)&out_condition->Handle);
+    return true;
+}
+
+void PlatformConditionDestroy(PlatformCondition* condition)
+{
+    condition->Handle = 0;
+}
+
+void PlatformConditionWait(PlatformCondition* condition, PlatformMutex* mutex)
+{
+    SleepConditionVariableSRW((CONDITION_VARIABLE*)&condition->Handle, (SRWLOCK*)&mutex->Handle, INFINITE, 0);
+}
+
+void PlatformConditionSignal(PlatformCondition* condition)
+{
+    WakeConditionVariable((CONDITION_VARIABLE*)&condition->Handle);
+}
+
+void PlatformConditionBroadcast(PlatformCondition* condition)
+{
+    WakeAllConditionVariable((CONDITION_VARIABLE*)&condition->Handle);
+}
+
+void PlatformSleep(u64 ms)
+{
+    Sleep((DWORD)ms);
+}
+
+f64 PlatformGetAbsoluteTime()
+{
+    // The frequency is fixed at boot, so racing threads would all store the same value.
+    static f64 clock_period = 0.0;
+    if (clock_period == 0.0) {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        clock_period = 1.0 / (f64)frequency.QuadPart;
+    }
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (f64)now.QuadPart * clock_period;
+}
+
 LRESULT CALLBACK PlatformProcessMessages(HWND hwnd, u32 msg, WPARAM w_param, LPARAM l_param)
 {
     switch (msg) {
@@ -371,7 +550,7 @@ LRESULT CALLBACK PlatformProcessMessages(HWND hwnd, u32 msg, WPARAM w_param, LPA
         }
         case WM_CLOSE: {
             Event data = {};
-            EventFire(EVENT_CODE_APPLICATION_QUIT, 0, data);
+            EventPost(EVENT_CODE_APPLICATION_QUIT, 0, data);
             return 0;
         }
         case WM_DESTROY: {
@@ -387,7 +566,7 @@ LRESULT CALLBACK PlatformProcessMessages(HWND hwnd, u32 msg, WPARAM w_param, LPA
             Event data = {};
             data.data.u16[0] = (u16)width;
             data.data.u16[1] = (u16)height;
-            EventFire(EVENT_CODE_RESIZED, 0, data);
+            EventPost(EVENT_CODE_RESIZED, 0, data);
         }
         case WM_KEYDOWN:
         case WM_SYSKEYDOWN:
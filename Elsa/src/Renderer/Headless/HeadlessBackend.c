@@ -0,0 +1,119 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_RENDERER
+
+#include "HeadlessBackend.h"
+
+#include <Core/Logger.h>
+#include <Containers/SlotMap.h>
+
+#include <Platform/Platform.h>
+
+typedef struct HeadlessBuffer {
+	u64 Size;
+	BufferUsage Usage;
+} HeadlessBuffer;
+
+typedef struct HeadlessContext {
+	u32 FramebufferWidth;
+	u32 FramebufferHeight;
+	
+	SlotMap Buffers;
+	SlotMap RenderPipelines;
+} HeadlessContext;
+
+static HeadlessContext context;
+
+b8 HeadlessRendererBackendInit(RendererBackend* backend)
+{
+	context.FramebufferWidth = 1280;
+	context.FramebufferHeight = 720;
+	
+	if (!SlotMap_Create(HeadlessBuffer, 0, &context.Buffers) ||
+		!SlotMap_Create(ShaderPack*, 0, &context.RenderPipelines)) {
+		ELSA_ERROR("Failed to create headless object pools. Shutting down...");
+		return false;
+	}
+	
+	ELSA_INFO("Headless renderer initialized, nothing will be drawn.");
+	return true;
+}
+
+void HeadlessRendererBackendShutdown(RendererBackend* backend)
+{
+	u32 live_buffers = SlotMapCount(&context.Buffers);
+	if (live_buffers)
+		ELSA_WARN("HeadlessRendererBackendShutdown - %u buffers were never freed.", live_buffers);
+	
+	SlotMapDestroy(&context.RenderPipelines);
+	SlotMapDestroy(&context.Buffers);
+	PlatformZeroMemory(&context, sizeof(context));
+}
+
+void HeadlessRendererBackendResized(RendererBackend* backend, u16 width, u16 height)
+{
+	context.FramebufferWidth = (u32)width;
+	context.FramebufferHeight = (u32)height;
+}
+
+BufferHandle HeadlessRendererBackendBufferCreate(RendererBackend* backend, u64 size, BufferUsage usage)
+{
+	HeadlessBuffer buffer;
+	buffer.Size = size;
+	buffer.Usage = usage;
+	return SlotMapInsert(&context.Buffers, &buffer);
+}
+
+void HeadlessRendererBackendBufferUpload(RendererBackend* backend, void* data, u64 size, BufferHandle buffer)
+{
+	HeadlessBuffer* backend_buffer = SlotMap_Get(&context.Buffers, HeadlessBuffer, buffer);
+	if (!backend_buffer) {
+		ELSA_WARN("Invalid or stale buffer handle 0x%llx!", buffer);
+		return;
+	}
+	if (size > backend_buffer->Size)
+		ELSA_ERROR("HeadlessRendererBackendBufferUpload - Uploading %llu bytes to a buffer of %llu bytes.", size, backend_buffer->Size);
+}
+
+void HeadlessRendererBackendBufferFree(RendererBackend* backend, BufferHandle buffer)
+{
+	if (!SlotMapRemove(&context.Buffers, buffer))
+		ELSA_WARN("Invalid or stale buffer handle 0x%llx!", buffer);
+}
+
+b8 HeadlessRendererBackendRenderPipelineCreate(RendererBackend* backend, ShaderPack* pack, DescriptorMap* map, RenderPipeline* pipeline)
+{
+	pipeline->Pack = pack;
+	pipeline->Handle = SlotMapInsert(&context.RenderPipelines, &pack);
+	return pipeline->Handle != SLOT_HANDLE_INVALID;
+}
+
+void HeadlessRendererBackendRenderPipelineDestroy(RendererBackend* backend, RenderPipeline* pipeline)
+{
+	if (!SlotMapRemove(&context.RenderPipelines, pipeline->Handle)) {
+		ELSA_WARN("HeadlessRendererBackendRenderPipelineDestroy - The pipeline was already destroyed.");
+		return;
+	}
+	pipeline->Handle = SLOT_HANDLE_INVALID;
+}
+
+b8 HeadlessRendererBackendDescriptorMapCreate(RendererBackend* backend, ShaderPack* pack, DescriptorMap* map)
+{
+	// Without SPIR-V reflection the map has no descriptors, which is all a backend that draws nothing needs.
+	PlatformZeroMemory(map, sizeof(DescriptorMap));
+	return true;
+}
+
+void HeadlessRendererBackendDescriptorMapDestroy(RendererBackend* backend, DescriptorMap* map)
+{
+	
+}
+
+b8 HeadlessRendererBackendBeginFrame(RendererBackend* backend, f32 delta_time)
+{
+	return true;
+}
+
+b8 HeadlessRendererBackendEndFrame(RendererBackend* backend, f32 delta_time)
+{
+	backend->FrameNumber++;
+	return true;
+}
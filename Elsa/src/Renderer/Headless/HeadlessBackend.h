@@ -0,0 +1,35 @@
+/**
+ * @file HeadlessBackend.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains the headless implementation of the renderer backend,
+ * which draws nothing. It keeps track of the buffers and pipelines it hands out, so
+ * that the rest of the engine behaves as it does with a real backend when there is
+ * no display to render to.
+ * @version 1.0
+ * @date 2022-07-30
+ */
+#ifndef ELSA_HEADLESS_BACKEND_H
+#define ELSA_HEADLESS_BACKEND_H
+
+#include <Defines.h>
+#include <Renderer/RendererTypes.h>
+
+b8 HeadlessRendererBackendInit(RendererBackend* backend);
+void HeadlessRendererBackendShutdown(RendererBackend* backend);
+
+void HeadlessRendererBackendResized(RendererBackend* backend, u16 width, u16 height);
+
+BufferHandle HeadlessRendererBackendBufferCreate(RendererBackend* backend, u64 size, BufferUsage usage);
+void HeadlessRendererBackendBufferUpload(RendererBackend* backend, void* data, u64 size, BufferHandle buffer);
+void HeadlessRendererBackendBufferFree(RendererBackend* backend, BufferHandle buffer);
+
+b8 HeadlessRendererBackendRenderPipelineCreate(RendererBackend* backend, ShaderPack* pack, DescriptorMap* map, RenderPipeline* pipeline);
+void HeadlessRendererBackendRenderPipelineDestroy(RendererBackend* backend, RenderPipeline* pipeline);
+
+b8 HeadlessRendererBackendDescriptorMapCreate(RendererBackend* backend, ShaderPack* pack, DescriptorMap* map);
+void HeadlessRendererBackendDescriptorMapDestroy(RendererBackend* backend, DescriptorMap* map);
+
+b8 HeadlessRendererBackendBeginFrame(RendererBackend* backend, f32 delta_time);
+b8 HeadlessRendererBackendEndFrame(RendererBackend* backend, f32 delta_time);
+
+#endif
@@ -1,3 +1,5 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "MetalBackend.h"
 
 #include <Platform/Platform.h>
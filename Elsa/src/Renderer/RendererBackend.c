@@ -2,6 +2,7 @@
 
 #include <Platform/Platform.h>
 
+#include "Headless/HeadlessBackend.h"
 #include "Metal/MetalBackend.h"
 #include "Vulkan/VulkanBackend.h"
 
@@ -40,6 +41,22 @@ b8 RendererBackendCreate(RendererBackendAPI api, RendererBackend* out_renderer_b
 #else
         return false;
 #endif
+    } else if (api == RENDERER_BACKEND_API_HEADLESS) {
+        out_renderer_backend->API = RENDERER_BACKEND_API_HEADLESS;
+        out_renderer_backend->Init = HeadlessRendererBackendInit;
+        out_renderer_backend->Shutdown = HeadlessRendererBackendShutdown;
+        out_renderer_backend->Resized = HeadlessRendererBackendResized;
+		out_renderer_backend->BufferCreate = HeadlessRendererBackendBufferCreate;
+        out_renderer_backend->BufferUpload = HeadlessRendererBackendBufferUpload;
+		out_renderer_backend->BufferFree = HeadlessRendererBackendBufferFree;
+		out_renderer_backend->RenderPipelineCreate = HeadlessRendererBackendRenderPipelineCreate;
+		out_renderer_backend->RenderPipelineDestroy = HeadlessRendererBackendRenderPipelineDestroy;
+        out_renderer_backend->DescriptorMapCreate = HeadlessRendererBackendDescriptorMapCreate;
+        out_renderer_backend->DescriptorMapDestroy = HeadlessRendererBackendDescriptorMapDestroy;
+        out_renderer_backend->BeginFrame = HeadlessRendererBackendBeginFrame;
+        out_renderer_backend->EndFrame = HeadlessRendererBackendEndFrame;
+		
+        return true;
     }
 	
     return false;
@@ -1,3 +1,5 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "RendererFrontend.h"
 
 #include "RendererBackend.h"
@@ -13,18 +15,24 @@ typedef struct RendererFrontend {
 
 static RendererFrontend frontend;
 
-b8 RendererFrontendInit(const char* application_name)
+b8 RendererFrontendInit(const char* application_name, b8 headless)
 {
     frontend.FramebufferWidth = 1280;
     frontend.FramebufferHeight = 720;
 	
+    if (headless) {
+        if (!RendererBackendCreate(RENDERER_BACKEND_API_HEADLESS, &frontend.backend)) {
+            ELSA_ERROR("RendererBackendCreate <RENDERER_BACKEND_API_HEADLESS> failed. Shutting down...");
+            return false;
+        }
+    }
 #if defined(ELSA_VULKAN)
-    if (!RendererBackendCreate(RENDERER_BACKEND_API_VULKAN, &frontend.backend)) {
+    else if (!RendererBackendCreate(RENDERER_BACKEND_API_VULKAN, &frontend.backend)) {
         ELSA_ERROR("RendererBackendCreate <RENDERER_BACKEND_API_VULKAN> failed. Shutting down...");
         return false;
     }
 #elif defined(ELSA_METAL)
-    if (!RendererBackendCreate(RENDERER_BACKEND_API_METAL, &frontend.backend)) {
+    else if (!RendererBackendCreate(RENDERER_BACKEND_API_METAL, &frontend.backend)) {
         ELSA_ERROR("RendererBackendCreate <RENDERER_BACKEND_API_METAL> failed. Shutting down...");
         return false;
     }
@@ -49,17 +57,17 @@ void RendererFrontendResized(u16 width, u16 height)
         frontend.backend.Resized(&frontend.backend, width, height);
 }
 
-Buffer* RendererFrontendBufferCreate(u64 size, BufferUsage usage)
+BufferHandle RendererFrontendBufferCreate(u64 size, BufferUsage usage)
 {
     return frontend.backend.BufferCreate(&frontend.backend, size, usage);
 }
 
-void RendererFrontendBufferUpload(void* data, u64 size, Buffer* buffer)
+void RendererFrontendBufferUpload(void* data, u64 size, BufferHandle buffer)
 {
     frontend.backend.BufferUpload(&frontend.backend, data, size, buffer);
 }
 
-void RendererFrontendBufferFree(Buffer* buffer)
+void RendererFrontendBufferFree(BufferHandle buffer)
 {
     frontend.backend.BufferFree(&frontend.backend, buffer);
 }
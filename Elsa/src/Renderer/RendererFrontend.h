@@ -17,9 +17,10 @@
  * @brief Initializes the renderer frontend.
  * 
  * @param application_name The name of the application.
+ * @param headless Whether to use the headless backend, which needs no window and draws nothing.
  * @returns True on success; otherwise false.
  */
-ELSA_API b8 RendererFrontendInit(const char* application_name);
+ELSA_API b8 RendererFrontendInit(const char* application_name, b8 headless);
 
 /**
  * @brief Shuts the renderer frontend down.
@@ -38,23 +39,23 @@ ELSA_API void RendererFrontendResized(u16 width, u16 height);
  * @brief Creates a GPU buffer.
  * @param size The size of the buffer to be created.
  * @param usage The usage for the buffer.
- * @returns A pointer to the created buffer if successful; otherwise NULL.
+ * @returns The handle of the created buffer if successful; otherwise BUFFER_HANDLE_INVALID.
  */
-ELSA_API Buffer* RendererFrontendBufferCreate(u64 size, BufferUsage usage);
+ELSA_API BufferHandle RendererFrontendBufferCreate(u64 size, BufferUsage usage);
 
 /**
  * @brief Uploads the given data to a GPU buffer.
  * @param data The data to be uploaded.
  * @param size The size in bytes of the data.
- * @param buffer A pointer to the buffer to upload.
+ * @param buffer The handle of the buffer to upload.
  */
-ELSA_API void RendererFrontendBufferUpload(void* data, u64 size, Buffer* buffer);
+ELSA_API void RendererFrontendBufferUpload(void* data, u64 size, BufferHandle buffer);
 
 /**
  * @brief Destroys a GPU buffer.
- * @param buffer The buffer to destroy.
+ * @param buffer The handle of the buffer to destroy. Stale handles are ignored with a warning.
  */
-ELSA_API void RendererFrontendBufferFree(Buffer* buffer);
+ELSA_API void RendererFrontendBufferFree(BufferHandle buffer);
 
 /**
 * @brief Creates a render pipeline.
@@ -9,13 +9,18 @@
 #define ELSA_RENDERER_TYPES_H
 
 #include <Defines.h>
+#include <Core/StringId.h>
+#include <Containers/SlotMap.h>
 
-/** @brief The max name of a reflect descriptor binding */
-#define MAX_DESCRIPTOR_NAME 128
-
-/** @brief Opaque handle representing a GPU buffer */
+/** @brief Opaque structure holding the backend data of a GPU buffer */
 typedef struct Buffer Buffer;
 
+/** @brief Handle representing a GPU buffer. Handles to destroyed buffers are detected and rejected. */
+typedef SlotHandle BufferHandle;
+
+/** @brief The handle that never refers to a buffer. */
+#define BUFFER_HANDLE_INVALID SLOT_HANDLE_INVALID
+
 /** @brief Opaque handle representing a GPU texture */
 typedef struct Texture Texture;
 
@@ -307,8 +312,8 @@ typedef struct ShaderPack {
 	/** @brief An array containing all the shaders in the pack. */
 	ShaderModule* Modules;
 	
-	/** @brief The path of the shader pack. */
-	const char* Path;
+	/** @brief The path of the shader pack, interned. */
+	StringId Path;
 } ShaderPack;
 
 /** @brief Represents the different types of descriptors */
@@ -329,8 +334,8 @@ typedef enum DescriptorType {
 
 /** @brief Holds the information of a descriptor */
 typedef struct DescriptorInfo {
-    /** @brief The descriptor's name */
-	char Name[MAX_DESCRIPTOR_NAME];
+    /** @brief The descriptor's name, interned */
+	StringId Name;
 	
     /** @brief The binding index of the descriptor */
 	u32 Binding;
@@ -374,7 +379,9 @@ typedef enum RendererBackendAPI {
     /** @brief (UNSUPPORTED: DESKTOP) The OpenGL backend */
     RENDERER_BACKEND_API_OPENGL,
     /** @brief (UNSUPPORTED: SWITCH) The Deko3D backend */
-    RENDERER_BACKEND_API_DEKO3D
+    RENDERER_BACKEND_API_DEKO3D,
+    /** @brief (SUPPORTED: ALL) The headless backend, which draws nothing */
+    RENDERER_BACKEND_API_HEADLESS
 } RendererBackendAPI;
 
 /** @brief Structure holding data about material configuration */
@@ -390,7 +397,8 @@ typedef struct MaterialConfig {
 typedef struct RenderPipeline {
 	ShaderPack* Pack;
 	MaterialConfig Config;
-	void* Internal;
+	/** @brief The handle of the backend pipeline. */
+	SlotHandle Handle;
 } RenderPipeline;
 
 /** @brief Structure representing a material layout. */
@@ -398,8 +406,8 @@ typedef struct MaterialLayout {
 	/** @brief The shader pack of the material */
 	ShaderPack Pack;
 	
-	/** @brief The path of the material layout */
-	const char* Path;
+	/** @brief The path of the material layout, interned */
+	StringId Path;
 	
 	/** @brief The render pipeline of the material */
 	RenderPipeline Pipeline;
@@ -451,25 +459,25 @@ typedef struct RendererBackend {
     * @param backend A pointer to the generic backend interface.
     * @param size The size of the buffer to be created.
     * @param usage The usage for the buffer.
-    * @returns A pointer to the created buffer if successful; otherwise NULL.
+    * @returns The handle of the created buffer if successful; otherwise BUFFER_HANDLE_INVALID.
     */
-	Buffer* (*BufferCreate)(struct RendererBackend* backend, u64 size, BufferUsage usage);
+	BufferHandle (*BufferCreate)(struct RendererBackend* backend, u64 size, BufferUsage usage);
 	
     /**
      * @brief Uploads the given data to a GPU buffer.
      * @param backend A pointer to the generic backend interface.
      * @param data The data to be uploaded.
      * @param size The size in bytes of the data.
-     * @param buffer A pointer to the buffer to upload.
+     * @param buffer The handle of the buffer to upload.
      */
-    void (*BufferUpload)(struct RendererBackend* backend, void* data, u64 size, Buffer* buffer);
+    void (*BufferUpload)(struct RendererBackend* backend, void* data, u64 size, BufferHandle buffer);
 
 	/**
     * @brief Destroys a GPU buffer.
     * @param backend A pointer to the generic backend interface.
-    * @param buffer The buffer to destroy.
+    * @param buffer The handle of the buffer to destroy.
     */
-	void (*BufferFree)(struct RendererBackend* backend, Buffer* buffer);
+	void (*BufferFree)(struct RendererBackend* backend, BufferHandle buffer);
 	
 	/**
     * @brief Creates a render pipeline.
@@ -1,7 +1,10 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_SHADER_COMPILER
+
 #include "ShaderCompiler.h"
 #include "RendererFrontend.h"
 
 #include <Core/Logger.h>
+#include <Core/Profiler.h>
 #include <Containers/Darray.h>
 #include <Platform/FileSystem.h>
 #include <Platform/Platform.h>
@@ -123,7 +126,7 @@ b8 ShaderCompile(const char* path, ShaderModule* out_stage)
 b8 ShaderPackCreate(const char* path, ShaderPack* out_pack)
 {
 	out_pack->Modules = Darray_Create(ShaderModule);
-	out_pack->Path = path;
+	out_pack->Path = StringIdIntern(path);
 	
 	// Whether or not the engine should compile the shaders present in the pack.
 	b8 should_compile = true;
@@ -228,7 +231,7 @@ void ShaderPackDestroy(ShaderPack* pack)
 
 b8 MaterialLayoutLoad(const char* path, MaterialLayout* layout)
 {
-	layout->Path = path;
+	layout->Path = StringIdIntern(path);
 	
 	CODE_BLOCK("Layout config")
 	{
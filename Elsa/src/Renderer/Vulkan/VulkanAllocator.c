@@ -1,3 +1,5 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "VulkanAllocator.h"
 
 #include <Core/MemTracker.h>
@@ -46,17 +48,38 @@ b8 VulkanAllocatorInit(VulkanAllocator* allocator, VulkanContext* context)
     allocator_info.vulkanApiVersion = VK_API_VERSION_1_3;
 	
     VkResult result = vmaCreateAllocator(&allocator_info, &allocator->Allocator);
-	return result == VK_SUCCESS;
+	if (result != VK_SUCCESS)
+		return false;
+	
+	if (!SlotMap_Create(Buffer, 0, &allocator->Buffers))
+		return false;
+	if (!MemoryPool_Create(Texture, MEMORY_POOL_DEFAULT_CHUNK_SLOTS, false, MEMORY_TAG_RENDERER, &allocator->TexturePool))
+		return false;
+	
+	return true;
 }
 
 void VulkanAllocatorFree(VulkanAllocator* allocator, VulkanContext* context)
 {
+	// Buffers are packed, so destroying whatever is still alive is a linear walk.
+	Buffer* buffers = allocator->Buffers.Data;
+	u32 live_buffers = SlotMapCount(&allocator->Buffers);
+	if (live_buffers)
+		ELSA_WARN("VulkanAllocatorFree - %u buffers were never freed.", live_buffers);
+	for (u32 i = 0; i < live_buffers; i++) {
+		vmaDestroyBuffer(allocator->Allocator, buffers[i].Buffer, buffers[i].Allocation);
+	}
+	
+	MemoryPoolDestroy(&allocator->TexturePool);
+	SlotMapDestroy(&allocator->Buffers);
 	vmaDestroyAllocator(allocator->Allocator);
 }
 
-Buffer* VulkanAllocatorBufferCreate(VulkanAllocator* allocator, u64 size, BufferUsage usage)
+BufferHandle VulkanAllocatorBufferCreate(VulkanAllocator* allocator, u64 size, BufferUsage usage)
 {
-	Buffer* buffer = MemoryTrackerAlloc(sizeof(Buffer), MEMORY_TAG_RENDERER);
+	Buffer buffer = { 0 };
+	buffer.Size = size;
+	buffer.Usage = usage;
 	
 	VkBufferCreateInfo buffer_create_info = {0};
 	buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -67,26 +90,44 @@ Buffer* VulkanAllocatorBufferCreate(VulkanAllocator* allocator, u64 size, Buffer
 	VmaAllocationCreateInfo allocation_create_info = {0};
 	allocation_create_info.usage = BufferUsageToVMA(usage);
 	
-	VkResult result = vmaCreateBuffer(allocator->Allocator, &buffer_create_info, &allocation_create_info, &buffer->Buffer, &buffer->Allocation, NULL);
+	VkResult result = vmaCreateBuffer(allocator->Allocator, &buffer_create_info, &allocation_create_info, &buffer.Buffer, &buffer.Allocation, NULL);
 	if (result != VK_SUCCESS) {
 		ELSA_ERROR("Failed to create GPU buffer!");
-		MemoryTrackerFree(buffer, sizeof(Buffer), MEMORY_TAG_RENDERER);
-		return NULL;
+		return BUFFER_HANDLE_INVALID;
 	}
 	
+	BufferHandle handle = SlotMapInsert(&allocator->Buffers, &buffer);
+	if (handle == BUFFER_HANDLE_INVALID)
+		vmaDestroyBuffer(allocator->Allocator, buffer.Buffer, buffer.Allocation);
+	return handle;
+}
+
+Buffer* VulkanAllocatorBufferGet(VulkanAllocator* allocator, BufferHandle handle)
+{
+	Buffer* buffer = SlotMap_Get(&allocator->Buffers, Buffer, handle);
+	if (!buffer)
+		ELSA_WARN("Invalid or stale buffer handle 0x%llx!", handle);
 	return buffer;
 }
 
-void VulkanAllocatorBufferUpload(VulkanAllocator* allocator, u64 size, void* data, Buffer* buffer)
+void VulkanAllocatorBufferUpload(VulkanAllocator* allocator, u64 size, void* data, BufferHandle handle)
 {
+	Buffer* buffer = VulkanAllocatorBufferGet(allocator, handle);
+	if (!buffer)
+		return;
+	
 	void* memory = NULL;
 	vmaMapMemory(allocator->Allocator, buffer->Allocation, &memory);
 	memcpy(memory, data, size);
 	vmaUnmapMemory(allocator->Allocator, buffer->Allocation);
 }
 
-void VulkanAllocatorBufferFree(VulkanAllocator* allocator, Buffer* buffer)
+void VulkanAllocatorBufferFree(VulkanAllocator* allocator, BufferHandle handle)
 {
+	Buffer* buffer = VulkanAllocatorBufferGet(allocator, handle);
+	if (!buffer)
+		return;
+	
 	vmaDestroyBuffer(allocator->Allocator, buffer->Buffer, buffer->Allocation);
-	MemoryTrackerFree(buffer, sizeof(Buffer), MEMORY_TAG_RENDERER);
+	SlotMapRemove(&allocator->Buffers, handle);
 }
\ No newline at end of file
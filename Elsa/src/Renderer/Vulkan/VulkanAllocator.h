@@ -13,8 +13,9 @@
 b8 VulkanAllocatorInit(VulkanAllocator* allocator, VulkanContext* context);
 void VulkanAllocatorFree(VulkanAllocator* allocator, VulkanContext* context);
 
-Buffer* VulkanAllocatorBufferCreate(VulkanAllocator* allocator, u64 size, BufferUsage usage);
-void VulkanAllocatorBufferUpload(VulkanAllocator* allocator, u64 size, void* data, Buffer* buffer);
-void VulkanAllocatorBufferFree(VulkanAllocator* allocator, Buffer* buffer);
+BufferHandle VulkanAllocatorBufferCreate(VulkanAllocator* allocator, u64 size, BufferUsage usage);
+Buffer* VulkanAllocatorBufferGet(VulkanAllocator* allocator, BufferHandle handle);
+void VulkanAllocatorBufferUpload(VulkanAllocator* allocator, u64 size, void* data, BufferHandle handle);
+void VulkanAllocatorBufferFree(VulkanAllocator* allocator, BufferHandle handle);
 
 #endif
\ No newline at end of file
@@ -1,8 +1,13 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "VulkanBackend.h"
 
 #if defined(ELSA_VULKAN)
 
 #include <Core/Logger.h>
+#include <Core/MemTracker.h>
+#include <Core/Profiler.h>
+#include <Core/StringId.h>
 #include <Containers/Darray.h>
 
 #include <Platform/Platform.h>
@@ -94,7 +99,16 @@ b8 VulkanRendererBackendInit(RendererBackend* backend)
         return false;
 	}
 	
-	VulkanSwapchainCreate(&context, context.FramebufferWidth, context.FramebufferHeight, &context.Swapchain);
+	if (!SlotMap_Create(VulkanRenderPipeline, 0, &context.RenderPipelines) ||
+		!MemoryPool_Create(VulkanDescriptorMap, 16, false, MEMORY_TAG_RENDERER, &context.DescriptorMapPool)) {
+		ELSA_ERROR("Failed to create Vulkan object pools. Shutting down...");
+		return false;
+	}
+	
+	if (!VulkanSwapchainCreate(&context, context.FramebufferWidth, context.FramebufferHeight, &context.Swapchain)) {
+		ELSA_ERROR("VulkanSwapchainCreate failed. Shutting down...");
+		return false;
+	}
 	
 	// Sync
 	VkFenceCreateInfo fence_info = { 0 };
@@ -135,6 +149,8 @@ void VulkanRendererBackendShutdown(RendererBackend* backend)
 	vkDestroySemaphore(context.Device.LogicalDevice, context.ImageRenderedSemaphore, NULL);
 	
 	VulkanSwapchainDestroy(&context, &context.Swapchain);
+	MemoryPoolDestroy(&context.DescriptorMapPool);
+	SlotMapDestroy(&context.RenderPipelines);
 	VulkanAllocatorFree(&context.Allocator, &context);
     VulkanDeviceDestroy(&context);
     vkDestroySurfaceKHR(context.Instance, context.Surface, NULL);
@@ -146,20 +162,21 @@ void VulkanRendererBackendResized(RendererBackend* backend, u16 width, u16 heigh
 	context.FramebufferWidth = (u32)width;
 	context.FramebufferHeight = (u32)height;
 	
-	VulkanSwapchainRecreate(&context, width, height, &context.Swapchain);
+	if (!VulkanSwapchainRecreate(&context, width, height, &context.Swapchain))
+		ELSA_ERROR("Failed to recreate the swapchain after a resize!");
 }
 
-Buffer* VulkanRendererBackendBufferCreate(RendererBackend* backend, u64 size, BufferUsage usage)
+BufferHandle VulkanRendererBackendBufferCreate(RendererBackend* backend, u64 size, BufferUsage usage)
 {
 	return VulkanAllocatorBufferCreate(&context.Allocator, size, usage);
 }
 
-void VulkanRendererBackendBufferUpload(RendererBackend* backend, void* data, u64 size, Buffer* buffer)
+void VulkanRendererBackendBufferUpload(RendererBackend* backend, void* data, u64 size, BufferHandle buffer)
 {
 	VulkanAllocatorBufferUpload(&context.Allocator, size, data, buffer);
 }
 
-void VulkanRendererBackendBufferFree(RendererBackend* backend, Buffer* buffer)
+void VulkanRendererBackendBufferFree(RendererBackend* backend, BufferHandle buffer)
 {
 	VulkanAllocatorBufferFree(&context.Allocator, buffer);
 }
@@ -204,8 +221,10 @@ b8 VulkanRendererBackendDescriptorMapCreate(RendererBackend* backend, ShaderPack
 				return false;
 			}
 
-			SpvReflectDescriptorSet* sets = PlatformAlloc(sizeof(SpvReflectDescriptorSet) * count);
-			result = spvReflectEnumerateDescriptorSets(&reflect, &count, &sets);
+			MemoryArena* arena = MemoryTrackerGetFrameArena();
+			u64 arena_mark = MemoryArenaGetMark(arena);
+			SpvReflectDescriptorSet** sets = MemoryArena_PushArray(arena, SpvReflectDescriptorSet*, count);
+			result = spvReflectEnumerateDescriptorSets(&reflect, &count, sets);
 			if (result != SPV_REFLECT_RESULT_SUCCESS) {
 				ELSA_ERROR("Failed to enumerate descriptor map sets!");
 				return false;
@@ -215,11 +234,11 @@ b8 VulkanRendererBackendDescriptorMapCreate(RendererBackend* backend, ShaderPack
 			submap->Stage = module->Stage;
 
 			for (u32 i = 0; i < count; i++) {
-				SpvReflectDescriptorSet refl_set = sets[i];
+				SpvReflectDescriptorSet refl_set = *sets[i];
 				for (u32 j = 0; j < refl_set.binding_count; j++) {
 					SpvReflectDescriptorBinding* refl_binding = refl_set.bindings[j];
 
-					sprintf(submap->Layouts[i].Descriptors[j].Name, "%s", refl_binding->name);
+					submap->Layouts[i].Descriptors[j].Name = StringIdIntern(refl_binding->name);
 					submap->Layouts[i].Descriptors[j].Binding = refl_binding->binding;
 					submap->Layouts[i].Descriptors[j].Type = (DescriptorType)refl_binding->descriptor_type;
 					submap->Layouts[i].Descriptors[j].Count = 1;
@@ -234,7 +253,7 @@ b8 VulkanRendererBackendDescriptorMapCreate(RendererBackend* backend, ShaderPack
 				submap->LayoutCount++;
 			}
 
-			PlatformFree(sets);
+			MemoryArenaRewind(arena, arena_mark);
 			spvReflectDestroyShaderModule(&reflect);
 
 			map->SubmapCount++;
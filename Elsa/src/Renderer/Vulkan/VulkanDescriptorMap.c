@@ -1,7 +1,9 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "VulkanDescriptorMap.h"
 
 #include <Containers/Darray.h>
-#include <Core/MemTracker.h>
+#include <Core/MemoryPool.h>
 #include <Core/Logger.h>
 
 VkShaderStageFlagBits GetShaderStageFlagBits(ShaderStage stage)
@@ -31,7 +33,9 @@ VkShaderStageFlagBits GetShaderStageFlagBits(ShaderStage stage)
 
 b8 VulkanDescriptorMapCreate(VulkanContext* context, DescriptorMap* map)
 {
-	VulkanDescriptorMap* backend = MemoryTrackerAlloc(sizeof(VulkanDescriptorMap), MEMORY_TAG_RENDERER);
+	VulkanDescriptorMap* backend = MemoryPool_Alloc(&context->DescriptorMapPool, VulkanDescriptorMap);
+	if (!backend)
+		return false;
 	backend->SubmapCount = map->SubmapCount;
 
 	// ALL SHADER STAGES
@@ -88,5 +92,5 @@ void VulkanDescriptorMapDestroy(VulkanContext* context, DescriptorMap* map)
 		}
 	}
 
-	MemoryTrackerFree(backend, sizeof(VulkanDescriptorMap), MEMORY_TAG_RENDERER);
+	MemoryPoolFree(&context->DescriptorMapPool, backend);
 }
\ No newline at end of file
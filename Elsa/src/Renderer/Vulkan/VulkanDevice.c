@@ -1,6 +1,8 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "VulkanDevice.h"
 
-#include <Containers/Darray.h>
+#include <Containers/SmallArray.h>
 #include <Platform/Platform.h>
 #include <Core/Logger.h>
 #include <Core/MemTracker.h>
@@ -11,7 +13,7 @@ typedef struct VulkanPhysicalDeviceRequirements {
     b8 Graphics;
     b8 Compute;
     b8 Transfer;
-    const char** DeviceExtensionNames;
+    SmallArray(const char*, 8) DeviceExtensionNames;
     b8 SamplerAnisotropy;
     b8 PipelineStatisticsQuery;
     b8 FillModeNonSolid;
@@ -88,7 +90,7 @@ b8 PhysicalDeviceMeetsRequirements(VkPhysicalDevice device, VkSurfaceKHR surface
         }
 		
         // Device extensions.
-        if (requirements->DeviceExtensionNames) {
+        if (requirements->DeviceExtensionNames.Length) {
             u32 available_extension_count = 0;
             VkExtensionProperties* available_extensions = 0;
             VK_CHECK(vkEnumerateDeviceExtensionProperties(
@@ -104,11 +106,11 @@ b8 PhysicalDeviceMeetsRequirements(VkPhysicalDevice device, VkSurfaceKHR surface
 															  &available_extension_count,
 															  available_extensions));
 				
-                u32 required_extension_count = Darray_Length(requirements->DeviceExtensionNames);
+                u32 required_extension_count = requirements->DeviceExtensionNames.Length;
                 for (u32 i = 0; i < required_extension_count; ++i) {
                     b8 found = false;
                     for (u32 j = 0; j < available_extension_count; ++j) {
-                        if (!strcmp(requirements->DeviceExtensionNames[i], available_extensions[j].extensionName)) {
+                        if (!strcmp(requirements->DeviceExtensionNames.Data[i], available_extensions[j].extensionName)) {
                             found = true;
                             break;
                         }
@@ -181,11 +183,12 @@ b8 SelectPhysicalDevice(VulkanContext* context)
 #else
 		requirements.DiscreteGPU = true;
 #endif
-        requirements.DeviceExtensionNames = Darray_Create(const char*);
-        Darray_Push(requirements.DeviceExtensionNames, &VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        SmallArray_Init(requirements.DeviceExtensionNames);
+        SmallArray_Push(requirements.DeviceExtensionNames, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 		
         VulkanPhysicalDeviceQueueFamilyInfo queue_info = {};
         b8 result = PhysicalDeviceMeetsRequirements(physical_devices[i], context->Surface, &properties, &features, &requirements, &queue_info, &context->Device.SwapchainSupport);
+        SmallArray_Destroy(requirements.DeviceExtensionNames);
 		
         if (result) {
             context->Device.PhysicalDevice = physical_devices[i];
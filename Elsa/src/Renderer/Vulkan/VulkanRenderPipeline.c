@@ -1,3 +1,5 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "VulkanRenderPipeline.h"
 
 #include <Containers/Darray.h>
@@ -6,7 +8,6 @@
 #include <Platform/Platform.h>
 
 #include <SPIRV/spirv_reflect.h>
-#include <stdlib.h>
 
 u32 VulkanFormatSize(VkFormat format)
 {
@@ -177,9 +178,14 @@ VkResult MakeShaderModule(VulkanContext* ctx, VkShaderModule* out, u8* code, u64
 
 b8 VulkanRenderPipelineCreate(VulkanContext* context, ShaderPack* pack, DescriptorMap* map, RenderPipeline* pipeline)
 {
-	VulkanRenderPipeline* backend = MemoryTrackerAlloc(sizeof(VulkanRenderPipeline), MEMORY_TAG_RENDERER);
+	VulkanRenderPipeline backend_data = { 0 };
+	VulkanRenderPipeline* backend = &backend_data;
 	pipeline->Pack = pack;
 	
+	// Every temporary array below lives on the frame arena and is released when we rewind.
+	MemoryArena* arena = MemoryTrackerGetFrameArena();
+	u64 arena_mark = MemoryArenaGetMark(arena);
+	
 	b8 mesh_shader_enabled = false;
 	
 	VkPipelineShaderStageCreateInfo* shader_stages = Darray_Reserve(VkPipelineShaderStageCreateInfo, Darray_Length(pipeline->Pack->Modules));
@@ -229,10 +235,10 @@ b8 VulkanRenderPipelineCreate(VulkanContext* context, ShaderPack* pack, Descript
 		
 		u32 vs_input_var_count = 0;
         spvReflectEnumerateInputVariables(&input_layout_reflect, &vs_input_var_count, 0);
-        vs_input_vars = calloc(vs_input_var_count, sizeof(SpvReflectInterfaceVariable*));
+        vs_input_vars = MemoryArena_PushArray(arena, SpvReflectInterfaceVariable*, vs_input_var_count);
         spvReflectEnumerateInputVariables(&input_layout_reflect, &vs_input_var_count, vs_input_vars);
 		
-		attribute_descriptions = PlatformAlloc(sizeof(VkVertexInputAttributeDescription) * vs_input_var_count);
+		attribute_descriptions = MemoryArena_PushArray(arena, VkVertexInputAttributeDescription, vs_input_var_count);
 		
         for (u32 i = 0; i < vs_input_var_count; i++)
         {
@@ -332,21 +338,22 @@ b8 VulkanRenderPipelineCreate(VulkanContext* context, ShaderPack* pack, Descript
     color_blending.blendConstants[3] = 0.0f;
 	
     // Setup descriptor set layouts
-    VkDescriptorSetLayout* layouts = Darray_Create(VkDescriptorSetLayout);
+    VkDescriptorSetLayout* layouts = MemoryArena_PushArray(arena, VkDescriptorSetLayout, SHADER_STAGE_MAX_STAGES * 8);
+    u32 layout_count = 0;
     if (map != NULL) {
         VulkanDescriptorMap* map_backend = map->Internal;
 
         for (u32 i = 0; i < map->SubmapCount; i++) {
             for (u32 j = 0; j < map->Submaps[i].LayoutCount; j++) {
-                Darray_Push(layouts, map_backend->Submaps[i].Layouts[j].Layout);
+                layouts[layout_count++] = map_backend->Submaps[i].Layouts[j].Layout;
             }
         }
     }
 
 	VkPipelineLayoutCreateInfo pipeline_layout_info = {0};
     pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	if (Darray_Length(layouts) != 0) {
-        pipeline_layout_info.setLayoutCount = Darray_Length(layouts);
+	if (layout_count != 0) {
+        pipeline_layout_info.setLayoutCount = layout_count;
         pipeline_layout_info.pSetLayouts = layouts;
     }
 
@@ -356,7 +363,6 @@ b8 VulkanRenderPipelineCreate(VulkanContext* context, ShaderPack* pack, Descript
 		return false;
 	}
 
-    Darray_Destroy(layouts);
 	
 	// TODO(milo): dynamic rendering setup
 	VkGraphicsPipelineCreateInfo pipeline_info = {0};
@@ -386,8 +392,6 @@ b8 VulkanRenderPipelineCreate(VulkanContext* context, ShaderPack* pack, Descript
 	
 	if (!mesh_shader_enabled)
 	{
-		PlatformFree(attribute_descriptions);
-		PlatformFree(vs_input_vars);
 		spvReflectDestroyShaderModule(&input_layout_reflect);
 	}
 	
@@ -395,17 +399,28 @@ b8 VulkanRenderPipelineCreate(VulkanContext* context, ShaderPack* pack, Descript
 		vkDestroyShaderModule(context->Device.LogicalDevice, shader_stages[i].module, NULL);
 	}
 	Darray_Destroy(shader_stages);
+	MemoryArenaRewind(arena, arena_mark);
 	
-	pipeline->Internal = backend;
+	pipeline->Handle = SlotMapInsert(&context->RenderPipelines, backend);
+	if (pipeline->Handle == SLOT_HANDLE_INVALID) {
+		vkDestroyPipeline(context->Device.LogicalDevice, backend->Pipeline, NULL);
+		vkDestroyPipelineLayout(context->Device.LogicalDevice, backend->PipelineLayout, NULL);
+		return false;
+	}
 	
 	return true;
 }
 
 void VulkanRenderPipelineDestroy(VulkanContext* context, RenderPipeline* pipeline)
 {
-	VulkanRenderPipeline* backend = pipeline->Internal;
+	VulkanRenderPipeline* backend = SlotMap_Get(&context->RenderPipelines, VulkanRenderPipeline, pipeline->Handle);
+	if (!backend) {
+		ELSA_WARN("VulkanRenderPipelineDestroy - The pipeline was already destroyed.");
+		return;
+	}
 	
 	vkDestroyPipeline(context->Device.LogicalDevice, backend->Pipeline, NULL);
 	vkDestroyPipelineLayout(context->Device.LogicalDevice, backend->PipelineLayout, NULL);
-	PlatformFree(backend);
+	SlotMapRemove(&context->RenderPipelines, pipeline->Handle);
+	pipeline->Handle = SLOT_HANDLE_INVALID;
 }
\ No newline at end of file
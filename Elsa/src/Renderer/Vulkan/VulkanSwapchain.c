@@ -1,21 +1,23 @@
+#define ELSA_LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "VulkanSwapchain.h"
 
 #include <Core/Logger.h>
-#include <Core/MemTracker.h>
+#include <Core/MemoryPool.h>
 #include "VulkanDevice.h"
 
-void Create(VulkanContext* context, u32 width, u32 height, VulkanSwapchain* swapchain);
+b8 Create(VulkanContext* context, u32 width, u32 height, VulkanSwapchain* swapchain);
 void Destroy(VulkanContext* context, VulkanSwapchain* swapchain);
 
-void VulkanSwapchainCreate(VulkanContext* context, u32 width, u32 height, VulkanSwapchain* out)
+b8 VulkanSwapchainCreate(VulkanContext* context, u32 width, u32 height, VulkanSwapchain* out)
 {
-	Create(context, width, height, out);
+	return Create(context, width, height, out);
 }
 
-void VulkanSwapchainRecreate(VulkanContext* context, u32 width, u32 height, VulkanSwapchain* swapchain)
+b8 VulkanSwapchainRecreate(VulkanContext* context, u32 width, u32 height, VulkanSwapchain* swapchain)
 {
 	Destroy(context, swapchain);
-	Create(context, width, height, swapchain);
+	return Create(context, width, height, swapchain);
 }
 
 void VulkanSwapchainDestroy(VulkanContext* context, VulkanSwapchain* swapchain)
@@ -28,7 +30,8 @@ b8 VulkanSwapchainNextImage(VulkanContext* context, VulkanSwapchain* swapchain,
 	VkResult result = vkAcquireNextImageKHR(context->Device.LogicalDevice, swapchain->Handle, timeout_ns, semaphore, fence, out_image_index);
 	
 	if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-        VulkanSwapchainRecreate(context, context->FramebufferWidth, context->FramebufferHeight, swapchain);
+        if (!VulkanSwapchainRecreate(context, context->FramebufferWidth, context->FramebufferHeight, swapchain))
+            ELSA_ERROR("Failed to recreate the out of date swapchain!");
         return false;
     } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
         ELSA_FATAL("Failed to acquire swapchain image!");
@@ -50,14 +53,17 @@ void VulkanSwapchainPresent(VulkanContext* context, VulkanSwapchain* swapchain,
 	
 	VkResult result = vkQueuePresentKHR(graphics_queue, &present_info);
 	if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
-        VulkanSwapchainRecreate(context, context->FramebufferWidth, context->FramebufferHeight, swapchain);
-        ELSA_DEBUG("Swapchain recreated because swapchain returned out of date or suboptimal.");
+        if (!VulkanSwapchainRecreate(context, context->FramebufferWidth, context->FramebufferHeight, swapchain)) {
+            ELSA_ERROR("Failed to recreate the out of date or suboptimal swapchain!");
+        } else {
+            ELSA_DEBUG("Swapchain recreated because swapchain returned out of date or suboptimal.");
+        }
     } else if (result != VK_SUCCESS) {
         ELSA_FATAL("Failed to present swap chain image!");
     }
 }
 
-void Create(VulkanContext* context, u32 width, u32 height, VulkanSwapchain* swapchain)
+b8 Create(VulkanContext* context, u32 width, u32 height, VulkanSwapchain* swapchain)
 {
 	VkExtent2D swapchain_extent = {width, height};
 	
@@ -128,11 +134,6 @@ void Create(VulkanContext* context, u32 width, u32 height, VulkanSwapchain* swap
 	
     VK_CHECK(vkCreateSwapchainKHR(context->Device.LogicalDevice, &swapchain_create_info, NULL, &swapchain->Handle));
 	
-	// Allocate textures
-	for (i32 i = 0; i < 3; i++) {
-		swapchain->RenderTextures[i] = MemoryTrackerAlloc(sizeof(Texture), MEMORY_TAG_RENDERER);
-	}
-	
     // Start with a zero frame index.
     context->ImageIndex = 0;
 	
@@ -143,6 +144,16 @@ void Create(VulkanContext* context, u32 width, u32 height, VulkanSwapchain* swap
     VkImage swapchain_images[32];
     VK_CHECK(vkGetSwapchainImagesKHR(context->Device.LogicalDevice, swapchain->Handle, &swapchain->ImageCount, swapchain_images));
     for (u32 i = 0; i < swapchain->ImageCount; ++i) {
+        swapchain->RenderTextures[i] = MemoryPool_Alloc(&context->Allocator.TexturePool, Texture);
+        if (!swapchain->RenderTextures[i]) {
+            ELSA_ERROR("Failed to allocate the texture of swapchain image %u, the texture pool is exhausted!", i);
+            for (u32 j = 0; j < i; ++j)
+                MemoryPoolFree(&context->Allocator.TexturePool, swapchain->RenderTextures[j]);
+            // Leaves nothing for Destroy to release but the swapchain itself.
+            swapchain->ImageCount = 0;
+            return false;
+        }
+		
         Texture* image = swapchain->RenderTextures[i];
         image->Image = swapchain_images[i];
         image->Width = swapchain_extent.width;
@@ -165,6 +176,7 @@ void Create(VulkanContext* context, u32 width, u32 height, VulkanSwapchain* swap
 		
         VK_CHECK(vkCreateImageView(context->Device.LogicalDevice, &view_info, NULL, &image->ImageView));
     }
+    return true;
 }
 
 void Destroy(VulkanContext* context, VulkanSwapchain* swapchain)
@@ -174,7 +186,7 @@ void Destroy(VulkanContext* context, VulkanSwapchain* swapchain)
 	for (u32 i = 0; i < swapchain->ImageCount; ++i) {
         Texture* image = swapchain->RenderTextures[i];
         vkDestroyImageView(context->Device.LogicalDevice, image->ImageView, NULL);
-		MemoryTrackerFree(image, sizeof(Texture), MEMORY_TAG_RENDERER);
+		MemoryPoolFree(&context->Allocator.TexturePool, image);
 	}
 	vkDestroySwapchainKHR(context->Device.LogicalDevice, swapchain->Handle, NULL);
 }
\ No newline at end of file
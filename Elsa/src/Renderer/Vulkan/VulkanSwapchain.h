@@ -10,8 +10,8 @@
 
 #include "VulkanTypes.h"
 
-void VulkanSwapchainCreate(VulkanContext* context, u32 width, u32 height, VulkanSwapchain* out);
-void VulkanSwapchainRecreate(VulkanContext* context, u32 width, u32 height, VulkanSwapchain* swapchain);
+b8 VulkanSwapchainCreate(VulkanContext* context, u32 width, u32 height, VulkanSwapchain* out);
+b8 VulkanSwapchainRecreate(VulkanContext* context, u32 width, u32 height, VulkanSwapchain* swapchain);
 void VulkanSwapchainDestroy(VulkanContext* context, VulkanSwapchain* swapchain);
 b8 VulkanSwapchainNextImage(VulkanContext* context, VulkanSwapchain* swapchain, u64 timeout_ns, VkSemaphore semaphore, VkFence fence, u32* out_image_index);
 void VulkanSwapchainPresent(VulkanContext* context, VulkanSwapchain* swapchain, VkQueue graphics_queue, VkSemaphore semaphore, u32 present_image_index);
@@ -11,6 +11,8 @@
 #include <Defines.h>
 #include <Renderer/RendererTypes.h>
 #include <Core/Asserts.h>
+#include <Core/MemoryPool.h>
+#include <Containers/SlotMap.h>
 
 #include <vulkan/vulkan.h>
 #include <VMA/vk_mem_alloc.h>
@@ -25,6 +27,9 @@
 
 typedef struct VulkanAllocator {
 	VmaAllocator Allocator;
+	
+	SlotMap Buffers;
+	MemoryPool TexturePool;
 } VulkanAllocator;
 
 typedef struct Buffer {
@@ -131,6 +136,9 @@ typedef struct VulkanContext {
 	VkSemaphore ImageRenderedSemaphore;
 	
 	VulkanCommandBuffer* CommandBuffers;
+	
+	SlotMap RenderPipelines;
+	MemoryPool DescriptorMapPool;
 } VulkanContext;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,14 @@
+set echo on
+
+mkdir -p ../bin
+
+cFilenames=$(find . -type f -name "*.c")
+
+Assembly="Tests"
+CompilerFlags="-g -fdeclspec -fPIC"
+IncludeFlags="-Isrc -I../Elsa/src"
+LinkerFlags="-L../bin/ -lElsa -lpthread -Wl,-rpath,\$ORIGIN"
+Defines="-D_DEBUG"
+
+echo "Building $Assembly..."
+clang $cFilenames $CompilerFlags -o ../bin/$Assembly $Defines $IncludeFlags $LinkerFlags
@@ -0,0 +1,253 @@
+#include "../Test.h"
+
+#include <Containers/Darray.h>
+#include <Containers/SmallArray.h>
+#include <Core/MemTracker.h>
+#include <Platform/Platform.h>
+
+#define DARRAY_PUSH_BENCHMARK_ELEMENTS 100000000ull
+#define DARRAY_BULK_BENCHMARK_ROUNDS 20000
+
+// Growing a stable darray never moves it, up to its maximum capacity.
+static void DarrayStableGrowth()
+{
+    u32* array = Darray_CreateStable(u32, 100000);
+    TEST_EXPECT(array != 0);
+    TEST_EXPECT(_Darray_Field_Get(array, DARRAY_FLAGS) & DARRAY_FLAG_STABLE);
+
+    u32* first = array;
+    b8 stayed = true;
+    for (u32 i = 0; i < 100000; i++) {
+        Darray_Push(array, i);
+        stayed = stayed && array == first;
+    }
+    TEST_EXPECT(stayed);
+    TEST_EXPECT(Darray_Length(array) == 100000);
+    b8 intact = true;
+    for (u32 i = 0; i < 100000; i++)
+        intact = intact && array[i] == i;
+    TEST_EXPECT(intact);
+
+    // The reservation is rounded up to whole pages, past which pushes fail, logging an error.
+    u64 length = Darray_Length(array);
+    for (;;) {
+        Darray_Push(array, 0u);
+        if (Darray_Length(array) == length)
+            break;
+        length = Darray_Length(array);
+    }
+    TEST_EXPECT(array == first);
+    TEST_EXPECT(Darray_Length(array) * sizeof(u32) < 100000 * sizeof(u32) + 65536);
+
+    Darray_Clear(array);
+    Darray_ShrinkToFit(array);
+    TEST_EXPECT(array == first);
+    TEST_EXPECT(Darray_Capacity(array) < 100000);
+    Darray_Push(array, 7u);
+    TEST_EXPECT(array[0] == 7);
+    Darray_Destroy(array);
+}
+
+static b8 DarrayEquals(u32* array, const u32* expected, u64 count)
+{
+    if (Darray_Length(array) != count)
+        return false;
+    for (u64 i = 0; i < count; i++) {
+        if (array[i] != expected[i])
+            return false;
+    }
+    return true;
+}
+
+static void DarrayBulkOperations()
+{
+    u32 values[] = {1, 2, 3, 4, 5, 6};
+    u32* array = Darray_Create(u32);
+    Darray_PushMany(array, values, 6);
+    TEST_EXPECT(DarrayEquals(array, values, 6));
+
+    u32 middle[] = {10, 11, 12};
+    Darray_InsertMany(array, 2, middle, 3);
+    u32 inserted[] = {1, 2, 10, 11, 12, 3, 4, 5, 6};
+    TEST_EXPECT(DarrayEquals(array, inserted, 9));
+    Darray_InsertMany(array, Darray_Length(array), middle, 1);
+    TEST_EXPECT(Darray_Length(array) == 10 && array[9] == 10);
+
+    // Removing keeps the order, swap-removing moves the last entry into the hole.
+    u32 popped = 0;
+    array = Darray_PopAt(array, 2, &popped);
+    TEST_EXPECT(popped == 10);
+    u32 after_pop[] = {1, 2, 11, 12, 3, 4, 5, 6, 10};
+    TEST_EXPECT(DarrayEquals(array, after_pop, 9));
+    array = Darray_PopSwap(array, 0, &popped);
+    TEST_EXPECT(popped == 1);
+    u32 after_swap[] = {10, 2, 11, 12, 3, 4, 5, 6};
+    TEST_EXPECT(DarrayEquals(array, after_swap, 8));
+
+    // Growing zeroes the new entries, and shrinking releases the spare capacity.
+    Darray_Resize(array, 100);
+    TEST_EXPECT(Darray_Length(array) == 100 && array[7] == 6 && array[8] == 0 && array[99] == 0);
+    Darray_Resize(array, 3);
+    Darray_ShrinkToFit(array);
+    TEST_EXPECT(Darray_Capacity(array) == 3);
+    TEST_EXPECT(DarrayEquals(array, after_swap, 3));
+    Darray_EnsureCapacity(array, 50);
+    TEST_EXPECT(Darray_Capacity(array) >= 50 && Darray_Length(array) == 3);
+    Darray_Clear(array);
+    TEST_EXPECT(Darray_Length(array) == 0 && Darray_Capacity(array) >= 50);
+
+    Darray_Destroy(array);
+}
+
+// Short arrays stay inline without allocating, and spill to the heap once they outgrow it.
+static void SmallArrayInlineAndSpill()
+{
+    u64 allocations = MemoryTrackerGetAllocationCount(MEMORY_TAG_DARRAY);
+    SmallArray(const char*, 8) names;
+    SmallArray_Init(names);
+    for (u32 i = 0; i < 8; i++)
+        SmallArray_Push(names, "VK_KHR_surface");
+    TEST_EXPECT(names.Length == 8 && names.Data == names.Inline);
+    TEST_EXPECT(MemoryTrackerGetAllocationCount(MEMORY_TAG_DARRAY) == allocations);
+
+    SmallArray_Push(names, "VK_EXT_debug_utils");
+    TEST_EXPECT(names.Length == 9 && names.Data != names.Inline);
+    TEST_EXPECT(names.Capacity >= 9);
+    TEST_EXPECT(MemoryTrackerGetAllocationCount(MEMORY_TAG_DARRAY) == allocations + 1);
+    TEST_EXPECT(names.Data[0] == names.Data[7] && names.Data[8] != names.Data[0]);
+
+    SmallArray_Destroy(names);
+    TEST_EXPECT(names.Length == 0 && names.Data == names.Inline);
+    TEST_EXPECT(MemoryTrackerGetAllocationCount(MEMORY_TAG_DARRAY) == allocations);
+}
+
+// Pushes 100M elements one at a time, from an empty array.
+static void DarrayPushBenchmark()
+{
+    u64 sum = 0;
+
+    f64 start = BenchmarkNow();
+    u32* array = Darray_Create(u32);
+    for (u64 i = 0; i < DARRAY_PUSH_BENCHMARK_ELEMENTS; i++)
+        Darray_Push(array, (u32)i);
+    BenchmarkReport("Darray push, growing by copying", DARRAY_PUSH_BENCHMARK_ELEMENTS, BenchmarkNow() - start);
+    sum += array[DARRAY_PUSH_BENCHMARK_ELEMENTS / 2];
+    Darray_Destroy(array);
+
+    start = BenchmarkNow();
+    array = Darray_CreateStable(u32, DARRAY_PUSH_BENCHMARK_ELEMENTS);
+    for (u64 i = 0; i < DARRAY_PUSH_BENCHMARK_ELEMENTS; i++)
+        Darray_Push(array, (u32)i);
+    BenchmarkReport("Stable darray push, committing pages", DARRAY_PUSH_BENCHMARK_ELEMENTS, BenchmarkNow() - start);
+    sum += array[DARRAY_PUSH_BENCHMARK_ELEMENTS / 2];
+    Darray_Destroy(array);
+
+    BenchmarkKeep(sum);
+}
+
+// The short-lived lists of the renderer, such as the extensions or layers asked of Vulkan.
+static void DarrayTypicalUseBenchmark()
+{
+    const char* extensions[6] = {"VK_KHR_surface", "VK_KHR_xcb_surface", "VK_EXT_debug_utils",
+                                 "VK_KHR_swapchain", "VK_KHR_maintenance1", "VK_KHR_dynamic_rendering"};
+    u64 sum = 0;
+
+    f64 start = BenchmarkNow();
+    for (u32 r = 0; r < DARRAY_BULK_BENCHMARK_ROUNDS * 10; r++) {
+        const char** names = Darray_Create(const char*);
+        for (u32 i = 0; i < 6; i++)
+            Darray_Push(names, extensions[i]);
+        sum += Darray_Length(names) + (u64)names[r % 6];
+        Darray_Destroy(names);
+    }
+    BenchmarkReport("6 names: Darray create, push, destroy", DARRAY_BULK_BENCHMARK_ROUNDS * 10, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 r = 0; r < DARRAY_BULK_BENCHMARK_ROUNDS * 10; r++) {
+        const char** names = Darray_Reserve(const char*, 6);
+        Darray_PushMany(names, extensions, 6);
+        sum += Darray_Length(names) + (u64)names[r % 6];
+        Darray_Destroy(names);
+    }
+    BenchmarkReport("6 names: Darray reserve, push many, destroy", DARRAY_BULK_BENCHMARK_ROUNDS * 10, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 r = 0; r < DARRAY_BULK_BENCHMARK_ROUNDS * 10; r++) {
+        SmallArray(const char*, 8) names;
+        SmallArray_Init(names);
+        for (u32 i = 0; i < 6; i++)
+            SmallArray_Push(names, extensions[i]);
+        sum += names.Length + (u64)names.Data[r % 6];
+        SmallArray_Destroy(names);
+    }
+    BenchmarkReport("6 names: SmallArray init, push, destroy", DARRAY_BULK_BENCHMARK_ROUNDS * 10, BenchmarkNow() - start);
+
+    // Appending and inserting batches, and removing from the front, of a 1000 element array.
+    u32 batch[100];
+    for (u32 i = 0; i < 100; i++)
+        batch[i] = i;
+    u32* array = Darray_Reserve(u32, 2000);
+
+    start = BenchmarkNow();
+    for (u32 r = 0; r < DARRAY_BULK_BENCHMARK_ROUNDS; r++) {
+        Darray_Clear(array);
+        for (u32 b = 0; b < 10; b++) {
+            for (u32 i = 0; i < 100; i++)
+                Darray_Push(array, batch[i]);
+        }
+    }
+    BenchmarkReport("1000 elements: push one at a time", DARRAY_BULK_BENCHMARK_ROUNDS * 1000ull, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 r = 0; r < DARRAY_BULK_BENCHMARK_ROUNDS; r++) {
+        Darray_Clear(array);
+        for (u32 b = 0; b < 10; b++)
+            Darray_PushMany(array, batch, 100);
+    }
+    BenchmarkReport("1000 elements: push many, 100 at a time", DARRAY_BULK_BENCHMARK_ROUNDS * 1000ull, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 r = 0; r < DARRAY_BULK_BENCHMARK_ROUNDS / 10; r++) {
+        Darray_Resize(array, 1000);
+        for (u32 i = 0; i < 100; i++)
+            Darray_InsertAt(array, 0, batch[i]);
+    }
+    BenchmarkReport("1000 elements: insert 100 at the front one by one", DARRAY_BULK_BENCHMARK_ROUNDS / 10 * 100ull, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 r = 0; r < DARRAY_BULK_BENCHMARK_ROUNDS / 10; r++) {
+        Darray_Resize(array, 1000);
+        Darray_InsertMany(array, 0, batch, 100);
+    }
+    BenchmarkReport("1000 elements: insert many, 100 at the front", DARRAY_BULK_BENCHMARK_ROUNDS / 10 * 100ull, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 r = 0; r < DARRAY_BULK_BENCHMARK_ROUNDS / 10; r++) {
+        Darray_Resize(array, 1000);
+        for (u32 i = 0; i < 100; i++)
+            array = Darray_PopAt(array, 0, 0);
+    }
+    BenchmarkReport("1000 elements: remove from the front", DARRAY_BULK_BENCHMARK_ROUNDS / 10 * 100ull, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 r = 0; r < DARRAY_BULK_BENCHMARK_ROUNDS / 10; r++) {
+        Darray_Resize(array, 1000);
+        for (u32 i = 0; i < 100; i++)
+            array = Darray_PopSwap(array, 0, 0);
+    }
+    BenchmarkReport("1000 elements: swap-remove from the front", DARRAY_BULK_BENCHMARK_ROUNDS / 10 * 100ull, BenchmarkNow() - start);
+
+    sum += array[0];
+    Darray_Destroy(array);
+    BenchmarkKeep(sum);
+}
+
+void RegisterDarrayTests()
+{
+    TestRegister("Darray: stable arrays grow in place up to their maximum", DarrayStableGrowth);
+    TestRegister("Darray: bulk push, insert, remove, resize and shrink", DarrayBulkOperations);
+    TestRegister("SmallArray: inline storage, then spilling to the heap", SmallArrayInlineAndSpill);
+
+    BenchmarkRegister("Darray: 100M element push loop", DarrayPushBenchmark);
+    BenchmarkRegister("Darray: short lists and bulk operations", DarrayTypicalUseBenchmark);
+}
@@ -0,0 +1,334 @@
+#include "../Test.h"
+
+#include <Containers/HashTable.h>
+#include <Core/MemTracker.h>
+#include <Platform/Platform.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ELSA_HASHTABLE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#define HASHTABLE_TEST_KEYS 100000
+#define HASHTABLE_KEY_LENGTH 32
+
+typedef struct HashTableKeys {
+    char Hits[HASHTABLE_TEST_KEYS][HASHTABLE_KEY_LENGTH];
+    char Misses[HASHTABLE_TEST_KEYS][HASHTABLE_KEY_LENGTH];
+} HashTableKeys;
+
+// Names shaped like the asset and shader names the tables hold.
+static HashTableKeys* HashTableKeysCreate()
+{
+    HashTableKeys* keys = MemoryTrackerAlloc(sizeof(HashTableKeys), MEMORY_TAG_APP);
+    for (u32 i = 0; i < HASHTABLE_TEST_KEYS; i++) {
+        snprintf(keys->Hits[i], HASHTABLE_KEY_LENGTH, "Textures/Asset_%u.png", i);
+        snprintf(keys->Misses[i], HASHTABLE_KEY_LENGTH, "Shaders/Missing_%u.spv", i);
+    }
+    return keys;
+}
+
+static void HashTableKeysDestroy(HashTableKeys* keys)
+{
+    MemoryTrackerFree(keys, sizeof(HashTableKeys), MEMORY_TAG_APP);
+}
+
+static void HashTableSetGetRemove()
+{
+    HashTableKeys* keys = HashTableKeysCreate();
+    HashTable table;
+    TEST_EXPECT(HashTableCreate(sizeof(u64), 1, false, &table));
+    TEST_EXPECT(table.Capacity == HASHTABLE_MIN_CAPACITY);
+
+    // Every key keeps its own value through the growth of the table.
+    for (u64 i = 0; i < HASHTABLE_TEST_KEYS; i++) {
+        u64 value = i * 3;
+        TEST_EXPECT(HashTableSet(&table, keys->Hits[i], (void**)&value));
+    }
+    TEST_EXPECT(table.Count == HASHTABLE_TEST_KEYS);
+    TEST_EXPECT((u64)table.Count * 100 <= (u64)table.Capacity * HASHTABLE_MAX_LOAD_PERCENT);
+
+    u32 wrong = 0;
+    for (u64 i = 0; i < HASHTABLE_TEST_KEYS; i++) {
+        u64 value = 0;
+        wrong += !HashTableGet(&table, keys->Hits[i], &value) || value != i * 3;
+        wrong += HashTableGet(&table, keys->Misses[i], &value);
+    }
+    TEST_EXPECT(wrong == 0);
+
+    // Setting an existing key replaces its value.
+    u64 value = 42;
+    TEST_EXPECT(HashTableSet(&table, keys->Hits[7], (void**)&value));
+    TEST_EXPECT(table.Count == HASHTABLE_TEST_KEYS);
+    TEST_EXPECT(HashTableGet(&table, keys->Hits[7], &value) && value == 42);
+    value = 7 * 3;
+    HashTableSet(&table, keys->Hits[7], (void**)&value);
+
+    // Removing every other key leaves the rest reachable, without tombstones.
+    for (u32 i = 0; i < HASHTABLE_TEST_KEYS; i += 2)
+        TEST_EXPECT(HashTableRemove(&table, keys->Hits[i]));
+    TEST_EXPECT(!HashTableRemove(&table, keys->Hits[0]));
+    TEST_EXPECT(table.Count == HASHTABLE_TEST_KEYS / 2);
+    wrong = 0;
+    for (u64 i = 0; i < HASHTABLE_TEST_KEYS; i++) {
+        b8 found = HashTableGet(&table, keys->Hits[i], &value);
+        wrong += found != (i & 1);
+    }
+    TEST_EXPECT(wrong == 0);
+
+    // Iteration visits each remaining entry once.
+    u32 iterator = 0;
+    u32 visited = 0;
+    const char* name = 0;
+    void* entry = 0;
+    while (HashTableIterate(&table, &iterator, &name, &entry)) {
+        u64 index = *(u64*)entry / 3;
+        visited++;
+        wrong += (index & 1) == 0 || strcmp(name, keys->Hits[index]) != 0;
+    }
+    TEST_EXPECT(visited == HASHTABLE_TEST_KEYS / 2);
+    TEST_EXPECT(wrong == 0);
+
+    // The fill value is returned for missing keys.
+    u64 fill = 0xFFFF;
+    TEST_EXPECT(HashTableFill(&table, &fill));
+    value = 0;
+    TEST_EXPECT(!HashTableGet(&table, keys->Misses[0], &value) && value == 0xFFFF);
+
+    HashTableDestroy(&table);
+    HashTableKeysDestroy(keys);
+}
+
+static void HashTablePointers()
+{
+    HashTable table;
+    TEST_EXPECT(HashTableCreate(sizeof(void*), 4, true, &table));
+
+    u32 objects[3];
+    void* pointer = &objects[0];
+    TEST_EXPECT(HashTableSetPointer(&table, "first", &pointer));
+    pointer = &objects[1];
+    TEST_EXPECT(HashTableSetPointerHashed(&table, HASHED_STRING("second"), &pointer));
+
+    TEST_EXPECT(HashTableGetPointer(&table, "second", &pointer) && pointer == &objects[1]);
+    TEST_EXPECT(HashTableGetPointerHashed(&table, HASHED_STRING("first"), &pointer) && pointer == &objects[0]);
+    TEST_EXPECT(!HashTableGetPointer(&table, "third", &pointer) && pointer == 0);
+
+    // Setting a null pointer removes the entry.
+    pointer = 0;
+    TEST_EXPECT(HashTableSetPointer(&table, "first", &pointer));
+    TEST_EXPECT(!HashTableGetPointer(&table, "first", &pointer));
+    TEST_EXPECT(table.Count == 1);
+
+    HashTableDestroy(&table);
+}
+
+// The hashtable before open addressing, which indexed by the hash alone, so that colliding
+// names shared a slot. Kept here as the baseline of the benchmarks.
+typedef struct LegacyHashTable {
+    u64 ElementSize;
+    u32 ElementCount;
+    void* Memory;
+} LegacyHashTable;
+
+static u64 LegacyHashName(const char* name, u32 element_count)
+{
+    static const u64 multiplier = 97;
+
+    unsigned const char* us;
+    u64 hash = 0;
+    for (us = (unsigned const char*)name; *us; us++)
+        hash = hash * multiplier + *us;
+
+    hash %= element_count;
+    return hash;
+}
+
+static void LegacyHashTableSet(LegacyHashTable* table, const char* name, void* value)
+{
+    u64 hash = LegacyHashName(name, table->ElementCount);
+    PlatformCopyMemory((u8*)table->Memory + (table->ElementSize * hash), value, table->ElementSize);
+}
+
+static void LegacyHashTableGet(LegacyHashTable* table, const char* name, void* out_value)
+{
+    u64 hash = LegacyHashName(name, table->ElementCount);
+    PlatformCopyMemory(out_value, (u8*)table->Memory + (table->ElementSize * hash), table->ElementSize);
+}
+
+static void HashTableBenchmark()
+{
+    HashTableKeys* keys = HashTableKeysCreate();
+    u64 sum = 0;
+
+    HashTable table;
+    HashTableCreate(sizeof(u64), 1, false, &table);
+    f64 start = BenchmarkNow();
+    for (u64 i = 0; i < HASHTABLE_TEST_KEYS; i++)
+        HashTableSet(&table, keys->Hits[i], (void**)&i);
+    BenchmarkReport("HashTable insert, growing from empty", HASHTABLE_TEST_KEYS, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 i = 0; i < HASHTABLE_TEST_KEYS; i++) {
+        u64 value;
+        HashTableGet(&table, keys->Hits[i], &value);
+        sum += value;
+    }
+    BenchmarkReport("HashTable lookup hit", HASHTABLE_TEST_KEYS, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 i = 0; i < HASHTABLE_TEST_KEYS; i++) {
+        u64 value;
+        sum += HashTableGet(&table, keys->Misses[i], &value);
+    }
+    BenchmarkReport("HashTable lookup miss", HASHTABLE_TEST_KEYS, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 i = 0; i < HASHTABLE_TEST_KEYS; i++)
+        sum += HashTableRemove(&table, keys->Hits[i]);
+    BenchmarkReport("HashTable delete", HASHTABLE_TEST_KEYS, BenchmarkNow() - start);
+    HashTableDestroy(&table);
+
+    // Sized up front like its callers did, as it can't grow. It can't tell a miss from
+    // a hit, nor delete, and colliding names overwrite each other.
+    LegacyHashTable legacy = {sizeof(u64), HASHTABLE_TEST_KEYS * 2, 0};
+    legacy.Memory = MemoryTrackerAlloc(legacy.ElementSize * legacy.ElementCount, MEMORY_TAG_HASHTABLE);
+    start = BenchmarkNow();
+    for (u64 i = 0; i < HASHTABLE_TEST_KEYS; i++)
+        LegacyHashTableSet(&legacy, keys->Hits[i], &i);
+    BenchmarkReport("Legacy insert, presized", HASHTABLE_TEST_KEYS, BenchmarkNow() - start);
+
+    u32 aliased = 0;
+    start = BenchmarkNow();
+    for (u64 i = 0; i < HASHTABLE_TEST_KEYS; i++) {
+        u64 value;
+        LegacyHashTableGet(&legacy, keys->Hits[i], &value);
+        aliased += value != i;
+        sum += value;
+    }
+    BenchmarkReport("Legacy lookup hit", HASHTABLE_TEST_KEYS, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 i = 0; i < HASHTABLE_TEST_KEYS; i++) {
+        u64 value;
+        LegacyHashTableGet(&legacy, keys->Misses[i], &value);
+        sum += value;
+    }
+    BenchmarkReport("Legacy lookup miss, returning another entry", HASHTABLE_TEST_KEYS, BenchmarkNow() - start);
+    printf("    Legacy lookups returning the value of another name: %u of %u\n", aliased, HASHTABLE_TEST_KEYS);
+    MemoryTrackerFree(legacy.Memory, legacy.ElementSize * legacy.ElementCount, MEMORY_TAG_HASHTABLE);
+
+    BenchmarkKeep(sum);
+    HashTableKeysDestroy(keys);
+}
+
+// The two probe loops of HashTableFind, of which the library only builds one. They
+// walk the same table, so that the benchmark compares nothing but the probing.
+static i64 ProbeScalar(HashTable* table, const char* name, u64 hash)
+{
+    u64 mask = table->Capacity - 1;
+    u64 index = hash & mask;
+    u8 control = (u8)(hash >> 57);
+    for (;;) {
+        u8 slot_control = table->Control[index];
+        if (slot_control == HASHTABLE_CONTROL_EMPTY)
+            return -1;
+        if (slot_control == control && table->Hashes[index] == hash && strcmp(table->Keys[index], name) == 0)
+            return (i64)index;
+        index = (index + 1) & mask;
+    }
+}
+
+#ifdef ELSA_HASHTABLE_USE_SSE2
+static i64 ProbeGroup(HashTable* table, const char* name, u64 hash)
+{
+    u64 mask = table->Capacity - 1;
+    u64 index = hash & mask;
+    __m128i control = _mm_set1_epi8((char)(u8)(hash >> 57));
+    __m128i empty = _mm_set1_epi8((char)HASHTABLE_CONTROL_EMPTY);
+    for (;;) {
+        __m128i group = _mm_loadu_si128((const __m128i*)(table->Control + index));
+        u32 matches = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, control));
+        u32 empties = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, empty));
+        if (empties)
+            matches &= (empties & (0 - empties)) - 1;
+
+        while (matches) {
+            u64 slot = (index + __builtin_ctz(matches)) & mask;
+            if (table->Hashes[slot] == hash && strcmp(table->Keys[slot], name) == 0)
+                return (i64)slot;
+            matches &= matches - 1;
+        }
+
+        if (empties)
+            return -1;
+        index = (index + HASHTABLE_GROUP_WIDTH) & mask;
+    }
+}
+#endif
+
+typedef i64 (*PFN_Probe)(HashTable* table, const char* name, u64 hash);
+
+static void ProbeBenchmarkRun(const char* probe_name, PFN_Probe probe, HashTable* table, HashTableKeys* keys, HashedString* hits, u32 key_count)
+{
+    const u32 rounds = HASHTABLE_TEST_KEYS * 4 / key_count;
+    char name[80];
+    u64 sum = 0;
+
+    f64 start = BenchmarkNow();
+    for (u32 r = 0; r < rounds; r++) {
+        for (u32 i = 0; i < key_count; i++)
+            sum += probe(table, hits[i].String, hits[i].Hash);
+    }
+    snprintf(name, sizeof(name), "%s, %u slots, hit", probe_name, table->Capacity);
+    BenchmarkReport(name, (u64)rounds * key_count, BenchmarkNow() - start);
+
+    // Misses walk the whole probe sequence, which is where comparing groups pays off.
+    start = BenchmarkNow();
+    for (u32 r = 0; r < rounds; r++) {
+        for (u32 i = 0; i < key_count; i++)
+            sum += probe(table, keys->Misses[i], hits[key_count - 1 - i].Hash ^ 0x5bd1e995);
+    }
+    snprintf(name, sizeof(name), "%s, %u slots, miss", probe_name, table->Capacity);
+    BenchmarkReport(name, (u64)rounds * key_count, BenchmarkNow() - start);
+
+    BenchmarkKeep(sum);
+}
+
+// Probes tables filled right up to the maximum load factor, with precomputed hashes.
+static void HashTableProbeBenchmark()
+{
+    HashTableKeys* keys = HashTableKeysCreate();
+    HashedString* hits = MemoryTrackerAlloc(sizeof(HashedString) * HASHTABLE_TEST_KEYS, MEMORY_TAG_APP);
+    for (u32 i = 0; i < HASHTABLE_TEST_KEYS; i++)
+        hits[i] = HashedStringCreate(keys->Hits[i]);
+
+    u32 capacities[] = {4096, 131072};
+    for (u32 c = 0; c < 2; c++) {
+        u32 key_count = capacities[c] / 100 * HASHTABLE_MAX_LOAD_PERCENT;
+        HashTable table;
+        HashTableCreate(sizeof(u64), 1, false, &table);
+        for (u64 i = 0; i < key_count; i++)
+            HashTableSetHashed(&table, hits[i], (void**)&i);
+
+        ProbeBenchmarkRun("Scalar probe", ProbeScalar, &table, keys, hits, key_count);
+#ifdef ELSA_HASHTABLE_USE_SSE2
+        ProbeBenchmarkRun("SSE2 group probe", ProbeGroup, &table, keys, hits, key_count);
+#endif
+        HashTableDestroy(&table);
+    }
+
+    MemoryTrackerFree(hits, sizeof(HashedString) * HASHTABLE_TEST_KEYS, MEMORY_TAG_APP);
+    HashTableKeysDestroy(keys);
+}
+
+void RegisterHashTableTests()
+{
+    TestRegister("HashTable: set, get, remove and iterate through growth", HashTableSetGetRemove);
+    TestRegister("HashTable: pointer tables", HashTablePointers);
+
+    BenchmarkRegister("HashTable: insert, hit, miss and delete against the legacy table", HashTableBenchmark);
+    BenchmarkRegister("HashTable: SSE2 group probe against the scalar probe", HashTableProbeBenchmark);
+}
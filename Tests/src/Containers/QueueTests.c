@@ -0,0 +1,305 @@
+#include "../Test.h"
+
+#include <Containers/MpmcQueue.h>
+#include <Containers/SpscQueue.h>
+#include <Core/Atomic.h>
+#include <Core/MemTracker.h>
+#include <Platform/Platform.h>
+
+#include <stdio.h>
+
+#define QUEUE_STRESS_ELEMENTS 200000
+#define QUEUE_STRESS_PRODUCERS 4
+#define QUEUE_STRESS_CONSUMERS 4
+#define QUEUE_STRESS_PER_PRODUCER (QUEUE_STRESS_ELEMENTS / QUEUE_STRESS_PRODUCERS)
+#define QUEUE_BATCH 16
+
+static void SpscQueueSequential()
+{
+    SpscQueue queue;
+    TEST_EXPECT(SpscQueueCreate(sizeof(u32), 5, &queue));
+    TEST_EXPECT(queue.Capacity == 8);
+
+    for (u32 i = 0; i < 8; i++)
+        TEST_EXPECT(SpscQueuePush(&queue, &i));
+    u32 value = 8;
+    TEST_EXPECT(!SpscQueuePush(&queue, &value));
+    TEST_EXPECT(SpscQueueCount(&queue) == 8);
+
+    TEST_EXPECT(SpscQueuePop(&queue, &value) && value == 0);
+    u32 values[8];
+    TEST_EXPECT(SpscQueuePopMany(&queue, values, 3) == 3);
+    TEST_EXPECT(values[0] == 1 && values[1] == 2 && values[2] == 3);
+
+    // Only four cells are free, and the writes wrap around the end of the buffer.
+    u32 more[6] = {8, 9, 10, 11, 12, 13};
+    TEST_EXPECT(SpscQueuePushMany(&queue, more, 6) == 4);
+    TEST_EXPECT(SpscQueuePopMany(&queue, values, 8) == 8);
+    b8 in_order = true;
+    for (u32 i = 0; i < 8; i++)
+        in_order = in_order && values[i] == i + 4;
+    TEST_EXPECT(in_order);
+    TEST_EXPECT(!SpscQueuePop(&queue, &value));
+
+    SpscQueueDestroy(&queue);
+}
+
+static void MpmcQueueSequential()
+{
+    MpmcQueue queue;
+    TEST_EXPECT(MpmcQueueCreate(sizeof(u64), 3, &queue));
+    TEST_EXPECT(queue.Capacity == 4);
+
+    u64 values[6] = {10, 11, 12, 13, 14, 15};
+    TEST_EXPECT(MpmcQueuePushMany(&queue, values, 6) == 4);
+    TEST_EXPECT(!MpmcQueuePush(&queue, &values[4]));
+    TEST_EXPECT(MpmcQueueCount(&queue) == 4);
+
+    u64 value = 0;
+    TEST_EXPECT(MpmcQueuePop(&queue, &value) && value == 10);
+    TEST_EXPECT(MpmcQueuePush(&queue, &values[4]));
+    u64 popped[6];
+    TEST_EXPECT(MpmcQueuePopMany(&queue, popped, 6) == 4);
+    TEST_EXPECT(popped[0] == 11 && popped[1] == 12 && popped[2] == 13 && popped[3] == 14);
+    TEST_EXPECT(!MpmcQueuePop(&queue, &value));
+
+    MpmcQueueDestroy(&queue);
+}
+
+typedef struct SpscStress {
+    SpscQueue Queue;
+    u32 OrderErrors;
+} SpscStress;
+
+// The producer alternates single and batched pushes, and the consumer single and batched pops.
+static void SpscStressThread(u32 index, void* data)
+{
+    SpscStress* stress = data;
+    u64 values[QUEUE_BATCH];
+
+    if (index == 0) {
+        u64 next = 1;
+        while (next <= QUEUE_STRESS_ELEMENTS) {
+            u64 count = 1 + next % QUEUE_BATCH;
+            if (next + count > QUEUE_STRESS_ELEMENTS + 1)
+                count = QUEUE_STRESS_ELEMENTS + 1 - next;
+            for (u64 i = 0; i < count; i++)
+                values[i] = next + i;
+
+            u64 pushed = count == 1 ? SpscQueuePush(&stress->Queue, values) : SpscQueuePushMany(&stress->Queue, values, count);
+            next += pushed;
+            if (!pushed)
+                PlatformSleep(0);
+        }
+        return;
+    }
+
+    u64 expected = 1;
+    while (expected <= QUEUE_STRESS_ELEMENTS) {
+        u64 popped = expected & 1 ? SpscQueuePop(&stress->Queue, values) : SpscQueuePopMany(&stress->Queue, values, QUEUE_BATCH);
+        for (u64 i = 0; i < popped; i++)
+            stress->OrderErrors += values[i] != expected++;
+        if (!popped)
+            PlatformSleep(0);
+    }
+}
+
+// Every element arrives once, in the order it was pushed.
+static void SpscQueueStress()
+{
+    SpscStress stress = {0};
+    TEST_EXPECT(SpscQueueCreate(sizeof(u64), 64, &stress.Queue));
+    TestRunThreads(2, SpscStressThread, &stress);
+    TEST_EXPECT(stress.OrderErrors == 0);
+    TEST_EXPECT(SpscQueueCount(&stress.Queue) == 0);
+    SpscQueueDestroy(&stress.Queue);
+}
+
+typedef struct MpmcStress {
+    MpmcQueue Queue;
+    u32 Popped;
+    u32 OrderErrors;
+    u8 Taken[QUEUE_STRESS_ELEMENTS];
+} MpmcStress;
+
+// Producers push their index in the upper half of a value, and a sequence number in the lower.
+static void MpmcStressThread(u32 index, void* data)
+{
+    MpmcStress* stress = data;
+    u64 values[QUEUE_BATCH];
+
+    if (index < QUEUE_STRESS_PRODUCERS) {
+        u64 next = 0;
+        while (next < QUEUE_STRESS_PER_PRODUCER) {
+            u64 count = 1 + (next + index) % QUEUE_BATCH;
+            if (next + count > QUEUE_STRESS_PER_PRODUCER)
+                count = QUEUE_STRESS_PER_PRODUCER - next;
+            for (u64 i = 0; i < count; i++)
+                values[i] = ((u64)index << 32) | (next + i);
+
+            u64 pushed = count == 1 ? MpmcQueuePush(&stress->Queue, values) : MpmcQueuePushMany(&stress->Queue, values, count);
+            next += pushed;
+            if (!pushed)
+                PlatformSleep(0);
+        }
+        return;
+    }
+
+    // A consumer sees the values of each producer in the order they were pushed.
+    u64 last[QUEUE_STRESS_PRODUCERS];
+    for (u32 i = 0; i < QUEUE_STRESS_PRODUCERS; i++)
+        last[i] = (u64)-1;
+
+    while (AtomicLoad(&stress->Popped, ATOMIC_RELAXED) < QUEUE_STRESS_ELEMENTS) {
+        u64 popped = index & 1 ? MpmcQueuePop(&stress->Queue, values) : MpmcQueuePopMany(&stress->Queue, values, QUEUE_BATCH);
+        for (u64 i = 0; i < popped; i++) {
+            u32 producer = (u32)(values[i] >> 32);
+            u32 sequence = (u32)values[i];
+            if (producer >= QUEUE_STRESS_PRODUCERS || sequence >= QUEUE_STRESS_PER_PRODUCER) {
+                AtomicFetchAdd(&stress->OrderErrors, 1, ATOMIC_RELAXED);
+                continue;
+            }
+            if (last[producer] != (u64)-1 && sequence <= last[producer])
+                AtomicFetchAdd(&stress->OrderErrors, 1, ATOMIC_RELAXED);
+            last[producer] = sequence;
+            AtomicFetchAdd(&stress->Taken[producer * QUEUE_STRESS_PER_PRODUCER + sequence], 1, ATOMIC_RELAXED);
+        }
+        if (popped)
+            AtomicFetchAdd(&stress->Popped, (u32)popped, ATOMIC_RELAXED);
+        else
+            PlatformSleep(0);
+    }
+}
+
+// Every element arrives exactly once, with producers and consumers racing on a small queue.
+static void MpmcQueueStress()
+{
+    MpmcStress* stress = MemoryTrackerAlloc(sizeof(MpmcStress), MEMORY_TAG_QUEUE);
+    TEST_EXPECT(MpmcQueueCreate(sizeof(u64), 64, &stress->Queue));
+    TestRunThreads(QUEUE_STRESS_PRODUCERS + QUEUE_STRESS_CONSUMERS, MpmcStressThread, stress);
+
+    u32 wrong = 0;
+    for (u32 i = 0; i < QUEUE_STRESS_ELEMENTS; i++)
+        wrong += stress->Taken[i] != 1;
+    TEST_EXPECT(wrong == 0);
+    TEST_EXPECT(stress->OrderErrors == 0);
+    TEST_EXPECT(stress->Popped == QUEUE_STRESS_ELEMENTS);
+    TEST_EXPECT(MpmcQueueCount(&stress->Queue) == 0);
+
+    MpmcQueueDestroy(&stress->Queue);
+    MemoryTrackerFree(stress, sizeof(MpmcStress), MEMORY_TAG_QUEUE);
+}
+
+typedef struct QueueBenchmark {
+    SpscQueue Spsc;
+    MpmcQueue Mpmc;
+    u32 Producers;
+    u32 PerProducer;
+    u32 Batch;
+    u32 Popped;
+    u64 Sum;
+} QueueBenchmark;
+
+static void SpscBenchmarkThread(u32 index, void* data)
+{
+    QueueBenchmark* bench = data;
+    u64 values[QUEUE_BATCH] = {0};
+    u64 sum = 0;
+
+    if (index == 0) {
+        for (u64 pushed = 0; pushed < bench->PerProducer;) {
+            u64 count = bench->Batch;
+            u64 done = count == 1 ? SpscQueuePush(&bench->Spsc, &pushed) : SpscQueuePushMany(&bench->Spsc, values, count);
+            pushed += done;
+            if (!done)
+                PlatformSleep(0);
+        }
+        return;
+    }
+
+    for (u64 popped = 0; popped < bench->PerProducer;) {
+        u64 done = bench->Batch == 1 ? SpscQueuePop(&bench->Spsc, values) : SpscQueuePopMany(&bench->Spsc, values, bench->Batch);
+        popped += done;
+        sum += values[0];
+        if (!done)
+            PlatformSleep(0);
+    }
+    bench->Sum = sum;
+}
+
+static void MpmcBenchmarkThread(u32 index, void* data)
+{
+    QueueBenchmark* bench = data;
+    u64 values[QUEUE_BATCH] = {0};
+    u64 total = (u64)bench->Producers * bench->PerProducer;
+
+    if (index < bench->Producers) {
+        for (u64 pushed = 0; pushed < bench->PerProducer;) {
+            u64 done = bench->Batch == 1 ? MpmcQueuePush(&bench->Mpmc, values) : MpmcQueuePushMany(&bench->Mpmc, values, bench->Batch);
+            pushed += done;
+            if (!done)
+                PlatformSleep(0);
+        }
+        return;
+    }
+
+    while (AtomicLoad(&bench->Popped, ATOMIC_RELAXED) < total) {
+        u64 done = bench->Batch == 1 ? MpmcQueuePop(&bench->Mpmc, values) : MpmcQueuePopMany(&bench->Mpmc, values, bench->Batch);
+        if (done)
+            AtomicFetchAdd(&bench->Popped, (u32)done, ATOMIC_RELAXED);
+        else
+            PlatformSleep(0);
+    }
+}
+
+// One producer and one consumer, then from one up to N threads on each side of the MPMC queue.
+static void QueueThroughputBenchmark()
+{
+    const u32 elements = 4000000;
+    u32 processors = PlatformGetProcessorCount();
+    QueueBenchmark* bench = MemoryTrackerAlloc(sizeof(QueueBenchmark), MEMORY_TAG_QUEUE);
+    SpscQueueCreate(sizeof(u64), 1024, &bench->Spsc);
+    MpmcQueueCreate(sizeof(u64), 1024, &bench->Mpmc);
+    char name[64];
+
+    u32 batches[] = {1, QUEUE_BATCH};
+    for (u32 b = 0; b < 2; b++) {
+        bench->Batch = batches[b];
+        bench->PerProducer = elements;
+        f64 start = BenchmarkNow();
+        TestRunThreads(2, SpscBenchmarkThread, bench);
+        snprintf(name, sizeof(name), "SPSC, batches of %u", bench->Batch);
+        BenchmarkReport(name, elements, BenchmarkNow() - start);
+        BenchmarkKeep(bench->Sum);
+    }
+
+    for (u32 b = 0; b < 2; b++) {
+        bench->Batch = batches[b];
+        for (u32 threads = 1;; threads = threads * 2 < processors ? threads * 2 : processors) {
+            bench->Producers = threads;
+            // Whole batches, so that producers finish on the element count.
+            bench->PerProducer = elements / threads / QUEUE_BATCH * QUEUE_BATCH;
+            bench->Popped = 0;
+            f64 start = BenchmarkNow();
+            TestRunThreads(threads * 2, MpmcBenchmarkThread, bench);
+            snprintf(name, sizeof(name), "MPMC, %u x %u threads, batches of %u", threads, threads, bench->Batch);
+            BenchmarkReport(name, (u64)threads * bench->PerProducer, BenchmarkNow() - start);
+            if (threads >= processors)
+                break;
+        }
+    }
+
+    MpmcQueueDestroy(&bench->Mpmc);
+    SpscQueueDestroy(&bench->Spsc);
+    MemoryTrackerFree(bench, sizeof(QueueBenchmark), MEMORY_TAG_QUEUE);
+}
+
+void RegisterQueueTests()
+{
+    TestRegister("SpscQueue: sequential push and pop, single and batched", SpscQueueSequential);
+    TestRegister("MpmcQueue: sequential push and pop, single and batched", MpmcQueueSequential);
+    TestRegister("SpscQueue: producer and consumer threads, in order", SpscQueueStress);
+    TestRegister("MpmcQueue: 4 producers and 4 consumers, each element once", MpmcQueueStress);
+
+    BenchmarkRegister("Queues: throughput from 1 to N threads", QueueThroughputBenchmark);
+}
@@ -0,0 +1,211 @@
+#include "../Test.h"
+
+#include <Containers/SlotMap.h>
+#include <Platform/Platform.h>
+
+#define SLOT_MAP_BENCH_OBJECTS 100000
+#define SLOT_MAP_BENCH_PASSES 200
+#define SLOT_MAP_BENCH_LOOKUPS 20000000
+
+// About the size of a frontend object, such as a buffer description.
+typedef struct SlotMapTestObject {
+    u64 Key;
+    u32 Size;
+    u32 Flags;
+    u8 Data[48];
+} SlotMapTestObject;
+
+static u32 SlotMapTestRandom(u32* state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static void SlotMapInsertAndRemove()
+{
+    SlotMap map;
+    TEST_EXPECT(SlotMap_Create(SlotMapTestObject, 0, &map));
+    TEST_EXPECT(SlotMapCount(&map) == 0);
+    TEST_EXPECT(SlotMapGet(&map, SLOT_HANDLE_INVALID) == 0);
+
+    SlotHandle handles[40];
+    for (u32 i = 0; i < 40; i++) {
+        SlotMapTestObject object = {0};
+        object.Key = i;
+        handles[i] = SlotMapInsert(&map, &object);
+        TEST_EXPECT(handles[i] != SLOT_HANDLE_INVALID);
+    }
+    TEST_EXPECT(SlotMapCount(&map) == 40);
+
+    // Removing every third element moves others into the holes, but handles keep finding them.
+    u32 removed = 0;
+    for (u32 i = 0; i < 40; i += 3) {
+        TEST_EXPECT(SlotMapRemove(&map, handles[i]));
+        removed++;
+    }
+    TEST_EXPECT(SlotMapCount(&map) == 40 - removed);
+    b8 found = true;
+    for (u32 i = 0; i < 40; i++) {
+        SlotMapTestObject* object = SlotMap_Get(&map, SlotMapTestObject, handles[i]);
+        found = found && (i % 3 == 0 ? object == 0 : object && object->Key == i);
+    }
+    TEST_EXPECT(found);
+
+    // Inserting without a value gives a zeroed element.
+    SlotHandle zeroed = SlotMapInsert(&map, 0);
+    SlotMapTestObject* object = SlotMap_Get(&map, SlotMapTestObject, zeroed);
+    TEST_EXPECT(object && object->Key == 0 && object->Size == 0);
+
+    SlotMapDestroy(&map);
+    TEST_EXPECT(map.Data == 0);
+}
+
+// A handle to a removed element misses, even after its slot is reused.
+static void SlotMapStaleHandles()
+{
+    SlotMap map;
+    TEST_EXPECT(SlotMap_Create(SlotMapTestObject, 4, &map));
+
+    SlotMapTestObject object = {0};
+    object.Key = 1;
+    SlotHandle first = SlotMapInsert(&map, &object);
+    TEST_EXPECT(SlotMapRemove(&map, first));
+    TEST_EXPECT(!SlotMapRemove(&map, first));
+    TEST_EXPECT(SlotMapGet(&map, first) == 0);
+
+    object.Key = 2;
+    SlotHandle second = SlotMapInsert(&map, &object);
+    TEST_EXPECT((u32)second == (u32)first);
+    TEST_EXPECT((second >> 32) != (first >> 32));
+    TEST_EXPECT(SlotMapGet(&map, first) == 0);
+    TEST_EXPECT(!SlotMapRemove(&map, first));
+    TEST_EXPECT(SlotMap_Get(&map, SlotMapTestObject, second)->Key == 2);
+
+    // Handles with a free slot's generation, or past the last slot, miss as well.
+    TEST_EXPECT(SlotMapGet(&map, second + (1ull << 32)) == 0);
+    TEST_EXPECT(SlotMapGet(&map, second + 100) == 0);
+
+    SlotMapDestroy(&map);
+}
+
+// Data holds exactly the live elements, and HandleAt maps each back to its handle.
+static void SlotMapDenseIteration()
+{
+    SlotMap map;
+    TEST_EXPECT(SlotMap_Create(u64, 0, &map));
+
+    SlotHandle handles[1000];
+    u8 live[1000] = {0};
+    u32 random = 0x9E3779B9u;
+    for (u32 i = 0; i < 1000; i++) {
+        u64 value = i;
+        handles[i] = SlotMapInsert(&map, &value);
+        live[i] = 1;
+        u32 victim = SlotMapTestRandom(&random) % (i + 1);
+        if (live[victim] && (random & 1)) {
+            TEST_EXPECT(SlotMapRemove(&map, handles[victim]));
+            live[victim] = 0;
+        }
+    }
+
+    u32 expected = 0;
+    u64 expected_sum = 0;
+    for (u32 i = 0; i < 1000; i++) {
+        expected += live[i];
+        expected_sum += live[i] ? i : 0;
+    }
+    TEST_EXPECT(SlotMapCount(&map) == expected);
+
+    u64* values = map.Data;
+    u64 sum = 0;
+    b8 consistent = true;
+    for (u32 i = 0; i < SlotMapCount(&map); i++) {
+        sum += values[i];
+        SlotHandle handle = SlotMapHandleAt(&map, i);
+        consistent = consistent && handle == handles[values[i]] && SlotMapGet(&map, handle) == &values[i];
+    }
+    TEST_EXPECT(sum == expected_sum);
+    TEST_EXPECT(consistent);
+
+    SlotMapDestroy(&map);
+}
+
+// The slot map against objects allocated one by one and kept in an array of pointers, the way
+// RendererFrontendBufferCreate handed out Buffer* before. Filler allocations between the objects
+// stand in for the rest of the heap, so that the objects are spread out as they would be in a game.
+static void SlotMapBenchmark()
+{
+    SlotMap map;
+    SlotMap_Create(SlotMapTestObject, SLOT_MAP_BENCH_OBJECTS, &map);
+    SlotHandle* handles = PlatformAlloc(sizeof(SlotHandle) * SLOT_MAP_BENCH_OBJECTS);
+    SlotMapTestObject** pointers = PlatformAlloc(sizeof(void*) * SLOT_MAP_BENCH_OBJECTS);
+    void** fillers = PlatformAlloc(sizeof(void*) * SLOT_MAP_BENCH_OBJECTS);
+
+    u32 random = 0x9E3779B9u;
+    for (u32 i = 0; i < SLOT_MAP_BENCH_OBJECTS; i++) {
+        SlotMapTestObject object = {0};
+        object.Key = i;
+        object.Size = i & 255;
+        handles[i] = SlotMapInsert(&map, &object);
+        pointers[i] = PlatformAlloc(sizeof(SlotMapTestObject));
+        *pointers[i] = object;
+        fillers[i] = PlatformAlloc(16 + SlotMapTestRandom(&random) % 512);
+    }
+    for (u32 i = 0; i < SLOT_MAP_BENCH_OBJECTS; i++)
+        PlatformFree(fillers[i]);
+    // Lookups go through the handles in a random order.
+    for (u32 i = SLOT_MAP_BENCH_OBJECTS - 1; i > 0; i--) {
+        u32 j = SlotMapTestRandom(&random) % (i + 1);
+        SlotHandle handle = handles[i];
+        handles[i] = handles[j];
+        handles[j] = handle;
+        SlotMapTestObject* pointer = pointers[i];
+        pointers[i] = pointers[j];
+        pointers[j] = pointer;
+    }
+    u64 sum = 0;
+
+    f64 start = BenchmarkNow();
+    for (u32 pass = 0; pass < SLOT_MAP_BENCH_PASSES; pass++) {
+        SlotMapTestObject* objects = map.Data;
+        u32 count = SlotMapCount(&map);
+        for (u32 i = 0; i < count; i++)
+            sum += objects[i].Size;
+    }
+    BenchmarkReport("SlotMap iteration over Data", (u64)SLOT_MAP_BENCH_PASSES * SLOT_MAP_BENCH_OBJECTS, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 pass = 0; pass < SLOT_MAP_BENCH_PASSES; pass++)
+        for (u32 i = 0; i < SLOT_MAP_BENCH_OBJECTS; i++)
+            sum += pointers[i]->Size;
+    BenchmarkReport("Pointer array iteration", (u64)SLOT_MAP_BENCH_PASSES * SLOT_MAP_BENCH_OBJECTS, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 i = 0; i < SLOT_MAP_BENCH_LOOKUPS; i++)
+        sum += SlotMap_Get(&map, SlotMapTestObject, handles[SlotMapTestRandom(&random) % SLOT_MAP_BENCH_OBJECTS])->Size;
+    BenchmarkReport("SlotMapGet, random handles", SLOT_MAP_BENCH_LOOKUPS, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 i = 0; i < SLOT_MAP_BENCH_LOOKUPS; i++)
+        sum += pointers[SlotMapTestRandom(&random) % SLOT_MAP_BENCH_OBJECTS]->Size;
+    BenchmarkReport("Pointer dereference, random pointers", SLOT_MAP_BENCH_LOOKUPS, BenchmarkNow() - start);
+
+    BenchmarkKeep(sum);
+    for (u32 i = 0; i < SLOT_MAP_BENCH_OBJECTS; i++)
+        PlatformFree(pointers[i]);
+    PlatformFree(fillers);
+    PlatformFree(pointers);
+    PlatformFree(handles);
+    SlotMapDestroy(&map);
+}
+
+void RegisterSlotMapTests()
+{
+    TestRegister("SlotMap: insert and remove with swap-remove", SlotMapInsertAndRemove);
+    TestRegister("SlotMap: stale handles miss after their slot is reused", SlotMapStaleHandles);
+    TestRegister("SlotMap: dense iteration matches the handles", SlotMapDenseIteration);
+
+    BenchmarkRegister("SlotMap: iteration and lookup against an array of pointers", SlotMapBenchmark);
+}
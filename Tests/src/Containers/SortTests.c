@@ -0,0 +1,294 @@
+#include "../Test.h"
+
+#include <Containers/Sort.h>
+#include <Core/JobSystem.h>
+#include <Platform/Platform.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SORT_TEST_COUNT 100000
+#define SORT_TEST_THREADS 4
+#define SORT_BENCH_COUNT 1000000
+
+static u64 SortTestRandom(u64* state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Fills entries with keys of the given bits, the index being the position before sorting.
+static void SortFill32(SortEntry32* entries, u32 count, u32 mask, u64 seed)
+{
+    for (u32 i = 0; i < count; i++) {
+        entries[i].Key = (u32)SortTestRandom(&seed) & mask;
+        entries[i].Index = i;
+    }
+}
+
+static void SortFill64(SortEntry64* entries, u32 count, u64 mask, u64 seed)
+{
+    for (u32 i = 0; i < count; i++) {
+        entries[i].Key = SortTestRandom(&seed) & mask;
+        entries[i].Index = i;
+        entries[i].Padding = 0;
+    }
+}
+
+// Keys ascend, and equal keys keep the order of their indices.
+static b8 SortIsStable32(SortEntry32* entries, u32 count)
+{
+    for (u32 i = 1; i < count; i++)
+        if (entries[i - 1].Key > entries[i].Key || (entries[i - 1].Key == entries[i].Key && entries[i - 1].Index > entries[i].Index))
+            return false;
+    return true;
+}
+
+static b8 SortIsStable64(SortEntry64* entries, u32 count)
+{
+    for (u32 i = 1; i < count; i++)
+        if (entries[i - 1].Key > entries[i].Key || (entries[i - 1].Key == entries[i].Key && entries[i - 1].Index > entries[i].Index))
+            return false;
+    return true;
+}
+
+// Each index appears once, with the key it was filled with.
+static b8 SortIsPermutation32(SortEntry32* entries, SortEntry32* original, u32 count)
+{
+    u8* seen = PlatformAlloc(count);
+    PlatformZeroMemory(seen, count);
+    b8 result = true;
+    for (u32 i = 0; i < count && result; i++) {
+        u32 index = entries[i].Index;
+        result = index < count && !seen[index] && original[index].Key == entries[i].Key;
+        if (result)
+            seen[index] = 1;
+    }
+    PlatformFree(seen);
+    return result;
+}
+
+static int SortCompare32(const void* a, const void* b)
+{
+    const SortEntry32* x = a;
+    const SortEntry32* y = b;
+    if (x->Key != y->Key)
+        return x->Key < y->Key ? -1 : 1;
+    return x->Index < y->Index ? -1 : x->Index > y->Index;
+}
+
+static int SortCompare64(const void* a, const void* b)
+{
+    const SortEntry64* x = a;
+    const SortEntry64* y = b;
+    if (x->Key != y->Key)
+        return x->Key < y->Key ? -1 : 1;
+    return x->Index < y->Index ? -1 : x->Index > y->Index;
+}
+
+// Full keys, and keys with few distinct values, in which every pass but one is skipped.
+static void RadixSort32Correctness()
+{
+    SortEntry32* entries = PlatformAlloc(sizeof(SortEntry32) * SORT_TEST_COUNT);
+    SortEntry32* original = PlatformAlloc(sizeof(SortEntry32) * SORT_TEST_COUNT);
+    SortEntry32* scratch = PlatformAlloc(sizeof(SortEntry32) * SORT_TEST_COUNT);
+
+    u32 masks[] = {0xFFFFFFFF, 0xFF, 0xFF0000, 0};
+    u32 counts[] = {SORT_TEST_COUNT, 1000, 1, 0};
+    for (u32 m = 0; m < sizeof(masks) / sizeof(masks[0]); m++) {
+        for (u32 c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+            SortFill32(original, counts[c], masks[m], 0x2545F4914F6CDD1Dull + m);
+            PlatformCopyMemory(entries, original, sizeof(SortEntry32) * counts[c]);
+            RadixSort32(entries, scratch, counts[c]);
+            TEST_EXPECT(SortIsStable32(entries, counts[c]));
+            TEST_EXPECT(SortIsPermutation32(entries, original, counts[c]));
+        }
+    }
+
+    // Already sorted and reversed input.
+    for (u32 i = 0; i < SORT_TEST_COUNT; i++) {
+        entries[i].Key = SORT_TEST_COUNT - i;
+        entries[i].Index = i;
+    }
+    RadixSort32(entries, scratch, SORT_TEST_COUNT);
+    TEST_EXPECT(SortIsStable32(entries, SORT_TEST_COUNT) && entries[0].Key == 1);
+    RadixSort32(entries, scratch, SORT_TEST_COUNT);
+    TEST_EXPECT(SortIsStable32(entries, SORT_TEST_COUNT) && entries[0].Index == SORT_TEST_COUNT - 1);
+
+    PlatformFree(scratch);
+    PlatformFree(original);
+    PlatformFree(entries);
+}
+
+static void RadixSort64Correctness()
+{
+    SortEntry64* entries = PlatformAlloc(sizeof(SortEntry64) * SORT_TEST_COUNT);
+    SortEntry64* expected = PlatformAlloc(sizeof(SortEntry64) * SORT_TEST_COUNT);
+    SortEntry64* scratch = PlatformAlloc(sizeof(SortEntry64) * SORT_TEST_COUNT);
+
+    u64 masks[] = {~0ull, 0xFFFF000000000000ull, 0xF0000000000Full};
+    for (u32 m = 0; m < sizeof(masks) / sizeof(masks[0]); m++) {
+        SortFill64(entries, SORT_TEST_COUNT, masks[m], 0x9E3779B97F4A7C15ull + m);
+        PlatformCopyMemory(expected, entries, sizeof(SortEntry64) * SORT_TEST_COUNT);
+        qsort(expected, SORT_TEST_COUNT, sizeof(SortEntry64), SortCompare64);
+        RadixSort64(entries, scratch, SORT_TEST_COUNT);
+        TEST_EXPECT(SortIsStable64(entries, SORT_TEST_COUNT));
+        TEST_EXPECT(memcmp(entries, expected, sizeof(SortEntry64) * SORT_TEST_COUNT) == 0);
+    }
+
+    PlatformFree(scratch);
+    PlatformFree(expected);
+    PlatformFree(entries);
+}
+
+// The parallel sorts give the same result as the single-threaded ones, run inline or as jobs,
+// with more workers than entries included.
+static void RadixSortParallel()
+{
+    SortEntry32* entries32 = PlatformAlloc(sizeof(SortEntry32) * SORT_TEST_COUNT);
+    SortEntry32* expected32 = PlatformAlloc(sizeof(SortEntry32) * SORT_TEST_COUNT);
+    SortEntry32* scratch32 = PlatformAlloc(sizeof(SortEntry32) * SORT_TEST_COUNT);
+    SortEntry64* entries64 = PlatformAlloc(sizeof(SortEntry64) * SORT_TEST_COUNT);
+    SortEntry64* expected64 = PlatformAlloc(sizeof(SortEntry64) * SORT_TEST_COUNT);
+    SortEntry64* scratch64 = PlatformAlloc(sizeof(SortEntry64) * SORT_TEST_COUNT);
+
+    TEST_EXPECT(JobSystemInit(SORT_TEST_THREADS));
+    u32 counts[] = {SORT_TEST_COUNT, 1000, 3};
+    u32 workers[] = {SORT_TEST_THREADS, 7, SORT_MAX_WORKERS + 8};
+    for (u32 c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        for (u32 w = 0; w < sizeof(workers) / sizeof(workers[0]); w++) {
+            u32 count = counts[c];
+            SortFill32(expected32, count, 0xFFFF00FF, 0x2545F4914F6CDD1Dull + w);
+            PlatformCopyMemory(entries32, expected32, sizeof(SortEntry32) * count);
+            RadixSort32(expected32, scratch32, count);
+            RadixSort32Parallel(entries32, scratch32, count, workers[w], JobSystemSortDispatch, 0);
+            TEST_EXPECT(memcmp(entries32, expected32, sizeof(SortEntry32) * count) == 0);
+
+            SortFill64(expected64, count, ~0ull, 0x9E3779B97F4A7C15ull + w);
+            PlatformCopyMemory(entries64, expected64, sizeof(SortEntry64) * count);
+            RadixSort64(expected64, scratch64, count);
+            RadixSort64Parallel(entries64, scratch64, count, workers[w], w == 1 ? 0 : JobSystemSortDispatch, 0);
+            TEST_EXPECT(memcmp(entries64, expected64, sizeof(SortEntry64) * count) == 0);
+        }
+    }
+    JobSystemShutdown();
+
+    PlatformFree(scratch64);
+    PlatformFree(expected64);
+    PlatformFree(entries64);
+    PlatformFree(scratch32);
+    PlatformFree(expected32);
+    PlatformFree(entries32);
+}
+
+// Packed keys sort by pipeline, then material, then depth, negative depths included.
+static void SortKeyPacking()
+{
+    f32 values[] = {-1e30f, -100.0f, -1.5f, -0.0f, 0.0f, 1e-30f, 0.25f, 1.0f, 3.0f, 1e30f};
+    b8 ordered = true;
+    for (u32 i = 1; i < sizeof(values) / sizeof(values[0]); i++)
+        ordered = ordered && SortKeyFromFloat(values[i - 1]) <= SortKeyFromFloat(values[i]);
+    TEST_EXPECT(ordered);
+    TEST_EXPECT(SortKeyFromFloat(-1.0f) < SortKeyFromFloat(1.0f));
+
+    u64 key = SortKeyPack(1234, 567890, 42.0f);
+    TEST_EXPECT(SortKeyGetPipeline(key) == 1234);
+    TEST_EXPECT(SortKeyGetMaterial(key) == 567890);
+    // Indices wider than their fields are cut to the low bits, without spilling into the next.
+    key = SortKeyPack(0x12345, 0x1234567, 0.0f);
+    TEST_EXPECT(SortKeyGetPipeline(key) == 0x2345);
+    TEST_EXPECT(SortKeyGetMaterial(key) == 0x234567);
+
+    TEST_EXPECT(SortKeyPack(1, 0, 0.0f) > SortKeyPack(0, 0xFFFFFF, 1e30f));
+    TEST_EXPECT(SortKeyPack(0, 2, -5.0f) > SortKeyPack(0, 1, 1e30f));
+    TEST_EXPECT(SortKeyPack(0, 1, 1.0f) < SortKeyPack(0, 1, 2.0f));
+    // Negating the depth orders back to front.
+    TEST_EXPECT(SortKeyPack(0, 1, -2.0f) < SortKeyPack(0, 1, -1.0f));
+}
+
+// 1M keys sorted by qsort, by the radix sort, and by the parallel radix sort on every processor.
+static void RadixSortBenchmark()
+{
+    SortEntry32* original32 = PlatformAlloc(sizeof(SortEntry32) * SORT_BENCH_COUNT);
+    SortEntry32* entries32 = PlatformAlloc(sizeof(SortEntry32) * SORT_BENCH_COUNT);
+    SortEntry32* scratch32 = PlatformAlloc(sizeof(SortEntry32) * SORT_BENCH_COUNT);
+    SortEntry64* original64 = PlatformAlloc(sizeof(SortEntry64) * SORT_BENCH_COUNT);
+    SortEntry64* entries64 = PlatformAlloc(sizeof(SortEntry64) * SORT_BENCH_COUNT);
+    SortEntry64* scratch64 = PlatformAlloc(sizeof(SortEntry64) * SORT_BENCH_COUNT);
+
+    // Draw keys, as a frame of a million draws over 64 pipelines and 4096 materials would make.
+    u64 state = 0x2545F4914F6CDD1Dull;
+    SortFill32(original32, SORT_BENCH_COUNT, 0xFFFFFFFF, state);
+    for (u32 i = 0; i < SORT_BENCH_COUNT; i++) {
+        u64 random = SortTestRandom(&state);
+        original64[i].Key = SortKeyPack(random & 63, (random >> 8) & 4095, (f32)(random >> 40) / 1000.0f);
+        original64[i].Index = i;
+        original64[i].Padding = 0;
+    }
+
+    u32 processors = PlatformGetProcessorCount();
+    u32 threads = processors > SORT_MAX_WORKERS ? SORT_MAX_WORKERS : processors;
+    char label[64];
+    u64 sum = 0;
+
+    PlatformCopyMemory(entries32, original32, sizeof(SortEntry32) * SORT_BENCH_COUNT);
+    f64 start = BenchmarkNow();
+    qsort(entries32, SORT_BENCH_COUNT, sizeof(SortEntry32), SortCompare32);
+    BenchmarkReport("qsort, 32-bit keys", SORT_BENCH_COUNT, BenchmarkNow() - start);
+    sum += entries32[SORT_BENCH_COUNT / 2].Index;
+
+    PlatformCopyMemory(entries32, original32, sizeof(SortEntry32) * SORT_BENCH_COUNT);
+    start = BenchmarkNow();
+    RadixSort32(entries32, scratch32, SORT_BENCH_COUNT);
+    BenchmarkReport("RadixSort32", SORT_BENCH_COUNT, BenchmarkNow() - start);
+    sum += entries32[SORT_BENCH_COUNT / 2].Index;
+
+    PlatformCopyMemory(entries64, original64, sizeof(SortEntry64) * SORT_BENCH_COUNT);
+    start = BenchmarkNow();
+    qsort(entries64, SORT_BENCH_COUNT, sizeof(SortEntry64), SortCompare64);
+    BenchmarkReport("qsort, 64-bit draw keys", SORT_BENCH_COUNT, BenchmarkNow() - start);
+    sum += entries64[SORT_BENCH_COUNT / 2].Index;
+
+    PlatformCopyMemory(entries64, original64, sizeof(SortEntry64) * SORT_BENCH_COUNT);
+    start = BenchmarkNow();
+    RadixSort64(entries64, scratch64, SORT_BENCH_COUNT);
+    BenchmarkReport("RadixSort64, draw keys", SORT_BENCH_COUNT, BenchmarkNow() - start);
+    sum += entries64[SORT_BENCH_COUNT / 2].Index;
+
+    JobSystemInit(threads);
+    PlatformCopyMemory(entries32, original32, sizeof(SortEntry32) * SORT_BENCH_COUNT);
+    start = BenchmarkNow();
+    RadixSort32Parallel(entries32, scratch32, SORT_BENCH_COUNT, threads, JobSystemSortDispatch, 0);
+    snprintf(label, sizeof(label), "RadixSort32Parallel, %u threads", threads);
+    BenchmarkReport(label, SORT_BENCH_COUNT, BenchmarkNow() - start);
+    sum += entries32[SORT_BENCH_COUNT / 2].Index;
+
+    PlatformCopyMemory(entries64, original64, sizeof(SortEntry64) * SORT_BENCH_COUNT);
+    start = BenchmarkNow();
+    RadixSort64Parallel(entries64, scratch64, SORT_BENCH_COUNT, threads, JobSystemSortDispatch, 0);
+    snprintf(label, sizeof(label), "RadixSort64Parallel, draw keys, %u threads", threads);
+    BenchmarkReport(label, SORT_BENCH_COUNT, BenchmarkNow() - start);
+    sum += entries64[SORT_BENCH_COUNT / 2].Index;
+    JobSystemShutdown();
+
+    BenchmarkKeep(sum);
+    PlatformFree(scratch64);
+    PlatformFree(entries64);
+    PlatformFree(original64);
+    PlatformFree(scratch32);
+    PlatformFree(entries32);
+    PlatformFree(original32);
+}
+
+void RegisterSortTests()
+{
+    TestRegister("Sort: 32-bit radix sort is stable, with skipped passes", RadixSort32Correctness);
+    TestRegister("Sort: 64-bit radix sort matches qsort", RadixSort64Correctness);
+    TestRegister("Sort: parallel radix sorts match the single-threaded ones", RadixSortParallel);
+    TestRegister("Sort: sort-key packing order and fields", SortKeyPacking);
+
+    BenchmarkRegister("Sort: 1M keys against qsort", RadixSortBenchmark);
+}
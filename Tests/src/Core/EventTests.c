@@ -0,0 +1,203 @@
+#include "../Test.h"
+
+#include <Core/Atomic.h>
+#include <Core/Event.h>
+#include <Core/MemTracker.h>
+#include <Platform/Platform.h>
+
+#include <stdio.h>
+
+#define EVENT_STRESS_POSTERS 4
+#define EVENT_STRESS_MOVES 20000
+#define EVENT_STRESS_KEYS 500
+#define EVENT_BENCH_CODES 12
+#define EVENT_BENCH_LISTENERS 18
+#define EVENT_BENCH_STARTUPS 1000
+#define EVENT_BENCH_FIRES 10000000
+
+typedef struct EventStress {
+    u32 KeyCount;
+    u32 MoveCount;
+    u32 OrderErrors;
+    // The next key expected from each poster.
+    u32 NextKey[EVENT_STRESS_POSTERS];
+    u32 PostersDone;
+    u32 Registrations;
+} EventStress;
+
+static EventStress event_stress;
+
+static b8 EventStressOnKey(u16 code, void* sender, void* listener_inst, Event data)
+{
+    u32 poster = data.data.u32[0];
+    u32 key = data.data.u32[1];
+    if (poster >= EVENT_STRESS_POSTERS || key != event_stress.NextKey[poster])
+        event_stress.OrderErrors++;
+    else
+        event_stress.NextKey[poster] = key + 1;
+    event_stress.KeyCount++;
+    return false;
+}
+
+static b8 EventStressOnMove(u16 code, void* sender, void* listener_inst, Event data)
+{
+    event_stress.MoveCount++;
+    return true;
+}
+
+static b8 EventStressIgnore(u16 code, void* sender, void* listener_inst, Event data)
+{
+    return false;
+}
+
+// Posted moves coalesce into a single slot, so that they can't crowd out the keys.
+static void EventCoalescedBurst()
+{
+    TEST_EXPECT(EventSystemInit());
+    PlatformZeroMemory(&event_stress, sizeof(event_stress));
+    EventRegister(EVENT_CODE_KEY_PRESSED, 0, EventStressOnKey);
+    EventRegister(EVENT_CODE_MOUSE_MOVED, 0, EventStressOnMove);
+
+    Event data = {0};
+    u32 dropped = 0;
+    for (u32 i = 0; i < EVENT_QUEUE_CAPACITY * 20; i++)
+        dropped += !EventPost(EVENT_CODE_MOUSE_MOVED, 0, data);
+    for (u32 i = 0; i < 10; i++) {
+        data.data.u32[1] = i;
+        dropped += !EventPost(EVENT_CODE_KEY_PRESSED, 0, data);
+    }
+    EventDispatchQueued();
+
+    TEST_EXPECT(dropped == 0);
+    TEST_EXPECT(event_stress.KeyCount == 10);
+    TEST_EXPECT(event_stress.MoveCount == 1);
+    TEST_EXPECT(event_stress.OrderErrors == 0);
+    EventSystemExit();
+}
+
+// Index 0 dispatches on the main thread, the last index registers and unregisters a listener
+// while events fire, and the others post.
+static void EventStressThread(u32 index, void* data)
+{
+    if (index == 0) {
+        while (AtomicLoad(&event_stress.PostersDone, ATOMIC_ACQUIRE) < EVENT_STRESS_POSTERS)
+            EventDispatchQueued();
+        EventDispatchQueued();
+        return;
+    }
+
+    if (index > EVENT_STRESS_POSTERS) {
+        while (AtomicLoad(&event_stress.PostersDone, ATOMIC_ACQUIRE) < EVENT_STRESS_POSTERS) {
+            TEST_EXPECT(EventRegister(EVENT_CODE_KEY_PRESSED, &event_stress, EventStressIgnore));
+            TEST_EXPECT(EventUnregister(EVENT_CODE_KEY_PRESSED, &event_stress, EventStressIgnore));
+            event_stress.Registrations++;
+        }
+        return;
+    }
+
+    u32 poster = index - 1;
+    Event event = {0};
+    event.data.u32[0] = poster;
+    for (u32 i = 0; i < EVENT_STRESS_MOVES; i++) {
+        event.data.u32[1] = i;
+        EventPost(EVENT_CODE_MOUSE_MOVED, 0, event);
+        if (i % (EVENT_STRESS_MOVES / EVENT_STRESS_KEYS) == 0) {
+            event.data.u32[1] = i / (EVENT_STRESS_MOVES / EVENT_STRESS_KEYS);
+            while (!EventPost(EVENT_CODE_KEY_PRESSED, 0, event))
+                PlatformSleep(0);
+        }
+    }
+    AtomicFetchAdd(&event_stress.PostersDone, 1, ATOMIC_RELEASE);
+}
+
+// Every key posted arrives once, in the order its thread posted it.
+static void EventPostFromManyThreads()
+{
+    TEST_EXPECT(EventSystemInit());
+    PlatformZeroMemory(&event_stress, sizeof(event_stress));
+    EventRegister(EVENT_CODE_KEY_PRESSED, 0, EventStressOnKey);
+    EventRegister(EVENT_CODE_MOUSE_MOVED, 0, EventStressOnMove);
+
+    TestRunThreads(EVENT_STRESS_POSTERS + 2, EventStressThread, 0);
+
+    TEST_EXPECT(event_stress.KeyCount == EVENT_STRESS_POSTERS * EVENT_STRESS_KEYS);
+    TEST_EXPECT(event_stress.OrderErrors == 0);
+    TEST_EXPECT(event_stress.MoveCount >= 1 && event_stress.MoveCount <= EVENT_STRESS_POSTERS * EVENT_STRESS_MOVES);
+    EventSystemExit();
+}
+
+// Registers listeners the way the engine and a game do at startup: a few codes with several
+// listeners, and the rest with one.
+static void EventBenchRegister(u32* listeners)
+{
+    for (u32 i = 0; i < EVENT_BENCH_LISTENERS; i++)
+        EventRegister(EVENT_CODE_APPLICATION_QUIT + i % EVENT_BENCH_CODES, &listeners[i], EventStressIgnore);
+}
+
+// The registry against the table of 16384 entries it replaced, each of which held a listener list
+// pointer, the last batch and the coalescing mode, 16 bytes in all.
+static void EventRegistryBenchmark()
+{
+    u32 listeners[EVENT_BENCH_LISTENERS];
+    u64 sum = 0;
+
+    TEST_EXPECT(EventSystemInit());
+    u64 usage = MemoryTrackerGetUsage(MEMORY_TAG_ENGINE_GENERAL);
+    EventBenchRegister(listeners);
+    // Frees the registries replaced while registering.
+    EventDispatchQueued();
+    u64 registry_size = MemoryTrackerGetUsage(MEMORY_TAG_ENGINE_GENERAL) - usage;
+    printf("    Registry of %u codes, %u listeners: %llu bytes, against %u bytes for the old table\n",
+        EVENT_BENCH_CODES, EVENT_BENCH_LISTENERS, registry_size, 16384 * 16);
+
+    Event data = {0};
+    f64 start = BenchmarkNow();
+    for (u32 i = 0; i < EVENT_BENCH_FIRES; i++) {
+        data.data.u32[0] = i;
+        sum += EventFire(EVENT_CODE_APPLICATION_QUIT + (i & 3), 0, data);
+    }
+    BenchmarkReport("EventFire, 1 or 2 listeners", EVENT_BENCH_FIRES, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 i = 0; i < EVENT_BENCH_FIRES; i++) {
+        data.data.u32[0] = i;
+        sum += EventFire(0xFFF0, 0, data);
+    }
+    BenchmarkReport("EventFire, no listeners", EVENT_BENCH_FIRES, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 i = 0; i < EVENT_BENCH_FIRES / 1000; i++) {
+        for (u32 j = 0; j < 1000; j++) {
+            data.data.u32[0] = j;
+            sum += EventPost(EVENT_CODE_KEY_PRESSED, 0, data);
+        }
+        EventDispatchQueued();
+    }
+    BenchmarkReport("EventPost + EventDispatchQueued", EVENT_BENCH_FIRES, BenchmarkNow() - start);
+    EventSystemExit();
+
+    start = BenchmarkNow();
+    for (u32 i = 0; i < EVENT_BENCH_STARTUPS; i++) {
+        EventSystemInit();
+        EventSystemExit();
+    }
+    BenchmarkReport("EventSystemInit + EventSystemExit", EVENT_BENCH_STARTUPS, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 i = 0; i < EVENT_BENCH_STARTUPS; i++) {
+        EventSystemInit();
+        EventBenchRegister(listeners);
+        EventSystemExit();
+    }
+    BenchmarkReport("Init, registering every listener, and Exit", EVENT_BENCH_STARTUPS, BenchmarkNow() - start);
+
+    BenchmarkKeep(sum);
+}
+
+void RegisterEventTests()
+{
+    TestRegister("Event: coalesced posts don't crowd out others", EventCoalescedBurst);
+    TestRegister("Event: posting from many threads while listeners change", EventPostFromManyThreads);
+
+    BenchmarkRegister("Event: registry memory, startup and dispatch latency", EventRegistryBenchmark);
+}
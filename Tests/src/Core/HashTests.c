@@ -0,0 +1,175 @@
+#include "../Test.h"
+
+#include <Core/Hash.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define HASH_TEST_NAMES 100000
+#define HASH_TEST_BUCKETS 4096
+
+// The hash HashTable used before, without the modulo it was followed by.
+static u64 LegacyHashName(const char* name)
+{
+    u64 hash = 0;
+    for (const unsigned char* us = (const unsigned char*)name; *us; us++)
+        hash = hash * 97 + *us;
+    return hash;
+}
+
+static u64 HashTestRandom(u64* state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// The chi-squared statistic of hashes spread over the buckets, by their low bits, or by their
+// high bits when shift is set. Uniformly spread hashes give about HASH_TEST_BUCKETS - 1.
+static f64 HashChiSquared(u64 (*hash_name)(const char* name), u32 shift)
+{
+    static u32 buckets[HASH_TEST_BUCKETS];
+    memset(buckets, 0, sizeof(buckets));
+
+    char name[64];
+    for (u32 i = 0; i < HASH_TEST_NAMES; i++) {
+        snprintf(name, sizeof(name), "Textures/Asset_%u.png", i);
+        u64 hash = hash_name(name);
+        buckets[(shift ? hash >> shift : hash) & (HASH_TEST_BUCKETS - 1)]++;
+    }
+
+    f64 expected = (f64)HASH_TEST_NAMES / HASH_TEST_BUCKETS;
+    f64 chi_squared = 0.0;
+    for (u32 i = 0; i < HASH_TEST_BUCKETS; i++)
+        chi_squared += (buckets[i] - expected) * (buckets[i] - expected) / expected;
+    return chi_squared;
+}
+
+static u64 HashStringName(const char* name)
+{
+    return HashString(name);
+}
+
+static void HashedStrings()
+{
+    HashedString literal = HASHED_STRING("Shaders/Builtin.ObjectShader");
+    HashedString runtime = HashedStringCreate("Shaders/Builtin.ObjectShader");
+    TEST_EXPECT(literal.Hash == runtime.Hash);
+    TEST_EXPECT(literal.Hash == HashString("Shaders/Builtin.ObjectShader"));
+    TEST_EXPECT(strcmp(literal.String, runtime.String) == 0);
+
+    // Every length takes its own path through the hash; none may ignore a byte.
+    u8 bytes[200];
+    for (u32 i = 0; i < sizeof(bytes); i++)
+        bytes[i] = (u8)(i * 31);
+    u32 ignored = 0;
+    for (u64 length = 1; length <= sizeof(bytes); length++) {
+        u64 hash = HashBytes(bytes, length, 0);
+        ignored += hash == HashBytes(bytes, length - 1, 0);
+        for (u64 i = 0; i < length; i++) {
+            bytes[i] ^= 1;
+            ignored += HashBytes(bytes, length, 0) == hash;
+            bytes[i] ^= 1;
+        }
+        ignored += HashBytes(bytes, length, 1) == hash;
+    }
+    TEST_EXPECT(ignored == 0);
+}
+
+// Hashes of similar names spread evenly over power-of-two tables, by their low and high bits.
+static void HashDistribution()
+{
+    // Four standard deviations, sqrt(2 * (HASH_TEST_BUCKETS - 1)) each, above the expected value.
+    f64 limit = (HASH_TEST_BUCKETS - 1) + 4.0 * 90.5;
+    TEST_EXPECT(HashChiSquared(HashStringName, 0) < limit);
+    TEST_EXPECT(HashChiSquared(HashStringName, 52) < limit);
+}
+
+// Flipping any bit of the input flips each bit of the hash with a probability close to one half.
+static void HashAvalanche()
+{
+    const u32 trials = 400;
+    u64 lengths[] = {4, 8, 16, 40, 100};
+    u64 state = 0x2545F4914F6CDD1Dull;
+    u8 bytes[100];
+
+    for (u32 l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        u64 length = lengths[l];
+        u32 flips[64] = {0};
+        u32 samples = 0;
+        for (u32 t = 0; t < trials; t++) {
+            for (u64 i = 0; i < length; i++)
+                bytes[i] = (u8)HashTestRandom(&state);
+            u64 hash = HashBytes(bytes, length, 0);
+
+            u64 bit = HashTestRandom(&state) % (length * 8);
+            bytes[bit / 8] ^= (u8)(1 << (bit % 8));
+            u64 difference = hash ^ HashBytes(bytes, length, 0);
+            for (u32 b = 0; b < 64; b++)
+                flips[b] += (difference >> b) & 1;
+            samples++;
+        }
+
+        // With 400 samples, five standard deviations from one half are 0.125.
+        u32 biased = 0;
+        for (u32 b = 0; b < 64; b++) {
+            f64 probability = (f64)flips[b] / samples;
+            biased += probability < 0.375 || probability > 0.625;
+        }
+        TEST_EXPECT(biased == 0);
+    }
+}
+
+static void HashThroughputBenchmark()
+{
+    static u8 bytes[4096];
+    static char names[4097];
+    for (u32 i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = (u8)(i * 131 + 7);
+        names[i] = 'a' + (char)(i % 26);
+    }
+
+    u64 lengths[] = {8, 16, 32, 64, 256, 4096};
+    char label[64];
+    u64 sum = 0;
+    for (u32 l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        u64 length = lengths[l];
+        u64 iterations = (64ull * 1024 * 1024) / length;
+
+        f64 start = BenchmarkNow();
+        for (u64 i = 0; i < iterations; i++)
+            sum += HashBytes(bytes, length, i);
+        f64 seconds = BenchmarkNow() - start;
+        snprintf(label, sizeof(label), "HashBytes, %llu bytes", length);
+        BenchmarkReport(label, iterations, seconds);
+        printf("    %-48s %10.2f GB/s\n", "", (f64)(iterations * length) / seconds / 1e9);
+
+        // A string of the same length, whose first character changes like the seed above.
+        char* name = names + sizeof(names) - 1 - length;
+        start = BenchmarkNow();
+        for (u64 i = 0; i < iterations; i++) {
+            name[0] = 'a' + (char)(i & 15);
+            sum += LegacyHashName(name);
+        }
+        seconds = BenchmarkNow() - start;
+        snprintf(label, sizeof(label), "Legacy hash * 97 + c, %llu bytes", length);
+        BenchmarkReport(label, iterations, seconds);
+        printf("    %-48s %10.2f GB/s\n", "", (f64)(iterations * length) / seconds / 1e9);
+    }
+
+    printf("    Chi-squared over %u buckets, %u asset names (about %u when uniform):\n", HASH_TEST_BUCKETS, HASH_TEST_NAMES, HASH_TEST_BUCKETS - 1);
+    printf("        HashString low bits %.0f, high bits %.0f\n", HashChiSquared(HashStringName, 0), HashChiSquared(HashStringName, 52));
+    printf("        Legacy hash low bits %.0f, high bits %.0f\n", HashChiSquared(LegacyHashName, 0), HashChiSquared(LegacyHashName, 52));
+
+    BenchmarkKeep(sum);
+}
+
+void RegisterHashTests()
+{
+    TestRegister("Hash: hashed strings, and every byte and the length counted", HashedStrings);
+    TestRegister("Hash: distribution of similar names over buckets", HashDistribution);
+    TestRegister("Hash: avalanche of single bit flips", HashAvalanche);
+
+    BenchmarkRegister("Hash: throughput and distribution against the legacy hash", HashThroughputBenchmark);
+}
@@ -0,0 +1,387 @@
+#include "../Test.h"
+
+#include <Containers/WorkStealingDeque.h>
+#include <Core/Atomic.h>
+#include <Core/JobSystem.h>
+#include <Core/MemTracker.h>
+#include <Platform/Platform.h>
+
+#include <stdio.h>
+
+#define DEQUE_STRESS_ELEMENTS 200000
+#define DEQUE_STRESS_THIEVES 3
+#define JOB_TEST_THREADS 4
+#define JOB_TEST_COUNT 10000
+#define JOB_TEST_CHILDREN 8
+#define PARALLEL_FOR_TEST_COUNT 100003
+
+static void DequeSequential()
+{
+    WorkStealingDeque deque;
+    TEST_EXPECT(WorkStealingDequeCreate(16, &deque));
+
+    u64 values[17];
+    for (u64 i = 0; i < 16; i++)
+        TEST_EXPECT(WorkStealingDequePush(&deque, &values[i]));
+    TEST_EXPECT(!WorkStealingDequePush(&deque, &values[16]));
+    TEST_EXPECT(WorkStealingDequeCount(&deque) == 16);
+
+    // The owner takes the newest element, thieves the oldest.
+    void* element = 0;
+    TEST_EXPECT(WorkStealingDequePop(&deque, &element) && element == &values[15]);
+    TEST_EXPECT(WorkStealingDequeSteal(&deque, &element) && element == &values[0]);
+    TEST_EXPECT(WorkStealingDequeSteal(&deque, &element) && element == &values[1]);
+
+    u32 left = 0;
+    while (WorkStealingDequePop(&deque, &element))
+        left++;
+    TEST_EXPECT(left == 13);
+    TEST_EXPECT(!WorkStealingDequeSteal(&deque, &element));
+
+    WorkStealingDequeDestroy(&deque);
+}
+
+typedef struct DequeStress {
+    WorkStealingDeque Deque;
+    u32 Taken[DEQUE_STRESS_ELEMENTS];
+    u32 Remaining;
+    u32 Done;
+} DequeStress;
+
+static void DequeStressThread(u32 index, void* data)
+{
+    DequeStress* stress = data;
+    void* element = 0;
+
+    if (index == 0) {
+        // The owner pushes every element, popping some of them back as it goes.
+        for (u64 i = 0; i < DEQUE_STRESS_ELEMENTS; i++) {
+            while (!WorkStealingDequePush(&stress->Deque, (void*)(i + 1))) {
+                if (WorkStealingDequePop(&stress->Deque, &element)) {
+                    AtomicFetchAdd(&stress->Taken[(u64)element - 1], 1, ATOMIC_RELAXED);
+                    AtomicFetchSub(&stress->Remaining, 1, ATOMIC_RELAXED);
+                }
+            }
+            if ((i & 7) == 0 && WorkStealingDequePop(&stress->Deque, &element)) {
+                AtomicFetchAdd(&stress->Taken[(u64)element - 1], 1, ATOMIC_RELAXED);
+                AtomicFetchSub(&stress->Remaining, 1, ATOMIC_RELAXED);
+            }
+        }
+        while (WorkStealingDequePop(&stress->Deque, &element)) {
+            AtomicFetchAdd(&stress->Taken[(u64)element - 1], 1, ATOMIC_RELAXED);
+            AtomicFetchSub(&stress->Remaining, 1, ATOMIC_RELAXED);
+        }
+        AtomicStore(&stress->Done, 1, ATOMIC_RELEASE);
+        return;
+    }
+
+    for (;;) {
+        if (WorkStealingDequeSteal(&stress->Deque, &element)) {
+            AtomicFetchAdd(&stress->Taken[(u64)element - 1], 1, ATOMIC_RELAXED);
+            AtomicFetchSub(&stress->Remaining, 1, ATOMIC_RELAXED);
+        } else if (AtomicLoad(&stress->Done, ATOMIC_ACQUIRE)) {
+            break;
+        } else {
+            ELSA_CPU_PAUSE();
+        }
+    }
+}
+
+// Every element pushed is taken exactly once, by the owner or by one of the thieves.
+static void DequeStealStress()
+{
+    DequeStress* stress = MemoryTrackerAlloc(sizeof(DequeStress), MEMORY_TAG_APP);
+    TEST_EXPECT(WorkStealingDequeCreate(256, &stress->Deque));
+    stress->Remaining = DEQUE_STRESS_ELEMENTS;
+
+    TestRunThreads(1 + DEQUE_STRESS_THIEVES, DequeStressThread, stress);
+
+    u32 wrong = 0;
+    for (u32 i = 0; i < DEQUE_STRESS_ELEMENTS; i++)
+        wrong += stress->Taken[i] != 1;
+    TEST_EXPECT(wrong == 0);
+    TEST_EXPECT(stress->Remaining == 0);
+    TEST_EXPECT(WorkStealingDequeCount(&stress->Deque) == 0);
+
+    WorkStealingDequeDestroy(&stress->Deque);
+    MemoryTrackerFree(stress, sizeof(DequeStress), MEMORY_TAG_APP);
+}
+
+typedef struct JobTestData {
+    u32 Count;
+    u32 FirstDone;
+    u32 OrderErrors;
+    Job Children[JOB_TEST_COUNT][JOB_TEST_CHILDREN];
+    JobCounter ChildCounters[JOB_TEST_COUNT];
+} JobTestData;
+
+static JobTestData* job_test;
+
+static void JobIncrement(void* data)
+{
+    AtomicFetchAdd(&job_test->Count, 1, ATOMIC_RELAXED);
+}
+
+// Spawns children from inside a job, and waits for them there.
+static void JobSpawnChildren(void* data)
+{
+    u64 index = (u64)data;
+    Job* children = job_test->Children[index];
+    for (u32 i = 0; i < JOB_TEST_CHILDREN; i++) {
+        children[i].Function = JobIncrement;
+        children[i].Data = 0;
+    }
+    JobSystemRun(children, JOB_TEST_CHILDREN, &job_test->ChildCounters[index]);
+    JobSystemWait(&job_test->ChildCounters[index]);
+}
+
+static void JobFirst(void* data)
+{
+    PlatformSleep(0);
+    AtomicFetchAdd(&job_test->FirstDone, 1, ATOMIC_RELEASE);
+}
+
+static void JobSecond(void* data)
+{
+    if (AtomicLoad(&job_test->FirstDone, ATOMIC_ACQUIRE) != JOB_TEST_CHILDREN)
+        AtomicFetchAdd(&job_test->OrderErrors, 1, ATOMIC_RELAXED);
+}
+
+static Job* JobTestCreateJobs(u32 count, PFN_Job function)
+{
+    Job* batch = MemoryTrackerAlloc(sizeof(Job) * count, MEMORY_TAG_APP);
+    for (u64 i = 0; i < count; i++) {
+        batch[i].Function = function;
+        batch[i].Data = (void*)i;
+    }
+    return batch;
+}
+
+static void JobSystemRunAndWait()
+{
+    TEST_EXPECT(JobSystemInit(JOB_TEST_THREADS));
+    TEST_EXPECT(JobSystemGetThreadCount() == JOB_TEST_THREADS);
+    TEST_EXPECT(JobSystemGetThreadIndex() == 0);
+
+    job_test = MemoryTrackerAlloc(sizeof(JobTestData), MEMORY_TAG_APP);
+    Job* batch = JobTestCreateJobs(JOB_TEST_COUNT, JobIncrement);
+    JobCounter counter = {0};
+    JobSystemRun(batch, JOB_TEST_COUNT, &counter);
+    JobSystemWait(&counter);
+    TEST_EXPECT(JobCounterIsDone(&counter));
+    TEST_EXPECT(job_test->Count == JOB_TEST_COUNT);
+
+    // Nested jobs, which wait on their children from inside the pool.
+    job_test->Count = 0;
+    Job* parents = JobTestCreateJobs(JOB_TEST_COUNT, JobSpawnChildren);
+    JobSystemRun(parents, JOB_TEST_COUNT, &counter);
+    JobSystemWait(&counter);
+    TEST_EXPECT(job_test->Count == JOB_TEST_COUNT * JOB_TEST_CHILDREN);
+
+    MemoryTrackerFree(parents, sizeof(Job) * JOB_TEST_COUNT, MEMORY_TAG_APP);
+    MemoryTrackerFree(batch, sizeof(Job) * JOB_TEST_COUNT, MEMORY_TAG_APP);
+    MemoryTrackerFree(job_test, sizeof(JobTestData), MEMORY_TAG_APP);
+    JobSystemShutdown();
+}
+
+static void JobSystemDependencies()
+{
+    TEST_EXPECT(JobSystemInit(JOB_TEST_THREADS));
+    job_test = MemoryTrackerAlloc(sizeof(JobTestData), MEMORY_TAG_APP);
+
+    for (u32 round = 0; round < 200; round++) {
+        job_test->FirstDone = 0;
+        Job first[JOB_TEST_CHILDREN];
+        Job second[JOB_TEST_CHILDREN];
+        for (u32 i = 0; i < JOB_TEST_CHILDREN; i++) {
+            first[i].Function = JobFirst;
+            first[i].Data = 0;
+            second[i].Function = JobSecond;
+            second[i].Data = 0;
+        }
+
+        JobCounter first_done = {0};
+        JobCounter second_done = {0};
+        JobSystemRun(first, JOB_TEST_CHILDREN, &first_done);
+        JobSystemRunAfter(second, JOB_TEST_CHILDREN, &first_done, &second_done);
+        JobSystemWait(&second_done);
+        TEST_EXPECT(JobCounterIsDone(&first_done));
+    }
+    TEST_EXPECT(job_test->OrderErrors == 0);
+
+    MemoryTrackerFree(job_test, sizeof(JobTestData), MEMORY_TAG_APP);
+    JobSystemShutdown();
+}
+
+typedef struct ParallelForTest {
+    u32 Hits[PARALLEL_FOR_TEST_COUNT];
+} ParallelForTest;
+
+static void ParallelForMark(void* data, u32 begin, u32 end)
+{
+    ParallelForTest* test = data;
+    for (u32 i = begin; i < end; i++)
+        AtomicFetchAdd(&test->Hits[i], 1, ATOMIC_RELAXED);
+}
+
+static void JobSystemParallelForCoversRange()
+{
+    TEST_EXPECT(JobSystemInit(JOB_TEST_THREADS));
+    ParallelForTest* test = MemoryTrackerAlloc(sizeof(ParallelForTest), MEMORY_TAG_APP);
+
+    u32 grains[] = {0, 1, 7, 1000, PARALLEL_FOR_TEST_COUNT * 2};
+    for (u32 g = 0; g < sizeof(grains) / sizeof(grains[0]); g++) {
+        PlatformZeroMemory(test, sizeof(ParallelForTest));
+        JobSystemParallelFor(PARALLEL_FOR_TEST_COUNT, grains[g], ParallelForMark, test);
+
+        u32 wrong = 0;
+        for (u32 i = 0; i < PARALLEL_FOR_TEST_COUNT; i++)
+            wrong += test->Hits[i] != 1;
+        TEST_EXPECT(wrong == 0);
+    }
+
+    MemoryTrackerFree(test, sizeof(ParallelForTest), MEMORY_TAG_APP);
+    JobSystemShutdown();
+}
+
+static void JobSubmitFromOutside(u32 index, void* data)
+{
+    Job batch[64];
+    for (u32 i = 0; i < 64; i++) {
+        batch[i].Function = JobIncrement;
+        batch[i].Data = 0;
+    }
+    for (u32 round = 0; round < 50; round++) {
+        JobCounter counter = {0};
+        JobSystemRun(batch, 64, &counter);
+        JobSystemWait(&counter);
+    }
+}
+
+// Threads outside the pool submit through the injection queue, and help out while they wait.
+static void JobSystemOutsideThreads()
+{
+    TEST_EXPECT(JobSystemInit(JOB_TEST_THREADS));
+    job_test = MemoryTrackerAlloc(sizeof(JobTestData), MEMORY_TAG_APP);
+
+    // Index 0 is the thread that initialized the pool, the others are outside of it.
+    TestRunThreads(4, JobSubmitFromOutside, 0);
+    TEST_EXPECT(job_test->Count == 4 * 50 * 64);
+
+    MemoryTrackerFree(job_test, sizeof(JobTestData), MEMORY_TAG_APP);
+    JobSystemShutdown();
+}
+
+// Jobs run before JobSystemRun returns when the job system isn't running.
+static void JobSystemNotRunning()
+{
+    job_test = MemoryTrackerAlloc(sizeof(JobTestData), MEMORY_TAG_APP);
+    Job batch[4];
+    for (u32 i = 0; i < 4; i++) {
+        batch[i].Function = JobIncrement;
+        batch[i].Data = 0;
+    }
+    JobCounter counter = {0};
+    JobSystemRun(batch, 4, &counter);
+    TEST_EXPECT(JobCounterIsDone(&counter));
+    TEST_EXPECT(job_test->Count == 4);
+    TEST_EXPECT(JobSystemGetThreadCount() == 1);
+    MemoryTrackerFree(job_test, sizeof(JobTestData), MEMORY_TAG_APP);
+}
+
+static void DequeBenchmark()
+{
+    WorkStealingDeque deque;
+    WorkStealingDequeCreate(1024, &deque);
+    const u32 rounds = 20000;
+    void* element = 0;
+    u64 sum = 0;
+
+    f64 start = BenchmarkNow();
+    for (u32 r = 0; r < rounds; r++) {
+        for (u64 i = 0; i < 1024; i++)
+            WorkStealingDequePush(&deque, (void*)i);
+        while (WorkStealingDequePop(&deque, &element))
+            sum += (u64)element;
+    }
+    BenchmarkReport("Owner push + pop", (u64)rounds * 1024, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 r = 0; r < rounds; r++) {
+        for (u64 i = 0; i < 1024; i++)
+            WorkStealingDequePush(&deque, (void*)i);
+        while (WorkStealingDequeSteal(&deque, &element))
+            sum += (u64)element;
+    }
+    BenchmarkReport("Owner push + uncontended steal", (u64)rounds * 1024, BenchmarkNow() - start);
+
+    BenchmarkKeep(sum);
+    WorkStealingDequeDestroy(&deque);
+}
+
+static void JobEmpty(void* data)
+{
+}
+
+// Burns a fixed amount of work, so that the scaling isn't only the overhead of the jobs.
+static void ParallelForWork(void* data, u32 begin, u32 end)
+{
+    u64 state = begin + 1;
+    for (u32 i = begin; i < end; i++) {
+        for (u32 j = 0; j < 64; j++) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+        }
+    }
+    AtomicFetchAdd((u64*)data, state, ATOMIC_RELAXED);
+}
+
+static void JobSystemScalingBenchmark()
+{
+    const u32 job_count = 100000;
+    const u32 work_count = 4000000;
+    Job* batch = JobTestCreateJobs(job_count, JobEmpty);
+    u32 processors = PlatformGetProcessorCount();
+
+    // Doubles the threads up to the number of logical processors, ending on it.
+    for (u32 threads = 1;; threads = threads * 2 < processors ? threads * 2 : processors) {
+        if (!JobSystemInit(threads))
+            break;
+
+        char name[64];
+        JobCounter counter = {0};
+        f64 start = BenchmarkNow();
+        JobSystemRun(batch, job_count, &counter);
+        JobSystemWait(&counter);
+        snprintf(name, sizeof(name), "%u thread(s): empty jobs", threads);
+        BenchmarkReport(name, job_count, BenchmarkNow() - start);
+
+        u64 sink = 0;
+        start = BenchmarkNow();
+        JobSystemParallelFor(work_count, 0, ParallelForWork, &sink);
+        snprintf(name, sizeof(name), "%u thread(s): parallel for, 64 xorshifts per index", threads);
+        BenchmarkReport(name, work_count, BenchmarkNow() - start);
+        BenchmarkKeep(sink);
+
+        JobSystemShutdown();
+        if (threads >= processors)
+            break;
+    }
+
+    MemoryTrackerFree(batch, sizeof(Job) * job_count, MEMORY_TAG_APP);
+}
+
+void RegisterJobSystemTests()
+{
+    TestRegister("WorkStealingDeque: sequential push, pop and steal", DequeSequential);
+    TestRegister("WorkStealingDeque: every element taken once under stealing", DequeStealStress);
+    TestRegister("JobSystem: run and wait, including nested jobs", JobSystemRunAndWait);
+    TestRegister("JobSystem: dependent batches run after their dependency", JobSystemDependencies);
+    TestRegister("JobSystem: parallel for covers the range once", JobSystemParallelForCoversRange);
+    TestRegister("JobSystem: submission from threads outside the pool", JobSystemOutsideThreads);
+    TestRegister("JobSystem: jobs run inline when it isn't running", JobSystemNotRunning);
+
+    BenchmarkRegister("WorkStealingDeque: single thread", DequeBenchmark);
+    BenchmarkRegister("JobSystem: scaling from 1 to N threads", JobSystemScalingBenchmark);
+}
@@ -0,0 +1,253 @@
+#include "../Test.h"
+
+#include <Core/MemTracker.h>
+#include <Platform/Platform.h>
+
+#define MEMORY_STRESS_THREADS 8
+#define MEMORY_STRESS_ROUNDS 2000
+#define MEMORY_STRESS_HELD 64
+
+// The tags the stress test allocates from, which nothing else uses while it runs.
+static const MemoryTag stress_tags[] = {MEMORY_TAG_UNKNOWN, MEMORY_TAG_APP, MEMORY_TAG_AUDIO};
+#define MEMORY_STRESS_TAG_COUNT (sizeof(stress_tags) / sizeof(stress_tags[0]))
+
+typedef struct MemoryStressBlock {
+    u8* Block;
+    u64 Size;
+    MemoryTag Tag;
+} MemoryStressBlock;
+
+typedef struct MemoryStress {
+    MemoryStressBlock Held[MEMORY_STRESS_THREADS][MEMORY_STRESS_HELD];
+    // The bytes of a block that weren't zeroed, or were overwritten by another thread.
+    u32 BadBytes[MEMORY_STRESS_THREADS];
+} MemoryStress;
+
+// Sizes on both sides of the thread cache limit, derived from the thread and slot.
+static u64 MemoryStressSize(u32 thread, u32 slot)
+{
+    static const u64 sizes[] = {1, 8, 24, 64, 100, 256, 512, 513, 2000, 16384};
+    return sizes[(thread * 7 + slot) % (sizeof(sizes) / sizeof(sizes[0]))];
+}
+
+static MemoryTag MemoryStressTag(u32 thread, u32 slot)
+{
+    return stress_tags[(thread + slot) % MEMORY_STRESS_TAG_COUNT];
+}
+
+static void MemoryStressCheck(MemoryStress* stress, u32 thread, MemoryStressBlock* held, u8 expected)
+{
+    for (u64 i = 0; i < held->Size; i++)
+        stress->BadBytes[thread] += held->Block[i] != expected;
+}
+
+// Allocates and frees blocks over and over, ending with every slot of the thread holding a block.
+static void MemoryStressAllocate(u32 index, void* data)
+{
+    MemoryStress* stress = data;
+    MemoryStressBlock* held = stress->Held[index];
+    u8 fill = (u8)(index + 1);
+
+    for (u32 round = 0; round < MEMORY_STRESS_ROUNDS; round++) {
+        u32 slot = (round * 13) % MEMORY_STRESS_HELD;
+        if (held[slot].Block) {
+            MemoryStressCheck(stress, index, &held[slot], fill);
+            MemoryTrackerFree(held[slot].Block, held[slot].Size, held[slot].Tag);
+        }
+        held[slot].Size = MemoryStressSize(index, slot + round);
+        held[slot].Tag = MemoryStressTag(index, slot + round);
+        held[slot].Block = MemoryTrackerAlloc(held[slot].Size, held[slot].Tag);
+        MemoryStressCheck(stress, index, &held[slot], 0);
+        PlatformSetMemory(held[slot].Block, fill, held[slot].Size);
+    }
+    for (u32 slot = 0; slot < MEMORY_STRESS_HELD; slot++) {
+        if (!held[slot].Block) {
+            held[slot].Size = MemoryStressSize(index, slot);
+            held[slot].Tag = MemoryStressTag(index, slot);
+            held[slot].Block = MemoryTrackerAlloc(held[slot].Size, held[slot].Tag);
+            PlatformSetMemory(held[slot].Block, fill, held[slot].Size);
+        }
+    }
+}
+
+// Frees the blocks of the thread with the next index, so that they're freed by another thread.
+static void MemoryStressFree(u32 index, void* data)
+{
+    MemoryStress* stress = data;
+    u32 owner = (index + 1) % MEMORY_STRESS_THREADS;
+    MemoryStressBlock* held = stress->Held[owner];
+    for (u32 slot = 0; slot < MEMORY_STRESS_HELD; slot++) {
+        MemoryStressCheck(stress, index, &held[slot], (u8)(owner + 1));
+        MemoryTrackerFree(held[slot].Block, held[slot].Size, held[slot].Tag);
+        held[slot].Block = 0;
+    }
+}
+
+// The statistics of every tag match the blocks held exactly, however the threads interleave.
+static void MemoryTrackerThreadedTotals()
+{
+    u64 base_count[MEMORY_STRESS_TAG_COUNT];
+    u64 base_usage[MEMORY_STRESS_TAG_COUNT];
+    for (u32 t = 0; t < MEMORY_STRESS_TAG_COUNT; t++) {
+        base_count[t] = MemoryTrackerGetAllocationCount(stress_tags[t]);
+        base_usage[t] = MemoryTrackerGetUsage(stress_tags[t]);
+    }
+
+    MemoryStress* stress = MemoryTrackerAlloc(sizeof(MemoryStress), MEMORY_TAG_ENGINE_GENERAL);
+    TestRunThreads(MEMORY_STRESS_THREADS, MemoryStressAllocate, stress);
+
+    u64 expected_count[MEMORY_STRESS_TAG_COUNT] = {0};
+    u64 expected_usage[MEMORY_STRESS_TAG_COUNT] = {0};
+    for (u32 thread = 0; thread < MEMORY_STRESS_THREADS; thread++) {
+        for (u32 slot = 0; slot < MEMORY_STRESS_HELD; slot++) {
+            MemoryStressBlock* held = &stress->Held[thread][slot];
+            for (u32 t = 0; t < MEMORY_STRESS_TAG_COUNT; t++) {
+                if (stress_tags[t] == held->Tag) {
+                    expected_count[t]++;
+                    expected_usage[t] += held->Size;
+                }
+            }
+        }
+    }
+    for (u32 t = 0; t < MEMORY_STRESS_TAG_COUNT; t++) {
+        TEST_EXPECT(MemoryTrackerGetAllocationCount(stress_tags[t]) - base_count[t] == expected_count[t]);
+        TEST_EXPECT(MemoryTrackerGetUsage(stress_tags[t]) - base_usage[t] == expected_usage[t]);
+    }
+
+    TestRunThreads(MEMORY_STRESS_THREADS, MemoryStressFree, stress);
+    for (u32 t = 0; t < MEMORY_STRESS_TAG_COUNT; t++) {
+        TEST_EXPECT(MemoryTrackerGetAllocationCount(stress_tags[t]) == base_count[t]);
+        TEST_EXPECT(MemoryTrackerGetUsage(stress_tags[t]) == base_usage[t]);
+    }
+
+    u32 bad_bytes = 0;
+    for (u32 thread = 0; thread < MEMORY_STRESS_THREADS; thread++)
+        bad_bytes += stress->BadBytes[thread];
+    TEST_EXPECT(bad_bytes == 0);
+
+    MemoryTrackerFree(stress, sizeof(MemoryStress), MEMORY_TAG_ENGINE_GENERAL);
+}
+
+static void MemoryCountFrameAllocations(u32 index, void* data)
+{
+    for (u32 i = 0; i < 10000; i++) {
+        void* block = MemoryTrackerAlloc(32, MEMORY_TAG_APP);
+        MemoryTrackerFree(block, 32, MEMORY_TAG_APP);
+    }
+}
+
+// The allocations of every thread are counted towards the frame, none of them lost.
+static void MemoryTrackerFrameAllocationCount()
+{
+    MemoryTrackerFrameReset();
+    TEST_EXPECT(MemoryTrackerGetFrameAllocationCount() == 0);
+    TestRunThreads(MEMORY_STRESS_THREADS, MemoryCountFrameAllocations, 0);
+    TEST_EXPECT(MemoryTrackerGetFrameAllocationCount() == MEMORY_STRESS_THREADS * 10000);
+    MemoryTrackerFrameReset();
+    TEST_EXPECT(MemoryTrackerGetFrameAllocationCount() == 0);
+}
+
+// Recycled blocks are zeroed like new ones.
+static void MemoryTrackerZeroedBlocks()
+{
+    for (u64 size = 1; size <= 4096; size *= 2) {
+        u8* block = MemoryTrackerAlloc(size, MEMORY_TAG_APP);
+        PlatformSetMemory(block, 0xCD, size);
+        MemoryTrackerFree(block, size, MEMORY_TAG_APP);
+
+        block = MemoryTrackerAlloc(size, MEMORY_TAG_APP);
+        u32 bad_bytes = 0;
+        for (u64 i = 0; i < size; i++)
+            bad_bytes += block[i] != 0;
+        TEST_EXPECT(bad_bytes == 0);
+        MemoryTrackerFree(block, size, MEMORY_TAG_APP);
+    }
+}
+
+static void MemoryArenaMarks()
+{
+    MemoryArena arena;
+    TEST_EXPECT(MemoryArenaCreate(1024, MEMORY_TAG_APP, &arena));
+
+    u8* first = MemoryArenaPush(&arena, 3, 1);
+    u64 mark = MemoryArenaGetMark(&arena);
+    u8* aligned = MemoryArenaPush(&arena, 16, 64);
+    TEST_EXPECT(first && aligned);
+    TEST_EXPECT(((u64)aligned & 63) == 0);
+
+    MemoryArenaRewind(&arena, mark);
+    TEST_EXPECT(MemoryArenaGetMark(&arena) == mark);
+    // Logs an error, as an arena doesn't grow.
+    TEST_EXPECT(MemoryArenaPush(&arena, 2048, MEMORY_ARENA_DEFAULT_ALIGNMENT) == 0);
+
+    MemoryArenaReset(&arena);
+    TEST_EXPECT(MemoryArenaPush(&arena, 3, 1) == first);
+    MemoryArenaDestroy(&arena);
+}
+
+#define TRANSIENT_FRAMES 2000
+#define TRANSIENT_PER_FRAME 256
+
+// Sizes of the transient arrays built during a frame, such as extension or layout lists.
+static u64 TransientSize(u32 i)
+{
+    return 16 << (i % 9);
+}
+
+// A frame of transient allocations, all released at its end, through each path.
+static void FrameArenaBenchmark()
+{
+    void* blocks[TRANSIENT_PER_FRAME];
+    u64 sum = 0;
+
+    f64 start = BenchmarkNow();
+    for (u32 frame = 0; frame < TRANSIENT_FRAMES; frame++) {
+        for (u32 i = 0; i < TRANSIENT_PER_FRAME; i++) {
+            blocks[i] = PlatformAlloc(TransientSize(i));
+            *(u8*)blocks[i] = (u8)i;
+        }
+        for (u32 i = 0; i < TRANSIENT_PER_FRAME; i++) {
+            sum += *(u8*)blocks[i];
+            PlatformFree(blocks[i]);
+        }
+    }
+    BenchmarkReport("Platform alloc + free", (u64)TRANSIENT_FRAMES * TRANSIENT_PER_FRAME, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 frame = 0; frame < TRANSIENT_FRAMES; frame++) {
+        for (u32 i = 0; i < TRANSIENT_PER_FRAME; i++) {
+            blocks[i] = MemoryTrackerAlloc(TransientSize(i), MEMORY_TAG_APP);
+            *(u8*)blocks[i] = (u8)i;
+        }
+        for (u32 i = 0; i < TRANSIENT_PER_FRAME; i++) {
+            sum += *(u8*)blocks[i];
+            MemoryTrackerFree(blocks[i], TransientSize(i), MEMORY_TAG_APP);
+        }
+    }
+    BenchmarkReport("MemoryTrackerAlloc + free", (u64)TRANSIENT_FRAMES * TRANSIENT_PER_FRAME, BenchmarkNow() - start);
+
+    start = BenchmarkNow();
+    for (u32 frame = 0; frame < TRANSIENT_FRAMES; frame++) {
+        MemoryTrackerFrameReset();
+        MemoryArena* arena = MemoryTrackerGetFrameArena();
+        for (u32 i = 0; i < TRANSIENT_PER_FRAME; i++) {
+            blocks[i] = MemoryArenaPush(arena, TransientSize(i), MEMORY_ARENA_DEFAULT_ALIGNMENT);
+            *(u8*)blocks[i] = (u8)i;
+        }
+        for (u32 i = 0; i < TRANSIENT_PER_FRAME; i++)
+            sum += *(u8*)blocks[i];
+    }
+    BenchmarkReport("Frame arena push, reset per frame", (u64)TRANSIENT_FRAMES * TRANSIENT_PER_FRAME, BenchmarkNow() - start);
+
+    BenchmarkKeep(sum);
+}
+
+void RegisterMemTrackerTests()
+{
+    TestRegister("MemTracker: exact tag totals with many threads", MemoryTrackerThreadedTotals);
+    TestRegister("MemTracker: frame allocations counted on every thread", MemoryTrackerFrameAllocationCount);
+    TestRegister("MemTracker: recycled blocks are zeroed", MemoryTrackerZeroedBlocks);
+    TestRegister("MemTracker: arena marks, alignment and reset", MemoryArenaMarks);
+
+    BenchmarkRegister("MemTracker: transient allocations of a frame", FrameArenaBenchmark);
+}
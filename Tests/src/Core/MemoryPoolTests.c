@@ -0,0 +1,122 @@
+#include "../Test.h"
+
+#include <Core/MemoryPool.h>
+#include <Platform/Platform.h>
+
+#define POOL_CHURN_LIVE 4096
+#define POOL_CHURN_OPERATIONS 4000000
+
+// About the size of a backend object, such as a buffer or a pipeline.
+typedef struct PoolTestObject {
+    u64 Handle;
+    u32 Flags;
+    u8 Data[180];
+} PoolTestObject;
+
+static void MemoryPoolReuse()
+{
+    MemoryPool pool;
+    TEST_EXPECT(MemoryPool_Create(PoolTestObject, 4, true, MEMORY_TAG_APP, &pool));
+    u32 registered = MemoryTrackerGetPoolCount();
+    TEST_EXPECT(registered > 0 && MemoryTrackerGetPool(registered - 1) == &pool);
+
+    PoolTestObject* objects[9];
+    b8 zeroed_and_aligned = true;
+    for (u32 i = 0; i < 9; i++) {
+        objects[i] = MemoryPool_Alloc(&pool, PoolTestObject);
+        zeroed_and_aligned = zeroed_and_aligned && objects[i] && objects[i]->Handle == 0 &&
+            ((u64)objects[i] & (MEMORY_POOL_SLOT_ALIGNMENT - 1)) == 0;
+        objects[i]->Handle = i + 1;
+    }
+    TEST_EXPECT(zeroed_and_aligned);
+    TEST_EXPECT(pool.ChunkCount == 3);
+    TEST_EXPECT(pool.LiveCount == 9 && pool.PeakCount == 9);
+
+    // A freed slot is the next one handed out, zeroed, with its generation moved on.
+    u32 generation = MemoryPoolGetGeneration(&pool, objects[4]);
+    PoolTestObject* freed = objects[4];
+    MemoryPoolFree(&pool, objects[4]);
+    objects[4] = MemoryPool_Alloc(&pool, PoolTestObject);
+    TEST_EXPECT(objects[4] == freed);
+    TEST_EXPECT(objects[4]->Handle == 0);
+    TEST_EXPECT(MemoryPoolGetGeneration(&pool, objects[4]) != generation);
+
+    for (u32 i = 0; i < 9; i++)
+        MemoryPoolFree(&pool, objects[i]);
+    TEST_EXPECT(pool.LiveCount == 0 && pool.PeakCount == 9);
+    TEST_EXPECT(pool.ChunkCount == 3);
+
+    MemoryPoolDestroy(&pool);
+    TEST_EXPECT(MemoryTrackerGetPoolCount() == registered - 1);
+}
+
+// Frees a random live object and allocates a new one in its place, over and over.
+static void MemoryPoolChurnBenchmark()
+{
+    void** live = MemoryTrackerAlloc(sizeof(void*) * POOL_CHURN_LIVE, MEMORY_TAG_APP);
+    MemoryPool pool;
+    MemoryPool_Create(PoolTestObject, MEMORY_POOL_DEFAULT_CHUNK_SLOTS, true, MEMORY_TAG_APP, &pool);
+    u64 sum = 0;
+
+    u32 random = 0x9E3779B9u;
+    for (u32 i = 0; i < POOL_CHURN_LIVE; i++)
+        live[i] = MemoryPool_Alloc(&pool, PoolTestObject);
+    f64 start = BenchmarkNow();
+    for (u32 i = 0; i < POOL_CHURN_OPERATIONS; i++) {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        u32 slot = random % POOL_CHURN_LIVE;
+        MemoryPoolFree(&pool, live[slot]);
+        live[slot] = MemoryPool_Alloc(&pool, PoolTestObject);
+        sum += ((PoolTestObject*)live[slot])->Flags++;
+    }
+    BenchmarkReport("MemoryPool free + alloc", POOL_CHURN_OPERATIONS, BenchmarkNow() - start);
+    for (u32 i = 0; i < POOL_CHURN_LIVE; i++)
+        MemoryPoolFree(&pool, live[i]);
+    MemoryPoolDestroy(&pool);
+
+    random = 0x9E3779B9u;
+    for (u32 i = 0; i < POOL_CHURN_LIVE; i++)
+        live[i] = MemoryTrackerAlloc(sizeof(PoolTestObject), MEMORY_TAG_APP);
+    start = BenchmarkNow();
+    for (u32 i = 0; i < POOL_CHURN_OPERATIONS; i++) {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        u32 slot = random % POOL_CHURN_LIVE;
+        MemoryTrackerFree(live[slot], sizeof(PoolTestObject), MEMORY_TAG_APP);
+        live[slot] = MemoryTrackerAlloc(sizeof(PoolTestObject), MEMORY_TAG_APP);
+        sum += ((PoolTestObject*)live[slot])->Flags++;
+    }
+    BenchmarkReport("MemoryTrackerAlloc free + alloc", POOL_CHURN_OPERATIONS, BenchmarkNow() - start);
+    for (u32 i = 0; i < POOL_CHURN_LIVE; i++)
+        MemoryTrackerFree(live[i], sizeof(PoolTestObject), MEMORY_TAG_APP);
+
+    random = 0x9E3779B9u;
+    for (u32 i = 0; i < POOL_CHURN_LIVE; i++)
+        live[i] = PlatformAlloc(sizeof(PoolTestObject));
+    start = BenchmarkNow();
+    for (u32 i = 0; i < POOL_CHURN_OPERATIONS; i++) {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        u32 slot = random % POOL_CHURN_LIVE;
+        PlatformFree(live[slot]);
+        live[slot] = PlatformAlloc(sizeof(PoolTestObject));
+        sum += ((PoolTestObject*)live[slot])->Flags++;
+    }
+    BenchmarkReport("Platform free + alloc", POOL_CHURN_OPERATIONS, BenchmarkNow() - start);
+    for (u32 i = 0; i < POOL_CHURN_LIVE; i++)
+        PlatformFree(live[i]);
+
+    BenchmarkKeep(sum);
+    MemoryTrackerFree(live, sizeof(void*) * POOL_CHURN_LIVE, MEMORY_TAG_APP);
+}
+
+void RegisterMemoryPoolTests()
+{
+    TestRegister("MemoryPool: slot reuse, generations and statistics", MemoryPoolReuse);
+
+    BenchmarkRegister("MemoryPool: churn of 4096 live objects", MemoryPoolChurnBenchmark);
+}
@@ -0,0 +1,156 @@
+#include "Test.h"
+
+#include <Core/Atomic.h>
+#include <Core/MemTracker.h>
+#include <Platform/Platform.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_MAX_ENTRIES 256
+#define TEST_MAX_THREADS 64
+
+typedef struct TestEntry {
+    const char* Name;
+    PFN_Test Function;
+    b8 Benchmark;
+} TestEntry;
+
+typedef struct TestThread {
+    void (*Function)(u32 index, void* data);
+    void* Data;
+    u32 Index;
+} TestThread;
+
+static TestEntry entries[TEST_MAX_ENTRIES];
+static u32 entry_count;
+// The failures of the running test, which can come from any thread.
+static u32 failures;
+static volatile u64 kept;
+
+void TestAdd(const char* name, PFN_Test function, b8 benchmark)
+{
+    if (entry_count == TEST_MAX_ENTRIES) {
+        fprintf(stderr, "Too many tests, '%s' will not run.\n", name);
+        return;
+    }
+    entries[entry_count].Name = name;
+    entries[entry_count].Function = function;
+    entries[entry_count].Benchmark = benchmark;
+    entry_count++;
+}
+
+void TestRegister(const char* name, PFN_Test test)
+{
+    TestAdd(name, test, false);
+}
+
+void BenchmarkRegister(const char* name, PFN_Test benchmark)
+{
+    TestAdd(name, benchmark, true);
+}
+
+void TestFail(const char* expression, const char* file, i32 line)
+{
+    AtomicFetchAdd(&failures, 1, ATOMIC_RELAXED);
+    fprintf(stderr, "    %s:%d: expected %s\n", file, line, expression);
+}
+
+void BenchmarkReport(const char* name, u64 operations, f64 seconds)
+{
+    f64 ns = operations ? seconds * 1e9 / (f64)operations : 0.0;
+    f64 per_second = seconds > 0.0 ? (f64)operations / seconds : 0.0;
+    printf("    %-48s %10.2f ns/op %14.0f op/s\n", name, ns, per_second);
+}
+
+f64 BenchmarkNow()
+{
+    return PlatformGetAbsoluteTime();
+}
+
+void BenchmarkKeep(u64 value)
+{
+    kept += value;
+}
+
+u32 TestThreadEntry(void* param)
+{
+    TestThread* thread = param;
+    thread->Function(thread->Index, thread->Data);
+    MemoryTrackerFlushThreadCache();
+    return 0;
+}
+
+void TestRunThreads(u32 thread_count, void (*function)(u32 index, void* data), void* data)
+{
+    if (thread_count > TEST_MAX_THREADS)
+        thread_count = TEST_MAX_THREADS;
+
+    TestThread threads[TEST_MAX_THREADS];
+    PlatformThread handles[TEST_MAX_THREADS];
+    b8 started[TEST_MAX_THREADS] = {0};
+    for (u32 i = 1; i < thread_count; i++) {
+        threads[i].Function = function;
+        threads[i].Data = data;
+        threads[i].Index = i;
+        started[i] = PlatformThreadCreate(TestThreadEntry, &threads[i], &handles[i]);
+        if (!started[i]) {
+            // Run it here instead, so that the test still sees every index.
+            fprintf(stderr, "    Failed to start test thread %u, running it on the calling thread.\n", i);
+            function(i, data);
+        }
+    }
+
+    function(0, data);
+
+    for (u32 i = 1; i < thread_count; i++) {
+        if (started[i])
+            PlatformThreadJoin(&handles[i]);
+    }
+}
+
+// Runs the engine tests, or with the bench argument the benchmarks. A further argument
+// only runs the tests whose name contains it.
+int main(int argc, char** argv)
+{
+    b8 benchmarks = argc > 1 && strcmp(argv[1], "bench") == 0;
+    const char* filter = argc > (benchmarks ? 2 : 1) ? argv[benchmarks ? 2 : 1] : 0;
+
+    if (!MemoryTrackerInit()) {
+        fprintf(stderr, "Failed to initialize the memory tracker.\n");
+        return 1;
+    }
+
+    RegisterJobSystemTests();
+    RegisterMemTrackerTests();
+    RegisterQueueTests();
+    RegisterEventTests();
+    RegisterMemoryPoolTests();
+    RegisterDarrayTests();
+    RegisterHashTableTests();
+    RegisterHashTests();
+    RegisterSlotMapTests();
+    RegisterSortTests();
+
+    u32 run = 0;
+    u32 failed = 0;
+    for (u32 i = 0; i < entry_count; i++) {
+        TestEntry* entry = &entries[i];
+        if (entry->Benchmark != benchmarks || (filter && !strstr(entry->Name, filter)))
+            continue;
+
+        printf("%s %s\n", benchmarks ? "[BENCH]" : "[TEST] ", entry->Name);
+        fflush(stdout);
+        AtomicStore(&failures, 0, ATOMIC_RELAXED);
+        entry->Function();
+        run++;
+        if (AtomicLoad(&failures, ATOMIC_RELAXED)) {
+            printf("[FAIL]  %s\n", entry->Name);
+            failed++;
+        }
+    }
+
+    printf("%u %s run, %u failed.\n", run, benchmarks ? "benchmark(s)" : "test(s)", failed);
+    MemoryTrackerShutdown();
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file Test.h
+ * @author Milo Heinrich (MikuoH15TH@gmail.com)
+ * @brief This file contains the small framework the engine tests and benchmarks are written with.
+ * Every test file provides a registration function, called from Main.c, which registers its
+ * tests and benchmarks by name. Tests check their results with TEST_EXPECT, and benchmarks
+ * report their timings with BenchmarkReport.
+ * @version 1.0
+ * @date 2022-08-02
+ */
+#ifndef ELSA_TEST_H
+#define ELSA_TEST_H
+
+#include <Defines.h>
+
+/** @brief The function of a test or a benchmark. */
+typedef void (*PFN_Test)();
+
+/**
+ * @brief Registers a test, run by default.
+ * @param name The name of the test. Must be a string literal.
+ * @param test The function of the test.
+ */
+void TestRegister(const char* name, PFN_Test test);
+
+/**
+ * @brief Registers a benchmark, only run when the program is given the bench argument.
+ * @param name The name of the benchmark. Must be a string literal.
+ * @param benchmark The function of the benchmark.
+ */
+void BenchmarkRegister(const char* name, PFN_Test benchmark);
+
+/**
+ * @brief Marks the running test as failed. Use it through TEST_EXPECT.
+ * @param expression The expression that was false.
+ * @param file The file of the expression.
+ * @param line The line of the expression.
+ */
+void TestFail(const char* expression, const char* file, i32 line);
+
+/**
+ * @brief Fails the running test if the expression is false, and carries on with the test.
+ * Safe to call from any thread.
+ * @param expr The expression to check.
+ */
+#define TEST_EXPECT(expr)                           \
+do {                                                \
+    if (!(expr))                                    \
+        TestFail(#expr, __FILE__, __LINE__);        \
+} while (0)
+
+/**
+ * @brief Prints the timing of a benchmark, as the time per operation and the operations per second.
+ * @param name What was measured.
+ * @param operations The number of operations that were run.
+ * @param seconds The time they took, in seconds.
+ */
+void BenchmarkReport(const char* name, u64 operations, f64 seconds);
+
+/**
+ * @brief Gets the current time, for timing benchmarks.
+ * @returns The time in seconds.
+ */
+f64 BenchmarkNow();
+
+/**
+ * @brief Keeps the compiler from optimizing away a value a benchmark computes.
+ * @param value The value to keep.
+ */
+void BenchmarkKeep(u64 value);
+
+/**
+ * @brief Runs a function on a number of threads at once, and waits for all of them.
+ * The calling thread runs it with index 0.
+ * @param thread_count The number of threads to run the function on, including the calling one.
+ * @param function The function, called with the index of the thread.
+ * @param data The data passed to the function.
+ */
+void TestRunThreads(u32 thread_count, void (*function)(u32 index, void* data), void* data);
+
+void RegisterJobSystemTests();
+void RegisterMemTrackerTests();
+void RegisterQueueTests();
+void RegisterEventTests();
+void RegisterMemoryPoolTests();
+void RegisterDarrayTests();
+void RegisterHashTableTests();
+void RegisterHashTests();
+void RegisterSlotMapTests();
+void RegisterSortTests();
+
+#endif
@@ -0,0 +1,14 @@
+set echo on
+
+mkdir -p ../../bin
+
+cFilenames=$(find . -type f -name "*.c")
+
+Assembly="LogDecoder"
+CompilerFlags="-g -fdeclspec -fPIC"
+IncludeFlags="-I../../Elsa/src"
+LinkerFlags="-L../../bin/ -lElsa -Wl,-rpath,\$ORIGIN"
+Defines="-D_DEBUG"
+
+echo "Building $Assembly..."
+clang $cFilenames $CompilerFlags -o ../../bin/$Assembly $Defines $IncludeFlags $LinkerFlags
@@ -0,0 +1,18 @@
+REM Build script for the log decoder
+@ECHO OFF
+SetLocal EnableDelayedExpansion
+
+REM Get a list of all the C files
+SET Filenames=
+FOR /R %%f in (*.c) do (
+    SET Filenames=!Filenames! %%f
+)
+
+SET Assembly=LogDecoder
+SET CompilerFlags=-g -MD -Werror=vla -Wno-missing-braces -fdeclspec
+SET IncludeFlags=-Isrc -I../../Elsa/src
+SET LinkerFlags=-L../../bin/ -lElsa.lib
+SET Defines=-D_DEBUG 
+
+ECHO "Building %Assembly%..."
+clang %Filenames% %CompilerFlags% -o ../../bin/%Assembly%.exe %Defines% %IncludeFlags% %LinkerFlags%
\ No newline at end of file
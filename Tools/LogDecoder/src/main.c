@@ -0,0 +1,14 @@
+#include <Core/Logger.h>
+
+#include <stdio.h>
+
+// Decodes a log file written with ELSA_LOG_BINARY defined back into text.
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <binary log> [text output]\n", argv[0]);
+        return 1;
+    }
+
+    return LogDecodeFile(argv[1], argc > 2 ? argv[2] : 0) ? 0 : 1;
+}
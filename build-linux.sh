@@ -0,0 +1,25 @@
+set echo on
+
+echo "Building everything..."
+
+cd Elsa
+chmod +x build-linux.sh
+./build-linux.sh
+cd ../
+
+cd App
+chmod +x build-linux.sh
+source build-linux.sh
+cd ../
+
+cd Tools/LogDecoder
+chmod +x build-linux.sh
+./build-linux.sh
+cd ../../
+
+cd Tests
+chmod +x build-linux.sh
+./build-linux.sh
+cd ../
+
+echo "All assemblies built succesfully."
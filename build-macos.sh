@@ -12,4 +12,14 @@ chmod +x build-macos.sh
 source build-macos.sh
 cd ../
 
+cd Tools/LogDecoder
+chmod +x build-macos.sh
+./build-macos.sh
+cd ../../
+
+cd Tests
+chmod +x build-macos.sh
+./build-macos.sh
+cd ../
+
 echo "All assemblies built succesfully."
\ No newline at end of file
@@ -15,4 +15,14 @@ PUSHD App
 CALL build-windows.bat
 POPD
 
+REM Tools
+PUSHD Tools\LogDecoder
+CALL build-windows.bat
+POPD
+
+REM Tests
+PUSHD Tests
+CALL build-windows.bat
+POPD
+
 ECHO "All assemblies built successfully."
\ No newline at end of file